@@ -0,0 +1,60 @@
+#include "bsp_flash.h"
+#include "stm32f4xx_hal.h"
+#include <string.h>
+
+#define BSP_FLASH_CONFIG_SECTOR FLASH_SECTOR_11
+
+// 清除上一次操作残留的错误标志，否则 HAL_FLASH_Program 会直接失败
+static void flash_clear_flags(void)
+{
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR |
+                           FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR);
+}
+
+const uint8_t *BSP_Flash_ConfigBase(void)
+{
+    return (const uint8_t *)BSP_FLASH_CONFIG_ADDR;
+}
+
+bool BSP_Flash_ConfigErase(void)
+{
+    FLASH_EraseInitTypeDef erase = {0};
+    erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+    erase.Sector = BSP_FLASH_CONFIG_SECTOR;
+    erase.NbSectors = 1;
+    erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;    // 3.3V：按字（x32）擦写
+
+    uint32_t bad_sector = 0;
+    HAL_FLASH_Unlock();
+    flash_clear_flags();
+    const HAL_StatusTypeDef st = HAL_FLASHEx_Erase(&erase, &bad_sector);   // 结束时会刷新 ART 缓存
+    HAL_FLASH_Lock();
+    return st == HAL_OK;
+}
+
+bool BSP_Flash_ConfigWrite(uint32_t offset, const void *data, uint32_t len)
+{
+    if (!data || (offset & 3U) || (len & 3U) || offset > BSP_FLASH_CONFIG_SIZE ||
+        len > BSP_FLASH_CONFIG_SIZE - offset) {
+        return false;
+    }
+
+    const uint8_t *src = (const uint8_t *)data;
+    bool ok = true;
+    HAL_FLASH_Unlock();
+    flash_clear_flags();
+    for (uint32_t i = 0; i < len && ok; i += 4) {
+        uint32_t w;
+        memcpy(&w, src + i, sizeof(w));
+        ok = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, BSP_FLASH_CONFIG_ADDR + offset + i, w) == HAL_OK;
+    }
+    HAL_FLASH_Lock();
+
+    // 写入前扫描时读过的擦除值可能还在 ART 数据缓存里，回读前先复位缓存
+    if (READ_BIT(FLASH->ACR, FLASH_ACR_DCEN)) {
+        __HAL_FLASH_DATA_CACHE_DISABLE();
+        __HAL_FLASH_DATA_CACHE_RESET();
+        __HAL_FLASH_DATA_CACHE_ENABLE();
+    }
+    return ok && memcmp(BSP_Flash_ConfigBase() + offset, data, len) == 0;
+}
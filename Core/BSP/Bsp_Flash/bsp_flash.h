@@ -0,0 +1,34 @@
+/**
+ * @file    bsp_flash.h
+ * @brief   内部 Flash 配置扇区（Sector 11，0x080E0000，128KB）
+ * @note    链接脚本（STM32F405XX_FLASH.ld）已把该扇区从 FLASH 中划出（CONFIG 区），程序不会占用。
+ *          擦除 128KB 约 1~2 秒，写一个字约 16us；期间 CPU 从 Flash 取指会停顿，中断一起推迟，
+ *          只能在上锁/静止时调用。SIL 构建中由 sil_board.c 以 RAM 模拟（同样只能把 1 写成 0）。
+ */
+#ifndef BSP_FLASH_H
+#define BSP_FLASH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BSP_FLASH_CONFIG_ADDR   0x080E0000UL
+#define BSP_FLASH_CONFIG_SIZE   (128UL * 1024UL)
+
+// 配置扇区的只读映射（擦除后全为 0xFF）
+const uint8_t *BSP_Flash_ConfigBase(void);
+
+// 擦除整个配置扇区
+bool BSP_Flash_ConfigErase(void);
+
+// 按字写入：offset、len 须 4 字节对齐，目标须已擦除；写完回读比较
+bool BSP_Flash_ConfigWrite(uint32_t offset, const void *data, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BSP_FLASH_H
@@ -40,6 +40,18 @@ void MX_GPIO_Init(void)
   /* USER CODE END MX_GPIO_Init_2 */
 }
 
+/**
+ * @brief 实时通道中断（PendSV）优先级：数值上大于 SPI DMA（1），小于 I2C/UART（5）
+ */
+void BSP_RT_Lane_Init(void)
+{
+  HAL_NVIC_SetPriority(PendSV_IRQn, BSP_RT_LANE_PRIORITY, 0);
+}
+
+__attribute__((weak)) void BSP_RT_Lane_IRQ(void)
+{
+}
+
 /**
  * @brief EXTI3 中断服务函数（PC3）
  */
@@ -1,4 +1,27 @@
+#ifndef BSP_IO_H
+#define BSP_IO_H
+
 #include "stm32f4xx.h"
 
+/*
+ * 调度器实时通道中断：IMU 数据就绪 EXTI（优先级 1，与 SPI DMA 同级）只挂起 PendSV，
+ * scheduler_rt_isr 在优先级 2 的 PendSV 中运行。这样 SPI DMA 完成中断可以抢占实时任务，
+ * 实时任务等待 DMA 不会死锁；I2C/UART（5）仍被实时任务抢占。
+ */
+#define BSP_RT_LANE_PRIORITY    2
+
+void MX_GPIO_Init(void);
+
+// 设置 PendSV 优先级（使用实时通道前调用一次）
+void BSP_RT_Lane_Init(void);
+
+// 在中断中挂起实时通道中断（同一节拍内多次挂起只执行一次）
+static inline void BSP_RT_Lane_Pend(void)
+{
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+}
+
+// 实时通道中断体，由 PendSV_Handler 调用（弱定义为空），应用层重定义为 scheduler_rt_isr(&sched)
+void BSP_RT_Lane_IRQ(void);
 
-void MX_GPIO_Init(void);
\ No newline at end of file
+#endif // BSP_IO_H
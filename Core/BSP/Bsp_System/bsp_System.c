@@ -1,4 +1,5 @@
 #include "bsp_System.h"
+#include "bsp_IO.h"
 
 static uint32_t usTicks = 0;
 
@@ -146,6 +147,7 @@ void DebugMon_Handler(void)
   */
 void PendSV_Handler(void)
 {
+  BSP_RT_Lane_IRQ();   // 调度器实时通道（见 bsp_IO.h）
 }
 
 /**
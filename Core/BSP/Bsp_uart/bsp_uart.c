@@ -217,11 +217,17 @@ int BSP_UART_Write(uint8_t uart_id, const uint8_t *data, uint16_t len)
 }
 
 // 默认弱回调，可在应用层重载
-__attribute__((weak)) void BSP_UART_RxByteCallback(uint8_t uart_id, uint8_t byte)
+__attribute__((weak)) void BSP_UART_ConsoleByteCallback(uint8_t uart_id, uint8_t byte)
 {
     (void)uart_id; (void)byte;
 }
 
+// 默认弱回调：没有协议占用串口时，所有字节都交给控制台
+__attribute__((weak)) void BSP_UART_RxByteCallback(uint8_t uart_id, uint8_t byte)
+{
+    BSP_UART_ConsoleByteCallback(uart_id, byte);
+}
+
 void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
 {
 #ifdef USE_UART1
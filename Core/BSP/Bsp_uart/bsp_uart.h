@@ -36,9 +36,13 @@ void BSP_UART_Open(uint8_t uart_id, uint32_t baudrate);
 // 发送数据（轮询）
 int  BSP_UART_Write(uint8_t uart_id, const uint8_t *data, uint16_t len);
 
-// 接收 1 字节完成回调（弱符号，可在其他文件重载）
+// 接收 1 字节完成回调（弱符号，可在其他文件重载；ELRS/CRSF 移植层重载了它）
 void BSP_UART_RxByteCallback(uint8_t uart_id, uint8_t byte);
 
+// 控制台字节回调（弱符号）：未被接收机等协议占用的串口字节由 BSP_UART_RxByteCallback 转交至此，
+// 应用层重载它实现串口命令，不要再重载 BSP_UART_RxByteCallback
+void BSP_UART_ConsoleByteCallback(uint8_t uart_id, uint8_t byte);
+
 #ifdef __cplusplus
 }
 #endif
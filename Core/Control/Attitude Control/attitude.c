@@ -5,6 +5,7 @@
 #include "maths.h"
 #include "stm32f4xx_hal.h"
 #include "attitude.h"
+#include "attitude_ekf.h"
 
 Euler_angles euler_angles;
 Quaternion attitude_q;
@@ -15,7 +16,15 @@ Quaternion attitude_q;
 
 // Mahony算法的积分项（误差积分）
 static float exInt = 0.0f, eyInt = 0.0f, ezInt = 0.0f;
-static uint32_t lastTick = 0;
+
+// 积分步长上限：丢样/断点调试恢复后不做超长一步积分
+#define ATTITUDE_DT_MAX          0.05f
+
+// 时间戳时基：默认 DWT->CYCCNT（SystemCoreClock），也可切换为传感器时间戳（如 ICM42688P 1MHz）
+static uint32_t stampHz = 0;        // 0 = 跟随 SystemCoreClock
+static float    stampToSec = 0.0f;  // 1 / 时基
+static uint32_t lastStamp = 0;
+static bool     haveLastStamp = false;
 
 // Mahony标准增益（9DoF）：twoKp=2*Kp, twoKi=2*Ki
 static const float twoKp = 2.0f * 4.0f;   // 比例增益 Kp=0.5
@@ -37,6 +46,76 @@ static void quat_normalize(Quaternion *q)
 // 运行诊断
 static AttitudeDiagnostics attitude_diag = {0};
 
+// 估计器选择与 EKF 状态
+static AttitudeEstimator attitude_estimator = ATTITUDE_ESTIMATOR_DEFAULT;
+static AttitudeEkf attitude_ekf;
+static bool attitude_ekf_configured = false;
+
+// 重新初始化姿态时调用：清零 Mahony 积分项，EKF 回到初始协方差与零偏
+static void attitude_estimator_reset(void)
+{
+    exInt = eyInt = ezInt = 0.0f;
+    AttitudeEkf_Init(&attitude_ekf, attitude_ekf_configured ? &attitude_ekf.cfg : NULL);
+    attitude_ekf_configured = true;
+}
+
+void Attitude_SetEstimator(AttitudeEstimator estimator)
+{
+    if (estimator != attitude_estimator) {
+        attitude_estimator = estimator;
+        attitude_estimator_reset();   // 保留当前姿态，只重置估计器内部状态
+    }
+}
+
+AttitudeEstimator Attitude_GetEstimator(void)
+{
+    return attitude_estimator;
+}
+
+void Attitude_SetEkfConfig(const AttitudeEkfConfig *cfg)
+{
+    AttitudeEkf_Init(&attitude_ekf, cfg);
+    attitude_ekf_configured = true;
+}
+
+AttitudeEkf *Attitude_GetEkf(void)
+{
+    return &attitude_ekf;
+}
+
+static void attitude_time_reset(void)
+{
+    const uint32_t hz = stampHz ? stampHz : SystemCoreClock;
+    stampToSec = 1.0f / (float)hz;
+    if (stampHz == 0) {
+        // DWT 时基：以初始化时刻为起点，与原先 HAL_GetTick 的行为一致
+        lastStamp = DWT->CYCCNT;
+        haveLastStamp = true;
+    } else {
+        // 外部时间戳：第一次更新只建立时间参考，不积分
+        haveLastStamp = false;
+    }
+}
+
+// 两次时间戳之差 -> dt(s)；32 位无符号差自动处理计数器回绕
+static float attitude_dt_from_stamp(uint32_t stamp)
+{
+    float dt = 0.0f;
+    if (haveLastStamp) {
+        dt = (float)(uint32_t)(stamp - lastStamp) * stampToSec;
+        if (dt > ATTITUDE_DT_MAX) dt = ATTITUDE_DT_MAX;
+    }
+    lastStamp = stamp;
+    haveLastStamp = true;
+    return dt;
+}
+
+void Attitude_SetTimeBase(uint32_t ticks_per_second)
+{
+    stampHz = ticks_per_second;
+    attitude_time_reset();
+}
+
 void Attitude_Init(void)
 {
     euler_angles.pitch = 0.0f;
@@ -48,8 +127,8 @@ void Attitude_Init(void)
     attitude_q.p2 = 0.0f;
     attitude_q.p3 = 0.0f;
 
-    exInt = eyInt = ezInt = 0.0f;
-    lastTick = HAL_GetTick();
+    attitude_estimator_reset();
+    attitude_time_reset();
     attitude_diag = (AttitudeDiagnostics){0};
 }
 
@@ -74,8 +153,8 @@ void Attitude_InitFromAccelerometer(float ax, float ay, float az)
 
     attitude_q = Attitude_EulerToQuat(roll, pitch, yaw);
 
-    exInt = eyInt = ezInt = 0.0f;
-    lastTick = HAL_GetTick();
+    attitude_estimator_reset();
+    attitude_time_reset();
     attitude_diag = (AttitudeDiagnostics){0};
 }
 
@@ -123,8 +202,8 @@ void Attitude_InitFromAccelMag(float ax, float ay, float az,
 
     attitude_q = Attitude_EulerToQuat(roll, pitch, yaw);
 
-    exInt = eyInt = ezInt = 0.0f;
-    lastTick = HAL_GetTick();
+    attitude_estimator_reset();
+    attitude_time_reset();
     attitude_diag = (AttitudeDiagnostics){0};
 
     euler_angles.roll  = roll  * RAD2DEG;
@@ -137,19 +216,16 @@ void Attitude_InitFromAccelMag(float ax, float ay, float az,
 static Euler_angles Attitude_Update_Internal(float ax_g, float ay_g, float az_g,
                                              float gx_dps, float gy_dps, float gz_dps,
                                              float mx_gauss, float my_gauss, float mz_gauss, 
-                                             bool use_mag)
+                                             bool use_mag, uint32_t stamp)
 #else
-Euler_angles Attitude_Update(float ax_g, float ay_g, float az_g,
-                             float gx_dps, float gy_dps, float gz_dps)
+static Euler_angles Attitude_Update_Internal(float ax_g, float ay_g, float az_g,
+                                             float gx_dps, float gy_dps, float gz_dps,
+                                             uint32_t stamp)
 #endif
 {
     const uint32_t cycle_start = DWT->CYCCNT;
 
-    uint32_t now = HAL_GetTick();
-    float dt = (now - lastTick) * 0.001f;
-    lastTick = now;
-    if (dt < 1e-4f) dt = 1e-4f;
-    if (dt > 0.05f) dt = 0.05f;
+    const float dt = attitude_dt_from_stamp(stamp);
 
     float spin_rate_dps = sqrtf(gx_dps*gx_dps + gy_dps*gy_dps + gz_dps*gz_dps);
     float gx = gx_dps * DEG2RAD;
@@ -159,75 +235,89 @@ Euler_angles Attitude_Update(float ax_g, float ay_g, float az_g,
     attitude_diag.mag_used = false;
     attitude_diag.mag_strength_ok = false;
 
-    float acc_norm = sqrtf(ax_g*ax_g + ay_g*ay_g + az_g*az_g);
-    if (acc_norm < ACC_FIELD_MIN_G) acc_norm = ACC_FIELD_MIN_G;
-    ax_g /= acc_norm; ay_g /= acc_norm; az_g /= acc_norm;
     bool acc_valid = true;
+    if (attitude_estimator == ATTITUDE_ESTIMATOR_EKF) {
+        AttitudeEkf_Predict(&attitude_ekf, &attitude_q, gx, gy, gz, dt);
+        acc_valid = AttitudeEkf_UpdateAccel(&attitude_ekf, &attitude_q, ax_g, ay_g, az_g);
+#if USE_MAGNETOMETER
+        if (use_mag) {
+            const float mag_norm = sqrtf(mx_gauss*mx_gauss + my_gauss*my_gauss + mz_gauss*mz_gauss);
+            attitude_diag.mag_strength_ok = mag_norm >= MAG_FIELD_MIN_GAUSS;
+            if (attitude_diag.mag_strength_ok) {
+                attitude_diag.mag_used = AttitudeEkf_UpdateMag(&attitude_ekf, &attitude_q, mx_gauss, my_gauss, mz_gauss);
+            }
+        }
+#endif
+    } else {
+        float acc_norm = sqrtf(ax_g*ax_g + ay_g*ay_g + az_g*az_g);
+        if (acc_norm < ACC_FIELD_MIN_G) acc_norm = ACC_FIELD_MIN_G;
+        ax_g /= acc_norm; ay_g /= acc_norm; az_g /= acc_norm;
 
-    float qw = attitude_q.p0, qx = attitude_q.p1, qy = attitude_q.p2, qz = attitude_q.p3;
-    float vx = 2.0f * (qx*qz - qw*qy);
-    float vy = 2.0f * (qw*qx + qy*qz);
-    float vz = qw*qw - qx*qx - qy*qy + qz*qz;
+        float qw = attitude_q.p0, qx = attitude_q.p1, qy = attitude_q.p2, qz = attitude_q.p3;
+        float vx = 2.0f * (qx*qz - qw*qy);
+        float vy = 2.0f * (qw*qx + qy*qz);
+        float vz = qw*qw - qx*qx - qy*qy + qz*qz;
 
-    float ex = 0.0f, ey = 0.0f, ez = 0.0f;
+        float ex = 0.0f, ey = 0.0f, ez = 0.0f;
 
-    if (acc_valid) {
-        ex = (ay_g * vz - az_g * vy);
-        ey = (az_g * vx - ax_g * vz);
-        ez = (ax_g * vy - ay_g * vx);
-    }
+        if (acc_valid) {
+            ex = (ay_g * vz - az_g * vy);
+            ey = (az_g * vx - ax_g * vz);
+            ez = (ax_g * vy - ay_g * vx);
+        }
 
 #if USE_MAGNETOMETER
-    if (use_mag) {
-        float mag_norm = sqrtf(mx_gauss*mx_gauss + my_gauss*my_gauss + mz_gauss*mz_gauss);
-        const bool mag_strength_ok = mag_norm >= MAG_FIELD_MIN_GAUSS;
-        if (!mag_strength_ok) {
-            mag_norm = MAG_FIELD_MIN_GAUSS;
+        if (use_mag) {
+            float mag_norm = sqrtf(mx_gauss*mx_gauss + my_gauss*my_gauss + mz_gauss*mz_gauss);
+            const bool mag_strength_ok = mag_norm >= MAG_FIELD_MIN_GAUSS;
+            if (!mag_strength_ok) {
+                mag_norm = MAG_FIELD_MIN_GAUSS;
+            }
+            mx_gauss /= mag_norm; my_gauss /= mag_norm; mz_gauss /= mag_norm;
+
+            float hx = 2.0f * (mx_gauss * (0.5f - qy*qy - qz*qz) + my_gauss * (qx*qy - qw*qz) + mz_gauss * (qx*qz + qw*qy));
+            float hy = 2.0f * (mx_gauss * (qx*qy + qw*qz) + my_gauss * (0.5f - qx*qx - qz*qz) + mz_gauss * (qy*qz - qw*qx));
+            float hz = 2.0f * (mx_gauss * (qx*qz - qw*qy) + my_gauss * (qy*qz + qw*qx) + mz_gauss * (0.5f - qx*qx - qy*qy));
+            float bx = sqrtf(hx*hx + hy*hy);
+            float bz = hz;
+
+            float wx = 2.0f * (bx * (0.5f - qy*qy - qz*qz) + bz * (qx*qz - qw*qy));
+            float wy = 2.0f * (bx * (qx*qy - qw*qz) + bz * (qw*qx + qy*qz));
+            float wz = 2.0f * (bx * (qw*qy + qx*qz) + bz * (0.5f - qx*qx - qy*qy));
+
+            float ex_mag = (my_gauss * wz - mz_gauss * wy);
+            float ey_mag = (mz_gauss * wx - mx_gauss * wz);
+            float ez_mag = (mx_gauss * wy - my_gauss * wx);
+
+            ex += ex_mag;
+            ey += ey_mag;
+            ez += ez_mag;
+            attitude_diag.mag_used = true;
+            attitude_diag.mag_strength_ok = mag_strength_ok;
         }
-        mx_gauss /= mag_norm; my_gauss /= mag_norm; mz_gauss /= mag_norm;
-
-        float hx = 2.0f * (mx_gauss * (0.5f - qy*qy - qz*qz) + my_gauss * (qx*qy - qw*qz) + mz_gauss * (qx*qz + qw*qy));
-        float hy = 2.0f * (mx_gauss * (qx*qy + qw*qz) + my_gauss * (0.5f - qx*qx - qz*qz) + mz_gauss * (qy*qz - qw*qx));
-        float hz = 2.0f * (mx_gauss * (qx*qz - qw*qy) + my_gauss * (qy*qz + qw*qx) + mz_gauss * (0.5f - qx*qx - qy*qy));
-        float bx = sqrtf(hx*hx + hy*hy);
-        float bz = hz;
-
-        float wx = 2.0f * (bx * (0.5f - qy*qy - qz*qz) + bz * (qx*qz - qw*qy));
-        float wy = 2.0f * (bx * (qx*qy - qw*qz) + bz * (qw*qx + qy*qz));
-        float wz = 2.0f * (bx * (qw*qy + qx*qz) + bz * (0.5f - qx*qx - qy*qy));
-
-        float ex_mag = (my_gauss * wz - mz_gauss * wy);
-        float ey_mag = (mz_gauss * wx - mx_gauss * wz);
-        float ez_mag = (mx_gauss * wy - my_gauss * wx);
-
-        ex += ex_mag;
-        ey += ey_mag;
-        ez += ez_mag;
-        attitude_diag.mag_used = true;
-        attitude_diag.mag_strength_ok = mag_strength_ok;
-    }
 #endif
 
-    exInt += twoKi * ex * dt;
-    eyInt += twoKi * ey * dt;
-    ezInt += twoKi * ez * dt;
+        exInt += twoKi * ex * dt;
+        eyInt += twoKi * ey * dt;
+        ezInt += twoKi * ez * dt;
 
-    gx += twoKp * ex + exInt;
-    gy += twoKp * ey + eyInt;
-    gz += twoKp * ez + ezInt;
+        gx += twoKp * ex + exInt;
+        gy += twoKp * ey + eyInt;
+        gz += twoKp * ez + ezInt;
 
-    float qw_dot = 0.5f * (-qx*gx - qy*gy - qz*gz);
-    float qx_dot = 0.5f * ( qw*gx + qy*gz - qz*gy);
-    float qy_dot = 0.5f * ( qw*gy - qx*gz + qz*gx);
-    float qz_dot = 0.5f * ( qw*gz + qx*gy - qy*gx);
+        float qw_dot = 0.5f * (-qx*gx - qy*gy - qz*gz);
+        float qx_dot = 0.5f * ( qw*gx + qy*gz - qz*gy);
+        float qy_dot = 0.5f * ( qw*gy - qx*gz + qz*gx);
+        float qz_dot = 0.5f * ( qw*gz + qx*gy - qy*gx);
 
-    attitude_q.p0 += qw_dot * dt;
-    attitude_q.p1 += qx_dot * dt;
-    attitude_q.p2 += qy_dot * dt;
-    attitude_q.p3 += qz_dot * dt;
-    quat_normalize(&attitude_q);
+        attitude_q.p0 += qw_dot * dt;
+        attitude_q.p1 += qx_dot * dt;
+        attitude_q.p2 += qy_dot * dt;
+        attitude_q.p3 += qz_dot * dt;
+        quat_normalize(&attitude_q);
+    }
 
-    qw = attitude_q.p0; qx = attitude_q.p1; qy = attitude_q.p2; qz = attitude_q.p3;
+    const float qw = attitude_q.p0, qx = attitude_q.p1, qy = attitude_q.p2, qz = attitude_q.p3;
     float sinr_cosp = 2.0f * (qw*qx + qy*qz);
     float cosr_cosp = 1.0f - 2.0f * (qx*qx + qy*qy);
     float roll = atan2_approx(sinr_cosp, cosr_cosp);
@@ -247,6 +337,16 @@ Euler_angles Attitude_Update(float ax_g, float ay_g, float az_g,
     attitude_diag.dt = dt;
     attitude_diag.spin_rate_dps = spin_rate_dps;
     attitude_diag.acc_valid = acc_valid;
+    if (attitude_estimator == ATTITUDE_ESTIMATOR_EKF) {
+        attitude_diag.gyro_bias_dps[0] = attitude_ekf.bias[0] * RAD2DEG;
+        attitude_diag.gyro_bias_dps[1] = attitude_ekf.bias[1] * RAD2DEG;
+        attitude_diag.gyro_bias_dps[2] = attitude_ekf.bias[2] * RAD2DEG;
+    } else {
+        // Mahony 积分项直接加到角速度上，相当于 -零偏
+        attitude_diag.gyro_bias_dps[0] = -exInt * RAD2DEG;
+        attitude_diag.gyro_bias_dps[1] = -eyInt * RAD2DEG;
+        attitude_diag.gyro_bias_dps[2] = -ezInt * RAD2DEG;
+    }
     attitude_diag.cycles = cycle_end - cycle_start;
     if (attitude_diag.cycles > attitude_diag.cycles_max) {
         attitude_diag.cycles_max = attitude_diag.cycles;
@@ -262,7 +362,7 @@ Euler_angles Attitude_Update(float ax_g, float ay_g, float az_g,
 {
     return Attitude_Update_Internal(ax_g, ay_g, az_g, 
                                    gx_dps, gy_dps, gz_dps, 
-                                   mx_gauss, my_gauss, mz_gauss, true);
+                                   mx_gauss, my_gauss, mz_gauss, true, DWT->CYCCNT);
 }
 
 Euler_angles Attitude_Update_IMU_Only(float ax_g, float ay_g, float az_g,
@@ -270,7 +370,39 @@ Euler_angles Attitude_Update_IMU_Only(float ax_g, float ay_g, float az_g,
 {
     return Attitude_Update_Internal(ax_g, ay_g, az_g, 
                                    gx_dps, gy_dps, gz_dps, 
-                                   0.0f, 0.0f, 0.0f, false);
+                                   0.0f, 0.0f, 0.0f, false, DWT->CYCCNT);
+}
+
+Euler_angles Attitude_Update_Stamped(float ax_g, float ay_g, float az_g,
+                                     float gx_dps, float gy_dps, float gz_dps,
+                                     float mx_gauss, float my_gauss, float mz_gauss,
+                                     uint32_t timestamp)
+{
+    return Attitude_Update_Internal(ax_g, ay_g, az_g,
+                                   gx_dps, gy_dps, gz_dps,
+                                   mx_gauss, my_gauss, mz_gauss, true, timestamp);
+}
+
+Euler_angles Attitude_Update_IMU_Only_Stamped(float ax_g, float ay_g, float az_g,
+                                              float gx_dps, float gy_dps, float gz_dps,
+                                              uint32_t timestamp)
+{
+    return Attitude_Update_Internal(ax_g, ay_g, az_g,
+                                   gx_dps, gy_dps, gz_dps,
+                                   0.0f, 0.0f, 0.0f, false, timestamp);
+}
+#else
+Euler_angles Attitude_Update(float ax_g, float ay_g, float az_g,
+                             float gx_dps, float gy_dps, float gz_dps)
+{
+    return Attitude_Update_Internal(ax_g, ay_g, az_g, gx_dps, gy_dps, gz_dps, DWT->CYCCNT);
+}
+
+Euler_angles Attitude_Update_Stamped(float ax_g, float ay_g, float az_g,
+                                     float gx_dps, float gy_dps, float gz_dps,
+                                     uint32_t timestamp)
+{
+    return Attitude_Update_Internal(ax_g, ay_g, az_g, gx_dps, gy_dps, gz_dps, timestamp);
 }
 #endif
 
@@ -1,6 +1,6 @@
 /**
  * @file    attitude.h
- * @brief   姿态解算模块（Mahony 互补滤波 + 磁力计融合）接口
+ * @brief   姿态解算模块（Mahony 互补滤波 / 误差状态 EKF + 磁力计融合）接口
  * @note    本模块只负责姿态融合算法，不涉及传感器数据读取
  *          所有输入数据应为物理单位（dps, g, gauss）
  */
@@ -22,6 +22,17 @@
 #define RAD2DEG 57.2957795130823208768f
 #endif
 
+// 姿态估计器
+typedef enum {
+    ATTITUDE_ESTIMATOR_MAHONY = 0,  // Mahony 互补滤波（固定增益）
+    ATTITUDE_ESTIMATOR_EKF,         // 四元数误差状态 EKF（含陀螺零偏估计，见 attitude_ekf.h）
+} AttitudeEstimator;
+
+// 编译宏：上电默认使用的估计器（运行时可用 Attitude_SetEstimator 切换）
+#ifndef ATTITUDE_ESTIMATOR_DEFAULT
+#define ATTITUDE_ESTIMATOR_DEFAULT ATTITUDE_ESTIMATOR_MAHONY
+#endif
+
 // 欧拉角（单位：deg）
 typedef struct {
     float pitch;  // 俯仰角
@@ -44,6 +55,7 @@ typedef struct {
     bool acc_valid;         // 是否使用了加速度计
     bool mag_used;          // 是否使用了磁力计
     bool mag_strength_ok;   // 磁场幅值是否在合理范围
+    float gyro_bias_dps[3]; // 陀螺零偏估计（EKF 状态；Mahony 为积分项折算）
     uint32_t cycles;        // 本次姿态更新耗费的DWT 时钟周期数
     uint32_t cycles_max;    // 运行以来的最大周期数
 } AttitudeDiagnostics;
@@ -58,6 +70,16 @@ float fast_inv_sqrt(float x);
 // 姿态初始化（设为单位四元数，清零积分项）
 void Attitude_Init(void);
 
+// 选择姿态估计器；切换时保留当前姿态，重置新估计器的内部状态（积分项 / 协方差与零偏）
+void Attitude_SetEstimator(AttitudeEstimator estimator);
+AttitudeEstimator Attitude_GetEstimator(void);
+
+// 设置时间戳时基（每秒计数数），并重新建立时间参考
+// 0（默认）= DWT->CYCCNT，即 SystemCoreClock，168MHz 下分辨率 5.95ns；
+// 使用 ICM42688P 传感器时间戳（微秒）时传 1000000。
+// 注意：不带 _Stamped 的更新函数内部读取 DWT->CYCCNT，只能在默认时基下使用。
+void Attitude_SetTimeBase(uint32_t ticks_per_second);
+
 // 利用加速度计静止姿态进行初始化（传入已归一化的加速度向量）
 // 注意：此函数会将yaw初始化为0，然后靠磁力计缓慢收敛
 void Attitude_InitFromAccelerometer(float ax_g, float ay_g, float az_g);
@@ -75,10 +97,25 @@ Euler_angles Attitude_Update(float ax_g, float ay_g, float az_g,
 // 更新姿态（仅使用IMU，不使用磁力计）
 Euler_angles Attitude_Update_IMU_Only(float ax_g, float ay_g, float az_g,
                                       float gx_dps, float gy_dps, float gz_dps);
+
+// 同上，但 dt 由调用者给出的采样时间戳计算（单位见 Attitude_SetTimeBase）
+// 时间戳应取自传感器采样时刻（DWT 抓取的 EXTI 时刻或 FIFO 时间戳），而不是调用时刻
+Euler_angles Attitude_Update_Stamped(float ax_g, float ay_g, float az_g,
+                                     float gx_dps, float gy_dps, float gz_dps,
+                                     float mx_gauss, float my_gauss, float mz_gauss,
+                                     uint32_t timestamp);
+Euler_angles Attitude_Update_IMU_Only_Stamped(float ax_g, float ay_g, float az_g,
+                                              float gx_dps, float gy_dps, float gz_dps,
+                                              uint32_t timestamp);
 #else
 // 更新姿态（不带磁力计）
 Euler_angles Attitude_Update(float ax_g, float ay_g, float az_g,
                              float gx_dps, float gy_dps, float gz_dps);
+
+// 同上，dt 由采样时间戳计算（单位见 Attitude_SetTimeBase）
+Euler_angles Attitude_Update_Stamped(float ax_g, float ay_g, float az_g,
+                                     float gx_dps, float gy_dps, float gz_dps,
+                                     uint32_t timestamp);
 #endif
 
 // 获取当前姿态角
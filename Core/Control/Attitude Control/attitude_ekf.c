@@ -0,0 +1,301 @@
+/*
+ * 四元数误差状态 EKF（姿态 + 陀螺零偏）
+ * 与 Mahony 共用 attitude_q，由 attitude.c 根据所选估计器调用
+ */
+#include "attitude_ekf.h"
+#include "maths.h"
+#include "arm_math.h"
+#include <string.h>
+
+#define N   ATTITUDE_EKF_STATES
+#define P_(r, c)    ekf->P[(r) * N + (c)]
+
+// 航向观测：磁场水平分量太小（接近竖直）时航向不可观
+#define EKF_MAG_MIN_HORIZONTAL  0.1f
+// 协方差下限，防止长时间静止后数值上失去正定性
+#define EKF_P_MIN               1e-12f
+
+void AttitudeEkf_GetDefaultConfig(AttitudeEkfConfig *cfg)
+{
+    cfg->gyro_noise    = 0.005f;    // 含滤波残余与模型误差，远大于 ICM42688P 的 0.0028dps/√Hz
+    cfg->bias_walk     = 2e-4f;
+    cfg->acc_noise     = 0.03f;
+    cfg->acc_dyn_gain  = 2.0f;
+    cfg->acc_reject_g  = 0.5f;
+    cfg->mag_noise     = 0.05f;
+    cfg->init_att_std  = 0.2f;      // ~11°
+    cfg->init_bias_std = 0.05f;     // ~3dps
+}
+
+static void ekf_reset_block(AttitudeEkf *ekf, int first, float var)
+{
+    for (int r = 0; r < N; r++) {
+        for (int c = first; c < first + 3; c++) {
+            P_(r, c) = 0.0f;
+            P_(c, r) = 0.0f;
+        }
+    }
+    for (int i = first; i < first + 3; i++) {
+        P_(i, i) = var;
+    }
+}
+
+void AttitudeEkf_Init(AttitudeEkf *ekf, const AttitudeEkfConfig *cfg)
+{
+    AttitudeEkfConfig c;
+    if (cfg) {
+        c = *cfg;       // cfg 可能就是 &ekf->cfg
+    } else {
+        AttitudeEkf_GetDefaultConfig(&c);
+    }
+    memset(ekf, 0, sizeof(*ekf));
+    ekf->cfg = c;
+    ekf_reset_block(ekf, 0, ekf->cfg.init_att_std * ekf->cfg.init_att_std);
+    ekf_reset_block(ekf, 3, ekf->cfg.init_bias_std * ekf->cfg.init_bias_std);
+}
+
+void AttitudeEkf_ResetAttitude(AttitudeEkf *ekf)
+{
+    ekf_reset_block(ekf, 0, ekf->cfg.init_att_std * ekf->cfg.init_att_std);
+}
+
+// q ← q ⊗ δq，δq = [1 - θ²/8, v·(1 - θ²/24)]，v = 旋转向量/2（二阶近似，kHz 更新率下足够）
+static void quat_mul_rotvec(Quaternion *q, float vx, float vy, float vz)
+{
+    const float t2 = vx*vx + vy*vy + vz*vz;     // (θ/2)²
+    const float dw = 1.0f - 0.5f * t2;
+    const float s  = 1.0f - t2 * (1.0f / 6.0f);
+    vx *= s; vy *= s; vz *= s;
+
+    const float w = q->p0, x = q->p1, y = q->p2, z = q->p3;
+    q->p0 = w*dw - x*vx - y*vy - z*vz;
+    q->p1 = w*vx + x*dw + y*vz - z*vy;
+    q->p2 = w*vy - x*vz + y*dw + z*vx;
+    q->p3 = w*vz + x*vy - y*vx + z*dw;
+
+    const float n2 = q->p0*q->p0 + q->p1*q->p1 + q->p2*q->p2 + q->p3*q->p3;
+    const float inv = 1.0f / sqrtf(n2);   // fast_inv_sqrt 的 ~0.2% 误差会在 P 的线性化点上累积
+    q->p0 *= inv; q->p1 *= inv; q->p2 *= inv; q->p3 *= inv;
+}
+
+// 机体系中的世界 z 轴：h = Rᵀ·[0,0,1]（= 静止时加速度计的期望方向）
+static void quat_world_z_in_body(const Quaternion *q, float h[3])
+{
+    const float w = q->p0, x = q->p1, y = q->p2, z = q->p3;
+    h[0] = 2.0f * (x*z - w*y);
+    h[1] = 2.0f * (y*z + w*x);
+    h[2] = 1.0f - 2.0f * (x*x + y*y);
+}
+
+// 把误差状态注入名义状态（忽略重置雅可比，小角度下近似为 I）
+static void ekf_inject(AttitudeEkf *ekf, Quaternion *q, const float dx[N])
+{
+    quat_mul_rotvec(q, 0.5f * dx[0], 0.5f * dx[1], 0.5f * dx[2]);
+    ekf->bias[0] += dx[3];
+    ekf->bias[1] += dx[4];
+    ekf->bias[2] += dx[5];
+}
+
+// P = (P + Pᵀ)/2，并限制对角线下限
+static void ekf_symmetrize(AttitudeEkf *ekf)
+{
+    for (int r = 0; r < N; r++) {
+        if (P_(r, r) < EKF_P_MIN) P_(r, r) = EKF_P_MIN;
+        for (int c = r + 1; c < N; c++) {
+            const float m = 0.5f * (P_(r, c) + P_(c, r));
+            P_(r, c) = m;
+            P_(c, r) = m;
+        }
+    }
+}
+
+void AttitudeEkf_Predict(AttitudeEkf *ekf, Quaternion *q, float gx, float gy, float gz, float dt)
+{
+    const float wx = gx - ekf->bias[0];
+    const float wy = gy - ekf->bias[1];
+    const float wz = gz - ekf->bias[2];
+
+    quat_mul_rotvec(q, 0.5f * wx * dt, 0.5f * wy * dt, 0.5f * wz * dt);
+
+    // A = I - [ω]x·dt
+    const float a[3][3] = {
+        { 1.0f,     wz * dt, -wy * dt },
+        { -wz * dt, 1.0f,     wx * dt },
+        { wy * dt, -wx * dt,  1.0f    },
+    };
+
+    float T[3][3], C[3][3], B[3][3];
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            T[r][c] = P_(r, c);
+            C[r][c] = P_(r, c + 3);
+            B[r][c] = P_(r + 3, c + 3);
+        }
+    }
+
+    // AT = A·T，AC = A·C
+    float AT[3][3], AC[3][3];
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            AT[r][c] = a[r][0]*T[0][c] + a[r][1]*T[1][c] + a[r][2]*T[2][c];
+            AC[r][c] = a[r][0]*C[0][c] + a[r][1]*C[1][c] + a[r][2]*C[2][c];
+        }
+    }
+
+    const float q_att  = ekf->cfg.gyro_noise * ekf->cfg.gyro_noise * dt;
+    const float q_bias = ekf->cfg.bias_walk * ekf->cfg.bias_walk * dt;
+    const float dt2 = dt * dt;
+
+    // Pθθ' = A·T·Aᵀ - dt·(A·C + (A·C)ᵀ) + dt²·B + Qθ（只算上三角）
+    for (int r = 0; r < 3; r++) {
+        for (int c = r; c < 3; c++) {
+            float v = AT[r][0]*a[c][0] + AT[r][1]*a[c][1] + AT[r][2]*a[c][2];
+            v -= dt * (AC[r][c] + AC[c][r]);
+            v += dt2 * B[r][c];
+            if (r == c) v += q_att;
+            P_(r, c) = v;
+            P_(c, r) = v;
+        }
+    }
+    // Pθb' = A·C - dt·B
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            const float v = AC[r][c] - dt * B[r][c];
+            P_(r, c + 3) = v;
+            P_(c + 3, r) = v;
+        }
+    }
+    // Pbb' = B + Qb
+    for (int i = 3; i < N; i++) {
+        P_(i, i) += q_bias;
+    }
+
+    ekf->predicts++;
+}
+
+bool AttitudeEkf_UpdateAccel(AttitudeEkf *ekf, Quaternion *q, float ax, float ay, float az)
+{
+    const float norm = sqrtf(ax*ax + ay*ay + az*az);
+    const float dev = fabsf(norm - 1.0f);
+    if (norm < 1e-3f || dev > ekf->cfg.acc_reject_g) {
+        ekf->acc_rejected++;
+        return false;
+    }
+    const float inv = 1.0f / norm;
+    ax *= inv; ay *= inv; az *= inv;
+
+    float h[3];
+    quat_world_z_in_body(q, h);
+    const float res[3] = { ax - h[0], ay - h[1], az - h[2] };
+
+    const float sigma = ekf->cfg.acc_noise + ekf->cfg.acc_dyn_gain * dev;
+    const float r_var = sigma * sigma;
+
+    // Hθ = [h]x；H 的零偏部分为 0，因此 H·P 只用到 P 的前 3 行
+    float Hd[9] = {
+        0.0f,  -h[2],  h[1],
+        h[2],   0.0f, -h[0],
+        -h[1],  h[0],  0.0f,
+    };
+    float HPd[3 * N], KTd[3 * N], Kd[N * 3], dPd[N * N];
+    arm_matrix_instance_f32 Hm, Ptop, HP, KT, K, dP, Pm;
+    arm_mat_init_f32(&Hm,   3, 3, Hd);
+    arm_mat_init_f32(&Ptop, 3, N, ekf->P);
+    arm_mat_init_f32(&HP,   3, N, HPd);
+    arm_mat_init_f32(&KT,   3, N, KTd);
+    arm_mat_init_f32(&K,    N, 3, Kd);
+    arm_mat_init_f32(&dP,   N, N, dPd);
+    arm_mat_init_f32(&Pm,   N, N, ekf->P);
+
+    arm_mat_mult_f32(&Hm, &Ptop, &HP);
+
+    // S = H·P·Hᵀ + R = HP[:, 0:3]·Hθᵀ + R（对称 3x3，闭式求逆）
+    float S[3][3];
+    for (int r = 0; r < 3; r++) {
+        for (int c = r; c < 3; c++) {
+            float v = HPd[r*N + 0]*Hd[c*3 + 0] + HPd[r*N + 1]*Hd[c*3 + 1] + HPd[r*N + 2]*Hd[c*3 + 2];
+            if (r == c) v += r_var;
+            S[r][c] = v;
+            S[c][r] = v;
+        }
+    }
+    const float c00 = S[1][1]*S[2][2] - S[1][2]*S[1][2];
+    const float c01 = S[0][2]*S[1][2] - S[0][1]*S[2][2];
+    const float c02 = S[0][1]*S[1][2] - S[0][2]*S[1][1];
+    const float det = S[0][0]*c00 + S[0][1]*c01 + S[0][2]*c02;
+    if (fabsf(det) < 1e-20f) {
+        ekf->acc_rejected++;
+        return false;
+    }
+    const float id = 1.0f / det;
+    float Sid[9] = {
+        c00 * id, c01 * id, c02 * id,
+        c01 * id, (S[0][0]*S[2][2] - S[0][2]*S[0][2]) * id, (S[0][2]*S[0][1] - S[0][0]*S[1][2]) * id,
+        c02 * id, (S[0][2]*S[0][1] - S[0][0]*S[1][2]) * id, (S[0][0]*S[1][1] - S[0][1]*S[0][1]) * id,
+    };
+    arm_matrix_instance_f32 Si;
+    arm_mat_init_f32(&Si, 3, 3, Sid);
+
+    // Kᵀ = S⁻¹·H·P（P 对称，故 K = P·Hᵀ·S⁻¹ 的转置）
+    arm_mat_mult_f32(&Si, &HP, &KT);
+    arm_mat_trans_f32(&KT, &K);
+
+    // δx = K·r
+    float dx[N];
+    for (int i = 0; i < N; i++) {
+        dx[i] = Kd[i*3 + 0]*res[0] + Kd[i*3 + 1]*res[1] + Kd[i*3 + 2]*res[2];
+    }
+
+    // P -= K·H·P
+    arm_mat_mult_f32(&K, &HP, &dP);
+    arm_mat_sub_f32(&Pm, &dP, &Pm);
+    ekf_symmetrize(ekf);
+
+    ekf_inject(ekf, q, dx);
+    ekf->acc_updates++;
+    return true;
+}
+
+bool AttitudeEkf_UpdateMag(AttitudeEkf *ekf, Quaternion *q, float mx, float my, float mz)
+{
+    const float w = q->p0, x = q->p1, y = q->p2, z = q->p3;
+
+    // 磁场转到世界系，只看水平分量的方向
+    const float mwx = (1.0f - 2.0f*(y*y + z*z))*mx + 2.0f*(x*y - w*z)*my + 2.0f*(x*z + w*y)*mz;
+    const float mwy = 2.0f*(x*y + w*z)*mx + (1.0f - 2.0f*(x*x + z*z))*my + 2.0f*(y*z - w*x)*mz;
+    const float mn = sqrtf(mx*mx + my*my + mz*mz);
+    const float mh = sqrtf(mwx*mwx + mwy*mwy);
+    if (mn < 1e-6f || mh < EKF_MAG_MIN_HORIZONTAL * mn) {
+        return false;
+    }
+
+    // 参考方向为世界 x 轴（与 Attitude_InitFromAccelMag 的 yaw 定义一致）
+    const float res = -atan2_approx(mwy, mwx);
+
+    // 航向误差 = 世界 z 轴上的转角 = h·δθ
+    float h[3];
+    quat_world_z_in_body(q, h);
+
+    float PHt[N];
+    for (int i = 0; i < N; i++) {
+        PHt[i] = P_(i, 0)*h[0] + P_(i, 1)*h[1] + P_(i, 2)*h[2];
+    }
+    const float s = PHt[0]*h[0] + PHt[1]*h[1] + PHt[2]*h[2] + ekf->cfg.mag_noise * ekf->cfg.mag_noise;
+    const float inv_s = 1.0f / s;
+
+    float dx[N];
+    for (int i = 0; i < N; i++) {
+        dx[i] = PHt[i] * inv_s * res;
+    }
+    for (int r = 0; r < N; r++) {
+        const float kr = PHt[r] * inv_s;
+        for (int c = 0; c < N; c++) {
+            P_(r, c) -= kr * PHt[c];
+        }
+    }
+    ekf_symmetrize(ekf);
+
+    ekf_inject(ekf, q, dx);
+    ekf->mag_updates++;
+    return true;
+}
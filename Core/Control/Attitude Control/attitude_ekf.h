@@ -0,0 +1,73 @@
+/**
+ * @file    attitude_ekf.h
+ * @brief   四元数误差状态 EKF（姿态 + 陀螺零偏），作为 Mahony 之外的第二种姿态估计器
+ * @note    名义状态：四元数 q（由 attitude.c 持有的 attitude_q）+ 陀螺零偏 b（rad/s）
+ *          误差状态：δx = [δθ(机体系小角度), δb]，协方差 P 为 6x6 行主序
+ *
+ *          预测：ω = g - b，q ← q ⊗ exp(ω·dt)
+ *                F = [ I-[ω]x·dt  -I·dt ]
+ *                    [     0        I   ]
+ *                F 是分块稀疏的，P = F·P·Fᵀ + Q 按 3x3 分块直接展开，不做 6x6 通用乘法
+ *          加速度计更新：h(q) = Rᵀ·[0,0,1]，H = [ [h]x  0 ]（3x6），
+ *                用 CMSIS-DSP arm_mat_*_f32 计算 H·P、K 与 P -= K·H·P，3x3 的 S 用闭式求逆
+ *          磁力计更新：只修正航向（标量观测），倾角完全由加速度计决定，
+ *                磁干扰不会污染 roll/pitch
+ *
+ *          加速度计噪声随 | |a|-1g | 自适应放大，机动时自动降低加速度计权重。
+ */
+#ifndef ATTITUDE_EKF_H
+#define ATTITUDE_EKF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "attitude.h"
+
+#define ATTITUDE_EKF_STATES     6
+
+// 噪声参数（均为标准差）
+typedef struct {
+    float gyro_noise;       // 陀螺白噪声（rad/s），按 dt 离散为 σ²·dt
+    float bias_walk;        // 零偏随机游走（rad/s/√s）
+    float acc_noise;        // 静止时加速度计方向噪声（归一化后，无量纲）
+    float acc_dyn_gain;     // 机动放大：σ_acc += acc_dyn_gain * | |a|-1g |
+    float acc_reject_g;     // | |a|-1g | 超过该值时跳过加速度计更新
+    float mag_noise;        // 航向观测噪声（rad）
+    float init_att_std;     // 初始姿态不确定度（rad）
+    float init_bias_std;    // 初始零偏不确定度（rad/s）
+} AttitudeEkfConfig;
+
+typedef struct {
+    AttitudeEkfConfig cfg;
+    float bias[3];                                          // 陀螺零偏估计（rad/s）
+    float P[ATTITUDE_EKF_STATES * ATTITUDE_EKF_STATES];     // 误差协方差（行主序）
+
+    // 统计
+    uint32_t predicts;
+    uint32_t acc_updates;
+    uint32_t acc_rejected;
+    uint32_t mag_updates;
+} AttitudeEkf;
+
+// 默认参数（ICM42688P 噪声量级，1kHz 更新）
+void AttitudeEkf_GetDefaultConfig(AttitudeEkfConfig *cfg);
+
+// 初始化（cfg 为 NULL 时使用默认参数），零偏清零，P 设为初始不确定度
+void AttitudeEkf_Init(AttitudeEkf *ekf, const AttitudeEkfConfig *cfg);
+
+// 重新收敛：保留零偏估计，只重置姿态部分的协方差（姿态被外部重新初始化时调用）
+void AttitudeEkf_ResetAttitude(AttitudeEkf *ekf);
+
+// 预测：用去零偏后的角速度积分 q 并传播 P（gx/gy/gz 单位 rad/s）
+void AttitudeEkf_Predict(AttitudeEkf *ekf, Quaternion *q, float gx, float gy, float gz, float dt);
+
+// 加速度计更新（单位 g，内部归一化）；返回是否实际做了更新（偏离 1g 过多时跳过）
+bool AttitudeEkf_UpdateAccel(AttitudeEkf *ekf, Quaternion *q, float ax, float ay, float az);
+
+// 磁力计航向更新（单位任意）；返回是否实际做了更新（磁场接近竖直时跳过）
+bool AttitudeEkf_UpdateMag(AttitudeEkf *ekf, Quaternion *q, float mx, float my, float mz);
+
+// attitude.c 持有的 EKF 实例：修改噪声参数（并重置滤波器）、读取零偏与统计
+void Attitude_SetEkfConfig(const AttitudeEkfConfig *cfg);
+AttitudeEkf *Attitude_GetEkf(void);
+
+#endif // ATTITUDE_EKF_H
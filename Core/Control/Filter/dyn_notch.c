@@ -0,0 +1,331 @@
+#include "dyn_notch.h"
+#include <math.h>
+#include <string.h>
+
+#define DYN_NOTCH_PEAK_RATIO    4.0f    // peak power must exceed this multiple of the band mean
+#define DYN_NOTCH_SMOOTHING     0.5f    // centre frequency update gain per analysis
+
+void dynNotchGetDefaultConfig(dynNotchConfig_t *cfg)
+{
+    cfg->input_hz = 8000.0f;
+    cfg->notch_hz = 1000.0f;
+    cfg->min_hz   = 80.0f;
+    cfg->max_hz   = 450.0f;
+    cfg->count    = 2;
+    cfg->q        = 3.0f;
+}
+
+bool dynNotchInit(dynNotch_t *dn, const dynNotchConfig_t *cfg)
+{
+    if (!dn || !cfg) {
+        return false;
+    }
+    memset(dn, 0, sizeof(*dn));
+
+    if (cfg->input_hz <= 0.0f || cfg->notch_hz <= 0.0f || cfg->min_hz <= 0.0f || cfg->max_hz <= cfg->min_hz ||
+        cfg->max_hz >= 0.5f * cfg->notch_hz || cfg->max_hz >= 0.5f * cfg->input_hz ||
+        cfg->count == 0 || cfg->count > DYN_NOTCH_MAX_COUNT || cfg->q <= 0.0f) {
+        return false;
+    }
+    dn->cfg = *cfg;
+
+    // Analysis rate: largest integer decimation that still keeps max_hz below Nyquist
+    dn->decim = (uint16_t)(cfg->input_hz / (2.0f * cfg->max_hz));
+    if (dn->decim == 0) {
+        dn->decim = 1;
+    }
+    dn->fft_hz = cfg->input_hz / (float)dn->decim;
+    dn->bin_hz = dn->fft_hz / (float)DYN_NOTCH_FFT_SIZE;
+
+    int min_bin = (int)(cfg->min_hz / dn->bin_hz);
+    int max_bin = (int)ceilf(cfg->max_hz / dn->bin_hz);
+    if (min_bin < 2) min_bin = 2;
+    if (max_bin > DYN_NOTCH_FFT_BINS - 2) max_bin = DYN_NOTCH_FFT_BINS - 2;
+    dn->min_bin = (uint8_t)min_bin;
+    dn->max_bin = (uint8_t)max_bin;
+
+    // Tables
+    for (int n = 0; n < DYN_NOTCH_FFT_SIZE; n++) {
+        dn->window[n] = 0.5f - 0.5f * cosf(2.0f * M_PIf * (float)n / (float)DYN_NOTCH_FFT_SIZE);
+    }
+    for (int m = 0; m < DYN_NOTCH_FFT_BINS / 2; m++) {
+        const float a = 2.0f * M_PIf * (float)m / (float)DYN_NOTCH_FFT_BINS;
+        dn->twiddle[2 * m]     = cosf(a);
+        dn->twiddle[2 * m + 1] = sinf(a);
+    }
+    for (int k = 0; k < DYN_NOTCH_FFT_BINS; k++) {
+        const float a = 2.0f * M_PIf * (float)k / (float)DYN_NOTCH_FFT_SIZE;
+        dn->twiddle_rfft[2 * k]     = cosf(a);
+        dn->twiddle_rfft[2 * k + 1] = sinf(a);
+    }
+    for (int i = 0; i < DYN_NOTCH_FFT_BINS; i++) {
+        uint8_t r = 0;
+        for (int b = 0; b < DYN_NOTCH_FFT_STAGES; b++) {
+            if (i & (1 << b)) {
+                r |= (uint8_t)(1 << (DYN_NOTCH_FFT_STAGES - 1 - b));
+            }
+        }
+        dn->bitrev[i] = r;
+    }
+
+    // Notches start spread across the band until the first analysis lands
+    dn->notch_refresh_us = (uint32_t)(1000000.0f / cfg->notch_hz);
+    for (int axis = 0; axis < DYN_NOTCH_AXES; axis++) {
+        for (int i = 0; i < cfg->count; i++) {
+            const float f = cfg->min_hz + (cfg->max_hz - cfg->min_hz) * (float)(i + 1) / (float)(cfg->count + 1);
+            dn->center_hz[axis][i] = f;
+            biquadFilterInit(&dn->notch[axis][i], f, dn->notch_refresh_us, cfg->q, FILTER_NOTCH, 1.0f);
+        }
+    }
+
+    dn->step = DYN_NOTCH_STEP_IDLE;
+    dn->ready = true;
+    return true;
+}
+
+void dynNotchPush(dynNotch_t *dn, float x, float y, float z)
+{
+    if (!dn->ready) {
+        return;
+    }
+    dn->decim_sum[0] += x;
+    dn->decim_sum[1] += y;
+    dn->decim_sum[2] += z;
+    if (++dn->decim_count < dn->decim) {
+        return;
+    }
+
+    const float inv = 1.0f / (float)dn->decim;
+    for (int axis = 0; axis < DYN_NOTCH_AXES; axis++) {
+        dn->ring[axis][dn->ring_idx] = dn->decim_sum[axis] * inv;
+        dn->decim_sum[axis] = 0.0f;
+    }
+    dn->decim_count = 0;
+    dn->ring_idx = (uint8_t)((dn->ring_idx + 1) & (DYN_NOTCH_FFT_SIZE - 1));
+    if (dn->ring_fill < DYN_NOTCH_FFT_SIZE) {
+        dn->ring_fill++;
+        return;             // still priming the first window
+    }
+    if (++dn->new_samples == 2 * DYN_NOTCH_HOP) {
+        dn->overruns++;     // a whole hop went by without an analysis starting
+    }
+}
+
+// One radix-2 DIT stage on the 32-point complex buffer; stage 0 also does the bit reversal
+static void dynNotchFftStage(const dynNotch_t *dn, float *buf, uint8_t stage)
+{
+    if (stage == 0) {
+        for (int i = 0; i < DYN_NOTCH_FFT_BINS; i++) {
+            const int j = dn->bitrev[i];
+            if (j > i) {
+                float t = buf[2 * i];     buf[2 * i] = buf[2 * j];         buf[2 * j] = t;
+                t = buf[2 * i + 1];       buf[2 * i + 1] = buf[2 * j + 1]; buf[2 * j + 1] = t;
+            }
+        }
+    }
+
+    const int len = 2 << stage;
+    const int half = len >> 1;
+    const int tw_step = DYN_NOTCH_FFT_BINS / len;
+    for (int start = 0; start < DYN_NOTCH_FFT_BINS; start += len) {
+        for (int k = 0; k < half; k++) {
+            const float c = dn->twiddle[2 * k * tw_step];
+            const float s = dn->twiddle[2 * k * tw_step + 1];
+            float *a = &buf[2 * (start + k)];
+            float *b = &buf[2 * (start + k + half)];
+            // t = b * (c - js)
+            const float tr = c * b[0] + s * b[1];
+            const float ti = c * b[1] - s * b[0];
+            b[0] = a[0] - tr;
+            b[1] = a[1] - ti;
+            a[0] += tr;
+            a[1] += ti;
+        }
+    }
+}
+
+// Turn the 32-point complex FFT of the even/odd-packed input into the 64-point real spectrum
+static void dynNotchRfftSplit(const dynNotch_t *dn, float *buf)
+{
+    const float z0r = buf[0];
+    const float z0i = buf[1];
+    buf[0] = z0r + z0i;     // DC
+    buf[1] = z0r - z0i;     // Nyquist
+
+    for (int k = 1; k <= DYN_NOTCH_FFT_BINS / 2; k++) {
+        const int kc = DYN_NOTCH_FFT_BINS - k;
+        const float ar = buf[2 * k],  ai = buf[2 * k + 1];     // Z[k]
+        const float cr = buf[2 * kc], ci = buf[2 * kc + 1];    // Z[N/2-k]
+
+        // X[k]   = (Z[k] + Z*[N/2-k])/2 + W^k  * (-j)(Z[k] - Z*[N/2-k])/2
+        // X[N/2-k] uses the mirrored pair with W^(N/2-k)
+        float er = 0.5f * (ar + cr), ei = 0.5f * (ai - ci);
+        float dr = 0.5f * (ar - cr), di = 0.5f * (ai + ci);
+        float c = dn->twiddle_rfft[2 * k], s = dn->twiddle_rfft[2 * k + 1];
+        // Xo = -j*D = (di, -dr); W*Xo with W = c - js
+        const float xkr = er + c * di - s * dr;
+        const float xki = ei - c * dr - s * di;
+
+        er = 0.5f * (cr + ar);  ei = 0.5f * (ci - ai);
+        dr = 0.5f * (cr - ar);  di = 0.5f * (ci + ai);
+        c = dn->twiddle_rfft[2 * kc];  s = dn->twiddle_rfft[2 * kc + 1];
+        const float xcr = er + c * di - s * dr;
+        const float xci = ei - c * dr - s * di;
+
+        buf[2 * k] = xkr;   buf[2 * k + 1] = xki;
+        buf[2 * kc] = xcr;  buf[2 * kc + 1] = xci;
+    }
+}
+
+void dynNotchRfft(const dynNotch_t *dn, float *buf)
+{
+    for (uint8_t stage = 0; stage < DYN_NOTCH_FFT_STAGES; stage++) {
+        dynNotchFftStage(dn, buf, stage);
+    }
+    dynNotchRfftSplit(dn, buf);
+}
+
+// Up to cfg.count strongest local maxima above the noise floor, parabolic-interpolated
+static void dynNotchFindPeaks(dynNotch_t *dn, const float *spec)
+{
+    float mean = 0.0f;
+    for (int k = dn->min_bin - 1; k <= dn->max_bin + 1; k++) {
+        dn->power[k] = spec[2 * k] * spec[2 * k] + spec[2 * k + 1] * spec[2 * k + 1];
+    }
+    for (int k = dn->min_bin; k <= dn->max_bin; k++) {
+        mean += dn->power[k];
+    }
+    mean /= (float)(dn->max_bin - dn->min_bin + 1);
+
+    uint8_t bins[DYN_NOTCH_MAX_COUNT];
+    uint8_t n = 0;
+    for (int k = dn->min_bin; k <= dn->max_bin; k++) {
+        const float p = dn->power[k];
+        if (p <= DYN_NOTCH_PEAK_RATIO * mean || p <= dn->power[k - 1] || p < dn->power[k + 1]) {
+            continue;
+        }
+        // Insert sorted by power, keep the strongest cfg.count
+        int pos = n;
+        while (pos > 0 && dn->power[bins[pos - 1]] < p) {
+            pos--;
+        }
+        if (pos >= dn->cfg.count) {
+            continue;
+        }
+        for (int j = (n < dn->cfg.count) ? n : dn->cfg.count - 1; j > pos; j--) {
+            bins[j] = bins[j - 1];
+        }
+        bins[pos] = (uint8_t)k;
+        if (n < dn->cfg.count) {
+            n++;
+        }
+    }
+
+    for (int i = 0; i < n; i++) {
+        const int k = bins[i];
+        const float a = sqrtf(dn->power[k - 1]);
+        const float b = sqrtf(dn->power[k]);
+        const float c = sqrtf(dn->power[k + 1]);
+        const float den = a - 2.0f * b + c;
+        float d = (den != 0.0f) ? 0.5f * (a - c) / den : 0.0f;
+        d = MIN(MAX(d, -0.5f), 0.5f);
+        dn->peak_hz[i] = ((float)k + d) * dn->bin_hz;
+    }
+    dn->peak_count = n;
+}
+
+// Peaks sorted by frequency go to the notch slots in order; slots without a peak hold
+static void dynNotchRetune(dynNotch_t *dn, uint8_t axis)
+{
+    float f[DYN_NOTCH_MAX_COUNT];
+    const uint8_t n = dn->peak_count;
+    for (int i = 0; i < n; i++) {
+        int j = i;
+        while (j > 0 && f[j - 1] > dn->peak_hz[i]) {
+            f[j] = f[j - 1];
+            j--;
+        }
+        f[j] = dn->peak_hz[i];
+    }
+
+    for (int i = 0; i < n; i++) {
+        float *center = &dn->center_hz[axis][i];
+        *center += DYN_NOTCH_SMOOTHING * (f[i] - *center);
+        *center = MIN(MAX(*center, dn->cfg.min_hz), dn->cfg.max_hz);
+        biquadFilterUpdate(&dn->notch[axis][i], *center, dn->notch_refresh_us, dn->cfg.q, FILTER_NOTCH, 1.0f);
+    }
+}
+
+bool dynNotchUpdate(dynNotch_t *dn)
+{
+    if (!dn->ready) {
+        return false;
+    }
+
+    switch (dn->step) {
+    case DYN_NOTCH_STEP_IDLE:
+        if (dn->ring_fill < DYN_NOTCH_FFT_SIZE || (dn->analyses > 0 && dn->new_samples < DYN_NOTCH_HOP)) {
+            return false;
+        }
+        // fall through: the snapshot is the first step of the analysis
+    case DYN_NOTCH_STEP_SNAPSHOT:
+        // Oldest sample first; all axes at once so they see the same window
+        for (int axis = 0; axis < DYN_NOTCH_AXES; axis++) {
+            for (int n = 0; n < DYN_NOTCH_FFT_SIZE; n++) {
+                const int idx = (dn->ring_idx + n) & (DYN_NOTCH_FFT_SIZE - 1);
+                dn->work[axis][n] = dn->ring[axis][idx] * dn->window[n];
+            }
+        }
+        dn->new_samples = 0;
+        dn->axis = 0;
+        dn->fft_stage = 0;
+        dn->step = DYN_NOTCH_STEP_FFT;
+        break;
+
+    case DYN_NOTCH_STEP_FFT:
+        dynNotchFftStage(dn, dn->work[dn->axis], dn->fft_stage);
+        if (++dn->fft_stage >= DYN_NOTCH_FFT_STAGES) {
+            dn->step = DYN_NOTCH_STEP_SPLIT;
+        }
+        break;
+
+    case DYN_NOTCH_STEP_SPLIT:
+        dynNotchRfftSplit(dn, dn->work[dn->axis]);
+        dn->step = DYN_NOTCH_STEP_PEAKS;
+        break;
+
+    case DYN_NOTCH_STEP_PEAKS:
+        dynNotchFindPeaks(dn, dn->work[dn->axis]);
+        dn->step = DYN_NOTCH_STEP_RETUNE;
+        break;
+
+    case DYN_NOTCH_STEP_RETUNE:
+        dynNotchRetune(dn, dn->axis);
+        if (++dn->axis < DYN_NOTCH_AXES) {
+            dn->fft_stage = 0;
+            dn->step = DYN_NOTCH_STEP_FFT;
+        } else {
+            dn->step = DYN_NOTCH_STEP_IDLE;
+            dn->analyses++;
+        }
+        break;
+
+    default:
+        dn->step = DYN_NOTCH_STEP_IDLE;
+        return false;
+    }
+
+    dn->steps++;
+    return true;
+}
+
+float dynNotchApply(dynNotch_t *dn, uint8_t axis, float input)
+{
+    if (!dn->ready) {
+        return input;
+    }
+    for (int i = 0; i < dn->cfg.count; i++) {
+        input = biquadFilterApplyDF1(&dn->notch[axis][i], input);
+    }
+    return input;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file    dyn_notch.h
+ * @brief   FFT-based dynamic notch: tracks up to 3 noise peaks per axis and retunes notch biquads
+ *
+ * Data flow:
+ *   dynNotchPush()   at the gyro rate (e.g. 8kHz, before any filtering): boxcar-decimates
+ *                    to the analysis rate and fills a per-axis ring buffer.
+ *   dynNotchUpdate() from a scheduler slice: performs ONE bounded step of the analysis
+ *                    (snapshot+window, one radix-2 FFT stage, real split, peak search,
+ *                    notch retune). A full 3-axis analysis is DYN_NOTCH_STEPS_PER_ANALYSIS
+ *                    calls; a new analysis starts every DYN_NOTCH_HOP new samples.
+ *   dynNotchApply()  at the notch rate (the filter loop rate): runs the notches in DF1,
+ *                    which tolerates coefficient changes between samples.
+ *
+ * The transform is a 64-point real FFT computed as a 32-point complex FFT plus split,
+ * with the same packed output layout as arm_rfft_fast_f32 (out[0]=DC, out[1]=Nyquist,
+ * then re/im pairs). The in-tree CMSIS-DSP snapshot lacks arm_common_tables.c, so the
+ * twiddles are generated at init instead.
+ */
+
+#ifndef DYN_NOTCH_H
+#define DYN_NOTCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "filter.h"
+
+#define DYN_NOTCH_AXES          3
+#define DYN_NOTCH_MAX_COUNT     3
+#define DYN_NOTCH_FFT_SIZE      64
+#define DYN_NOTCH_FFT_BINS      (DYN_NOTCH_FFT_SIZE / 2)
+#define DYN_NOTCH_FFT_STAGES    5           // log2(DYN_NOTCH_FFT_SIZE / 2)
+#define DYN_NOTCH_HOP           (DYN_NOTCH_FFT_SIZE / 2)   // 50% window overlap
+
+// Per axis: FFT stages + real split + peak search + retune; plus one shared snapshot step
+#define DYN_NOTCH_STEPS_PER_AXIS      (DYN_NOTCH_FFT_STAGES + 3)
+#define DYN_NOTCH_STEPS_PER_ANALYSIS  (1 + DYN_NOTCH_AXES * DYN_NOTCH_STEPS_PER_AXIS)
+
+typedef struct dynNotchConfig_s {
+    float   input_hz;       // dynNotchPush rate
+    float   notch_hz;       // dynNotchApply rate
+    float   min_hz;         // tracked band
+    float   max_hz;
+    uint8_t count;          // notches per axis (1..DYN_NOTCH_MAX_COUNT)
+    float   q;              // notch quality factor
+} dynNotchConfig_t;
+
+typedef enum {
+    DYN_NOTCH_STEP_IDLE = 0,
+    DYN_NOTCH_STEP_SNAPSHOT,
+    DYN_NOTCH_STEP_FFT,         // one butterfly stage per call
+    DYN_NOTCH_STEP_SPLIT,
+    DYN_NOTCH_STEP_PEAKS,
+    DYN_NOTCH_STEP_RETUNE,
+} dynNotchStep_e;
+
+typedef struct dynNotch_s {
+    dynNotchConfig_t cfg;
+    bool     ready;
+    float    fft_hz;                // analysis sample rate
+    float    bin_hz;
+    uint8_t  min_bin, max_bin;
+    uint32_t notch_refresh_us;
+
+    // Decimation to the analysis rate
+    uint16_t decim;
+    uint16_t decim_count;
+    float    decim_sum[DYN_NOTCH_AXES];
+
+    // Analysis input ring
+    float    ring[DYN_NOTCH_AXES][DYN_NOTCH_FFT_SIZE];
+    uint8_t  ring_idx;
+    uint16_t ring_fill;
+    uint16_t new_samples;
+
+    // Analysis state
+    uint8_t  step;                  // dynNotchStep_e
+    uint8_t  axis;
+    uint8_t  fft_stage;
+    float    work[DYN_NOTCH_AXES][DYN_NOTCH_FFT_SIZE];
+    float    power[DYN_NOTCH_FFT_BINS];
+    float    peak_hz[DYN_NOTCH_MAX_COUNT];
+    uint8_t  peak_count;
+
+    // Tables (generated at init)
+    float    window[DYN_NOTCH_FFT_SIZE];
+    float    twiddle[DYN_NOTCH_FFT_BINS];          // complex FFT: cos, sin pairs for k < N/4
+    float    twiddle_rfft[DYN_NOTCH_FFT_SIZE];     // split: cos, sin pairs for k < N/2
+    uint8_t  bitrev[DYN_NOTCH_FFT_BINS];
+
+    // Output
+    float    center_hz[DYN_NOTCH_AXES][DYN_NOTCH_MAX_COUNT];
+    biquadFilter_t notch[DYN_NOTCH_AXES][DYN_NOTCH_MAX_COUNT];
+
+    // Statistics
+    uint32_t analyses;
+    uint32_t steps;
+    uint32_t overruns;              // hop completed while an analysis was still running
+} dynNotch_t;
+
+void dynNotchGetDefaultConfig(dynNotchConfig_t *cfg);
+bool dynNotchInit(dynNotch_t *dn, const dynNotchConfig_t *cfg);
+void dynNotchPush(dynNotch_t *dn, float x, float y, float z);
+bool dynNotchUpdate(dynNotch_t *dn);
+float dynNotchApply(dynNotch_t *dn, uint8_t axis, float input);
+
+// Whole 64-point real FFT in one call (tests and offline tools); buf is transformed in place
+void dynNotchRfft(const dynNotch_t *dn, float *buf);
+
+#endif // DYN_NOTCH_H
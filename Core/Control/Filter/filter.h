@@ -1,4 +1,7 @@
 /* These codes come from Betaflight */
+#ifndef FILTER_H
+#define FILTER_H
+
 #include <stdint.h>
 #include "maths.h"
 
@@ -36,3 +39,5 @@ void biquadFilterUpdateLPF(biquadFilter_t *filter, float filterFreq, uint32_t re
 float biquadFilterApplyDF1(biquadFilter_t *filter, float input);
 float biquadFilterApplyDF1Weighted(biquadFilter_t *filter, float input);
 float biquadFilterApply(biquadFilter_t *filter, float input);
+
+#endif // FILTER_H
@@ -0,0 +1,161 @@
+#include "filter_bank.h"
+#include <string.h>
+
+// 1 / sqrt(2^(1/n) - 1): moves each of n cascaded PT1 so the cascade is -3dB at the requested cutoff
+#define PT2_CUTOFF_CORRECTION   1.553773974f
+#define PT3_CUTOFF_CORRECTION   1.961459177f
+
+uint8_t filterBankStageSections(filterBankStageType_e type)
+{
+    switch (type) {
+    case FILTER_BANK_PT2: return 2;
+    case FILTER_BANK_PT3: return 3;
+    default:              return 1;
+    }
+}
+
+// Store a biquadFilter_t section in CMSIS DF2T order (feedback coefficients negated)
+static void filterBankSetSection(filterBank_t *bank, uint8_t section, const biquadFilter_t *bq)
+{
+    float *c = &bank->coeffs[5 * section];
+    c[0] = bq->b0;
+    c[1] = bq->b1;
+    c[2] = bq->b2;
+    c[3] = -bq->a1;
+    c[4] = -bq->a2;
+}
+
+static void filterBankSetPt1(filterBank_t *bank, uint8_t section, float k)
+{
+    // y = k*x + (1-k)*y[n-1]
+    const biquadFilter_t bq = { .b0 = k, .a1 = -(1.0f - k) };
+    filterBankSetSection(bank, section, &bq);
+}
+
+bool filterBankInit(filterBank_t *bank, const filterBankStage_t *stages, uint8_t count, float sample_hz)
+{
+    if (!bank || (!stages && count) || sample_hz <= 0.0f) {
+        return false;
+    }
+
+    memset(bank, 0, sizeof(*bank));
+    bank->sample_hz = sample_hz;
+
+    const float dT = 1.0f / sample_hz;
+    const uint32_t refresh_us = (uint32_t)(1000000.0f / sample_hz);
+    const float nyquist = 0.5f * sample_hz;
+
+    uint8_t section = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        const filterBankStage_t *st = &stages[i];
+        const uint8_t n = filterBankStageSections(st->type);
+        if (section + n > FILTER_BANK_MAX_SECTIONS || st->cutoff_hz <= 0.0f || st->cutoff_hz >= nyquist) {
+            bank->num_sections = 0;
+            return false;
+        }
+
+        biquadFilter_t bq;
+        switch (st->type) {
+        case FILTER_BANK_PT1:
+            filterBankSetPt1(bank, section, pt1FilterGain(st->cutoff_hz, dT));
+            break;
+        case FILTER_BANK_PT2:
+        case FILTER_BANK_PT3: {
+            const float corr = (st->type == FILTER_BANK_PT2) ? PT2_CUTOFF_CORRECTION : PT3_CUTOFF_CORRECTION;
+            const float k = pt1FilterGain(st->cutoff_hz * corr, dT);
+            for (uint8_t j = 0; j < n; j++) {
+                filterBankSetPt1(bank, section + j, k);
+            }
+            break;
+        }
+        case FILTER_BANK_LPF:
+            biquadFilterInitLPF(&bq, st->cutoff_hz, refresh_us);
+            filterBankSetSection(bank, section, &bq);
+            break;
+        case FILTER_BANK_NOTCH:
+            if (st->center_hz <= st->cutoff_hz || st->center_hz >= nyquist) {
+                bank->num_sections = 0;
+                return false;
+            }
+            biquadFilterInit(&bq, st->center_hz, refresh_us, filterGetNotchQ(st->center_hz, st->cutoff_hz),
+                             FILTER_NOTCH, 1.0f);
+            filterBankSetSection(bank, section, &bq);
+            break;
+        default:
+            bank->num_sections = 0;
+            return false;
+        }
+        section += n;
+    }
+
+    bank->num_sections = section;
+    for (uint8_t axis = 0; axis < FILTER_BANK_AXES; axis++) {
+        arm_biquad_cascade_df2T_init_f32(&bank->inst[axis], section, bank->coeffs, bank->state[axis]);
+    }
+    filterBankReset(bank);
+    return true;
+}
+
+void filterBankReset(filterBank_t *bank)
+{
+    memset(bank->state, 0, sizeof(bank->state));
+}
+
+// Retune a notch section in place (DF2T state is kept; fine for slow centre-frequency tracking)
+bool filterBankUpdateNotch(filterBank_t *bank, uint8_t section, float center_hz, float cutoff_hz)
+{
+    if (!bank || section >= bank->num_sections || center_hz <= cutoff_hz || cutoff_hz <= 0.0f ||
+        center_hz >= 0.5f * bank->sample_hz) {
+        return false;
+    }
+    biquadFilter_t bq;
+    biquadFilterUpdate(&bq, center_hz, (uint32_t)(1000000.0f / bank->sample_hz),
+                       filterGetNotchQ(center_hz, cutoff_hz), FILTER_NOTCH, 1.0f);
+    filterBankSetSection(bank, section, &bq);
+    return true;
+}
+
+void filterBankProcess(filterBank_t *bank, uint8_t axis, const float *in, float *out, uint32_t count)
+{
+    if (bank->num_sections == 0) {
+        if (out != in) {
+            memcpy(out, in, count * sizeof(float));
+        }
+        return;
+    }
+    arm_biquad_cascade_df2T_f32(&bank->inst[axis], in, out, count);
+}
+
+void filterBankApply(filterBank_t *bank, const float in[FILTER_BANK_AXES], float out[FILTER_BANK_AXES])
+{
+    for (uint8_t axis = 0; axis < FILTER_BANK_AXES; axis++) {
+        filterBankProcess(bank, axis, &in[axis], &out[axis], 1);
+    }
+}
+
+// Scalar reference: one sample at a time, zero state
+void filterBankScalarInit(filterBankScalar_t *ref, const filterBank_t *bank)
+{
+    memset(ref, 0, sizeof(*ref));
+    ref->num_sections = bank->num_sections;
+    memcpy(ref->coeffs, bank->coeffs, sizeof(ref->coeffs));
+}
+
+float filterBankScalarApply(filterBankScalar_t *ref, uint8_t axis, float input)
+{
+    float *d = ref->state[axis];
+    for (uint8_t s = 0; s < ref->num_sections; s++) {
+        const float *c = &ref->coeffs[5 * s];
+        const float result = c[0] * input + d[2 * s];
+
+        float d1 = c[1] * input + d[2 * s + 1];
+        d1 += c[3] * result;
+        float d2 = c[2] * input;
+        d2 += c[4] * result;
+
+        d[2 * s] = d1;
+        d[2 * s + 1] = d2;
+        input = result;
+    }
+    return input;
+}
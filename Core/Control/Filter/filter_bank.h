@@ -0,0 +1,68 @@
+/**
+ * @file    filter_bank.h
+ * @brief   Per-axis gyro filter bank on CMSIS-DSP biquad cascades (DF2T)
+ *
+ * A bank is an ordered list of stages (PT1/PT2/PT3/biquad LPF/notch). Every
+ * stage expands into one or more second-order sections; the sections share one
+ * coefficient array and each axis owns its own state, so axes never leak into
+ * each other. Blocks of samples per axis go through arm_biquad_cascade_df2T_f32.
+ *
+ * filterBankScalar_t is the scalar reference: the same sections run sample by
+ * sample in DF2T with CMSIS' operation order (d1 = b1*x + d2 + a1*y), so both
+ * paths match bit for bit as long as the compiler does not contract multiply-adds
+ * differently. biquadFilterApply groups the d1 update as (b1*x - a1*y) + d2 and
+ * therefore only agrees to rounding.
+ */
+
+#ifndef FILTER_BANK_H
+#define FILTER_BANK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "arm_math.h"
+#include "filter.h"
+
+#define FILTER_BANK_AXES            3
+#define FILTER_BANK_MAX_SECTIONS    8
+
+typedef enum {
+    FILTER_BANK_PT1 = 0,
+    FILTER_BANK_PT2,            // two PT1 sections, cutoff corrected for -3dB at cutoff_hz
+    FILTER_BANK_PT3,            // three PT1 sections, cutoff corrected for -3dB at cutoff_hz
+    FILTER_BANK_LPF,            // 2nd order Butterworth biquad
+    FILTER_BANK_NOTCH,          // biquad notch at center_hz, lower cutoff cutoff_hz
+} filterBankStageType_e;
+
+typedef struct filterBankStage_s {
+    filterBankStageType_e type;
+    float cutoff_hz;
+    float center_hz;            // notch only
+} filterBankStage_t;
+
+typedef struct filterBank_s {
+    uint8_t num_sections;
+    float sample_hz;
+    // CMSIS order per section: b0, b1, b2, -a1, -a2 (shared by all axes)
+    float coeffs[5 * FILTER_BANK_MAX_SECTIONS];
+    // d1, d2 per section, one row per axis
+    float state[FILTER_BANK_AXES][2 * FILTER_BANK_MAX_SECTIONS];
+    arm_biquad_cascade_df2T_instance_f32 inst[FILTER_BANK_AXES];
+} filterBank_t;
+
+typedef struct filterBankScalar_s {
+    uint8_t num_sections;
+    float coeffs[5 * FILTER_BANK_MAX_SECTIONS];
+    float state[FILTER_BANK_AXES][2 * FILTER_BANK_MAX_SECTIONS];
+} filterBankScalar_t;
+
+uint8_t filterBankStageSections(filterBankStageType_e type);
+bool filterBankInit(filterBank_t *bank, const filterBankStage_t *stages, uint8_t count, float sample_hz);
+void filterBankReset(filterBank_t *bank);
+bool filterBankUpdateNotch(filterBank_t *bank, uint8_t section, float center_hz, float cutoff_hz);
+void filterBankProcess(filterBank_t *bank, uint8_t axis, const float *in, float *out, uint32_t count);
+void filterBankApply(filterBank_t *bank, const float in[FILTER_BANK_AXES], float out[FILTER_BANK_AXES]);
+
+void filterBankScalarInit(filterBankScalar_t *ref, const filterBank_t *bank);
+float filterBankScalarApply(filterBankScalar_t *ref, uint8_t axis, float input);
+
+#endif // FILTER_BANK_H
@@ -0,0 +1,244 @@
+#include "fir_decimator.h"
+#include <string.h>
+
+/*
+ * Coefficients: windowed sinc at 8kHz, cutoff 0.9 * fs_out / 2, Kaiser window,
+ * normalised to unity DC gain. Passband is checked up to fp, alias rejection is
+ * the worst gain over k*fs_out +/- fp (the bands that fold onto 0..fp):
+ *
+ *   M  N   beta  fp      passband   alias     delay
+ *   2  10  4     800Hz   -0.23dB    -49.8dB   0.56ms
+ *   4  20  5     400Hz   -0.35dB    -53.7dB   1.19ms
+ *   8  32  4     200Hz   -0.58dB    -49.3dB   1.94ms
+ *
+ * An M-sample boxcar manages -10..-12dB over the same bands.
+ *
+ * The Q15 tables are the same taps rounded to 1/32768, with the rounding
+ * remainder put on the centre pair so the DC gain stays exactly 1 and the taps
+ * stay symmetric. Passband and alias figures move by less than 0.7dB.
+ */
+static const float firDecim2Coeffs[10] = {
+     4.907236551e-04f, -2.600474761e-02f, -2.748044637e-02f,  1.485587714e-01f,
+     4.044356989e-01f,  4.044356989e-01f,  1.485587714e-01f, -2.748044637e-02f,
+    -2.600474761e-02f,  4.907236551e-04f,
+};
+
+static const float firDecim4Coeffs[20] = {
+     5.141249911e-04f, -1.003361705e-03f, -6.676155452e-03f, -1.488228172e-02f,
+    -1.739092180e-02f, -1.634532908e-03f,  4.111722409e-02f,  1.065498026e-01f,
+     1.747806908e-01f,  2.186254111e-01f,  2.186254111e-01f,  1.747806908e-01f,
+     1.065498026e-01f,  4.111722409e-02f, -1.634532908e-03f, -1.739092180e-02f,
+    -1.488228172e-02f, -6.676155452e-03f, -1.003361705e-03f,  5.141249911e-04f,
+};
+
+static const float firDecim8Coeffs[32] = {
+    -1.299510186e-03f, -2.763835200e-03f, -4.598102596e-03f, -6.354393009e-03f,
+    -7.337488828e-03f, -6.684260872e-03f, -3.507325901e-03f,  2.918646795e-03f,
+     1.296414466e-02f,  2.648902915e-02f,  4.276461302e-02f,  6.050147109e-02f,
+     7.798984161e-02f,  9.333497245e-02f,  1.047475248e-01f,  1.108346730e-01f,
+     1.108346730e-01f,  1.047475248e-01f,  9.333497245e-02f,  7.798984161e-02f,
+     6.050147109e-02f,  4.276461302e-02f,  2.648902915e-02f,  1.296414466e-02f,
+     2.918646795e-03f, -3.507325901e-03f, -6.684260872e-03f, -7.337488828e-03f,
+    -6.354393009e-03f, -4.598102596e-03f, -2.763835200e-03f, -1.299510186e-03f,
+};
+
+static const int16_t firDecim2CoeffsQ15[10] = {
+        16,   -852,   -900,   4868,  13252,  13252,   4868,   -900,
+      -852,     16,
+};
+
+static const int16_t firDecim4CoeffsQ15[20] = {
+        17,    -33,   -219,   -488,   -570,    -54,   1347,   3491,
+      5727,   7166,   7166,   5727,   3491,   1347,    -54,   -570,
+      -488,   -219,    -33,     17,
+};
+
+static const int16_t firDecim8CoeffsQ15[32] = {
+       -43,    -91,   -151,   -208,   -240,   -219,   -115,     96,
+       425,    868,   1401,   1983,   2556,   3058,   3432,   3632,
+      3632,   3432,   3058,   2556,   1983,   1401,    868,    425,
+        96,   -115,   -219,   -240,   -208,   -151,    -91,    -43,
+};
+
+static const firDecimatorDesign_t firDecimatorDesigns[] = {
+    { .ratio = 2, .phase_taps = 5, .passband_hz = 800.0f, .coeffs = firDecim2Coeffs, .coeffs_q15 = firDecim2CoeffsQ15 },
+    { .ratio = 4, .phase_taps = 5, .passband_hz = 400.0f, .coeffs = firDecim4Coeffs, .coeffs_q15 = firDecim4CoeffsQ15 },
+    { .ratio = 8, .phase_taps = 4, .passband_hz = 200.0f, .coeffs = firDecim8Coeffs, .coeffs_q15 = firDecim8CoeffsQ15 },
+};
+
+const firDecimatorDesign_t *firDecimatorDesign(uint8_t ratio)
+{
+    for (unsigned i = 0; i < sizeof(firDecimatorDesigns) / sizeof(firDecimatorDesigns[0]); i++) {
+        if (firDecimatorDesigns[i].ratio == ratio) {
+            return &firDecimatorDesigns[i];
+        }
+    }
+    return NULL;
+}
+
+bool firDecimatorInit(firDecimator_t *dec, uint8_t ratio)
+{
+    if (!dec) {
+        return false;
+    }
+    const firDecimatorDesign_t *design = firDecimatorDesign(ratio);
+    if (!design) {
+        return false;
+    }
+    dec->design = design;
+    firDecimatorReset(dec);
+    return true;
+}
+
+void firDecimatorReset(firDecimator_t *dec)
+{
+    dec->phase = 0;
+    dec->head = 0;
+    dec->primed = false;
+    memset(dec->acc, 0, sizeof(dec->acc));
+}
+
+// Seed the pending outputs with a constant history x0: output n + d already
+// holds taps (d+1)*M .. N-1 from the samples before the current block.
+static void firDecimatorPrime(firDecimator_t *dec, const float in[FIR_DECIMATOR_AXES])
+{
+    const firDecimatorDesign_t *design = dec->design;
+    const uint8_t m = design->ratio;
+    const uint8_t k = design->phase_taps;
+
+    for (uint8_t d = 0; d < k; d++) {
+        float tail = 0.0f;
+        for (uint16_t n = (uint16_t)((d + 1) * m); n < (uint16_t)(k * m); n++) {
+            tail += design->coeffs[n];
+        }
+        for (uint8_t axis = 0; axis < FIR_DECIMATOR_AXES; axis++) {
+            dec->acc[axis][d] = tail * in[axis];
+        }
+    }
+    dec->primed = true;
+}
+
+bool firDecimatorApply(firDecimator_t *dec, const float in[FIR_DECIMATOR_AXES], float out[FIR_DECIMATOR_AXES])
+{
+    const firDecimatorDesign_t *design = dec->design;
+    const uint8_t m = design->ratio;
+    const uint8_t k = design->phase_taps;
+
+    if (!dec->primed) {
+        firDecimatorPrime(dec, in);
+    }
+
+    // Input at phase p reaches output n + d through tap d*M + (M-1-p)
+    const float *h = &design->coeffs[m - 1 - dec->phase];
+    uint8_t slot = dec->head;
+    for (uint8_t d = 0; d < k; d++) {
+        const float c = h[d * m];
+        dec->acc[0][slot] += c * in[0];
+        dec->acc[1][slot] += c * in[1];
+        dec->acc[2][slot] += c * in[2];
+        if (++slot == k) {
+            slot = 0;
+        }
+    }
+
+    if (++dec->phase < m) {
+        return false;
+    }
+
+    dec->phase = 0;
+    for (uint8_t axis = 0; axis < FIR_DECIMATOR_AXES; axis++) {
+        out[axis] = dec->acc[axis][dec->head];
+        dec->acc[axis][dec->head] = 0.0f;
+    }
+    if (++dec->head == k) {
+        dec->head = 0;
+    }
+    return true;
+}
+
+float firDecimatorGroupDelay(const firDecimator_t *dec)
+{
+    if (!dec || !dec->design) {
+        return 0.0f;
+    }
+    return 0.5f * (float)(dec->design->phase_taps * dec->design->ratio - 1);
+}
+
+bool firDecimatorQ15Init(firDecimatorQ15_t *dec, uint8_t ratio)
+{
+    if (!dec) {
+        return false;
+    }
+    const firDecimatorDesign_t *design = firDecimatorDesign(ratio);
+    if (!design) {
+        return false;
+    }
+    dec->design = design;
+    firDecimatorQ15Reset(dec);
+    return true;
+}
+
+void firDecimatorQ15Reset(firDecimatorQ15_t *dec)
+{
+    dec->phase = 0;
+    dec->head = 0;
+    dec->primed = false;
+    memset(dec->acc, 0, sizeof(dec->acc));
+}
+
+static void firDecimatorQ15Prime(firDecimatorQ15_t *dec, const int16_t in[FIR_DECIMATOR_AXES])
+{
+    const firDecimatorDesign_t *design = dec->design;
+    const uint8_t m = design->ratio;
+    const uint8_t k = design->phase_taps;
+
+    for (uint8_t d = 0; d < k; d++) {
+        int32_t tail = 0;
+        for (uint16_t n = (uint16_t)((d + 1) * m); n < (uint16_t)(k * m); n++) {
+            tail += design->coeffs_q15[n];
+        }
+        for (uint8_t axis = 0; axis < FIR_DECIMATOR_AXES; axis++) {
+            dec->acc[axis][d] = tail * in[axis];
+        }
+    }
+    dec->primed = true;
+}
+
+bool firDecimatorQ15Apply(firDecimatorQ15_t *dec, const int16_t in[FIR_DECIMATOR_AXES], int32_t out[FIR_DECIMATOR_AXES])
+{
+    const firDecimatorDesign_t *design = dec->design;
+    const uint8_t m = design->ratio;
+    const uint8_t k = design->phase_taps;
+
+    if (!dec->primed) {
+        firDecimatorQ15Prime(dec, in);
+    }
+
+    // 16x16 -> 32 multiply-accumulate (SMLABB on Cortex-M4)
+    const int16_t *h = &design->coeffs_q15[m - 1 - dec->phase];
+    const int32_t x = in[0], y = in[1], z = in[2];
+    uint8_t slot = dec->head;
+    for (uint8_t d = 0; d < k; d++) {
+        const int32_t c = h[d * m];
+        dec->acc[0][slot] += c * x;
+        dec->acc[1][slot] += c * y;
+        dec->acc[2][slot] += c * z;
+        if (++slot == k) {
+            slot = 0;
+        }
+    }
+
+    if (++dec->phase < m) {
+        return false;
+    }
+
+    dec->phase = 0;
+    for (uint8_t axis = 0; axis < FIR_DECIMATOR_AXES; axis++) {
+        out[axis] = dec->acc[axis][dec->head];
+        dec->acc[axis][dec->head] = 0;
+    }
+    if (++dec->head == k) {
+        dec->head = 0;
+    }
+    return true;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file    fir_decimator.h
+ * @brief   Polyphase FIR decimator for the 8kHz gyro stream (8kHz -> 4/2/1kHz)
+ *
+ * Each ratio M uses a fixed linear-phase low-pass of N = K*M taps (Kaiser
+ * windowed sinc, designed offline, see fir_decimator.c). Instead of running the
+ * whole N-tap dot product once per output, every input sample is folded into the
+ * K outputs it contributes to (one polyphase tap each), so every sample costs
+ * exactly K multiply-adds per axis and there is no burst on the output sample.
+ *
+ * Group delay is (N-1)/2 input samples. Compared with an M-sample boxcar the
+ * filter trades some latency for 35..40dB more rejection of the band that
+ * folds onto 0..fp after decimation.
+ *
+ * firDecimatorQ15_t runs the same structure on raw int16 sensor counts with Q15
+ * taps (rounded offline, DC gain exactly 32768) and int32 accumulators, so a
+ * fixed-point front end only converts to float once per decimated output.
+ * |sum of taps| <= 1.22, so a full-scale int16 input cannot overflow.
+ */
+
+#ifndef FIR_DECIMATOR_H
+#define FIR_DECIMATOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define FIR_DECIMATOR_AXES          3
+#define FIR_DECIMATOR_MAX_PHASE_TAPS 5   // K: taps per polyphase branch
+
+typedef struct firDecimatorDesign_s {
+    uint8_t ratio;              // M
+    uint8_t phase_taps;         // K, N = K * M
+    float passband_hz;          // edge used for the design checks at 8kHz input
+    const float *coeffs;        // N taps, symmetric
+    const int16_t *coeffs_q15;  // same taps in Q15, sum = 32768
+} firDecimatorDesign_t;
+
+typedef struct firDecimator_s {
+    const firDecimatorDesign_t *design;
+    uint8_t phase;              // input index within the current output block, 0..M-1
+    uint8_t head;               // accumulator of the next output
+    bool primed;
+    // acc[axis][(head + d) % K] collects output n + d
+    float acc[FIR_DECIMATOR_AXES][FIR_DECIMATOR_MAX_PHASE_TAPS];
+} firDecimator_t;
+
+typedef struct firDecimatorQ15_s {
+    const firDecimatorDesign_t *design;
+    uint8_t phase;
+    uint8_t head;
+    bool primed;
+    int32_t acc[FIR_DECIMATOR_AXES][FIR_DECIMATOR_MAX_PHASE_TAPS];  // Q15 counts
+} firDecimatorQ15_t;
+
+// Design for 8kHz -> 8kHz/ratio, NULL if the ratio has no table (supported: 2, 4, 8)
+const firDecimatorDesign_t *firDecimatorDesign(uint8_t ratio);
+
+bool firDecimatorInit(firDecimator_t *dec, uint8_t ratio);
+void firDecimatorReset(firDecimator_t *dec);
+
+// Push one 3-axis input sample; returns true and fills out[] on every M-th sample.
+// The first sample primes the history as if the input had been constant before it.
+bool firDecimatorApply(firDecimator_t *dec, const float in[FIR_DECIMATOR_AXES], float out[FIR_DECIMATOR_AXES]);
+
+// Group delay in input samples: (N-1)/2
+float firDecimatorGroupDelay(const firDecimator_t *dec);
+
+bool firDecimatorQ15Init(firDecimatorQ15_t *dec, uint8_t ratio);
+void firDecimatorQ15Reset(firDecimatorQ15_t *dec);
+
+// Integer variant of firDecimatorApply: out[] = filtered counts << 15
+bool firDecimatorQ15Apply(firDecimatorQ15_t *dec, const int16_t in[FIR_DECIMATOR_AXES], int32_t out[FIR_DECIMATOR_AXES]);
+
+#endif // FIR_DECIMATOR_H
@@ -0,0 +1,391 @@
+/**
+ * @file    accel_cal.c
+ * @brief   加速度计六面校准实现
+ */
+
+#include "accel_cal.h"
+#include "task_acc.h"
+#include "icm42688p_lib.h"
+#include "stm32f4xx_hal.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define ACCEL_CAL_MAX_RESIDUAL_G    0.05f   // 六面拟合 RMS 残差上限
+#define ACCEL_CAL_MAX_SCALE_ERR     0.2f    // 刻度相对标称的偏离上限
+#define ACCEL_CAL_MAX_MISALIGN      0.1f    // 交叉轴项上限
+#define ACCEL_CAL_AXIS_MIN_G        0.8f    // 判定朝向：主轴至少 0.8g
+#define ACCEL_CAL_NORM_TOL_G        0.2f    // 且模长在 1 ± 0.2g 内
+
+// 一块原始样本的累加结果（样本路径 -> 任务）
+typedef struct {
+    int32_t sum[3];
+    int64_t sum_sq[3];
+    uint16_t n;
+} accel_cal_block_t;
+
+static const accel_cal_config_t accel_cal_default_config = {
+    .block_samples = 100,
+    .window_blocks = 10,
+    .still_std_g = 0.05f,
+    .still_drift_g = 0.02f,
+};
+
+static const char *const accel_cal_pos_name[ACCEL_CAL_POS_COUNT] = {
+    "+X up", "-X up", "+Y up", "-Y up", "+Z up", "-Z up",
+};
+
+static accel_cal_config_t cal_cfg;
+static volatile accel_cal_state_e cal_state = ACCEL_CAL_STATE_OFF;
+
+static accel_cal_block_t cal_acc;
+static accel_cal_block_t cal_pending;
+static volatile bool cal_pending_ready = false;
+static volatile uint32_t cal_overruns = 0;
+
+// 当前采集窗口
+static int8_t cal_win_pos = -1;
+static uint8_t cal_win_n = 0;
+static float cal_win_sum[3];
+static float cal_win_min[3];
+static float cal_win_max[3];
+
+static uint8_t cal_captured = 0;
+static float cal_mean[ACCEL_CAL_POS_COUNT][3];
+static accel_cal_result_t cal_result;
+static bool cal_have_result = false;
+
+/**
+ * @brief n 元线性方程组（n <= 4，高斯消元，列主元），解写回 b
+ */
+static bool accel_cal_solve_linear(float a[4][4], float b[4], int n)
+{
+    for (int c = 0; c < n; c++) {
+        int p = c;
+        for (int r = c + 1; r < n; r++) {
+            if (fabsf(a[r][c]) > fabsf(a[p][c])) p = r;
+        }
+        if (fabsf(a[p][c]) < 1e-4f) {       // 方程已归一化到 1 附近
+            return false;
+        }
+        if (p != c) {
+            for (int k = 0; k < n; k++) {
+                const float t = a[c][k]; a[c][k] = a[p][k]; a[p][k] = t;
+            }
+            const float t = b[c]; b[c] = b[p]; b[p] = t;
+        }
+        for (int r = c + 1; r < n; r++) {
+            const float f = a[r][c] / a[c][c];
+            for (int k = c; k < n; k++) a[r][k] -= f * a[c][k];
+            b[r] -= f * b[c];
+        }
+    }
+    for (int c = n - 1; c >= 0; c--) {
+        float s = b[c];
+        for (int k = c + 1; k < n; k++) s -= a[c][k] * b[k];
+        b[c] = s / a[c][c];
+    }
+    return true;
+}
+
+// 第 pos 面的重力方向（传感器系，g）：朝上的轴读 +1g
+static float accel_cal_target(int pos, int axis)
+{
+    if (axis != pos / 2) {
+        return 0.0f;
+    }
+    return (pos & 1) ? -1.0f : 1.0f;
+}
+
+/**
+ * @brief 六面最小二乘求解
+ */
+bool accel_cal_solve(const float mean[ACCEL_CAL_POS_COUNT][3], float nominal_scale, accel_cal_result_t *result)
+{
+    if (!mean || !result || !(nominal_scale > 0.0f)) {
+        return false;
+    }
+
+    // 原始计数先除以标称刻度，正规矩阵元素在 1 附近
+    const float k = 1.0f / nominal_scale;
+    float ntn[4][4] = { { 0 } };
+    float ntg[3][4] = { { 0 } };
+    for (int i = 0; i < ACCEL_CAL_POS_COUNT; i++) {
+        const float phi[4] = { mean[i][0] * k, mean[i][1] * k, mean[i][2] * k, 1.0f };
+        for (int r = 0; r < 4; r++) {
+            for (int c = 0; c < 4; c++) ntn[r][c] += phi[r] * phi[c];
+            for (int a = 0; a < 3; a++) ntg[a][r] += phi[r] * accel_cal_target(i, a);
+        }
+    }
+
+    // 三个输出轴共用正规矩阵：a_i = A_i . (raw * k) + d_i
+    float c[3][3], d[3];
+    for (int a = 0; a < 3; a++) {
+        float m[4][4];
+        memcpy(m, ntn, sizeof(m));
+        float theta[4] = { ntg[a][0], ntg[a][1], ntg[a][2], ntg[a][3] };
+        if (!accel_cal_solve_linear(m, theta, 4)) {
+            printf("[accel_cal] Singular system (orientations not distinct?)\r\n");
+            return false;
+        }
+        for (int j = 0; j < 3; j++) c[a][j] = theta[j] * k;
+        d[a] = theta[3];
+    }
+
+    // 零偏：C * b = -d
+    float cm[4][4] = { { 0 } };
+    float bias[4] = { -d[0], -d[1], -d[2], 0.0f };
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) cm[i][j] = c[i][j] * nominal_scale;   // 同样归一化
+    }
+    if (!accel_cal_solve_linear(cm, bias, 3)) {
+        printf("[accel_cal] Singular matrix\r\n");
+        return false;
+    }
+
+    accel_cal_result_t r;
+    double sq = 0.0;
+    for (int i = 0; i < ACCEL_CAL_POS_COUNT; i++) {
+        for (int a = 0; a < 3; a++) {
+            const float e = c[a][0] * mean[i][0] + c[a][1] * mean[i][1] + c[a][2] * mean[i][2] + d[a] -
+                            accel_cal_target(i, a);
+            sq += (double)e * e;
+        }
+    }
+    r.residual_g = (float)sqrt(sq / (3.0 * ACCEL_CAL_POS_COUNT));
+
+    bool ok = r.residual_g <= ACCEL_CAL_MAX_RESIDUAL_G;
+    for (int i = 0; i < 3; i++) {
+        r.bias[i] = bias[i] * nominal_scale;
+        r.scale[i] = 1.0f / c[i][i];
+        memcpy(r.matrix[i], c[i], sizeof(r.matrix[i]));
+        if (!(fabsf(r.scale[i] / nominal_scale - 1.0f) <= ACCEL_CAL_MAX_SCALE_ERR)) {
+            ok = false;
+        }
+    }
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            r.misalign[i][j] = c[i][j] * r.scale[j];
+            if (i != j && !(fabsf(r.misalign[i][j]) <= ACCEL_CAL_MAX_MISALIGN)) {
+                ok = false;
+            }
+        }
+    }
+    if (!ok) {
+        printf("[accel_cal] Result rejected: residual %.4fg, scale %.1f %.1f %.1f\r\n",
+               (double)r.residual_g, (double)r.scale[0], (double)r.scale[1], (double)r.scale[2]);
+        return false;
+    }
+    *result = r;
+    return true;
+}
+
+static void accel_cal_window_reset(int8_t pos)
+{
+    cal_win_pos = pos;
+    cal_win_n = 0;
+    for (int a = 0; a < 3; a++) {
+        cal_win_sum[a] = 0.0f;
+    }
+}
+
+static accel_cal_pos_e accel_cal_next(void)
+{
+    for (int i = 0; i < ACCEL_CAL_POS_COUNT; i++) {
+        if (!(cal_captured & (1U << i))) {
+            return (accel_cal_pos_e)i;
+        }
+    }
+    return ACCEL_CAL_POS_COUNT;
+}
+
+/**
+ * @brief 开始引导校准
+ */
+bool accel_cal_start(const accel_cal_config_t *cfg)
+{
+    if (!cfg) {
+        cfg = &accel_cal_default_config;
+    }
+    if (cfg->block_samples < 16 || cfg->block_samples > 8000 || cfg->window_blocks == 0 ||
+        !(cfg->still_std_g > 0.0f) || !(cfg->still_drift_g > 0.0f)) {
+        printf("[accel_cal] Invalid config\r\n");
+        return false;
+    }
+
+    cal_state = ACCEL_CAL_STATE_OFF;
+    cal_cfg = *cfg;
+    memset(&cal_acc, 0, sizeof(cal_acc));
+    cal_pending_ready = false;
+    cal_overruns = 0;
+    cal_captured = 0;
+    accel_cal_window_reset(-1);
+    cal_state = ACCEL_CAL_STATE_COLLECTING;
+
+    printf("[accel_cal] Started: place the board %s and hold still\r\n", accel_cal_pos_name[0]);
+    return true;
+}
+
+void accel_cal_abort(void)
+{
+    cal_state = ACCEL_CAL_STATE_OFF;
+    cal_pending_ready = false;
+}
+
+/**
+ * @brief 样本路径：累加一个原始样本
+ */
+void accel_cal_push_sample(const int16_t raw[3])
+{
+    if (cal_state != ACCEL_CAL_STATE_COLLECTING) {
+        return;
+    }
+
+    for (int a = 0; a < 3; a++) {
+        const int32_t v = raw[a];
+        cal_acc.sum[a] += v;
+        cal_acc.sum_sq[a] += (int64_t)(v * v);
+    }
+    if (++cal_acc.n < cal_cfg.block_samples) {
+        return;
+    }
+
+    if (cal_pending_ready) {
+        cal_overruns++;
+    } else {
+        cal_pending = cal_acc;
+        __DMB();   // 块写完后再发布
+        cal_pending_ready = true;
+    }
+    memset(&cal_acc, 0, sizeof(cal_acc));
+}
+
+bool accel_cal_should_run(void *user)
+{
+    (void)user;
+    return cal_pending_ready;
+}
+
+/**
+ * @brief 调度器任务：处理一块
+ */
+void accel_cal_task(void *user)
+{
+    (void)user;
+    extern icm42688p_dev_t icm;
+
+    if (!cal_pending_ready) {
+        return;
+    }
+    __DMB();   // 先读标志再读块内容
+    const accel_cal_block_t blk = cal_pending;
+    __DMB();   // 块读完后才释放给样本路径
+    cal_pending_ready = false;
+    if (cal_state != ACCEL_CAL_STATE_COLLECTING || blk.n == 0) {
+        return;
+    }
+
+    const float scale = (icm.accel_scale > 0.0f) ? icm.accel_scale : 1.0f;
+    const float std_lim = cal_cfg.still_std_g * scale;
+    const float n = (float)blk.n;
+    float mean[3];
+    float norm_g = 0.0f;
+    bool still = true;
+    for (int a = 0; a < 3; a++) {
+        const int64_t s = blk.sum[a];
+        const int64_t var_n2 = (int64_t)blk.n * blk.sum_sq[a] - s * s;
+        mean[a] = (float)blk.sum[a] / n;
+        norm_g += (mean[a] / scale) * (mean[a] / scale);
+        if ((float)var_n2 > std_lim * std_lim * n * n) {
+            still = false;
+        }
+    }
+
+    // 朝向：主轴 >= 0.8g 且模长接近 1g
+    int axis = 0;
+    for (int a = 1; a < 3; a++) {
+        if (fabsf(mean[a]) > fabsf(mean[axis])) axis = a;
+    }
+    const bool upright = fabsf(mean[axis]) >= ACCEL_CAL_AXIS_MIN_G * scale &&
+                         fabsf(sqrtf(norm_g) - 1.0f) <= ACCEL_CAL_NORM_TOL_G;
+    const int8_t pos = (int8_t)(axis * 2 + (mean[axis] < 0.0f ? 1 : 0));
+
+    if (!still || !upright || (cal_captured & (1U << pos))) {
+        accel_cal_window_reset(-1);
+        return;
+    }
+    if (pos != cal_win_pos) {
+        accel_cal_window_reset(pos);
+    }
+
+    // 窗口内块均值极差
+    const float drift_lim = cal_cfg.still_drift_g * scale;
+    if (cal_win_n > 0) {
+        for (int a = 0; a < 3; a++) {
+            const float lo = (mean[a] < cal_win_min[a]) ? mean[a] : cal_win_min[a];
+            const float hi = (mean[a] > cal_win_max[a]) ? mean[a] : cal_win_max[a];
+            if (hi - lo > drift_lim) {
+                accel_cal_window_reset(pos);
+                break;
+            }
+        }
+    }
+    for (int a = 0; a < 3; a++) {
+        if (cal_win_n == 0) {
+            cal_win_min[a] = cal_win_max[a] = mean[a];
+        } else {
+            if (mean[a] < cal_win_min[a]) cal_win_min[a] = mean[a];
+            if (mean[a] > cal_win_max[a]) cal_win_max[a] = mean[a];
+        }
+        cal_win_sum[a] += mean[a];
+    }
+    if (++cal_win_n < cal_cfg.window_blocks) {
+        return;
+    }
+
+    // 采集该面
+    for (int a = 0; a < 3; a++) {
+        cal_mean[pos][a] = cal_win_sum[a] / (float)cal_win_n;
+    }
+    cal_captured |= (uint8_t)(1U << pos);
+    accel_cal_window_reset(-1);
+
+    const accel_cal_pos_e next = accel_cal_next();
+    if (next != ACCEL_CAL_POS_COUNT) {
+        printf("[accel_cal] Captured %s, next: %s\r\n", accel_cal_pos_name[pos], accel_cal_pos_name[next]);
+        return;
+    }
+
+    accel_cal_result_t r;
+    if (!accel_cal_solve((const float (*)[3])cal_mean, scale, &r)) {
+        cal_state = ACCEL_CAL_STATE_FAILED;
+        return;
+    }
+    cal_result = r;
+    cal_have_result = true;
+    accel_processing_set_calibration(r.matrix, r.bias);
+    cal_state = ACCEL_CAL_STATE_DONE;
+    printf("[accel_cal] Done: bias %.1f %.1f %.1f, scale %.1f %.1f %.1f LSB/g, residual %.4fg\r\n",
+           (double)r.bias[0], (double)r.bias[1], (double)r.bias[2],
+           (double)r.scale[0], (double)r.scale[1], (double)r.scale[2], (double)r.residual_g);
+}
+
+void accel_cal_get_status(accel_cal_status_t *status)
+{
+    if (!status) {
+        return;
+    }
+    status->state = cal_state;
+    status->captured = cal_captured;
+    status->next = accel_cal_next();
+    status->overruns = cal_overruns;
+}
+
+bool accel_cal_get_result(accel_cal_result_t *result)
+{
+    if (!cal_have_result || !result) {
+        return false;
+    }
+    *result = cal_result;
+    return true;
+}
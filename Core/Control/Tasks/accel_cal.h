@@ -0,0 +1,115 @@
+/**
+ * @file    accel_cal.h
+ * @brief   加速度计六面校准：零偏 + 各轴刻度 + 3x3 交叉轴矩阵（最小二乘）
+ * @note    取代 icm42688p_calibrate_accel 的“平均值减 1g”（只在 Z 轴严格朝上时成立，且不校刻度）。
+ *          模型：a = C * (raw - b)，C 为 3x3（g/LSB，含刻度与交叉轴），b 为零偏（计数），均在传感器系。
+ *          改写为 a = C * raw + d（d = -C * b）后每个输出轴对 [raw, 1] 线性，6 个姿态 × 3 轴 = 18 个方程、
+ *          12 个未知数；三行共用同一个 4x4 正规矩阵，求解一次消元即可。
+ *          引导流程（非阻塞）：
+ *          - accel_process_sample 把原始样本交给 accel_cal_push_sample，只做整数块累加
+ *          - accel_cal_task（调度器事件任务）逐块判断静止与朝向（主轴 ±1g），
+ *            同一朝向连续静止 window_blocks 块即采集该面，6 面采齐后求解、检查、下发到 task_acc
+ *          - 朝向任意顺序；请把飞控贴着方正的参考面（例如盒子）放置，C 会吸收放置面的倾斜
+ *          结果通过 accel_processing_set_calibration 下发，task_acc 把它与安装方向合成为
+ *          一次 3x3 乘加（见 task_acc.h）。
+ *          固件入口：RUN_MODE 5（test_flight_loop.c）中串口发送 'A' 启动，accel_cal_task 为清单中的 EVENT_CB 任务。
+ *
+ * @example
+ * accel_cal_start(NULL);
+ * // 任务清单（task_manifest.h）条目：每块 100 个 1kHz 样本
+ * EVENT_CB(accel_cal, accel_cal_task, accel_cal_should_run, NULL, TASK_PRIORITY_LOW, 100000, 10000)
+ * // 按提示依次放置 6 个面；完成后
+ * accel_cal_result_t r;
+ * if (accel_cal_get_result(&r)) { 保存 r.matrix / r.bias，下次启动调用 accel_processing_set_calibration }
+ */
+
+#ifndef ACCEL_CAL_H
+#define ACCEL_CAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    ACCEL_CAL_POS_X_UP = 0,     // +X 朝上（X 轴读 +1g）
+    ACCEL_CAL_POS_X_DOWN,
+    ACCEL_CAL_POS_Y_UP,
+    ACCEL_CAL_POS_Y_DOWN,
+    ACCEL_CAL_POS_Z_UP,         // 正常水平放置
+    ACCEL_CAL_POS_Z_DOWN,       // 倒置
+    ACCEL_CAL_POS_COUNT,
+} accel_cal_pos_e;
+
+typedef enum {
+    ACCEL_CAL_STATE_OFF = 0,
+    ACCEL_CAL_STATE_COLLECTING,     // 等待/采集各面
+    ACCEL_CAL_STATE_DONE,           // 已求解并下发
+    ACCEL_CAL_STATE_FAILED,         // 求解结果未通过检查（未下发）
+} accel_cal_state_e;
+
+typedef struct accel_cal_config_s {
+    uint16_t block_samples;         // 每块原始样本数（1kHz 下 100 = 0.1s）
+    uint8_t  window_blocks;         // 同一朝向连续静止块数（采集一面）
+    float    still_std_g;           // 块内标准差阈值（g）
+    float    still_drift_g;         // 窗口内块均值极差阈值（g）
+} accel_cal_config_t;
+
+typedef struct accel_cal_result_s {
+    float bias[3];                  // 零偏（计数，传感器系）
+    float scale[3];                 // 各轴刻度（LSB/g）= 1 / C[i][i]
+    float misalign[3][3];           // 交叉轴矩阵 C * diag(scale)，对角为 1
+    float matrix[3][3];             // C（g/LSB），a = C * (raw - bias)
+    float residual_g;               // 六面拟合 RMS 残差（g）
+} accel_cal_result_t;
+
+typedef struct accel_cal_status_s {
+    accel_cal_state_e state;
+    uint8_t captured;               // 已采集的面（bit = accel_cal_pos_e）
+    accel_cal_pos_e next;           // 建议下一面（未采集的第一个）
+    uint32_t overruns;              // 任务未及时取走而丢弃的块
+} accel_cal_status_t;
+
+/**
+ * @brief 六面最小二乘求解（纯函数，可在主机上直接测试）
+ * @param mean 各面静止平均值（原始计数，传感器系），按 accel_cal_pos_e 排列
+ * @param nominal_scale 标称刻度（LSB/g，例如 icm.accel_scale），仅用于归一化与合理性检查
+ * @param result 输出
+ * @return false=方程奇异或结果不合理（残差 > 0.05g、刻度偏离标称 > 20%、交叉轴项 > 0.1）
+ */
+bool accel_cal_solve(const float mean[ACCEL_CAL_POS_COUNT][3], float nominal_scale, accel_cal_result_t *result);
+
+/**
+ * @brief 开始引导校准
+ * @param cfg 参数，NULL=默认（100 样本/块、10 块、0.05g、0.02g）
+ * @return false=参数无效
+ */
+bool accel_cal_start(const accel_cal_config_t *cfg);
+
+/**
+ * @brief 中止引导校准（已下发的校准不变）
+ */
+void accel_cal_abort(void);
+
+/**
+ * @brief 样本路径：累加一个原始样本（传感器系、未补偿），由 accel_process_sample 调用
+ */
+void accel_cal_push_sample(const int16_t raw[3]);
+
+/**
+ * @brief 调度器判断回调：有待处理的块时返回 true
+ */
+bool accel_cal_should_run(void *user);
+
+/**
+ * @brief 调度器任务：处理一块（静止/朝向判断、采集、求解）
+ */
+void accel_cal_task(void *user);
+
+void accel_cal_get_status(accel_cal_status_t *status);
+
+/**
+ * @brief 取得最近一次成功的求解结果
+ * @return false=尚无结果
+ */
+bool accel_cal_get_result(accel_cal_result_t *result);
+
+#endif // ACCEL_CAL_H
@@ -0,0 +1,689 @@
+/**
+ * @file    gyro_cal.c
+ * @brief   陀螺仪在线零偏估计实现
+ */
+
+#include "gyro_cal.h"
+#include "bsp_flash.h"
+#include "dump_writer.h"
+#include "icm42688p_lib.h"
+#include "stm32f4xx_hal.h"
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define GYRO_CAL_MODEL_REF_C        25.0f   // 模型自变量 x = (T - 25) / 10，改善正规方程条件数
+#define GYRO_CAL_MODEL_SCALE_C      10.0f
+#define GYRO_CAL_LINEAR_SPAN_C      4.0f    // 分箱温度跨度达到此值才拟合一次项
+#define GYRO_CAL_QUAD_SPAN_C        15.0f   // 达到此值且至少 3 个分箱才拟合二次项
+#define GYRO_CAL_EXTRAPOLATE_C      5.0f    // 模型只在数据范围外 5°C 内外推，超出按边界取值
+
+// Flash 配置扇区按记录大小分槽，每次保存写入下一个空槽（128KB / 492B = 266 槽）
+#define GYRO_CAL_STORE_SLOTS        (BSP_FLASH_CONFIG_SIZE / sizeof(gyro_cal_store_t))
+_Static_assert(sizeof(gyro_cal_store_t) % 4 == 0, "gyro_cal_store_t must be whole flash words");
+
+// 一块原始样本的累加结果（样本路径 -> 任务）
+typedef struct {
+    int32_t sum[3];
+    int64_t sum_sq[3];
+    uint16_t n;
+    float temp_c;
+} gyro_cal_block_t;
+
+static const gyro_cal_config_t gyro_cal_default_config = {
+    .block_samples = 500,
+    .window_blocks = 8,
+    .still_std_dps = 2.0f,
+    .still_drift_dps = 0.3f,
+    .track_alpha = 0.25f,
+};
+
+static gyro_cal_config_t cal_cfg;
+static volatile gyro_cal_state_e cal_state = GYRO_CAL_STATE_OFF;
+static volatile bool cal_idle = true;
+static volatile float cal_temp_c = GYRO_CAL_MODEL_REF_C;
+
+// 样本路径累加器与交接缓冲区（单生产者/单消费者）
+static gyro_cal_block_t cal_acc;
+static gyro_cal_block_t cal_pending;
+static volatile bool cal_pending_ready = false;
+static volatile uint32_t cal_overruns = 0;
+
+// 静止窗口：块均值（计数）的和与极值
+static uint8_t cal_win_n = 0;
+static float cal_win_sum[3];
+static float cal_win_min[3];
+static float cal_win_max[3];
+static float cal_win_temp;
+
+// 零偏：bias_ref 为 ref_temp 下实测值，其他温度按模型差值修正
+static float cal_bias_ref[3];
+static float cal_bias_ref_temp;
+static float cal_bias_now[3];
+static float cal_last_temp;
+static uint32_t cal_windows = 0;
+
+// 零偏-温度分箱表与拟合结果
+static struct {
+    float temp_c;
+    float bias_dps[3];
+    uint16_t count;
+} cal_bins[GYRO_CAL_TEMP_BINS];
+static uint8_t cal_bins_used = 0;
+static int8_t cal_model_order = -1;
+static float cal_model[3][3];           // cal_model[axis] = {c0, c1, c2}
+static float cal_model_tmin, cal_model_tmax;
+static bool cal_model_dirty = false;
+
+// Flash 记录：下一个空槽与最近一次保存（或导入）时的拟合
+static bool cal_store_scanned = false;
+static uint32_t cal_store_next = 0;
+static uint8_t cal_saved_bins = 0;
+static int8_t cal_saved_order = -1;
+static uint32_t cal_saved_ms = 0;
+static gyro_cal_store_t cal_store_buf;      // 保存用缓冲区（492 字节，不放在任务栈上）
+
+static void gyro_cal_window_reset(void)
+{
+    cal_win_n = 0;
+    cal_win_temp = 0.0f;
+    for (int a = 0; a < 3; a++) {
+        cal_win_sum[a] = 0.0f;
+    }
+}
+
+/**
+ * @brief 3x3 以内的正规方程求解（高斯消元，列主元）
+ */
+static bool gyro_cal_solve(float a[3][3], float b[3], int n)
+{
+    for (int c = 0; c < n; c++) {
+        int p = c;
+        for (int r = c + 1; r < n; r++) {
+            if (fabsf(a[r][c]) > fabsf(a[p][c])) p = r;
+        }
+        if (fabsf(a[p][c]) < 1e-6f) {
+            return false;
+        }
+        if (p != c) {
+            for (int k = 0; k < n; k++) {
+                const float t = a[c][k]; a[c][k] = a[p][k]; a[p][k] = t;
+            }
+            const float t = b[c]; b[c] = b[p]; b[p] = t;
+        }
+        for (int r = c + 1; r < n; r++) {
+            const float f = a[r][c] / a[c][c];
+            for (int k = c; k < n; k++) a[r][k] -= f * a[c][k];
+            b[r] -= f * b[c];
+        }
+    }
+    for (int c = n - 1; c >= 0; c--) {
+        float s = b[c];
+        for (int k = c + 1; k < n; k++) s -= a[c][k] * b[k];
+        b[c] = s / a[c][c];
+    }
+    return true;
+}
+
+/**
+ * @brief 由分箱表拟合零偏-温度模型（每个分箱等权）
+ * @note 阶数按温度跨度选择：跨度不足时高阶项不可辨识
+ */
+static void gyro_cal_fit(void)
+{
+    float tmin = 1e9f, tmax = -1e9f;
+    uint8_t used = 0;
+    for (int i = 0; i < GYRO_CAL_TEMP_BINS; i++) {
+        if (cal_bins[i].count == 0) continue;
+        used++;
+        if (cal_bins[i].temp_c < tmin) tmin = cal_bins[i].temp_c;
+        if (cal_bins[i].temp_c > tmax) tmax = cal_bins[i].temp_c;
+    }
+    cal_bins_used = used;
+    if (used == 0) {
+        cal_model_order = -1;
+        return;
+    }
+
+    const float span = tmax - tmin;
+    int order = 0;
+    if (used >= 3 && span >= GYRO_CAL_QUAD_SPAN_C) {
+        order = 2;
+    } else if (used >= 2 && span >= GYRO_CAL_LINEAR_SPAN_C) {
+        order = 1;
+    }
+
+    for (; order >= 0; order--) {
+        const int n = order + 1;
+        float ata[3][3] = { { 0 } };
+        float atb[3][3] = { { 0 } };        // atb[axis][k]
+        for (int i = 0; i < GYRO_CAL_TEMP_BINS; i++) {
+            if (cal_bins[i].count == 0) continue;
+            const float x = (cal_bins[i].temp_c - GYRO_CAL_MODEL_REF_C) / GYRO_CAL_MODEL_SCALE_C;
+            const float phi[3] = { 1.0f, x, x * x };
+            for (int r = 0; r < n; r++) {
+                for (int c = 0; c < n; c++) ata[r][c] += phi[r] * phi[c];
+                for (int a = 0; a < 3; a++) atb[a][r] += phi[r] * cal_bins[i].bias_dps[a];
+            }
+        }
+
+        bool ok = true;
+        float coef[3][3] = { { 0 } };
+        for (int a = 0; a < 3 && ok; a++) {
+            float m[3][3];
+            memcpy(m, ata, sizeof(m));
+            float rhs[3] = { atb[a][0], atb[a][1], atb[a][2] };
+            ok = gyro_cal_solve(m, rhs, n);
+            for (int k = 0; k < n; k++) coef[a][k] = rhs[k];
+        }
+        if (ok) {
+            memcpy(cal_model, coef, sizeof(cal_model));
+            cal_model_order = (int8_t)order;
+            cal_model_tmin = tmin;
+            cal_model_tmax = tmax;
+            return;
+        }
+    }
+    cal_model_order = -1;
+}
+
+static void gyro_cal_model_eval(float temp_c, float out[3])
+{
+    if (temp_c < cal_model_tmin - GYRO_CAL_EXTRAPOLATE_C) temp_c = cal_model_tmin - GYRO_CAL_EXTRAPOLATE_C;
+    if (temp_c > cal_model_tmax + GYRO_CAL_EXTRAPOLATE_C) temp_c = cal_model_tmax + GYRO_CAL_EXTRAPOLATE_C;
+    const float x = (temp_c - GYRO_CAL_MODEL_REF_C) / GYRO_CAL_MODEL_SCALE_C;
+    for (int a = 0; a < 3; a++) {
+        out[a] = cal_model[a][0] + x * (cal_model[a][1] + x * cal_model[a][2]);
+    }
+}
+
+static void gyro_cal_bin_add(float temp_c, const float bias_dps[3])
+{
+    int i = (int)floorf((temp_c - GYRO_CAL_TEMP_BIN_MIN_C) / GYRO_CAL_TEMP_BIN_WIDTH_C);
+    if (i < 0) i = 0;
+    if (i >= GYRO_CAL_TEMP_BINS) i = GYRO_CAL_TEMP_BINS - 1;
+
+    if (cal_bins[i].count < GYRO_CAL_BIN_WEIGHT_MAX) {
+        cal_bins[i].count++;
+    }
+    const float w = 1.0f / (float)cal_bins[i].count;
+    cal_bins[i].temp_c += w * (temp_c - cal_bins[i].temp_c);
+    for (int a = 0; a < 3; a++) {
+        cal_bins[i].bias_dps[a] += w * (bias_dps[a] - cal_bins[i].bias_dps[a]);
+    }
+    cal_model_dirty = true;
+    gyro_cal_fit();
+}
+
+/**
+ * @brief 按当前温度更新零偏并写入 icm.gyro_offset
+ * @note  样本路径（实时通道或中断）读 icm.gyro_offset 时可能抢占本任务：
+ *        三轴先算好，再在关中断下一次写入，前端不会用到新旧混合的零偏
+ */
+static void gyro_cal_apply(float temp_c)
+{
+    extern icm42688p_dev_t icm;
+
+    if (cal_state == GYRO_CAL_STATE_READY) {
+        for (int a = 0; a < 3; a++) cal_bias_now[a] = cal_bias_ref[a];
+        if (cal_model_order >= 1) {
+            float m_now[3], m_ref[3];
+            gyro_cal_model_eval(temp_c, m_now);
+            gyro_cal_model_eval(cal_bias_ref_temp, m_ref);
+            for (int a = 0; a < 3; a++) cal_bias_now[a] += m_now[a] - m_ref[a];
+        }
+    } else if (cal_state == GYRO_CAL_STATE_MODEL) {
+        gyro_cal_model_eval(temp_c, cal_bias_now);
+    } else {
+        return;
+    }
+
+    const float scale = icm.gyro_scale;
+    if (!(scale > 0.0f)) {
+        return;
+    }
+    int16_t offset[3];
+    for (int a = 0; a < 3; a++) {
+        float c = cal_bias_now[a] * scale;
+        if (c > 32767.0f) c = 32767.0f;
+        if (c < -32768.0f) c = -32768.0f;
+        offset[a] = (int16_t)lrintf(c);
+    }
+
+    __disable_irq();
+    icm.gyro_offset[0] = offset[0];
+    icm.gyro_offset[1] = offset[1];
+    icm.gyro_offset[2] = offset[2];
+    __enable_irq();
+}
+
+/**
+ * @brief 接受一个静止窗口
+ */
+static void gyro_cal_accept_window(void)
+{
+    extern icm42688p_dev_t icm;
+    const float k = 1.0f / ((icm.gyro_scale > 0.0f) ? icm.gyro_scale : 1.0f);
+    const float inv_n = 1.0f / (float)cal_win_n;
+    const float temp_c = cal_win_temp * inv_n;
+
+    float est[3];
+    for (int a = 0; a < 3; a++) {
+        est[a] = cal_win_sum[a] * inv_n * k;
+    }
+
+    if (cal_state == GYRO_CAL_STATE_READY) {
+        // 旧零偏先按模型折算到本窗口温度，再向实测值靠拢
+        float prev[3];
+        for (int a = 0; a < 3; a++) prev[a] = cal_bias_ref[a];
+        if (cal_model_order >= 1) {
+            float m_now[3], m_ref[3];
+            gyro_cal_model_eval(temp_c, m_now);
+            gyro_cal_model_eval(cal_bias_ref_temp, m_ref);
+            for (int a = 0; a < 3; a++) prev[a] += m_now[a] - m_ref[a];
+        }
+        for (int a = 0; a < 3; a++) {
+            cal_bias_ref[a] = prev[a] + cal_cfg.track_alpha * (est[a] - prev[a]);
+        }
+    } else {
+        // 首个实测窗口（无论此前是否有模型）直接采用
+        for (int a = 0; a < 3; a++) cal_bias_ref[a] = est[a];
+        cal_state = GYRO_CAL_STATE_READY;
+        printf("[gyro_cal] Bias %.3f %.3f %.3f dps at %.1fC\r\n",
+               (double)est[0], (double)est[1], (double)est[2], (double)temp_c);
+    }
+    cal_bias_ref_temp = temp_c;
+    cal_windows++;
+
+    gyro_cal_bin_add(temp_c, est);
+}
+
+/**
+ * @brief 初始化
+ */
+bool gyro_cal_init(const gyro_cal_config_t *cfg)
+{
+    if (!cfg) {
+        cfg = &gyro_cal_default_config;
+    }
+    // Σx 在 int32 内：|x| <= 32768，最多 65535 块样本时可能溢出，限制块长
+    if (cfg->block_samples < 16 || cfg->block_samples > 8000 || cfg->window_blocks == 0 ||
+        !(cfg->still_std_dps > 0.0f) || !(cfg->still_drift_dps > 0.0f) ||
+        !(cfg->track_alpha > 0.0f && cfg->track_alpha <= 1.0f)) {
+        printf("[gyro_cal] Invalid config\r\n");
+        return false;
+    }
+
+    cal_state = GYRO_CAL_STATE_OFF;
+    cal_cfg = *cfg;
+    memset(&cal_acc, 0, sizeof(cal_acc));
+    memset(&cal_pending, 0, sizeof(cal_pending));
+    cal_pending_ready = false;
+    cal_overruns = 0;
+    cal_idle = true;
+    gyro_cal_window_reset();
+
+    memset(cal_bias_ref, 0, sizeof(cal_bias_ref));
+    memset(cal_bias_now, 0, sizeof(cal_bias_now));
+    cal_bias_ref_temp = GYRO_CAL_MODEL_REF_C;
+    cal_last_temp = cal_temp_c;
+    cal_windows = 0;
+
+    memset(cal_bins, 0, sizeof(cal_bins));
+    cal_bins_used = 0;
+    cal_model_order = -1;
+    cal_model_dirty = false;
+
+    cal_store_scanned = false;
+    cal_saved_bins = 0;
+    cal_saved_order = -1;
+    cal_saved_ms = HAL_GetTick();
+
+    cal_state = GYRO_CAL_STATE_WAIT_STILL;
+    printf("[gyro_cal] Initialized: %u samples/block, %u blocks/window\r\n",
+           cal_cfg.block_samples, cal_cfg.window_blocks);
+    return true;
+}
+
+void gyro_cal_stop(void)
+{
+    cal_state = GYRO_CAL_STATE_OFF;
+    cal_pending_ready = false;
+}
+
+/**
+ * @brief 样本路径：累加一个原始样本
+ */
+void gyro_cal_push_sample(const int16_t raw[3])
+{
+    if (cal_state == GYRO_CAL_STATE_OFF) {
+        return;
+    }
+
+    for (int a = 0; a < 3; a++) {
+        const int32_t v = raw[a];
+        cal_acc.sum[a] += v;
+        cal_acc.sum_sq[a] += (int64_t)(v * v);
+    }
+    if (++cal_acc.n < cal_cfg.block_samples) {
+        return;
+    }
+
+    // 任务尚未取走上一块时丢弃本块（不覆盖正在读取的缓冲区）
+    if (cal_pending_ready) {
+        cal_overruns++;
+    } else {
+        cal_acc.temp_c = cal_temp_c;
+        cal_pending = cal_acc;
+        __DMB();   // 块写完后再发布
+        cal_pending_ready = true;
+    }
+    memset(&cal_acc, 0, sizeof(cal_acc));
+}
+
+void gyro_cal_set_temperature(float temp_c)
+{
+    if (isfinite(temp_c)) {
+        cal_temp_c = temp_c;
+    }
+}
+
+void gyro_cal_set_idle(bool idle)
+{
+    cal_idle = idle;
+}
+
+bool gyro_cal_should_run(void *user)
+{
+    (void)user;
+    return cal_pending_ready;
+}
+
+/**
+ * @brief 调度器任务：处理一块
+ */
+void gyro_cal_task(void *user)
+{
+    (void)user;
+    extern icm42688p_dev_t icm;
+
+    if (!cal_pending_ready) {
+        return;
+    }
+    __DMB();   // 先读标志再读块内容
+    const gyro_cal_block_t blk = cal_pending;
+    __DMB();   // 块读完后才释放给样本路径
+    cal_pending_ready = false;
+    if (cal_state == GYRO_CAL_STATE_OFF || blk.n == 0) {
+        return;
+    }
+    cal_last_temp = blk.temp_c;
+
+    if (!cal_idle) {
+        // 解锁：不接受新窗口，只按温度修正
+        gyro_cal_window_reset();
+        gyro_cal_apply(blk.temp_c);
+        return;
+    }
+
+    // 块内方差：n*Σx² - (Σx)²，整数计算避免大数相减的浮点误差
+    const float scale = (icm.gyro_scale > 0.0f) ? icm.gyro_scale : 1.0f;
+    const float std_lim = cal_cfg.still_std_dps * scale;
+    const float n = (float)blk.n;
+    bool still = true;
+    float mean[3];
+    for (int a = 0; a < 3; a++) {
+        const int64_t s = blk.sum[a];
+        const int64_t var_n2 = (int64_t)blk.n * blk.sum_sq[a] - s * s;
+        mean[a] = (float)blk.sum[a] / n;
+        if ((float)var_n2 > std_lim * std_lim * n * n) {
+            still = false;
+        }
+    }
+
+    if (!still) {
+        gyro_cal_window_reset();
+        gyro_cal_apply(blk.temp_c);
+        return;
+    }
+
+    // 窗口内块均值极差：超限时以本块重新开始窗口
+    const float drift_lim = cal_cfg.still_drift_dps * scale;
+    if (cal_win_n > 0) {
+        for (int a = 0; a < 3; a++) {
+            const float lo = (mean[a] < cal_win_min[a]) ? mean[a] : cal_win_min[a];
+            const float hi = (mean[a] > cal_win_max[a]) ? mean[a] : cal_win_max[a];
+            if (hi - lo > drift_lim) {
+                gyro_cal_window_reset();
+                break;
+            }
+        }
+    }
+    for (int a = 0; a < 3; a++) {
+        if (cal_win_n == 0) {
+            cal_win_min[a] = cal_win_max[a] = mean[a];
+        } else {
+            if (mean[a] < cal_win_min[a]) cal_win_min[a] = mean[a];
+            if (mean[a] > cal_win_max[a]) cal_win_max[a] = mean[a];
+        }
+        cal_win_sum[a] += mean[a];
+    }
+    cal_win_temp += blk.temp_c;
+
+    if (++cal_win_n >= cal_cfg.window_blocks) {
+        gyro_cal_accept_window();
+        gyro_cal_window_reset();
+    }
+    gyro_cal_apply(blk.temp_c);
+}
+
+bool gyro_cal_is_ready(void)
+{
+    return cal_state == GYRO_CAL_STATE_MODEL || cal_state == GYRO_CAL_STATE_READY;
+}
+
+void gyro_cal_get_status(gyro_cal_status_t *status)
+{
+    if (!status) {
+        return;
+    }
+    status->state = cal_state;
+    for (int a = 0; a < 3; a++) {
+        status->bias_dps[a] = cal_bias_now[a];
+    }
+    status->temp_c = cal_last_temp;
+    status->model_order = cal_model_order;
+    status->bins_used = cal_bins_used;
+    status->windows = cal_windows;
+    status->overruns = cal_overruns;
+}
+
+bool gyro_cal_predict(float temp_c, float bias_dps[3])
+{
+    if (cal_model_order < 0 || !bias_dps) {
+        return false;
+    }
+    gyro_cal_model_eval(temp_c, bias_dps);
+    return true;
+}
+
+bool gyro_cal_model_changed(void)
+{
+    return cal_model_dirty;
+}
+
+void gyro_cal_export(gyro_cal_store_t *store)
+{
+    if (!store) {
+        return;
+    }
+    memset(store, 0, sizeof(*store));
+    store->magic = GYRO_CAL_STORE_MAGIC;
+    store->version = GYRO_CAL_STORE_VERSION;
+    for (int i = 0; i < GYRO_CAL_TEMP_BINS; i++) {
+        store->bin[i].temp_c = cal_bins[i].temp_c;
+        for (int a = 0; a < 3; a++) {
+            store->bin[i].bias_dps[a] = cal_bins[i].bias_dps[a];
+        }
+        store->bin[i].count = cal_bins[i].count;
+    }
+    store->crc = crc16_ccitt((const uint8_t *)store, offsetof(gyro_cal_store_t, crc));
+    cal_model_dirty = false;
+}
+
+/**
+ * @brief 记录校验：magic、版本、CRC 与每个分箱的取值范围
+ */
+static bool gyro_cal_store_valid(const gyro_cal_store_t *store)
+{
+    if (!store || store->magic != GYRO_CAL_STORE_MAGIC || store->version != GYRO_CAL_STORE_VERSION ||
+        store->crc != crc16_ccitt((const uint8_t *)store, offsetof(gyro_cal_store_t, crc))) {
+        return false;
+    }
+    for (int i = 0; i < GYRO_CAL_TEMP_BINS; i++) {
+        if (store->bin[i].count > GYRO_CAL_BIN_WEIGHT_MAX || !isfinite(store->bin[i].temp_c) ||
+            !isfinite(store->bin[i].bias_dps[0]) || !isfinite(store->bin[i].bias_dps[1]) ||
+            !isfinite(store->bin[i].bias_dps[2])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool gyro_cal_import(const gyro_cal_store_t *store)
+{
+    if (cal_state == GYRO_CAL_STATE_OFF) {
+        printf("[gyro_cal] Not initialized!\r\n");
+        return false;
+    }
+    if (!gyro_cal_store_valid(store)) {
+        printf("[gyro_cal] Stored model invalid, ignored\r\n");
+        return false;
+    }
+
+    for (int i = 0; i < GYRO_CAL_TEMP_BINS; i++) {
+        cal_bins[i].temp_c = store->bin[i].temp_c;
+        for (int a = 0; a < 3; a++) {
+            cal_bins[i].bias_dps[a] = store->bin[i].bias_dps[a];
+        }
+        cal_bins[i].count = store->bin[i].count;
+    }
+    cal_model_dirty = false;
+    gyro_cal_fit();
+    if (cal_model_order >= 0 && cal_state == GYRO_CAL_STATE_WAIT_STILL) {
+        cal_state = GYRO_CAL_STATE_MODEL;
+    }
+    cal_saved_bins = cal_bins_used;
+    cal_saved_order = cal_model_order;
+    cal_saved_ms = HAL_GetTick();
+    printf("[gyro_cal] Loaded model: %u bins, order %d\r\n", cal_bins_used, cal_model_order);
+    return true;
+}
+
+// ============================================================================
+// Flash 持久化：配置扇区内追加记录，读取时取最后一条有效记录
+// ============================================================================
+
+static const gyro_cal_store_t *gyro_cal_store_slot(uint32_t i)
+{
+    return (const gyro_cal_store_t *)(const void *)(BSP_Flash_ConfigBase() + i * sizeof(gyro_cal_store_t));
+}
+
+static bool gyro_cal_slot_blank(uint32_t i)
+{
+    const uint32_t *w = (const uint32_t *)(const void *)gyro_cal_store_slot(i);
+    for (uint32_t k = 0; k < sizeof(gyro_cal_store_t) / 4; k++) {
+        if (w[k] != 0xFFFFFFFFUL) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 扫描配置扇区：返回最后一条有效记录，并定位下一个空槽
+ * @note  记录按槽顺序写入，第一个 magic 仍为擦除值的槽之后都未写过；
+ *        掉电写了一半的记录 CRC 不符，被跳过
+ */
+static const gyro_cal_store_t *gyro_cal_store_scan(void)
+{
+    const gyro_cal_store_t *latest = NULL;
+    uint32_t i = 0;
+    for (; i < GYRO_CAL_STORE_SLOTS; i++) {
+        const gyro_cal_store_t *rec = gyro_cal_store_slot(i);
+        if (rec->magic == 0xFFFFFFFFUL) {
+            break;
+        }
+        if (gyro_cal_store_valid(rec)) {
+            latest = rec;
+        }
+    }
+    cal_store_next = i;
+    cal_store_scanned = true;
+    return latest;
+}
+
+bool gyro_cal_load(void)
+{
+    const gyro_cal_store_t *rec = gyro_cal_store_scan();
+    if (!rec) {
+        printf("[gyro_cal] No stored model in flash\r\n");
+        return false;
+    }
+    return gyro_cal_import(rec);
+}
+
+bool gyro_cal_save(void)
+{
+    if (cal_state == GYRO_CAL_STATE_OFF) {
+        return false;
+    }
+    if (!cal_store_scanned) {
+        (void)gyro_cal_store_scan();
+    }
+    // 跳过不是全擦除状态的槽（上次掉电时可能只写了开头几个字）
+    while (cal_store_next < GYRO_CAL_STORE_SLOTS && !gyro_cal_slot_blank(cal_store_next)) {
+        cal_store_next++;
+    }
+
+    // 失败时也记下本次尝试，按保存间隔重试，不会每轮都阻塞擦除
+    cal_saved_bins = cal_bins_used;
+    cal_saved_order = cal_model_order;
+    cal_saved_ms = HAL_GetTick();
+
+    if (cal_store_next >= GYRO_CAL_STORE_SLOTS) {
+        if (!BSP_Flash_ConfigErase()) {
+            printf("[gyro_cal] Flash erase failed\r\n");
+            return false;
+        }
+        cal_store_next = 0;
+    }
+
+    gyro_cal_export(&cal_store_buf);
+    const uint32_t slot = cal_store_next++;
+    if (!BSP_Flash_ConfigWrite(slot * sizeof(gyro_cal_store_t), &cal_store_buf, sizeof(cal_store_buf))) {
+        cal_model_dirty = true;
+        printf("[gyro_cal] Flash write failed (slot %lu)\r\n", (unsigned long)slot);
+        return false;
+    }
+    printf("[gyro_cal] Model saved: %u bins, order %d (slot %lu)\r\n",
+           cal_bins_used, cal_model_order, (unsigned long)slot);
+    return true;
+}
+
+bool gyro_cal_save_should_run(void *user)
+{
+    (void)user;
+    if (cal_state == GYRO_CAL_STATE_OFF || !cal_idle || !cal_model_dirty) {
+        return false;
+    }
+    if (cal_bins_used != cal_saved_bins || cal_model_order != cal_saved_order) {
+        return true;
+    }
+    return (uint32_t)(HAL_GetTick() - cal_saved_ms) >= GYRO_CAL_SAVE_INTERVAL_MS;
+}
+
+void gyro_cal_save_task(void *user)
+{
+    (void)user;
+    (void)gyro_cal_save();
+}
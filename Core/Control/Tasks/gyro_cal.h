@@ -0,0 +1,178 @@
+/**
+ * @file    gyro_cal.h
+ * @brief   陀螺仪在线零偏估计：非阻塞静止检测 + 空闲期持续细化 + 零偏-温度模型
+ * @note    取代启动时阻塞 0.5s 的 icm42688p_calibrate_gyro：
+ *          - 样本路径（gyro_process_sample）只做整数累加：每 block_samples 个原始样本
+ *            形成一块（Σx、Σx²），交给调度器任务，不做任何判断
+ *          - 调度器任务（gyro_cal_task，事件型，gyro_cal_should_run 判断）逐块处理：
+ *            块内标准差低于阈值且连续 window_blocks 块的均值极差低于阈值时认为静止，
+ *            窗口均值即为该温度下的零偏
+ *          - 首个静止窗口直接写入 icm.gyro_offset；之后每个空闲（未解锁）静止窗口按 track_alpha
+ *            细化，并记入按 4°C 分箱的零偏-温度表，按温度跨度拟合常数/一次/二次模型
+ *          - 每块按当前芯片温度用模型修正零偏（解锁飞行中也生效），冷启动升温时漂移更小
+ *          - 分箱表导出为带 CRC 的 gyro_cal_store_t，gyro_cal_save 追加写入 Flash 配置扇区
+ *            （bsp_flash.h，扇区写满才擦除），启动时 gyro_cal_load 取最新的有效记录导入，
+ *            第一块就按模型给出零偏（GYRO_CAL_STATE_MODEL），无需等待静止；
+ *            gyro_cal_save_task 在空闲（未解锁）且拟合变化时保存
+ *          零偏以°/s、传感器系保存（与量程无关），写入 icm.gyro_offset 时按当前刻度换算为计数，
+ *          三轴在关中断下一起写入（样本路径可在实时通道/中断中抢占任务）。
+ *          固件接入：test_flight_loop.c 作为清单中的 EVENT_CB 任务；test_gyro.c、test_attitude_full.c
+ *          没有调度器，在主循环中轮询 gyro_cal_should_run/gyro_cal_task 与 gyro_cal_save_should_run/gyro_cal_save_task。
+ *
+ * @example
+ * gyro_cal_init(NULL);                     // 默认参数
+ * gyro_cal_load();                         // 可选：Flash 中上次保存的温度模型
+ * // 任务清单（task_manifest.h）条目：每块 500 样本，8kHz 下 62.5ms；保存任务不限执行时间（擦除约 1~2 秒）
+ * EVENT_CB(gyro_cal, gyro_cal_task, gyro_cal_should_run, NULL, TASK_PRIORITY_LOW, 62500, 100)
+ * EVENT_CB(gyro_cal_save, gyro_cal_save_task, gyro_cal_save_should_run, NULL, TASK_PRIORITY_IDLE, 0, 0)
+ * // 解锁/上锁时（解锁期间不保存）
+ * gyro_cal_set_idle(!armed);
+ */
+
+#ifndef GYRO_CAL_H
+#define GYRO_CAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define GYRO_CAL_TEMP_BINS          24          // 分箱个数
+#define GYRO_CAL_TEMP_BIN_MIN_C     (-20.0f)    // 第一个分箱的下沿
+#define GYRO_CAL_TEMP_BIN_WIDTH_C   4.0f        // 分箱宽度，覆盖 -20..76°C
+#define GYRO_CAL_BIN_WEIGHT_MAX     8U          // 分箱均值的最大权重（旧数据逐步被新窗口替换）
+
+#define GYRO_CAL_STORE_MAGIC        0x47434131UL    // "GCA1"
+#define GYRO_CAL_STORE_VERSION      1U
+#define GYRO_CAL_SAVE_INTERVAL_MS   600000U         // 拟合未变、只有分箱细化时，最多每 10 分钟保存一次
+
+typedef enum {
+    GYRO_CAL_STATE_OFF = 0,         // 未初始化，样本路径不累加
+    GYRO_CAL_STATE_WAIT_STILL,      // 尚无零偏，等待静止窗口
+    GYRO_CAL_STATE_MODEL,           // 零偏来自温度模型，等待静止窗口确认
+    GYRO_CAL_STATE_READY,           // 零偏已由静止窗口测得，空闲时持续细化
+} gyro_cal_state_e;
+
+typedef struct gyro_cal_config_s {
+    uint16_t block_samples;         // 每块原始样本数（8kHz 下 500 = 62.5ms）
+    uint8_t  window_blocks;         // 静止窗口块数
+    float    still_std_dps;         // 块内标准差阈值（°/s）
+    float    still_drift_dps;       // 窗口内块均值极差阈值（°/s）
+    float    track_alpha;           // 空闲细化系数（每个静止窗口，0..1]
+} gyro_cal_config_t;
+
+typedef struct gyro_cal_status_s {
+    gyro_cal_state_e state;
+    float    bias_dps[3];           // 当前温度下的零偏（传感器系，°/s）
+    float    temp_c;                // 最近一块的芯片温度
+    int8_t   model_order;           // 温度模型阶数：-1=无，0/1/2
+    uint8_t  bins_used;             // 有数据的温度分箱数
+    uint32_t windows;               // 已接受的静止窗口数
+    uint32_t overruns;              // 任务未及时取走而丢弃的块
+} gyro_cal_status_t;
+
+/**
+ * @brief 持久化数据（gyro_cal_save 写入 Flash 配置扇区，每次保存追加一条）
+ */
+typedef struct gyro_cal_store_s {
+    uint32_t magic;                 // GYRO_CAL_STORE_MAGIC
+    uint16_t version;               // GYRO_CAL_STORE_VERSION
+    uint16_t reserved;
+    struct {
+        float    temp_c;            // 分箱内平均温度
+        float    bias_dps[3];       // 分箱内平均零偏（°/s，传感器系）
+        uint16_t count;             // 权重，0=空
+        uint16_t reserved;
+    } bin[GYRO_CAL_TEMP_BINS];
+    uint32_t crc;                   // CRC-16/CCITT-FALSE（覆盖之前的全部字节，高 16 位为 0）
+} gyro_cal_store_t;
+
+/**
+ * @brief 初始化（清空零偏与温度表，不修改 icm.gyro_offset）
+ * @param cfg 参数，NULL=默认（500 样本/块、8 块窗口、2°/s、0.3°/s、0.25）
+ * @return false=参数无效（保持原状态）
+ */
+bool gyro_cal_init(const gyro_cal_config_t *cfg);
+
+/**
+ * @brief 关闭估计器（样本路径停止累加，icm.gyro_offset 保持当前值）
+ */
+void gyro_cal_stop(void);
+
+/**
+ * @brief 样本路径：累加一个原始样本（传感器系、未补偿），由 gyro_process_sample 调用
+ */
+void gyro_cal_push_sample(const int16_t raw[3]);
+
+/**
+ * @brief 更新芯片温度（FIFO 批量路径每批调用一次，或由读温度的任务调用）
+ */
+void gyro_cal_set_temperature(float temp_c);
+
+/**
+ * @brief 空闲标志：true=未解锁（允许用静止窗口更新零偏与温度表）
+ * @note 解锁期间只按温度模型修正，不接受新窗口；默认 true
+ */
+void gyro_cal_set_idle(bool idle);
+
+/**
+ * @brief 调度器判断回调：有待处理的块时返回 true
+ */
+bool gyro_cal_should_run(void *user);
+
+/**
+ * @brief 调度器任务：处理一块（静止判定、零偏细化、温度模型、写 icm.gyro_offset）
+ */
+void gyro_cal_task(void *user);
+
+/**
+ * @brief 是否已有可用零偏（模型或实测）
+ */
+bool gyro_cal_is_ready(void);
+
+void gyro_cal_get_status(gyro_cal_status_t *status);
+
+/**
+ * @brief 用温度模型预测零偏
+ * @return false=尚无模型
+ */
+bool gyro_cal_predict(float temp_c, float bias_dps[3]);
+
+/**
+ * @brief 温度表自上次导出后是否有变化（应在上锁时保存）
+ */
+bool gyro_cal_model_changed(void);
+
+/**
+ * @brief 导出温度表（清除变化标志）
+ */
+void gyro_cal_export(gyro_cal_store_t *store);
+
+/**
+ * @brief 导入温度表（校验 magic/版本/CRC），成功后进入 GYRO_CAL_STATE_MODEL
+ * @return false=数据无效（保持当前状态）
+ */
+bool gyro_cal_import(const gyro_cal_store_t *store);
+
+/**
+ * @brief 从 Flash 配置扇区导入最新的有效记录（gyro_cal_init 之后调用）
+ * @return false=没有有效记录（magic/版本/CRC 不符的记录被跳过），保持当前状态
+ */
+bool gyro_cal_load(void);
+
+/**
+ * @brief 导出温度表并追加写入 Flash 配置扇区；扇区写满时先擦除（约 1~2 秒，期间中断一起停顿）
+ * @return false=擦除或写入失败（变化标志保留，GYRO_CAL_SAVE_INTERVAL_MS 后重试）
+ */
+bool gyro_cal_save(void);
+
+/**
+ * @brief 保存判断回调：空闲（未解锁）、温度表有变化，且拟合（分箱数/阶数）变了
+ *        或距上次保存超过 GYRO_CAL_SAVE_INTERVAL_MS
+ */
+bool gyro_cal_save_should_run(void *user);
+
+/**
+ * @brief 保存任务：调用 gyro_cal_save（只在上锁时运行，阻塞可以接受）
+ */
+void gyro_cal_save_task(void *user);
+
+#endif // GYRO_CAL_H
@@ -0,0 +1,110 @@
+/**
+ * @file    imu_frontend.c
+ * @brief   IMU 定点前端实现
+ */
+
+#include "imu_frontend.h"
+#include "arm_math.h"
+#include <math.h>
+
+#define ROT_ONE     (1 << IMU_FRONTEND_ROT_Q)
+
+static uint32_t pack16(int16_t lo, int16_t hi)
+{
+    return (uint32_t)(uint16_t)lo | ((uint32_t)(uint16_t)hi << 16);
+}
+
+static void imu_frontend_set_identity(imu_frontend_t *fe)
+{
+    for (int i = 0; i < 3; i++) {
+        const int16_t d0 = (i == 0) ? ROT_ONE : 0;
+        const int16_t d1 = (i == 1) ? ROT_ONE : 0;
+        fe->rot_xy[i] = pack16(d0, d1);
+        fe->rot_z[i] = (i == 2) ? ROT_ONE : 0;
+        fe->perm_src[i] = (uint8_t)i;
+        fe->perm_neg[i] = false;
+    }
+    fe->mode = SENSOR_ROTATION_IDENTITY;
+}
+
+/**
+ * @brief 初始化为单位旋转、刻度未设置
+ */
+void imu_frontend_init(imu_frontend_t *fe)
+{
+    imu_frontend_set_identity(fe);
+    fe->lsb_per_unit = 0.0f;
+    fe->unit_per_lsb = 1.0f;
+}
+
+/**
+ * @brief 设置传感器系 → 机体系的旋转矩阵
+ */
+bool imu_frontend_set_rotation(imu_frontend_t *fe, const float m[3][3])
+{
+    sensor_rotation_t rot;
+    if (!sensor_rotation_from_matrix(&rot, m)) {
+        return false;
+    }
+    imu_frontend_set_alignment(fe, &rot);
+    return true;
+}
+
+/**
+ * @brief 设置预编译的安装方向
+ */
+void imu_frontend_set_alignment(imu_frontend_t *fe, const sensor_rotation_t *rot)
+{
+    imu_frontend_set_identity(fe);
+    if (rot->kind == SENSOR_ROTATION_IDENTITY) {
+        return;
+    }
+
+    int16_t q[3][3];
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            long r = lroundf(rot->m[i][j] * (float)ROT_ONE);
+            if (r > ROT_ONE) r = ROT_ONE;
+            if (r < -ROT_ONE) r = -ROT_ONE;
+            q[i][j] = (int16_t)r;
+        }
+        fe->rot_xy[i] = pack16(q[i][0], q[i][1]);
+        fe->rot_z[i] = q[i][2];
+        fe->perm_src[i] = rot->src[i];
+        fe->perm_neg[i] = rot->sign[i] < 0;
+    }
+    fe->mode = rot->kind;
+}
+
+/**
+ * @brief 整数前端：零偏补偿 + 饱和 + 旋转
+ */
+void imu_frontend_apply(const imu_frontend_t *fe, const int16_t raw[3], const int16_t offset[3], int16_t out[3])
+{
+    // x/y 两轴一条饱和减法，z 单独饱和
+    const uint32_t xy = __QSUB16(pack16(raw[0], raw[1]), pack16(offset[0], offset[1]));
+    const int32_t z = __SSAT((int32_t)raw[2] - (int32_t)offset[2], 16);
+
+    if (fe->mode == SENSOR_ROTATION_IDENTITY) {
+        out[0] = (int16_t)(xy & 0xFFFFU);
+        out[1] = (int16_t)(xy >> 16);
+        out[2] = (int16_t)z;
+        return;
+    }
+
+    if (fe->mode == SENSOR_ROTATION_PERMUTE) {
+        // 取反时 -32768 饱和为 32767，与矩阵路径的 __SSAT 一致
+        const int32_t c[3] = { (int16_t)(xy & 0xFFFFU), (int16_t)(xy >> 16), z };
+        for (int i = 0; i < 3; i++) {
+            const int32_t v = c[fe->perm_src[i]];
+            out[i] = (int16_t)(fe->perm_neg[i] ? __SSAT(-v, 16) : v);
+        }
+        return;
+    }
+
+    // |m| <= 2^14：|x*m0 + y*m1 + z*m2| <= 3 * 2^29 < 2^31，不会溢出
+    for (int i = 0; i < 3; i++) {
+        const int32_t acc = (int32_t)__SMUAD(xy, fe->rot_xy[i]) + z * fe->rot_z[i];
+        out[i] = (int16_t)__SSAT((acc + (1 << (IMU_FRONTEND_ROT_Q - 1))) >> IMU_FRONTEND_ROT_Q, 16);
+    }
+}
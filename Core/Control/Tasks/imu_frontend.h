@@ -0,0 +1,72 @@
+/**
+ * @file    imu_frontend.h
+ * @brief   IMU 定点前端：零偏补偿 + 饱和 + 轴向旋转（整数，Q14）+ 刻度倒数缓存
+ * @note    每个样本只做整数运算：x/y 打包后用 __QSUB16 一次完成两轴饱和减零偏，z 用 __SSAT；
+ *          旋转矩阵按行以 Q14 打包，每个输出轴一条 __SMUAD（x*m0 + y*m1）加一次 z*m2，
+ *          结果四舍五入后 __SSAT 到 int16。单位矩阵时跳过旋转；90° 步进组合（轴置换 + 取反）
+ *          走快路径，只做取数和饱和取反，结果与矩阵路径逐位一致。
+ *          刻度转换不再逐样本做浮点除法：imu_frontend_unit_per_lsb 缓存 1/刻度，
+ *          刻度（量程）变化时才重新求倒数；陀螺仪路径在降采样之后才转换为浮点。
+ *          Cortex-M4 上 CMSIS 内建函数对应单条 DSP 指令，主机构建使用 CMSIS-DSP 的 C 参考实现。
+ */
+
+#ifndef IMU_FRONTEND_H
+#define IMU_FRONTEND_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sensor_align.h"
+
+#define IMU_FRONTEND_ROT_Q      14      // 旋转矩阵定点格式：1.0 = 16384
+
+typedef struct imu_frontend_s {
+    uint32_t rot_xy[3];     // 第 i 行 (m[i][0], m[i][1])，Q14，低半字为 m[i][0]
+    int16_t  rot_z[3];      // 第 i 行 m[i][2]，Q14
+    sensor_rotation_kind_e mode;    // 单位 / 置换取反 / Q14 矩阵
+    uint8_t  perm_src[3];   // 置换路径：out[i] = ±in[perm_src[i]]
+    bool     perm_neg[3];
+    float    lsb_per_unit;  // 缓存对应的刻度（LSB/dps 或 LSB/g）
+    float    unit_per_lsb;  // 其倒数
+} imu_frontend_t;
+
+/**
+ * @brief 初始化为单位旋转、刻度未设置
+ */
+void imu_frontend_init(imu_frontend_t *fe);
+
+/**
+ * @brief 设置传感器系 → 机体系的旋转矩阵（out = m * in）
+ * @param m 按行给出的 3x3 矩阵（旋转矩阵，元素在 [-1, 1] 内）
+ * @return false=参数无效（保持原矩阵）
+ * @note 元素全为 0/±1 时自动选择置换快路径
+ */
+bool imu_frontend_set_rotation(imu_frontend_t *fe, const float m[3][3]);
+
+/**
+ * @brief 设置预编译的安装方向（sensor_rotation_build 的结果）
+ * @note 一般矩阵量化为 Q14
+ */
+void imu_frontend_set_alignment(imu_frontend_t *fe, const sensor_rotation_t *rot);
+
+/**
+ * @brief 整数前端：out = sat16(R * sat16(raw - offset))
+ * @param raw 原始计数
+ * @param offset 零偏（计数），每次调用读取，校准可随时更新
+ * @param out 补偿并旋转后的计数
+ */
+void imu_frontend_apply(const imu_frontend_t *fe, const int16_t raw[3], const int16_t offset[3], int16_t out[3]);
+
+/**
+ * @brief 刻度倒数（单位/LSB），刻度变化时才重新计算
+ * @param lsb_per_unit 当前刻度（例如 icm.gyro_scale），<=0 时按 1 处理
+ */
+static inline float imu_frontend_unit_per_lsb(imu_frontend_t *fe, float lsb_per_unit)
+{
+    if (lsb_per_unit != fe->lsb_per_unit) {
+        fe->lsb_per_unit = lsb_per_unit;
+        fe->unit_per_lsb = (lsb_per_unit > 0.0f) ? 1.0f / lsb_per_unit : 1.0f;
+    }
+    return fe->unit_per_lsb;
+}
+
+#endif // IMU_FRONTEND_H
@@ -0,0 +1,198 @@
+#include "latency_trace.h"
+#include "dump_writer.h"
+#include "bsp_System.h"
+#include "bsp_uart.h"
+#include "stm32f4xx.h"
+#include <string.h>
+
+#define TRACE_DUMP_VERSION  1
+#define TRACE_MASK          (LATENCY_TRACE_DEPTH - 1U)
+
+#if (LATENCY_TRACE_DEPTH & (LATENCY_TRACE_DEPTH - 1U)) != 0
+#error "LATENCY_TRACE_DEPTH must be a power of two"
+#endif
+
+static const char *const point_names[LATENCY_TRACE_POINTS] = {
+    "exti", "spi", "gyro", "filter", "attitude", "pid", "motor"
+};
+
+#if LATENCY_TRACE
+// 记录本体放 CCM；控制状态放普通 .bss，上电即为 0（CCM 段启动时不清零）
+static latency_trace_record_t ring[LATENCY_TRACE_DEPTH] LATENCY_TRACE_CCM;
+#endif
+static volatile uint32_t head = LATENCY_TRACE_NONE;    // 最新记录 id
+static volatile uint32_t recorded = 0;                 // 已写入的记录数（饱和于 DEPTH）
+static volatile bool     enabled = false;
+static volatile uint32_t stale = 0;
+
+void latency_trace_init(void)
+{
+    enabled = false;
+#if LATENCY_TRACE
+    memset(ring, 0, sizeof(ring));
+#endif
+    head = LATENCY_TRACE_NONE;
+    recorded = 0;
+    stale = 0;
+    enabled = true;
+}
+
+void latency_trace_enable(bool enable)
+{
+    enabled = enable;
+}
+
+uint32_t latency_trace_begin(uint32_t t_exti)
+{
+#if LATENCY_TRACE
+    if (!enabled) return LATENCY_TRACE_NONE;
+
+    uint32_t id = head + 1U;
+    if (id == LATENCY_TRACE_NONE) id++;
+
+    latency_trace_record_t *r = &ring[id & TRACE_MASK];
+    r->id = id;
+    r->mask = 1U << LATENCY_TRACE_EXTI;
+    r->t[LATENCY_TRACE_EXTI] = t_exti;
+
+    head = id;
+    if (recorded < LATENCY_TRACE_DEPTH) recorded++;
+    return id;
+#else
+    (void)t_exti;
+    return LATENCY_TRACE_NONE;
+#endif
+}
+
+void latency_trace_mark(uint32_t id, latency_trace_point_t point)
+{
+#if LATENCY_TRACE
+    if (id == LATENCY_TRACE_NONE || point >= LATENCY_TRACE_POINTS) return;
+
+    const uint32_t now = DWT_GetTick();
+    latency_trace_record_t *r = &ring[id & TRACE_MASK];
+    if (r->id != id) {
+        stale++;
+        return;
+    }
+    r->t[point] = now;
+    r->mask |= (uint8_t)(1U << point);
+#else
+    (void)id;
+    (void)point;
+#endif
+}
+
+uint32_t latency_trace_current(void)
+{
+    return head;
+}
+
+uint32_t latency_trace_find(uint32_t t_exti)
+{
+#if LATENCY_TRACE
+    uint32_t id = head;
+    for (uint32_t n = 0; n < recorded; n++, id--) {
+        if (id == LATENCY_TRACE_NONE) id--;
+        const latency_trace_record_t *r = &ring[id & TRACE_MASK];
+        if (r->id == id && r->t[LATENCY_TRACE_EXTI] == t_exti) return id;
+    }
+#else
+    (void)t_exti;
+#endif
+    return LATENCY_TRACE_NONE;
+}
+
+bool latency_trace_get(uint32_t id, latency_trace_record_t *out)
+{
+#if LATENCY_TRACE
+    if (id == LATENCY_TRACE_NONE || !out) return false;
+    const latency_trace_record_t *r = &ring[id & TRACE_MASK];
+    if (r->id != id) return false;
+    *out = *r;
+    return out->id == id;
+#else
+    (void)id;
+    (void)out;
+    return false;
+#endif
+}
+
+uint32_t latency_trace_count(void)
+{
+    return recorded;
+}
+
+uint32_t latency_trace_stale(void)
+{
+    return stale;
+}
+
+const char *latency_trace_point_name(latency_trace_point_t point)
+{
+    return (point < LATENCY_TRACE_POINTS) ? point_names[point] : "?";
+}
+
+// ============================================================================
+// 二进制导出（格式见 latency_trace.h，写出与 CRC 见 dump_writer）
+// ============================================================================
+
+uint32_t latency_trace_dump(latency_trace_write_cb write, void *user)
+{
+    if (!write) return 0;
+
+    // 导出期间不再开新记录；已开始的记录仍可能被打点（只会补全，不会换成别的样本）
+    const bool was_enabled = enabled;
+    enabled = false;
+
+    const uint32_t newest = head;
+    const uint16_t count = (uint16_t)recorded;
+
+    dump_writer_t d;
+    dump_writer_init(&d, write, user);
+    const uint8_t magic[2] = { 'L', 'T' };
+    dump_writer_put(&d, magic, 2);
+    dump_writer_u8(&d, TRACE_DUMP_VERSION);
+    dump_writer_u8(&d, LATENCY_TRACE_POINTS);
+    dump_writer_u32(&d, SystemCoreClock);
+    dump_writer_u32(&d, stale);
+    dump_writer_u16(&d, count);
+
+#if LATENCY_TRACE
+    // 最旧的记录：从 newest 往前数 count-1 个有效 id（跳过 0）
+    uint32_t id = newest;
+    for (uint16_t n = 1; n < count; n++) {
+        id--;
+        if (id == LATENCY_TRACE_NONE) id--;
+    }
+    for (uint16_t n = 0; n < count; n++) {
+        const latency_trace_record_t *r = &ring[id & TRACE_MASK];
+        const uint32_t t0 = r->t[LATENCY_TRACE_EXTI];
+        dump_writer_u32(&d, r->id);
+        dump_writer_u32(&d, t0);
+        dump_writer_u8(&d, r->mask);
+        for (uint8_t p = 1; p < LATENCY_TRACE_POINTS; p++) {
+            dump_writer_u32(&d, (r->mask & (1U << p)) ? r->t[p] - t0 : 0U);
+        }
+        id++;
+        if (id == LATENCY_TRACE_NONE) id++;
+    }
+#else
+    (void)newest;
+#endif
+
+    const uint32_t bytes = dump_writer_finish(&d);
+
+    enabled = was_enabled;
+    return bytes;
+}
+
+static void uart_write(void *user, const uint8_t *data, uint16_t len)
+{
+    BSP_UART_Write(*(const uint8_t *)user, data, len);
+}
+
+uint32_t latency_trace_dump_uart(uint8_t uart_id)
+{
+    return latency_trace_dump(uart_write, &uart_id);
+}
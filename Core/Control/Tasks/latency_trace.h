@@ -0,0 +1,110 @@
+/**
+ * @file    latency_trace.h
+ * @brief   陀螺仪 -> 电机端到端延迟追踪
+ * @note    每个 IMU 样本一条记录，在各处理节点打 DWT 周期戳：
+ *            EXTI -> SPI 完成 -> gyro_process_sample -> 滤波 -> Attitude_Update -> PID -> 电机输出
+ *          - 记录保存在 CCM RAM 的定长环形缓冲区（LATENCY_TRACE_DEPTH 条，满后覆盖最旧的）
+ *          - 记录以 id 标识：EXTI 中 latency_trace_begin 分配，之后各节点用同一个 id 打点；
+ *            记录已被覆盖时打点丢弃并计入 stale
+ *          - latency_trace_dump 以二进制导出，上位机用 fc_trace（Core/Sil/sil_trace_main.c）解码
+ *          - CCM 不能被 DMA 访问：导出走 CPU 轮询写（BSP_UART_Write），不要把环形缓冲区交给 DMA
+ *          - 固件接线：icm42688p.c 的 EXTI / SPI 完成回调开记录并打 SPI_DONE；
+ *            RUN_MODE 5 飞控循环（test_flight_loop.c）负责 init、流水线打点、MOTOR 打点与串口 'T' 导出
+ *
+ * @example
+ * // IMU data-ready EXTI：只有真正启动了传输才开新记录，SPI 完成中断与之一一对应
+ * uint32_t t = DWT_GetTick();
+ * if (icm42688p_dma_on_data_ready(&imu_dma, t)) latency_trace_begin(t);
+ * // SPI/DMA 完成中断
+ * icm42688p_dma_on_complete(&imu_dma);
+ * latency_trace_mark(latency_trace_current(), LATENCY_TRACE_SPI_DONE);
+ * // 任务中取帧：按 EXTI 时间戳找回记录，飞控流水线各阶段自动打点
+ * f.trace_id = latency_trace_find(frame.timestamp);
+ * pipeline_run(&flight, &f);
+ * motors_write(f.motor->motor);
+ * latency_trace_mark(f.trace_id, LATENCY_TRACE_MOTOR);
+ */
+
+#ifndef LATENCY_TRACE_H
+#define LATENCY_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// 0 = 打点函数为空操作，不占用 CCM
+#ifndef LATENCY_TRACE
+#define LATENCY_TRACE           1
+#endif
+
+// 环形缓冲区深度（2 的幂），每条 36 字节
+#ifndef LATENCY_TRACE_DEPTH
+#define LATENCY_TRACE_DEPTH     256
+#endif
+
+#define LATENCY_TRACE_NONE      0U      // 无效 id（未开始记录 / 已暂停）
+
+// 放到 CCM（链接脚本 .ccmbss，NOLOAD，不占 Flash、启动时不清零）
+#ifdef FC_SIL
+#define LATENCY_TRACE_CCM
+#else
+#define LATENCY_TRACE_CCM       __attribute__((section(".ccmbss")))
+#endif
+
+typedef enum {
+    LATENCY_TRACE_EXTI = 0,     // 数据就绪中断（采样时刻）
+    LATENCY_TRACE_SPI_DONE,     // SPI/DMA 传输完成
+    LATENCY_TRACE_GYRO,         // gyro_process_sample 之后
+    LATENCY_TRACE_FILTER,       // gyro_filter_feed_sample 之后
+    LATENCY_TRACE_ATTITUDE,     // Attitude_Update 之后
+    LATENCY_TRACE_PID,          // task_pid_update 之后
+    LATENCY_TRACE_MOTOR,        // 电机输出写入之后
+    LATENCY_TRACE_POINTS
+} latency_trace_point_t;
+
+typedef struct {
+    uint32_t id;
+    uint8_t  mask;                          // bit n = 第 n 个节点已打点
+    uint32_t t[LATENCY_TRACE_POINTS];       // DWT 周期
+} latency_trace_record_t;
+
+typedef void (*latency_trace_write_cb)(void *user, const uint8_t *data, uint16_t len);
+
+// 清空缓冲区并开始记录（未调用前 begin 返回 LATENCY_TRACE_NONE）
+void latency_trace_init(void);
+// 暂停/恢复记录（暂停期间 begin 返回 LATENCY_TRACE_NONE）
+void latency_trace_enable(bool enable);
+
+/**
+ * @brief 开始一条记录（在 EXTI 中调用）
+ * @param t_exti 采样时刻（DWT 周期）
+ * @return 记录 id；未启用时为 LATENCY_TRACE_NONE
+ */
+uint32_t latency_trace_begin(uint32_t t_exti);
+
+/**
+ * @brief 以当前 DWT 时刻给记录打点（中断/任务均可调用）
+ * @note  id 为 LATENCY_TRACE_NONE 时直接返回；记录已被覆盖时计入 stale
+ */
+void latency_trace_mark(uint32_t id, latency_trace_point_t point);
+
+// 最新记录的 id
+uint32_t latency_trace_current(void);
+// 按 EXTI 时刻从最新往前查找记录，找不到返回 LATENCY_TRACE_NONE
+uint32_t latency_trace_find(uint32_t t_exti);
+// 读取一条记录（已被覆盖返回 false）
+bool latency_trace_get(uint32_t id, latency_trace_record_t *out);
+// 缓冲区中的记录数 / 打点时记录已被覆盖的次数
+uint32_t latency_trace_count(void);
+uint32_t latency_trace_stale(void);
+const char *latency_trace_point_name(latency_trace_point_t point);
+
+// 二进制导出（小端）：
+//   'L' 'T' | u8 版本=1 | u8 节点数 N | u32 cpu_freq_hz | u32 stale | u16 记录数 M
+//   M x { u32 id | u32 t_exti | u8 mask | (N-1) x u32 相对 t_exti 的周期数（未打点为 0） }
+//   u16 CRC-16/CCITT-FALSE（覆盖之前的全部字节）
+// 按 id 从旧到新输出，导出期间暂停记录。返回写出的字节数
+uint32_t latency_trace_dump(latency_trace_write_cb write, void *user);
+// 通过 BSP_UART_Write 导出（轮询发送）
+uint32_t latency_trace_dump_uart(uint8_t uart_id);
+
+#endif // LATENCY_TRACE_H
@@ -4,6 +4,7 @@
  */
 
 #include "scheduler.h"
+#include "dump_writer.h"
 #include <string.h>
 #include <stdio.h>
 
@@ -21,7 +22,7 @@ static int find_task_index(task_scheduler_fc_t *sched, const char *name)
 {
     if (!sched || !name) return -1;
     for (uint8_t i = 0; i < sched->task_count; i++) {
-        if (sched->tasks[i].name && strcmp(sched->tasks[i].name, name) == 0) {
+        if (sched->tasks[i].desc->name && strcmp(sched->tasks[i].desc->name, name) == 0) {
             return i;
         }
     }
@@ -39,155 +40,360 @@ static inline uint32_t cycles_to_us(uint32_t cycles, uint32_t cpu_freq_hz)
     return (cycles / (cpu_freq_hz / 1000000));
 }
 
+/**
+ * @brief 句柄转任务指针，无效句柄返回 NULL
+ */
+static inline task_entry_t *task_from_handle(task_scheduler_fc_t *sched, task_handle_t task)
+{
+    if (!sched || task < 0 || task >= (task_handle_t)sched->task_count) return NULL;
+    return &sched->tasks[task];
+}
+
+/**
+ * @brief 根据优先级确定任务所在通道
+ */
+static inline task_lane_t lane_for_priority(const task_scheduler_fc_t *sched, task_priority_t priority)
+{
+    return (sched->rt_lane_enabled && priority <= sched->rt_max_priority)
+           ? TASK_LANE_RT : TASK_LANE_COOPERATIVE;
+}
+
 // ============================================================================
-// 任务注册函数
+// 派发队列：周期任务最小堆 + 按优先级分组的就绪位图
 // ============================================================================
 
 /**
- * @brief 注册周期性任务
+ * @brief 堆比较：a 的下次运行时间是否早于 b（按回绕差值比较）
  */
-bool scheduler_register_periodic(task_scheduler_fc_t *sched,
-                                 const char *name,
-                                 task_cb_t callback,
-                                 void *user_data,
-                                 task_priority_t priority,
-                                 uint32_t period_us,
-                                 uint32_t max_exec_us)
+static inline bool deadline_before(const task_entry_t *a, const task_entry_t *b)
 {
-    // 参数检查
-    if (!sched || !name || !callback || period_us == 0) {
-        return false;
+    return (int32_t)(a->next_run_time - b->next_run_time) < 0;
+}
+
+static inline void heap_place(task_scheduler_fc_t *sched, task_queue_t *q, uint8_t pos, uint8_t idx)
+{
+    q->heap[pos] = idx;
+    sched->tasks[idx].heap_pos = pos;
+}
+
+static void heap_sift_up(task_scheduler_fc_t *sched, task_queue_t *q, uint8_t pos)
+{
+    uint8_t idx = q->heap[pos];
+    while (pos > 0) {
+        uint8_t parent = (uint8_t)((pos - 1) / 2);
+        if (!deadline_before(&sched->tasks[idx], &sched->tasks[q->heap[parent]])) break;
+        heap_place(sched, q, pos, q->heap[parent]);
+        pos = parent;
+    }
+    heap_place(sched, q, pos, idx);
+}
+
+static void heap_sift_down(task_scheduler_fc_t *sched, task_queue_t *q, uint8_t pos)
+{
+    uint8_t idx = q->heap[pos];
+    for (;;) {
+        uint8_t child = (uint8_t)(2 * pos + 1);
+        if (child >= q->heap_size) break;
+        if (child + 1 < q->heap_size &&
+            deadline_before(&sched->tasks[q->heap[child + 1]], &sched->tasks[q->heap[child]])) {
+            child++;
+        }
+        if (!deadline_before(&sched->tasks[q->heap[child]], &sched->tasks[idx])) break;
+        heap_place(sched, q, pos, q->heap[child]);
+        pos = child;
+    }
+    heap_place(sched, q, pos, idx);
+}
+
+static void heap_push(task_scheduler_fc_t *sched, task_queue_t *q, uint8_t idx)
+{
+    heap_place(sched, q, q->heap_size++, idx);
+    heap_sift_up(sched, q, sched->tasks[idx].heap_pos);
+}
+
+static void heap_remove(task_scheduler_fc_t *sched, task_queue_t *q, uint8_t pos)
+{
+    sched->tasks[q->heap[pos]].heap_pos = SCHEDULER_NOT_QUEUED;
+    q->heap_size--;
+    if (pos == q->heap_size) return;
+
+    // 用堆尾元素填补空位，再向上或向下调整
+    heap_place(sched, q, pos, q->heap[q->heap_size]);
+    heap_sift_up(sched, q, pos);
+    heap_sift_down(sched, q, sched->tasks[q->heap[pos]].heap_pos);
+}
+
+static inline void ready_set(task_queue_t *q, task_priority_t prio, uint8_t idx)
+{
+    q->ready_mask[prio] |= (1UL << idx);
+    q->ready_prio_mask |= (uint8_t)(1U << prio);
+}
+
+static inline void ready_clear(task_queue_t *q, task_priority_t prio, uint8_t idx)
+{
+    q->ready_mask[prio] &= ~(1UL << idx);
+    if (q->ready_mask[prio] == 0) {
+        q->ready_prio_mask &= (uint8_t)~(1U << prio);
+    }
+}
+
+/**
+ * @brief 取出优先级最高的就绪任务（同优先级按注册顺序），调用前需确认 ready_prio_mask 非空
+ */
+static inline uint8_t ready_pop(task_queue_t *q)
+{
+    task_priority_t prio = (task_priority_t)__builtin_ctz(q->ready_prio_mask);
+    uint8_t idx = (uint8_t)__builtin_ctz(q->ready_mask[prio]);
+    ready_clear(q, prio, idx);
+    return idx;
+}
+
+/**
+ * @brief 把任务放入所属通道的队列（周期任务入堆，事件任务进入轮询位图）
+ */
+static void queue_add_task(task_scheduler_fc_t *sched, uint8_t idx)
+{
+    task_entry_t *task = &sched->tasks[idx];
+    task_queue_t *q = &sched->queue[task->lane];
+
+    if (task->desc->trigger_mode == TASK_TRIGGER_PERIODIC) {
+        if (task->heap_pos == SCHEDULER_NOT_QUEUED) {
+            heap_push(sched, q, idx);
+        }
+    } else {
+        q->event_mask |= (1UL << idx);
     }
+}
+
+/**
+ * @brief 把任务从所属通道的队列中移除（含就绪位）
+ */
+static void queue_remove_task(task_scheduler_fc_t *sched, uint8_t idx)
+{
+    task_entry_t *task = &sched->tasks[idx];
+    task_queue_t *q = &sched->queue[task->lane];
+
+    if (task->heap_pos != SCHEDULER_NOT_QUEUED) {
+        heap_remove(sched, q, task->heap_pos);
+    }
+    q->event_mask &= ~(1UL << idx);
+    ready_clear(q, task->desc->priority, idx);
+}
+
+/**
+ * @brief 按当前通道划分重建两条通道的队列（启用/关闭实时通道时调用，需关中断）
+ */
+static void queue_rebuild(task_scheduler_fc_t *sched)
+{
+    memset(sched->queue, 0, sizeof(sched->queue));
+    for (uint8_t i = 0; i < sched->task_count; i++) {
+        task_entry_t *task = &sched->tasks[i];
+        task->heap_pos = SCHEDULER_NOT_QUEUED;
+        task->lane = lane_for_priority(sched, task->desc->priority);
+        if (task->active && task->state != TASK_STATE_SUSPENDED) {
+            queue_add_task(sched, i);
+        }
+    }
+}
+
+/**
+ * @brief 注册完成后激活任务并入队（实时通道中断可能随时看到该任务，关中断）
+ */
+static void activate_task(task_scheduler_fc_t *sched, task_entry_t *task)
+{
+#if SCHEDULER_HIST
+    task_hist_reset(&task->exec_hist);
+    task_hist_reset(&task->jitter_hist);
+#endif
+
+    __disable_irq();
+    task->heap_pos = SCHEDULER_NOT_QUEUED;
+    task->active = true;
+    queue_add_task(sched, (uint8_t)(task - sched->tasks));
+    __enable_irq();
+}
+
+// ============================================================================
+// 任务注册函数
+// ============================================================================
+
+/**
+ * @brief 按描述符占用下一个任务槽并激活
+ * @note  描述符须在任务生命周期内有效（静态任务表或调度器的描述符池）
+ */
+static task_handle_t add_task(task_scheduler_fc_t *sched, const task_desc_t *desc)
+{
     if (sched->task_count >= sched->capacity) {
-        return false;  // 任务数量已满
+        return TASK_HANDLE_INVALID;  // 任务数量已满
     }
 
-    // 分配任务槽
+    // 分配任务槽（运行状态全部清零：统计、相位、超时策略默认 SKIP）
     task_entry_t *task = &sched->tasks[sched->task_count++];
-    
-    // 设置基本信息
-    task->name = name;
-    task->callback = callback;
-    task->user_data = user_data;
-    task->priority = priority;
-    task->trigger_mode = TASK_TRIGGER_PERIODIC;
+    memset(task, 0, sizeof(*task));
+    task->desc = desc;
     task->state = TASK_STATE_READY;
+    task->lane = lane_for_priority(sched, desc->priority);
+
+    if (desc->trigger_mode == TASK_TRIGGER_PERIODIC) {
+        // 网格锚定在注册时刻，可用 scheduler_set_task_timing 改为相位对齐
+        task->next_run_time = DWT_GetTick() + desc->period_cycles;
+    }
+    if (desc->event_buf) {
+        task->events.buf = desc->event_buf;
+        task->events.mask = (uint8_t)(desc->event_depth - 1);
+    }
+
+    activate_task(sched, task);
+    return (task_handle_t)(task - sched->tasks);
+}
+
+#if SCHEDULER_DYNAMIC_TASKS > 0
+/**
+ * @brief 取下一个任务槽对应的 RAM 描述符（动态注册用），池已用完返回 NULL
+ */
+static task_desc_t *alloc_desc(task_scheduler_fc_t *sched)
+{
+    if (sched->task_count >= sched->capacity || sched->task_count >= SCHEDULER_DYNAMIC_TASKS) {
+        return NULL;
+    }
+    task_desc_t *desc = &sched->desc_pool[sched->task_count];
+    memset(desc, 0, sizeof(*desc));
+    return desc;
+}
+
+/**
+ * @brief 注册周期性任务
+ */
+task_handle_t scheduler_register_periodic(task_scheduler_fc_t *sched,
+                                          const char *name,
+                                          task_cb_t callback,
+                                          void *user_data,
+                                          task_priority_t priority,
+                                          uint32_t period_us,
+                                          uint32_t max_exec_us)
+{
+    // 参数检查
+    if (!sched || !name || !callback || period_us == 0) {
+        return TASK_HANDLE_INVALID;
+    }
+    task_desc_t *desc = alloc_desc(sched);
+    if (!desc) return TASK_HANDLE_INVALID;
+
+    desc->name = name;
+    desc->callback = callback;
+    desc->user_data = user_data;
+    desc->priority = priority;
+    desc->trigger_mode = TASK_TRIGGER_PERIODIC;
+    desc->max_exec_us = max_exec_us;
 
     // 计算周期（微秒转为CPU周期数）
-    task->period_cycles = clockMicrosToCycles(period_us);
-    if (task->period_cycles == 0) {
-        task->period_cycles = 1;  // 防止除零错误
+    desc->period_cycles = clockMicrosToCycles(period_us);
+    if (desc->period_cycles == 0) {
+        desc->period_cycles = 1;  // 防止除零错误
     }
-    
-    // 设置下次运行时间
-    uint32_t now = DWT_GetTick();
-    task->next_run_time = now + task->period_cycles;
 
-    // 性能监控参数
-    task->max_exec_time_us = max_exec_us;
-    task->active = true;
-    
-    // 清空统计信息
-    memset(&task->stats, 0, sizeof(task_stats_t));
-    
-    return true;
+    return add_task(sched, desc);
 }
 
 /**
  * @brief 注册事件触发任务（标志位方式）
  */
-bool scheduler_register_event_flag(task_scheduler_fc_t *sched,
-                                   const char *name,
-                                   task_cb_t callback,
-                                   void *user_data,
-                                   task_priority_t priority,
-                                   volatile bool *event_flag,
-                                   uint32_t max_exec_us)
+task_handle_t scheduler_register_event_flag(task_scheduler_fc_t *sched,
+                                            const char *name,
+                                            task_cb_t callback,
+                                            void *user_data,
+                                            task_priority_t priority,
+                                            volatile bool *event_flag,
+                                            uint32_t max_exec_us)
 {
     // 参数检查
-    if (!sched || !name || !callback || !event_flag) return false;
-    if (sched->task_count >= sched->capacity) return false;
+    if (!sched || !name || !callback || !event_flag) return TASK_HANDLE_INVALID;
+    task_desc_t *desc = alloc_desc(sched);
+    if (!desc) return TASK_HANDLE_INVALID;
 
-    // 分配任务槽
-    task_entry_t *task = &sched->tasks[sched->task_count++];
-    
-    // 设置基本信息
-    task->name = name;
-    task->callback = callback;
-    task->user_data = user_data;
-    task->priority = priority;
-    task->trigger_mode = TASK_TRIGGER_EVENT;
-    task->state = TASK_STATE_READY;
-    
-    // 设置事件标志位
-    task->event_flag = event_flag;
-    task->should_run = NULL;
-    
-    // 性能监控参数
-    task->max_exec_time_us = max_exec_us;
-    task->active = true;
-    
-    // 清空统计信息
-    memset(&task->stats, 0, sizeof(task_stats_t));
-    
-    return true;
+    desc->name = name;
+    desc->callback = callback;
+    desc->user_data = user_data;
+    desc->priority = priority;
+    desc->trigger_mode = TASK_TRIGGER_EVENT;
+    desc->event_flag = event_flag;
+    desc->max_exec_us = max_exec_us;
+
+    return add_task(sched, desc);
 }
 
 /**
  * @brief 注册事件触发任务（回调判断方式）
  */
-bool scheduler_register_event_callback(task_scheduler_fc_t *sched,
-                                       const char *name,
-                                       task_cb_t callback,
-                                       task_should_run_cb_t should_run,
-                                       void *user_data,
-                                       task_priority_t priority,
-                                       uint32_t max_exec_us)
+task_handle_t scheduler_register_event_callback(task_scheduler_fc_t *sched,
+                                                const char *name,
+                                                task_cb_t callback,
+                                                task_should_run_cb_t should_run,
+                                                void *user_data,
+                                                task_priority_t priority,
+                                                uint32_t max_exec_us)
 {
     // 参数检查
-    if (!sched || !name || !callback || !should_run) return false;
-    if (sched->task_count >= sched->capacity) return false;
+    if (!sched || !name || !callback || !should_run) return TASK_HANDLE_INVALID;
+    task_desc_t *desc = alloc_desc(sched);
+    if (!desc) return TASK_HANDLE_INVALID;
 
-    // 分配任务槽
-    task_entry_t *task = &sched->tasks[sched->task_count++];
-    
-    // 设置基本信息
-    task->name = name;
-    task->callback = callback;
-    task->user_data = user_data;
-    task->priority = priority;
-    task->trigger_mode = TASK_TRIGGER_EVENT;
-    task->state = TASK_STATE_READY;
-    
-    // 设置判断回调
-    task->event_flag = NULL;
-    task->should_run = should_run;
-    
-    // 性能监控参数
-    task->max_exec_time_us = max_exec_us;
-    task->active = true;
-    
-    // 清空统计信息
-    memset(&task->stats, 0, sizeof(task_stats_t));
-    
-    return true;
+    desc->name = name;
+    desc->callback = callback;
+    desc->should_run = should_run;
+    desc->user_data = user_data;
+    desc->priority = priority;
+    desc->trigger_mode = TASK_TRIGGER_EVENT;
+    desc->max_exec_us = max_exec_us;
+
+    return add_task(sched, desc);
 }
 
+/**
+ * @brief 注册事件触发任务（事件队列方式）
+ */
+task_handle_t scheduler_register_event_queue(task_scheduler_fc_t *sched,
+                                             const char *name,
+                                             task_event_cb_t callback,
+                                             void *user_data,
+                                             task_priority_t priority,
+                                             task_event_t *buffer,
+                                             uint8_t depth,
+                                             uint32_t max_exec_us)
+{
+    // 参数检查（深度须为 2 的幂，且不超过 uint8_t 索引范围的一半）
+    if (!sched || !name || !callback || !buffer) return TASK_HANDLE_INVALID;
+    if (depth < 2 || depth > 128 || (depth & (depth - 1)) != 0) return TASK_HANDLE_INVALID;
+    task_desc_t *desc = alloc_desc(sched);
+    if (!desc) return TASK_HANDLE_INVALID;
+
+    desc->name = name;
+    desc->event_cb = callback;
+    desc->user_data = user_data;
+    desc->priority = priority;
+    desc->trigger_mode = TASK_TRIGGER_EVENT;
+    desc->event_buf = buffer;
+    desc->event_depth = depth;
+    desc->max_exec_us = max_exec_us;
+
+    return add_task(sched, desc);
+}
+#endif // SCHEDULER_DYNAMIC_TASKS > 0
+
 // ============================================================================
 // 调度器初始化
 // ============================================================================
 
 /**
- * @brief 初始化调度器
+ * @brief 复位调度器状态（任务槽由调用者按需清零）
  */
-void scheduler_init(task_scheduler_fc_t *sched,
-                    task_entry_t *storage,
-                    uint8_t capacity,
-                    const scheduler_config_t *config)
+static void reset_scheduler(task_scheduler_fc_t *sched, task_entry_t *storage, uint8_t capacity,
+                            const scheduler_config_t *config)
 {
-    if (!sched || !storage) return;
-
-    // 设置任务存储
+    // 设置任务存储（就绪位图最多容纳 SCHEDULER_MAX_TASKS 个任务）
+    if (capacity > SCHEDULER_MAX_TASKS) {
+        capacity = SCHEDULER_MAX_TASKS;
+    }
     sched->tasks = storage;
     sched->capacity = capacity;
     sched->task_count = 0;
@@ -202,48 +408,177 @@ void scheduler_init(task_scheduler_fc_t *sched,
         sched->config.cpu_freq_hz = SystemCoreClock;
         sched->config.max_tasks = capacity;
     }
+    memset(sched->queue, 0, sizeof(sched->queue));
+
+    // 初始化CPU负载统计
+    memset(sched->busy_cycles, 0, sizeof(sched->busy_cycles));
+    memset(sched->overhead_cycles, 0, sizeof(sched->overhead_cycles));
+    sched->idle_cycles = 0;
+    sched->sleep_cycles = 0;
+    sched->rt_isr_cycles = 0;
+    memset(&sched->load, 0, sizeof(sched->load));
+    sched->cpu_load = 0.0f;
+    sched->last_load_update = DWT_GetTick();
+    sched->epoch = sched->last_load_update;
+    sched->idle_hook = NULL;
+    sched->idle_user = NULL;
+    sched->idle_min_cycles = 0;
+
+    // 实时通道默认关闭，所有任务都在 scheduler_run 中协作执行
+    sched->rt_lane_enabled = false;
+    sched->rt_max_priority = TASK_PRIORITY_HIGH;
+    sched->rt_in_isr = false;
+    memset(sched->lane_stats, 0, sizeof(sched->lane_stats));
+}
+
+#if SCHEDULER_DYNAMIC_TASKS > 0
+/**
+ * @brief 初始化调度器
+ */
+void scheduler_init(task_scheduler_fc_t *sched,
+                    task_entry_t *storage,
+                    uint8_t capacity,
+                    const scheduler_config_t *config)
+{
+    if (!sched || !storage) return;
+
+    reset_scheduler(sched, storage, capacity, config);
 
     // 清空所有任务槽
-    for (uint8_t i = 0; i < capacity; i++) {
+    for (uint8_t i = 0; i < sched->capacity; i++) {
         memset(&sched->tasks[i], 0, sizeof(task_entry_t));
         sched->tasks[i].state = TASK_STATE_IDLE;
         sched->tasks[i].active = false;
+        sched->tasks[i].heap_pos = SCHEDULER_NOT_QUEUED;
     }
+}
+#endif
 
-    // 初始化CPU负载统计
-    sched->total_cycles = 0;
-    sched->idle_cycles = 0;
-    sched->cpu_load = 0.0f;
-    sched->last_load_update = DWT_GetTick();
+/**
+ * @brief 用静态任务表初始化调度器
+ * @note  只初始化表中任务的运行状态，描述符（含已换算好的 period_cycles）直接引用 Flash 中的表
+ */
+bool scheduler_init_static(task_scheduler_fc_t *sched,
+                           const task_table_t *table,
+                           task_entry_t *state,
+                           uint8_t capacity,
+                           const scheduler_config_t *config)
+{
+    if (!sched || !table || !state) return false;
+
+    const uint32_t cpu_hz = config ? config->cpu_freq_hz : SystemCoreClock;
+    if (table->cpu_freq_hz != cpu_hz) {
+        printf("[scheduler] task table built for %lu Hz, core runs at %lu Hz\r\n",
+               (unsigned long)table->cpu_freq_hz, (unsigned long)cpu_hz);
+        return false;
+    }
+    if (table->count > capacity || table->count > SCHEDULER_MAX_TASKS) {
+        printf("[scheduler] task table has %u tasks, capacity %u\r\n", table->count, capacity);
+        return false;
+    }
+
+    reset_scheduler(sched, state, capacity, config);
+    for (uint8_t i = 0; i < table->count; i++) {
+        add_task(sched, &table->tasks[i]);
+    }
+    return true;
 }
 
 // ============================================================================
 // 任务执行逻辑
 // ============================================================================
 
+/**
+ * @brief 记录一次释放抖动（任务统计 + 所在通道统计）
+ * @param release 计划释放时刻（CPU周期数）
+ * @param start   实际开始时刻（CPU周期数）
+ */
+static void record_jitter(task_scheduler_fc_t *sched, task_entry_t *task, uint32_t release, uint32_t start)
+{
+    int32_t late = (int32_t)(start - release);
+    uint32_t late_cycles = (late > 0) ? (uint32_t)late : 0;
+    uint32_t jitter_us = cycles_to_us(late_cycles, sched->config.cpu_freq_hz);
+
+#if SCHEDULER_HIST
+    task_hist_record(&task->jitter_hist, late_cycles);
+#endif
+
+    task->stats.jitter_us = jitter_us;
+    if (jitter_us > task->stats.jitter_max_us) {
+        task->stats.jitter_max_us = jitter_us;
+    }
+
+    task_lane_stats_t *ls = &sched->lane_stats[task->lane];
+    ls->jitter_samples++;
+    ls->jitter_total_us += jitter_us;
+    if (jitter_us > ls->jitter_max_us) {
+        ls->jitter_max_us = jitter_us;
+    }
+}
+
 /**
  * @brief 执行单个任务并记录统计信息
  * @param sched 调度器实例
  * @param task 要执行的任务
+ * @param event_release 事件任务的释放时刻（实时通道为中断入口时刻），协作通道事件任务无意义
  */
-static void execute_task(task_scheduler_fc_t *sched, task_entry_t *task)
+static void execute_task(task_scheduler_fc_t *sched, task_entry_t *task, uint32_t event_release)
 {
-    if (!task || !task->callback || !task->active) return;
+    if (!task || !task->active || (!task->desc->callback && !task->desc->event_cb)) return;
 
     // 记录开始时间
     uint32_t start_time = DWT_GetTick();
+    uint32_t isr_start = sched->rt_isr_cycles;
     task->state = TASK_STATE_RUNNING;
+
+    if (sched->config.enable_stats) {
+        sched->lane_stats[task->lane].dispatch_count++;
+        // 周期任务以计划时刻为基准；事件任务只有在实时通道中才有明确的释放时刻
+        if (task->desc->trigger_mode == TASK_TRIGGER_PERIODIC) {
+            record_jitter(sched, task, task->next_run_time, start_time);
+        } else if (task->events.buf) {
+            // 事件队列：以最早一个待处理事件的投递时刻为释放时刻
+            record_jitter(sched, task, task->events.buf[task->events.tail & task->events.mask].timestamp,
+                          start_time);
+        } else if (task->lane == TASK_LANE_RT) {
+            record_jitter(sched, task, event_release, start_time);
+        }
+    }
     
     // 执行任务回调
-    task->callback(task->user_data);
+    if (task->events.buf) {
+        // 只处理本次派发开始时已到达的事件；回调期间新到的事件留给下一次派发
+        task_event_queue_t *q = &task->events;
+        uint8_t pending = (uint8_t)(q->head - q->tail);
+        __DMB();   // 先读 head 再读槽位内容
+        while (pending--) {
+            task->desc->event_cb(task->desc->user_data, &q->buf[q->tail & q->mask]);
+            __DMB();   // 槽位读完后才释放给生产者
+            q->tail++;
+        }
+    } else {
+        task->desc->callback(task->desc->user_data);
+    }
     
     // 记录结束时间
     uint32_t end_time = DWT_GetTick();
-    task->state = TASK_STATE_READY;
+    // 回调中把自己挂起（或被实时通道挂起）时保留 SUSPENDED，dispatch_task 据此不再入堆
+    __disable_irq();
+    if (task->state == TASK_STATE_RUNNING) {
+        task->state = TASK_STATE_READY;
+    }
+    __enable_irq();
 
     // 计算执行时间并更新统计
     uint32_t exec_cycles = end_time - start_time;
     if (sched->config.enable_stats) {
+        // CPU 占用按净值累计：协作任务被实时通道抢占的时间已计入实时通道
+        uint32_t busy_cycles = exec_cycles - (sched->rt_isr_cycles - isr_start);
+        task->busy_cycles += busy_cycles;
+        sched->busy_cycles[task->lane] += busy_cycles;
+#if SCHEDULER_HIST
+        task_hist_record(&task->exec_hist, exec_cycles);
+#endif
         task->stats.exec_count++;
         task->stats.exec_time_us = cycles_to_us(exec_cycles, sched->config.cpu_freq_hz);
         task->stats.exec_time_total_us += task->stats.exec_time_us;
@@ -254,15 +589,15 @@ static void execute_task(task_scheduler_fc_t *sched, task_entry_t *task)
         }
         
         // 检查是否超过最大允许时间
-        if (sched->config.enable_overrun_check && task->max_exec_time_us > 0) {
-            if (task->stats.exec_time_us > task->max_exec_time_us) {
+        if (sched->config.enable_overrun_check && task->desc->max_exec_us > 0) {
+            if (task->stats.exec_time_us > task->desc->max_exec_us) {
                 task->stats.overrun_count++;
             }
         }
         
         // 对于周期任务，检查是否超过周期时间
-        if (task->trigger_mode == TASK_TRIGGER_PERIODIC) {
-            uint32_t period_us = cycles_to_us(task->period_cycles, sched->config.cpu_freq_hz);
+        if (task->desc->trigger_mode == TASK_TRIGGER_PERIODIC) {
+            uint32_t period_us = cycles_to_us(task->desc->period_cycles, sched->config.cpu_freq_hz);
             if (task->stats.exec_time_us > period_us) {
                 task->stats.overrun_count++;
             }
@@ -284,17 +619,19 @@ static bool should_task_run(task_entry_t *task, uint32_t now)
     }
     
     // 根据触发模式判断
-    switch (task->trigger_mode) {
+    switch (task->desc->trigger_mode) {
         case TASK_TRIGGER_PERIODIC:
             // 周期任务：检查是否到达运行时间
             return ((int32_t)(now - task->next_run_time) >= 0);
             
         case TASK_TRIGGER_EVENT:
             // 事件任务：检查标志位或回调函数
-            if (task->event_flag) {
-                return (*task->event_flag != 0);
-            } else if (task->should_run) {
-                return task->should_run(task->user_data);
+            if (task->desc->event_flag) {
+                return (*task->desc->event_flag != 0);
+            } else if (task->desc->should_run) {
+                return task->desc->should_run(task->desc->user_data);
+            } else if (task->events.buf) {
+                return task->events.head != task->events.tail;
             }
             return false;
             
@@ -303,108 +640,403 @@ static bool should_task_run(task_entry_t *task, uint32_t now)
     }
 }
 
+/**
+ * @brief 周期任务执行后推进 next_run_time：按时则 += period，错过整周期时按超时策略处理
+ * @param now 任务结束时刻（CPU周期数）
+ */
+static void advance_periodic(task_scheduler_fc_t *sched, task_entry_t *task, uint32_t now)
+{
+    task->next_run_time += task->desc->period_cycles;
+
+    int32_t behind = (int32_t)(now - task->next_run_time);
+    if (behind < 0) {
+        task->catch_up_run = 0;   // 按时完成
+        return;
+    }
+
+    switch (task->overrun_policy) {
+        case TASK_OVERRUN_CATCH_UP:
+            // 保持 next_run_time 在过去，下一轮立即再次派发
+            if (task->catch_up_run < task->catch_up_max) {
+                task->catch_up_run++;
+                if (sched->config.enable_stats) {
+                    task->stats.catch_up_count++;
+                }
+                break;
+            }
+            // 补跑次数用完：剩余周期按 SKIP 处理
+            /* fall through */
+
+        case TASK_OVERRUN_SKIP:
+        default: {
+            uint32_t skipped = (uint32_t)behind / task->desc->period_cycles + 1;
+            task->next_run_time += skipped * task->desc->period_cycles;
+            task->catch_up_run = 0;
+            if (sched->config.enable_stats) {
+                task->stats.missed_count += skipped;
+            }
+            break;
+        }
+
+        case TASK_OVERRUN_REPHASE:
+            task->next_run_time = now + task->desc->period_cycles;
+            if (sched->config.enable_stats) {
+                task->stats.missed_count++;
+            }
+            break;
+    }
+}
+
+/**
+ * @brief 把周期任务的 next_run_time 对齐到 epoch + phase + k*period 上第一个未来时刻
+ */
+static void align_to_phase(task_scheduler_fc_t *sched, task_entry_t *task, uint32_t now)
+{
+    uint32_t anchor = sched->epoch + task->phase_cycles;
+    int32_t elapsed = (int32_t)(now - anchor);
+
+    if (elapsed < 0) {
+        task->next_run_time = anchor;
+    } else {
+        task->next_run_time = anchor + ((uint32_t)elapsed / task->desc->period_cycles + 1) * task->desc->period_cycles;
+    }
+}
+
+/**
+ * @brief 执行一个已判定到期的任务，并完成周期/事件的后续处理（两条通道共用）
+ */
+static void dispatch_task(task_scheduler_fc_t *sched, task_entry_t *task, uint32_t event_release)
+{
+    // 执行任务
+    execute_task(sched, task, event_release);
+
+    // 周期任务：在时间网格上推进下次运行时间
+    if (task->desc->trigger_mode == TASK_TRIGGER_PERIODIC) {
+        advance_periodic(sched, task, DWT_GetTick());
+
+        // 重新入堆（任务在回调中把自己挂起时不再入堆，由 resume 负责）
+        if (task->state != TASK_STATE_SUSPENDED) {
+            queue_add_task(sched, (uint8_t)(task - sched->tasks));
+        }
+    }
+
+    // 事件任务：清除事件标志位
+    if (task->desc->trigger_mode == TASK_TRIGGER_EVENT && task->desc->event_flag) {
+        *task->desc->event_flag = false;  // 自动清零标志位
+    }
+}
+
 // ============================================================================
 // 调度器主循环
 // ============================================================================
 
 /**
- * @brief 调度器主循环
- * @note 按优先级从高到低遍历所有任务，执行到期的任务
+ * @brief 派发一条通道中所有到期/置位的任务
+ * @param event_release 事件任务的释放时刻（见 execute_task）
+ * @return 是否有任务运行
+ * @note  堆顶未到期且没有事件置位时，开销只有一次 DWT 读取、一次堆顶比较和事件位图轮询。
+ *        每执行完一个任务重新收集一次到期的周期任务，执行期间到期的高优先级任务会排到
+ *        尚未执行的低优先级任务前面。
  */
-void scheduler_run(task_scheduler_fc_t *sched)
+static bool run_lane(task_scheduler_fc_t *sched, task_lane_t lane, uint32_t event_release)
 {
-    if (!sched) return;
+    task_queue_t *q = &sched->queue[lane];
+    bool any_task_ran = false;
 
+    // 事件任务：只轮询本通道的事件任务位图
+    uint32_t events = q->event_mask;
+    while (events) {
+        uint8_t idx = (uint8_t)__builtin_ctz(events);
+        events &= events - 1;
+        task_entry_t *task = &sched->tasks[idx];
+        if (should_task_run(task, event_release)) {
+            ready_set(q, task->desc->priority, idx);
+        }
+    }
+
+    for (;;) {
+        // 周期任务：弹出所有已到期的堆顶
+        uint32_t now = DWT_GetTick();
+        while (q->heap_size > 0) {
+            uint8_t idx = q->heap[0];
+            task_entry_t *task = &sched->tasks[idx];
+            if ((int32_t)(now - task->next_run_time) < 0) break;
+            heap_remove(sched, q, 0);
+            ready_set(q, task->desc->priority, idx);
+        }
+
+        if (q->ready_prio_mask == 0) break;
+
+        dispatch_task(sched, &sched->tasks[ready_pop(q)], event_release);
+        any_task_ran = true;
+    }
+
+    return any_task_ran;
+}
+
+/**
+ * @brief 结算一个统计窗口：CPU 时间分解与每个任务的占用
+ */
+static void update_load(task_scheduler_fc_t *sched, uint32_t now)
+{
+    static uint32_t task_busy[SCHEDULER_MAX_TASKS];
+    uint32_t window = now - sched->last_load_update;
+
+    // 实时通道中断也在累加，关中断取快照并清零
+    __disable_irq();
+    uint32_t busy = sched->busy_cycles[TASK_LANE_COOPERATIVE] + sched->busy_cycles[TASK_LANE_RT];
+    uint32_t overhead = sched->overhead_cycles[TASK_LANE_COOPERATIVE] + sched->overhead_cycles[TASK_LANE_RT];
+    uint32_t idle = sched->idle_cycles;
+    uint32_t sleep = sched->sleep_cycles;
+    for (uint8_t i = 0; i < sched->task_count; i++) {
+        task_busy[i] = sched->tasks[i].busy_cycles;
+        sched->tasks[i].busy_cycles = 0;
+    }
+    memset(sched->busy_cycles, 0, sizeof(sched->busy_cycles));
+    memset(sched->overhead_cycles, 0, sizeof(sched->overhead_cycles));
+    sched->idle_cycles = 0;
+    sched->sleep_cycles = 0;
+    __enable_irq();
+
+    float scale = (window > 0) ? 100.0f / (float)window : 0.0f;
+    for (uint8_t i = 0; i < sched->task_count; i++) {
+        sched->tasks[i].stats.cpu_load = (float)task_busy[i] * scale;
+    }
+
+    scheduler_load_t *load = &sched->load;
+    load->task = (float)busy * scale;
+    load->overhead = (float)overhead * scale;
+    load->idle = (float)idle * scale;
+    load->sleep = (float)sleep * scale;
+    load->other = 100.0f - load->task - load->overhead - load->idle;
+    if (load->other < 0.0f) load->other = 0.0f;
+    load->cpu_load = 100.0f - load->idle;
+    sched->cpu_load = load->cpu_load;
+    sched->last_load_update = now;
+}
+
+/**
+ * @brief 协作通道无事可做时调用空闲回调
+ * @return 在回调中度过的周期数（扣除期间实时通道中断的耗时）
+ * @note  关中断后重新检查事件任务：检查之后才置位的事件会使 WFI 立即返回
+ */
+static uint32_t enter_idle(task_scheduler_fc_t *sched)
+{
+    task_queue_t *q = &sched->queue[TASK_LANE_COOPERATIVE];
+    uint32_t slept = 0;
+
+    __disable_irq();
     uint32_t now = DWT_GetTick();
-    uint32_t loop_start = now;
-    bool any_task_ran = false;
+    uint32_t isr_start = sched->rt_isr_cycles;
 
-    // 按优先级从高到低遍历（CRITICAL -> HIGH -> NORMAL -> LOW -> IDLE）
-    for (task_priority_t prio = TASK_PRIORITY_CRITICAL; prio <= TASK_PRIORITY_IDLE; prio++) {
-        for (uint8_t i = 0; i < sched->task_count; i++) {
-            task_entry_t *task = &sched->tasks[i];
-            
-            // 跳过不是当前优先级的任务
-            if (task->priority != prio) continue;
+    uint32_t idle_cycles = UINT32_MAX;
+    if (q->heap_size > 0) {
+        int32_t remain = (int32_t)(sched->tasks[q->heap[0]].next_run_time - now);
+        idle_cycles = (remain > 0) ? (uint32_t)remain : 0;
+    }
 
-            // 更新当前时间（因为前面的任务可能执行了一段时间）
-            now = DWT_GetTick();
-            
-            // 判断任务是否应该运行
-            if (should_task_run(task, now)) {
-                // 执行任务
-                execute_task(sched, task);
-                any_task_ran = true;
-
-                // 周期任务：更新下次运行时间
-                if (task->trigger_mode == TASK_TRIGGER_PERIODIC) {
-                    now = DWT_GetTick();
-                    task->next_run_time = now + task->period_cycles;
-                    
-                    // 检测是否错过了周期（任务执行时间过长）
-                    if ((int32_t)(now - task->next_run_time) >= 0) {
-                        if (sched->config.enable_stats) {
-                            task->stats.missed_count++;
-                        }
-                        // 直接设置下一个周期，避免追赶
-                        task->next_run_time = now + task->period_cycles;
-                    }
-                }
+    bool pending = false;
+    uint32_t events = q->event_mask;
+    while (events && !pending) {
+        uint8_t idx = (uint8_t)__builtin_ctz(events);
+        events &= events - 1;
+        pending = should_task_run(&sched->tasks[idx], now);
+    }
 
-                // 事件任务：清除事件标志位
-                if (task->trigger_mode == TASK_TRIGGER_EVENT && task->event_flag) {
-                    *task->event_flag = false;  // 自动清零标志位
-                }
-            }
-        }
+    if (!pending && idle_cycles > 0 && idle_cycles >= sched->idle_min_cycles) {
+        sched->idle_hook(sched->idle_user, idle_cycles);
+        slept = (DWT_GetTick() - now) - (sched->rt_isr_cycles - isr_start);
+    }
+    __enable_irq();
+
+    return slept;
+}
+
+/**
+ * @brief 调度器主循环
+ * @note 按优先级从高到低执行协作通道中到期的任务（实时通道任务由 scheduler_rt_isr 执行）。
+ *       本次调用派发了任务时，任务之外的时间计为调度器开销；否则整次调用（含空闲回调）计为空闲。
+ *       两者都扣除期间实时通道中断的耗时，避免与实时通道重复计算
+ */
+void scheduler_run(task_scheduler_fc_t *sched)
+{
+    if (!sched) return;
+
+    uint32_t loop_start = DWT_GetTick();
+    uint32_t isr_start = sched->rt_isr_cycles;
+    uint32_t busy_start = sched->busy_cycles[TASK_LANE_COOPERATIVE];
+    bool any_task_ran = run_lane(sched, TASK_LANE_COOPERATIVE, loop_start);
+
+    uint32_t slept = 0;
+    if (!any_task_ran && sched->idle_hook) {
+        slept = enter_idle(sched);
     }
 
     // 计算CPU负载
     if (sched->config.enable_stats) {
         uint32_t loop_end = DWT_GetTick();
-        uint32_t loop_cycles = loop_end - loop_start;
-        
-        sched->total_cycles += loop_cycles;
-        if (!any_task_ran) {
-            sched->idle_cycles += loop_cycles;  // 没有任务运行，累计空闲时间
+        uint32_t loop_cycles = (loop_end - loop_start) - (sched->rt_isr_cycles - isr_start);
+
+        if (any_task_ran) {
+            sched->overhead_cycles[TASK_LANE_COOPERATIVE] +=
+                loop_cycles - (sched->busy_cycles[TASK_LANE_COOPERATIVE] - busy_start);
+        } else {
+            sched->idle_cycles += loop_cycles;
+            sched->sleep_cycles += slept;
         }
-        
-        // 每秒更新一次CPU负载
-        uint32_t load_update_interval = sched->config.cpu_freq_hz;  // 1秒
-        if ((loop_end - sched->last_load_update) >= load_update_interval) {
-            if (sched->total_cycles > 0) {
-                sched->cpu_load = 100.0f * (1.0f - (float)sched->idle_cycles / (float)sched->total_cycles);
-            }
-            // 重置计数器
-            sched->total_cycles = 0;
-            sched->idle_cycles = 0;
-            sched->last_load_update = loop_end;
+
+        // 每秒结算一次
+        if ((loop_end - sched->last_load_update) >= sched->config.cpu_freq_hz) {
+            update_load(sched, loop_end);
         }
     }
 }
 
+/**
+ * @brief 设置空闲回调
+ */
+void scheduler_set_idle_hook(task_scheduler_fc_t *sched, scheduler_idle_cb_t hook, void *user,
+                             uint32_t min_idle_us)
+{
+    if (!sched) return;
+    sched->idle_hook = hook;
+    sched->idle_user = user;
+    sched->idle_min_cycles = clockMicrosToCycles(min_idle_us);
+}
+
+/**
+ * @brief 默认空闲回调：距下一个到期超过唤醒间隔时睡眠到下一个中断
+ * @note  唤醒间隔内一定有中断（SysTick），睡眠不会越过到期时刻；余量不足时返回，
+ *        由 scheduler_run 继续轮询
+ */
+void scheduler_idle_wfi(void *user, uint32_t idle_cycles)
+{
+    const uint32_t wake_us = user ? *(const uint32_t *)user : SCHEDULER_IDLE_WAKE_US;
+    if (idle_cycles <= clockMicrosToCycles(wake_us)) {
+        return;
+    }
+    __DSB();
+    __WFI();
+}
+
+// ============================================================================
+// 实时通道
+// ============================================================================
+
+/**
+ * @brief 启用实时通道，priority <= max_priority 的任务改由 scheduler_rt_isr 派发
+ * @note  之后注册的任务同样按优先级分配通道
+ */
+void scheduler_enable_rt_lane(task_scheduler_fc_t *sched, task_priority_t max_priority)
+{
+    if (!sched) return;
+
+    __disable_irq();
+    sched->rt_max_priority = max_priority;
+    sched->rt_lane_enabled = true;
+    queue_rebuild(sched);
+    __enable_irq();
+}
+
+/**
+ * @brief 关闭实时通道，所有任务回到 scheduler_run 协作执行
+ */
+void scheduler_disable_rt_lane(task_scheduler_fc_t *sched)
+{
+    if (!sched) return;
+
+    __disable_irq();
+    sched->rt_lane_enabled = false;
+    queue_rebuild(sched);
+    __enable_irq();
+}
+
+/**
+ * @brief 实时通道派发（在 IMU EXTI 挂起的 PendSV 或定时器中断中调用）
+ * @note  按优先级执行所有到期的实时通道任务；抢占的协作任务在中断返回后继续。
+ *        两条通道的任务与队列互不重叠，scheduler_run 不会访问实时通道任务的状态。
+ *        事件任务的释放时刻取中断入口，抖动即“中断入口 -> 任务开始”的派发延迟。
+ */
+void scheduler_rt_isr(task_scheduler_fc_t *sched)
+{
+    if (!sched || !sched->rt_lane_enabled) return;
+
+    // 两个不同优先级的中断源都挂了本函数时，低优先级那次正在派发，直接放弃本次
+    if (sched->rt_in_isr) {
+        sched->lane_stats[TASK_LANE_RT].reentry_count++;
+        return;
+    }
+    sched->rt_in_isr = true;
+
+    uint32_t start = DWT_GetTick();
+    uint32_t busy_start = sched->busy_cycles[TASK_LANE_RT];
+    run_lane(sched, TASK_LANE_RT, start);
+
+    if (sched->config.enable_stats) {
+        uint32_t cycles = DWT_GetTick() - start;
+        sched->overhead_cycles[TASK_LANE_RT] += cycles - (sched->busy_cycles[TASK_LANE_RT] - busy_start);
+        sched->rt_isr_cycles += cycles;
+    }
+
+    sched->rt_in_isr = false;
+}
+
 // ============================================================================
 // 中断触发
 // ============================================================================
 
+/**
+ * @brief 按名字查找任务句柄
+ * @note  线性 strcmp 查找，仅供 CLI/调试使用；运行时请保存注册函数返回的句柄，不要在中断中调用
+ */
+task_handle_t scheduler_find_task(task_scheduler_fc_t *sched, const char *name)
+{
+    int idx = find_task_index(sched, name);
+    return (idx < 0) ? TASK_HANDLE_INVALID : (task_handle_t)idx;
+}
+
+/**
+ * @brief 在中断中向事件队列任务投递一个事件（单生产者，无锁）
+ * @note  先写槽位再推进 head，消费者看到 head 变化时槽位内容已完整；
+ *        同一个队列只能有一个生产者上下文，多个中断源需各自使用不同的任务/队列
+ */
+bool scheduler_post_from_isr(task_scheduler_fc_t *sched, task_handle_t task,
+                             uint16_t type, uint16_t arg, void *payload)
+{
+    task_entry_t *t = task_from_handle(sched, task);
+    if (!t || !t->events.buf) return false;
+
+    task_event_queue_t *q = &t->events;
+
+    uint8_t head = q->head;
+    if ((uint8_t)(head - q->tail) > q->mask) {
+        t->stats.event_drop_count++;   // 队列满：丢弃最新事件
+        return false;
+    }
+
+    task_event_t *ev = &q->buf[head & q->mask];
+    ev->type = type;
+    ev->arg = arg;
+    ev->payload = payload;
+    ev->timestamp = DWT_GetTick();
+    __DMB();   // 槽位写完后再发布
+    q->head = (uint8_t)(head + 1);
+    return true;
+}
+
 /**
  * @brief 在中断中直接触发任务执行
  * @warning 任务会在中断上下文中执行，必须确保任务足够快！
  */
-void scheduler_trigger_from_isr(task_scheduler_fc_t *sched, const char *task_name)
+void scheduler_trigger_from_isr(task_scheduler_fc_t *sched, task_handle_t handle)
 {
-    if (!sched || !task_name) return;
-    
-    // 查找任务
-    int idx = find_task_index(sched, task_name);
-    if (idx < 0) return;
-    
-    task_entry_t *task = &sched->tasks[idx];
+    task_entry_t *task = task_from_handle(sched, handle);
+    if (!task) return;
     
     // 在中断上下文中直接执行任务
-    if (task->active && task->callback) {
+    if (task->active && task->desc->callback) {
         uint32_t start = DWT_GetTick();
-        task->callback(task->user_data);
+        task->desc->callback(task->desc->user_data);
         uint32_t end = DWT_GetTick();
         
         // 简单的统计（不做复杂计算）
@@ -426,30 +1058,75 @@ void scheduler_trigger_from_isr(task_scheduler_fc_t *sched, const char *task_nam
 /**
  * @brief 挂起任务（暂停执行）
  */
-bool scheduler_suspend_task(task_scheduler_fc_t *sched, const char *name)
+bool scheduler_suspend_task(task_scheduler_fc_t *sched, task_handle_t handle)
 {
-    int idx = find_task_index(sched, name);
-    if (idx < 0) return false;
+    task_entry_t *task = task_from_handle(sched, handle);
+    if (!task) return false;
     
-    sched->tasks[idx].state = TASK_STATE_SUSPENDED;
+    __disable_irq();
+    task->state = TASK_STATE_SUSPENDED;
+    queue_remove_task(sched, (uint8_t)handle);
+    __enable_irq();
+    return true;
+}
+
+/**
+ * @brief 设置周期任务的相位与超时策略
+ * @note  设置后任务的释放时刻对齐到 epoch + phase + k*period，
+ *        相同周期、不同相位的任务在同一周期内按相位先后错开运行
+ */
+bool scheduler_set_task_timing(task_scheduler_fc_t *sched, task_handle_t handle, const task_timing_t *timing)
+{
+    task_entry_t *task = task_from_handle(sched, handle);
+    if (!task || !timing) return false;
+
+    if (task->desc->trigger_mode != TASK_TRIGGER_PERIODIC) return false;
+
+    uint32_t phase_cycles = clockMicrosToCycles(timing->phase_us);
+    if (phase_cycles >= task->desc->period_cycles) {
+        printf("[scheduler] %s: phase %lu us >= period\r\n", task->desc->name, (unsigned long)timing->phase_us);
+        return false;
+    }
+
+    __disable_irq();
+    queue_remove_task(sched, (uint8_t)handle);
+    task->phase_cycles = phase_cycles;
+    task->phased = true;
+    task->overrun_policy = timing->overrun_policy;
+    task->catch_up_max = timing->catch_up_max;
+    task->catch_up_run = 0;
+    align_to_phase(sched, task, DWT_GetTick());
+    if (task->active && task->state != TASK_STATE_SUSPENDED) {
+        queue_add_task(sched, (uint8_t)handle);
+    }
+    __enable_irq();
+
     return true;
 }
 
 /**
  * @brief 恢复任务（继续执行）
  */
-bool scheduler_resume_task(task_scheduler_fc_t *sched, const char *name)
+bool scheduler_resume_task(task_scheduler_fc_t *sched, task_handle_t handle)
 {
-    int idx = find_task_index(sched, name);
-    if (idx < 0) return false;
+    task_entry_t *task = task_from_handle(sched, handle);
+    if (!task) return false;
     
-    sched->tasks[idx].state = TASK_STATE_READY;
-    
-    // 对于周期任务，重置下次运行时间
-    if (sched->tasks[idx].trigger_mode == TASK_TRIGGER_PERIODIC) {
+    // 出队后修改 next_run_time 再重新入队，保持堆有序
+    __disable_irq();
+    queue_remove_task(sched, (uint8_t)handle);
+    if (task->desc->trigger_mode == TASK_TRIGGER_PERIODIC) {
         uint32_t now = DWT_GetTick();
-        sched->tasks[idx].next_run_time = now + sched->tasks[idx].period_cycles;
+        if (task->phased) {
+            align_to_phase(sched, task, now);   // 回到原来的相位网格
+        } else {
+            task->next_run_time = now + task->desc->period_cycles;
+        }
+        task->catch_up_run = 0;
     }
+    task->state = TASK_STATE_READY;
+    queue_add_task(sched, (uint8_t)handle);
+    __enable_irq();
     
     return true;
 }
@@ -461,12 +1138,39 @@ bool scheduler_resume_task(task_scheduler_fc_t *sched, const char *name)
 /**
  * @brief 获取任务统计信息
  */
-const task_stats_t* scheduler_get_stats(task_scheduler_fc_t *sched, const char *name)
+const task_stats_t* scheduler_get_stats(task_scheduler_fc_t *sched, task_handle_t handle)
 {
-    int idx = find_task_index(sched, name);
-    if (idx < 0) return NULL;
-    
-    return &sched->tasks[idx].stats;
+    task_entry_t *task = task_from_handle(sched, handle);
+    return task ? &task->stats : NULL;
+}
+
+/**
+ * @brief 获取通道统计信息（派发次数、释放抖动）
+ */
+const task_lane_stats_t* scheduler_get_lane_stats(task_scheduler_fc_t *sched, task_lane_t lane)
+{
+    if (!sched || lane >= TASK_LANE_COUNT) return NULL;
+    return &sched->lane_stats[lane];
+}
+
+/**
+ * @brief 获取任务执行时间与释放抖动的 p50/p99/p99.9（CPU周期数）
+ */
+bool scheduler_get_percentiles(task_scheduler_fc_t *sched, task_handle_t handle, task_percentiles_t *out)
+{
+    const task_entry_t *t = task_from_handle(sched, handle);
+    if (!t || !out) return false;
+
+    memset(out, 0, sizeof(*out));
+#if SCHEDULER_HIST
+    out->exec_p50    = task_hist_percentile(&t->exec_hist, 5000);
+    out->exec_p99    = task_hist_percentile(&t->exec_hist, 9900);
+    out->exec_p999   = task_hist_percentile(&t->exec_hist, 9990);
+    out->jitter_p50  = task_hist_percentile(&t->jitter_hist, 5000);
+    out->jitter_p99  = task_hist_percentile(&t->jitter_hist, 9900);
+    out->jitter_p999 = task_hist_percentile(&t->jitter_hist, 9990);
+#endif
+    return true;
 }
 
 /**
@@ -478,6 +1182,15 @@ float scheduler_get_cpu_load(task_scheduler_fc_t *sched)
     return sched->cpu_load;
 }
 
+/**
+ * @brief 获取上一个统计窗口的 CPU 时间分解
+ */
+const scheduler_load_t* scheduler_get_load(task_scheduler_fc_t *sched)
+{
+    if (!sched) return NULL;
+    return &sched->load;
+}
+
 /**
  * @brief 重置所有任务的统计信息
  */
@@ -485,14 +1198,25 @@ void scheduler_reset_stats(task_scheduler_fc_t *sched)
 {
     if (!sched) return;
     
-    // 清空所有任务的统计
+    // 清空所有任务与通道的统计（实时通道中断也在写，关中断清零）
+    __disable_irq();
     for (uint8_t i = 0; i < sched->task_count; i++) {
         memset(&sched->tasks[i].stats, 0, sizeof(task_stats_t));
+        sched->tasks[i].busy_cycles = 0;
+#if SCHEDULER_HIST
+        task_hist_reset(&sched->tasks[i].exec_hist);
+        task_hist_reset(&sched->tasks[i].jitter_hist);
+#endif
     }
+    memset(sched->lane_stats, 0, sizeof(sched->lane_stats));
+    memset(sched->busy_cycles, 0, sizeof(sched->busy_cycles));
+    memset(sched->overhead_cycles, 0, sizeof(sched->overhead_cycles));
+    sched->idle_cycles = 0;
+    sched->sleep_cycles = 0;
+    __enable_irq();
     
     // 重置CPU负载统计
-    sched->total_cycles = 0;
-    sched->idle_cycles = 0;
+    memset(&sched->load, 0, sizeof(sched->load));
     sched->cpu_load = 0.0f;
     sched->last_load_update = DWT_GetTick();
 }
@@ -510,29 +1234,169 @@ void scheduler_print_stats(task_scheduler_fc_t *sched)
 
     // 打印调度器总览
     printf("\r\n========== 调度器统计 ==========\r\n");
-    printf("CPU 负载: %.1f%%\r\n", sched->cpu_load);
-    printf("任务数量: %d/%d\r\n\r\n", sched->task_count, sched->capacity);
+    const scheduler_load_t *ld = &sched->load;
+    printf("CPU 负载: %.1f%% (任务 %.1f%%, 调度开销 %.1f%%, 其他 %.1f%%, 空闲 %.1f%%, 其中睡眠 %.1f%%)\r\n",
+           sched->cpu_load, ld->task, ld->overhead, ld->other, ld->idle, ld->sleep);
+    printf("任务数量: %d/%d\r\n", sched->task_count, sched->capacity);
+    printf("实时通道: %s\r\n\r\n", sched->rt_lane_enabled ? "启用" : "关闭");
 
     // 打印表头
-    printf("%-18s %-8s %-10s %-8s %-8s %-8s %-8s\r\n",
-           "任务名", "优先级", "触发模式", "执行次数", "当前(us)", "最大(us)", "超时次数");
-    printf("------------------------------------------------------------------------------------\r\n");
+    printf("%-18s %-8s %-10s %-4s %-8s %-8s %-8s %-8s %-8s %-6s\r\n",
+           "任务名", "优先级", "触发模式", "通道", "执行次数", "当前(us)", "最大(us)", "抖动(us)", "超时次数", "占用%");
+    printf("-------------------------------------------------------------------------------------------------------\r\n");
 
     // 打印每个任务的统计信息
     const char *prio_str[] = {"CRITICAL", "HIGH", "NORMAL", "LOW", "IDLE"};
     const char *mode_str[] = {"PERIODIC", "EVENT"};
+    const char *lane_str[] = {"COOP", "RT"};
     
     for (uint8_t i = 0; i < sched->task_count; i++) {
         task_entry_t *t = &sched->tasks[i];
-        printf("%-18s %-8s %-10s %-8lu %-8lu %-8lu %-8lu\r\n",
-               t->name,                              // 任务名
-               prio_str[t->priority],                // 优先级
-               mode_str[t->trigger_mode],            // 触发模式
-               t->stats.exec_count,                  // 执行次数
-               t->stats.exec_time_us,                // 最近一次执行时间
-               t->stats.exec_time_max_us,            // 最大执行时间
-               t->stats.overrun_count);              // 超时次数
+        printf("%-18s %-8s %-10s %-4s %-8lu %-8lu %-8lu %-8lu %-8lu %-6.1f\r\n",
+               t->desc->name,                              // 任务名
+               prio_str[t->desc->priority],                // 优先级
+               mode_str[t->desc->trigger_mode],            // 触发模式
+               lane_str[t->lane],                    // 执行通道
+               (unsigned long)t->stats.exec_count,       // 执行次数
+               (unsigned long)t->stats.exec_time_us,     // 最近一次执行时间
+               (unsigned long)t->stats.exec_time_max_us, // 最大执行时间
+               (unsigned long)t->stats.jitter_max_us,    // 最大释放抖动
+               (unsigned long)t->stats.overrun_count,    // 超时次数
+               t->stats.cpu_load);                   // CPU 占用
+    }
+
+#if SCHEDULER_HIST
+    // 打印分位数（微秒，保留小数：直方图以周期为单位，不受 cycles_to_us 取整影响）
+    printf("\r\n%-18s %-26s %-26s\r\n", "任务名", "执行 p50/p99/p99.9 (us)", "抖动 p50/p99/p99.9 (us)");
+    float us_per_cycle = 1e6f / (float)sched->config.cpu_freq_hz;
+    for (uint8_t i = 0; i < sched->task_count; i++) {
+        task_percentiles_t p;
+        scheduler_get_percentiles(sched, (task_handle_t)i, &p);
+        printf("%-18s %7.1f %7.1f %7.1f    %7.1f %7.1f %7.1f\r\n", sched->tasks[i].desc->name,
+               p.exec_p50 * us_per_cycle, p.exec_p99 * us_per_cycle, p.exec_p999 * us_per_cycle,
+               p.jitter_p50 * us_per_cycle, p.jitter_p99 * us_per_cycle, p.jitter_p999 * us_per_cycle);
+    }
+#endif
+
+    // 打印通道抖动汇总
+    printf("\r\n");
+    for (uint8_t l = 0; l < TASK_LANE_COUNT; l++) {
+        const task_lane_stats_t *ls = &sched->lane_stats[l];
+        printf("[%-4s] 派发 %lu 次, 抖动 平均 %lu us / 最大 %lu us, 重入 %lu\r\n",
+               lane_str[l], (unsigned long)ls->dispatch_count,
+               ls->jitter_samples ? (unsigned long)(ls->jitter_total_us / ls->jitter_samples) : 0UL,
+               (unsigned long)ls->jitter_max_us, (unsigned long)ls->reentry_count);
     }
     
     printf("=================================\r\n\r\n");
 }
+
+// ============================================================================
+// 直方图二进制导出
+// ============================================================================
+
+#define HIST_DUMP_VERSION   1
+#define HIST_DUMP_NAME_MAX  15
+
+#if SCHEDULER_HIST
+static void dump_hist(dump_writer_t *d, const task_hist_t *h)
+{
+    uint8_t nonzero = 0;
+    for (uint8_t b = 0; b < TASK_HIST_BUCKETS; b++) {
+        if (h->count[b]) nonzero++;
+    }
+    dump_writer_u8(d, nonzero);
+    for (uint8_t b = 0; b < TASK_HIST_BUCKETS; b++) {
+        if (h->count[b]) {
+            dump_writer_u8(d, b);
+            dump_writer_u16(d, h->count[b]);
+        }
+    }
+}
+#endif
+
+/**
+ * @brief 以紧凑二进制格式导出所有任务的直方图（格式见 scheduler.h）
+ * @note  只导出非零桶；导出期间不关中断，实时通道任务的直方图可能是略微不一致的快照
+ */
+uint32_t scheduler_dump_histograms(task_scheduler_fc_t *sched, scheduler_write_cb write, void *user)
+{
+    if (!sched || !write) return 0;
+
+    dump_writer_t d;
+    dump_writer_init(&d, write, user);
+    const uint8_t magic[2] = { 'S', 'H' };
+    dump_writer_put(&d, magic, 2);
+    dump_writer_u8(&d, HIST_DUMP_VERSION);
+    dump_writer_u8(&d, sched->task_count);
+    dump_writer_u32(&d, sched->config.cpu_freq_hz);
+    dump_writer_u8(&d, TASK_HIST_LINEAR);
+    dump_writer_u8(&d, TASK_HIST_SUB_BITS);
+    dump_writer_u8(&d, TASK_HIST_BUCKETS);
+
+    for (uint8_t i = 0; i < sched->task_count; i++) {
+        const task_entry_t *t = &sched->tasks[i];
+        size_t name_len = t->desc->name ? strlen(t->desc->name) : 0;
+        if (name_len > HIST_DUMP_NAME_MAX) name_len = HIST_DUMP_NAME_MAX;
+        dump_writer_u8(&d, (uint8_t)name_len);
+        dump_writer_put(&d, (const uint8_t *)t->desc->name, (uint16_t)name_len);
+        dump_writer_u8(&d, (uint8_t)t->desc->priority);
+        dump_writer_u8(&d, (uint8_t)t->lane);
+        dump_writer_u8(&d, (uint8_t)t->desc->trigger_mode);
+        dump_writer_u32(&d, t->stats.exec_count);
+#if SCHEDULER_HIST
+        dump_hist(&d, &t->exec_hist);
+        dump_hist(&d, &t->jitter_hist);
+#else
+        dump_writer_u8(&d, 0);
+        dump_writer_u8(&d, 0);
+#endif
+    }
+
+    return dump_writer_finish(&d);
+}
+
+// base64 流式编码：攒够 3 字节输出 4 个字符
+typedef struct {
+    uint8_t carry[3];
+    uint8_t n;
+} b64_stream_t;
+
+static const char b64_table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static void b64_flush(b64_stream_t *s)
+{
+    if (s->n == 0) return;
+    uint32_t v = ((uint32_t)s->carry[0] << 16) | ((uint32_t)s->carry[1] << 8) | s->carry[2];
+    char out[5] = {
+        b64_table[(v >> 18) & 0x3F], b64_table[(v >> 12) & 0x3F],
+        (s->n > 1) ? b64_table[(v >> 6) & 0x3F] : '=',
+        (s->n > 2) ? b64_table[v & 0x3F] : '=', 0
+    };
+    printf("%s", out);
+    memset(s->carry, 0, sizeof(s->carry));
+    s->n = 0;
+}
+
+static void b64_write(void *user, const uint8_t *data, uint16_t len)
+{
+    b64_stream_t *s = (b64_stream_t *)user;
+    for (uint16_t i = 0; i < len; i++) {
+        s->carry[s->n++] = data[i];
+        if (s->n == 3) b64_flush(s);
+    }
+}
+
+/**
+ * @brief 以一行 "SCHED_HIST,<base64>" 输出直方图导出，兼容上位机的文本行协议
+ */
+void scheduler_print_histograms(task_scheduler_fc_t *sched)
+{
+    if (!sched) return;
+
+    b64_stream_t s = { { 0, 0, 0 }, 0 };
+    printf("SCHED_HIST,");
+    scheduler_dump_histograms(sched, b64_write, &s);
+    b64_flush(&s);
+    printf("\r\n");
+}
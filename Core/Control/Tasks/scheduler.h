@@ -2,6 +2,29 @@
  * @file    scheduler.h
  * @brief   飞控专用任务调度器 - 支持周期性任务和事件触发任务
  * @note    基于 DWT 周期计数器实现精确时间管理
+ *
+ *          两级调度：
+ *          - 协作通道：scheduler_run 在主循环中按优先级轮询，任务之间不可抢占
+ *          - 实时通道：scheduler_enable_rt_lane 后，优先级不低于 rt_max_priority 的任务
+ *            （默认 CRITICAL/HIGH）改由 scheduler_rt_isr 在中断中派发。该函数应挂在
+ *            由 IMU 数据就绪 EXTI 挂起的 PendSV（BSP_RT_Lane_Pend）或定时器更新中断里，
+ *            中断会抢占正在运行的协作任务，因此 BMP280 HAL_Delay、VL53L0X 测距之类的
+ *            慢任务不再拖延陀螺/PID 路径
+ *
+ *          实时通道中断的 NVIC 优先级应数值上大于 SPI DMA（=1），否则实时任务中
+ *          等待 DMA 完成会死锁；小于 I2C/UART（=5），以便抢占它们的回调。
+ *          IMU EXTI 本身也是 1，因此不能直接在 EXTI 中调用，BSP 用优先级 2 的 PendSV。
+ *          两条通道的释放抖动（实际开始时刻 - 计划时刻）分别统计，
+ *          见 task_stats_t.jitter_* 与 scheduler_get_lane_stats。
+ *
+ *          派发核心：每条通道一个就绪队列。周期任务放在按 next_run_time 排序的最小堆中，
+ *          空闲时只比较堆顶；到期任务与置位的事件任务写入按优先级分组的就绪位图，
+ *          取下一个任务 = 两次 CTZ，与任务总数无关。事件任务的标志位/回调仍需逐个轮询，
+ *          但只遍历事件任务位图，不再按优先级把整张任务表扫 5 遍。
+ *          所有周期任务的 next_run_time 需在彼此 2^31 个周期（168MHz 下约 12.7s）以内。
+ *
+ *          周期任务按时间网格释放：执行后 next_run_time += period，而不是“结束时刻 + period”，
+ *          执行时间不会累积成频率漂移。错过整周期时按任务的 task_overrun_policy_t 处理。
  */
 
 #ifndef SCHEDULERH
@@ -10,6 +33,17 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "bsp_System.h"
+#include "scheduler_hist.h"
+
+// 每个任务的执行时间/释放抖动直方图（每任务约 370 字节，RAM 紧张时可定义为 0 关闭）
+#ifndef SCHEDULER_HIST
+#define SCHEDULER_HIST          1
+#endif
+
+// scheduler_idle_wfi 默认假定的最长唤醒间隔（SysTick 1kHz）：距下一个到期不超过该值时不睡眠
+#ifndef SCHEDULER_IDLE_WAKE_US
+#define SCHEDULER_IDLE_WAKE_US  1000U
+#endif
 
 // ============================================================================
 // 任务优先级（数字越小优先级越高）
@@ -20,8 +54,21 @@ typedef enum {
     TASK_PRIORITY_NORMAL   = 2,  // 普通优先级：遥控器接收、传感器读取
     TASK_PRIORITY_LOW      = 3,  // 低优先级：气压计、磁力计
     TASK_PRIORITY_IDLE     = 4,  // 空闲任务：LED、日志输出
+    TASK_PRIORITY_COUNT,
 } task_priority_t;
 
+// 任务数上限（就绪位图为 32 位）
+#define SCHEDULER_MAX_TASKS     32
+#define SCHEDULER_NOT_QUEUED    0xFF    // task_entry_t.heap_pos：不在最小堆中
+
+// scheduler_register_* 动态注册可用的描述符数（每个调度器实例内的 RAM 池，每个约 44 字节）。
+// 只使用静态任务表（scheduler_init_static）时定义为 0：scheduler_init/scheduler_register_* 与
+// task_register.h 随之编译掉，残留的调用在编译/链接时报错，而不是运行时返回 TASK_HANDLE_INVALID。
+// 固件构建（CMakeLists.txt）即定义为 0，SIL 测试保留默认值
+#ifndef SCHEDULER_DYNAMIC_TASKS
+#define SCHEDULER_DYNAMIC_TASKS SCHEDULER_MAX_TASKS
+#endif
+
 // ============================================================================
 // 任务触发模式
 // ============================================================================
@@ -30,6 +77,31 @@ typedef enum {
     TASK_TRIGGER_EVENT,      // 事件触发（标志位或回调判断）
 } task_trigger_mode_t;
 
+// ============================================================================
+// 执行通道
+// ============================================================================
+typedef enum {
+    TASK_LANE_COOPERATIVE = 0,   // 协作通道：主循环 scheduler_run
+    TASK_LANE_RT,                // 实时通道：中断 scheduler_rt_isr
+    TASK_LANE_COUNT,
+} task_lane_t;
+
+// ============================================================================
+// 周期任务超时（错过释放时刻）处理策略
+// ============================================================================
+typedef enum {
+    TASK_OVERRUN_SKIP = 0,   // 保持相位：跳过已错过的周期，下次在原时间网格上运行（默认）
+    TASK_OVERRUN_CATCH_UP,   // 补跑：立即连续补跑错过的周期，最多 catch_up_max 次，超出部分跳过
+    TASK_OVERRUN_REPHASE,    // 重新定相：以本次结束时刻为新起点（旧调度器行为）
+} task_overrun_policy_t;
+
+// 周期任务时序参数（scheduler_set_task_timing）
+typedef struct {
+    uint32_t              phase_us;        // 相位：释放时刻 = 调度器时间原点 + phase + k*period
+    task_overrun_policy_t overrun_policy;  // 超时策略
+    uint8_t               catch_up_max;    // CATCH_UP 策略下最多连续补跑的次数
+} task_timing_t;
+
 // ============================================================================
 // 任务状态
 // ============================================================================
@@ -46,6 +118,32 @@ typedef enum {
 typedef void (*task_cb_t)(void *user);                // 任务执行回调
 typedef bool (*task_should_run_cb_t)(void *user);     // 任务判断回调（返回true表示应该执行）
 
+// ============================================================================
+// 任务句柄（tasks[] 下标）：由 scheduler_register_* 返回，任务控制与查询接口均以句柄为参数，
+// O(1) 定位且不做字符串比较；按名字查找只保留 scheduler_find_task（供 CLI/调试使用）
+// ============================================================================
+typedef int8_t task_handle_t;
+#define TASK_HANDLE_INVALID     ((task_handle_t)-1)
+
+// ============================================================================
+// 事件队列（中断 -> 任务，单生产者/单消费者无锁环形队列）
+// ============================================================================
+typedef struct {
+    uint16_t  type;         // 事件类型（由应用定义，如 IMU 帧 / CRSF 帧 / DMA 完成）
+    uint16_t  arg;          // 小参数（长度、通道号等）
+    void     *payload;      // 负载指针（生产者保证其在回调返回前有效）
+    uint32_t  timestamp;    // 投递时刻（DWT 周期），作为该事件的释放时刻统计抖动
+} task_event_t;
+
+typedef void (*task_event_cb_t)(void *user, const task_event_t *event);   // 事件队列任务回调
+
+typedef struct {
+    task_event_t     *buf;      // 调用者提供的存储（深度为 2 的幂，<= 128）
+    uint8_t           mask;     // 深度 - 1
+    volatile uint8_t  head;     // 只由生产者（中断）推进
+    volatile uint8_t  tail;     // 只由消费者（调度器）推进
+} task_event_queue_t;
+
 // ============================================================================
 // 任务统计信息
 // ============================================================================
@@ -55,39 +153,113 @@ typedef struct {
     uint32_t exec_time_max_us;     // 最大执行时间（微秒）
     uint32_t exec_time_total_us;   // 累计执行时间（微秒）
     uint32_t overrun_count;        // 超时次数（执行时间超过允许值）
-    uint32_t missed_count;         // 错过次数（未能按时执行）
+    uint32_t missed_count;         // 错过次数（被跳过的周期数，REPHASE 策略为重新定相次数）
+    uint32_t catch_up_count;       // 补跑次数（CATCH_UP 策略）
+    uint32_t jitter_us;            // 最近一次释放抖动（微秒，实际开始 - 计划时刻）
+    uint32_t jitter_max_us;        // 最大释放抖动（微秒）
+    uint32_t event_drop_count;     // 事件队列满而丢弃的事件数（由生产者递增）
+    float    cpu_load;             // 上一个统计窗口（1s）内的 CPU 占用（%，扣除被实时通道抢占的时间）
 } task_stats_t;
 
+// 分位数（单位：CPU 周期，未启用 SCHEDULER_HIST 时全为 0）
+typedef struct {
+    uint32_t exec_p50;
+    uint32_t exec_p99;
+    uint32_t exec_p999;
+    uint32_t jitter_p50;
+    uint32_t jitter_p99;
+    uint32_t jitter_p999;
+} task_percentiles_t;
+
+// CPU 时间分解（上一个 1s 统计窗口，单位 %，各项之和为 100）
+typedef struct {
+    float cpu_load;                // 100 - idle
+    float task;                    // 任务回调（两条通道，协作任务扣除被抢占时间）
+    float overhead;                // 调度器自身：派发了任务的 scheduler_run 与 scheduler_rt_isr 中任务之外的时间
+    float idle;                    // 没有任务可运行的 scheduler_run 调用（含空闲回调）
+    float sleep;                   // idle 中处于空闲回调（WFI）的部分
+    float other;                   // 其余：scheduler_run 之外的主循环代码、其他中断
+} scheduler_load_t;
+
+// 空闲回调：协作通道没有可运行的任务时调用（关中断状态下），idle_cycles 为距下一个
+// 周期任务到期的 CPU 周期数（没有周期任务时为 UINT32_MAX）。回调内执行 __WFI() 时，
+// 关中断期间挂起的中断同样会唤醒内核，返回后开中断、中断随即执行，不会丢失事件
+typedef void (*scheduler_idle_cb_t)(void *user, uint32_t idle_cycles);
+
+// 二进制导出的写出回调
+typedef void (*scheduler_write_cb)(void *user, const uint8_t *data, uint16_t len);
+
+// ============================================================================
+// 通道统计信息
+// ============================================================================
+typedef struct {
+    uint32_t dispatch_count;       // 派发任务次数
+    uint32_t jitter_samples;       // 参与抖动统计的次数
+    uint32_t jitter_max_us;        // 最大释放抖动（微秒）
+    uint32_t jitter_total_us;      // 累计释放抖动（微秒，除以 jitter_samples 得平均）
+    uint32_t reentry_count;        // 实时通道：上一次中断派发尚未返回时再次进入的次数
+} task_lane_stats_t;
+
 // ============================================================================
-// 任务控制块（Task Control Block）
+// 任务描述符（只读部分）：清单（task_manifest.h）生成的静态任务表是 const，放在 Flash；
+// scheduler_register_* 动态注册的任务使用调度器内的 RAM 描述符池
 // ============================================================================
 typedef struct {
-    // 基本信息
     const char          *name;          // 任务名称
-    task_cb_t            callback;      // 任务回调函数
+    task_cb_t            callback;      // 任务回调函数（事件队列任务为 NULL）
+    task_event_cb_t      event_cb;      // 事件队列任务回调（每个事件调用一次）
+    task_should_run_cb_t should_run;    // 判断是否应该运行的回调函数
+    volatile bool       *event_flag;    // 事件标志位指针
+    task_event_t        *event_buf;     // 事件队列存储（非空时为事件队列任务）
     void                *user_data;     // 用户数据指针
-
-    // 调度参数
+    uint32_t             period_cycles; // 周期（CPU时钟周期数）
+    uint32_t             max_exec_us;   // 最大允许执行时间（微秒，0=不限制）
     task_priority_t      priority;      // 任务优先级
     task_trigger_mode_t  trigger_mode;  // 触发模式
+    uint8_t              event_depth;   // 事件队列深度（2 的幂）
+} task_desc_t;
+
+// ============================================================================
+// 任务控制块（Task Control Block）：运行状态，放在 RAM
+// ============================================================================
+typedef struct {
+    const task_desc_t   *desc;          // 只读描述符
+
+    // 调度状态
     task_state_t         state;         // 任务状态
+    task_lane_t          lane;          // 执行通道（由优先级与 rt_max_priority 决定）
 
-    // 周期性任务参数
-    uint32_t             period_cycles;  // 周期（CPU时钟周期数）
-    uint32_t             next_run_time;  // 下次运行时间
+    // 周期性任务状态
+    uint32_t             next_run_time;  // 下次运行时间（锚定在时间网格上：每次 += period_cycles）
+    uint32_t             phase_cycles;   // 相位偏移（相对 epoch，CPU周期数）
+    bool                 phased;         // 是否锚定到 epoch + phase 的网格（否则锚定在注册时刻）
+    task_overrun_policy_t overrun_policy; // 超时策略
+    uint8_t              catch_up_max;   // 最多连续补跑次数
+    uint8_t              catch_up_run;   // 当前已连续补跑次数
+    uint8_t              heap_pos;       // 在所属通道最小堆中的位置（SCHEDULER_NOT_QUEUED=不在堆中）
 
-    // 事件触发任务参数
-    task_should_run_cb_t should_run;    // 判断是否应该运行的回调函数
-    volatile bool       *event_flag;    // 事件标志位指针
+    // 事件队列（events.buf 非空时为事件队列任务，buf/mask 取自描述符）
+    task_event_queue_t   events;
 
     // 性能监控
     task_stats_t         stats;         // 统计信息
-    uint32_t             max_exec_time_us;  // 最大允许执行时间（微秒，0=不限制）
+    uint32_t             busy_cycles;   // 当前统计窗口内的执行周期数（净值）
+#if SCHEDULER_HIST
+    task_hist_t          exec_hist;     // 执行时间直方图（CPU周期数）
+    task_hist_t          jitter_hist;   // 释放抖动直方图（CPU周期数，与 jitter_us 同一批样本）
+#endif
 
     // 控制标志
     bool                 active;        // 任务是否激活
 } task_entry_t;
 
+// 静态任务表（由 TASK_MANIFEST_DEFINE 生成）
+typedef struct {
+    const task_desc_t   *tasks;
+    uint8_t              count;
+    uint32_t             cpu_freq_hz;   // 换算 period_cycles 时使用的主频
+} task_table_t;
+
 // ============================================================================
 // 调度器配置
 // ============================================================================
@@ -98,6 +270,17 @@ typedef struct {
     uint32_t max_tasks;             // 最大任务数量
 } scheduler_config_t;
 
+// ============================================================================
+// 通道就绪队列
+// ============================================================================
+typedef struct {
+    uint8_t  heap[SCHEDULER_MAX_TASKS];         // 周期任务最小堆（任务下标，按 next_run_time）
+    uint8_t  heap_size;
+    uint8_t  ready_prio_mask;                   // bit p：ready_mask[p] 非空
+    uint32_t ready_mask[TASK_PRIORITY_COUNT];   // 就绪任务位图（bit i = tasks[i]）
+    uint32_t event_mask;                        // 本通道未挂起的事件任务位图
+} task_queue_t;
+
 // ============================================================================
 // 调度器控制块
 // ============================================================================
@@ -107,51 +290,147 @@ typedef struct {
     uint8_t             capacity;       // 任务容量
     scheduler_config_t  config;         // 配置参数
 
-    // CPU负载统计
-    uint32_t            total_cycles;       // 总周期数
+    // CPU负载统计（当前窗口的累计值，每秒在 scheduler_run 中结算到 load）
+    uint32_t            busy_cycles[TASK_LANE_COUNT];      // 任务执行周期数（净值）
+    uint32_t            overhead_cycles[TASK_LANE_COUNT];  // 调度器开销周期数
     uint32_t            idle_cycles;        // 空闲周期数
-    float               cpu_load;           // CPU负载（0-100%）
+    uint32_t            sleep_cycles;       // 空闲回调内的周期数
+    volatile uint32_t   rt_isr_cycles;      // scheduler_rt_isr 累计耗时（单调递增，用于扣除抢占）
+    scheduler_load_t    load;               // 上一个窗口的分解结果
+    float               cpu_load;           // CPU负载（0-100%，= load.cpu_load）
     uint32_t            last_load_update;   // 上次负载更新时间
+
+    // 空闲回调
+    scheduler_idle_cb_t idle_hook;
+    void               *idle_user;
+    uint32_t            idle_min_cycles;    // 距下一个到期不足该值时不调用空闲回调
+
+    // 周期任务相位的时间原点（scheduler_init 时刻）
+    uint32_t            epoch;
+
+    // 实时通道
+    bool                rt_lane_enabled;    // 是否启用实时通道
+    task_priority_t     rt_max_priority;    // 进入实时通道的最低优先级（含）
+    volatile bool       rt_in_isr;          // scheduler_rt_isr 正在派发
+    task_lane_stats_t   lane_stats[TASK_LANE_COUNT];
+
+    // 派发队列（实时通道的队列只在关中断时由主循环修改）
+    task_queue_t        queue[TASK_LANE_COUNT];
+
+#if SCHEDULER_DYNAMIC_TASKS > 0
+    // 动态注册任务的描述符（下标与任务句柄相同）
+    task_desc_t         desc_pool[SCHEDULER_DYNAMIC_TASKS];
+#endif
 } task_scheduler_fc_t;
 
+#if SCHEDULER_DYNAMIC_TASKS > 0
 void scheduler_init(task_scheduler_fc_t *sched,
                     task_entry_t *storage,
                     uint8_t capacity,
                     const scheduler_config_t *config);
+#endif
+
+/**
+ * @brief 用静态任务表初始化调度器（描述符留在 Flash，state 只保存运行状态）
+ * @param state    运行状态数组
+ * @param capacity state 的项数（>= table->count，多出的槽位留给动态注册，SCHEDULER_DYNAMIC_TASKS > 0 时）
+ * @return false=容量不足，或任务表的主频与 config->cpu_freq_hz（NULL 时为 SystemCoreClock）不一致
+ * @note  任务句柄即表中下标（TASK_MANIFEST_IDS 生成的枚举）
+ */
+bool scheduler_init_static(task_scheduler_fc_t *sched,
+                           const task_table_t *table,
+                           task_entry_t *state,
+                           uint8_t capacity,
+                           const scheduler_config_t *config);
 
-bool scheduler_register_periodic(task_scheduler_fc_t *sched,
-                                 const char *name,
-                                 task_cb_t callback,
-                                 void *user_data,
-                                 task_priority_t priority,
-                                 uint32_t period_us,
-                                 uint32_t max_exec_us);
-
-bool scheduler_register_event_flag(task_scheduler_fc_t *sched,
-                                   const char *name,
-                                   task_cb_t callback,
-                                   void *user_data,
-                                   task_priority_t priority,
-                                   volatile bool *event_flag,
-                                   uint32_t max_exec_us);
-
-bool scheduler_register_event_callback(task_scheduler_fc_t *sched,
-                                       const char *name,
-                                       task_cb_t callback,
-                                       task_should_run_cb_t should_run,
-                                       void *user_data,
-                                       task_priority_t priority,
-                                       uint32_t max_exec_us);
+#if SCHEDULER_DYNAMIC_TASKS > 0
+task_handle_t scheduler_register_periodic(task_scheduler_fc_t *sched,
+                                          const char *name,
+                                          task_cb_t callback,
+                                          void *user_data,
+                                          task_priority_t priority,
+                                          uint32_t period_us,
+                                          uint32_t max_exec_us);
+
+task_handle_t scheduler_register_event_flag(task_scheduler_fc_t *sched,
+                                            const char *name,
+                                            task_cb_t callback,
+                                            void *user_data,
+                                            task_priority_t priority,
+                                            volatile bool *event_flag,
+                                            uint32_t max_exec_us);
+
+// 事件队列任务：中断用 scheduler_post_from_isr 投递事件，调度器逐个把事件交给回调。
+// 任务运行期间到达的事件留在队列中，下一次派发处理，不会像标志位那样被清除而丢失。
+// buffer 深度须为 2 的幂（2..128）；每个队列只允许一个生产者上下文（一个中断源）
+task_handle_t scheduler_register_event_queue(task_scheduler_fc_t *sched,
+                                             const char *name,
+                                             task_event_cb_t callback,
+                                             void *user_data,
+                                             task_priority_t priority,
+                                             task_event_t *buffer,
+                                             uint8_t depth,
+                                             uint32_t max_exec_us);
+
+task_handle_t scheduler_register_event_callback(task_scheduler_fc_t *sched,
+                                                const char *name,
+                                                task_cb_t callback,
+                                                task_should_run_cb_t should_run,
+                                                void *user_data,
+                                                task_priority_t priority,
+                                                uint32_t max_exec_us);
+// 注册函数返回任务句柄，失败（容量已满/参数错误）返回 TASK_HANDLE_INVALID
+#endif // SCHEDULER_DYNAMIC_TASKS > 0
 
 void scheduler_run(task_scheduler_fc_t *sched);
-void scheduler_trigger_from_isr(task_scheduler_fc_t *sched, const char *task_name);
 
-bool scheduler_suspend_task(task_scheduler_fc_t *sched, const char *name);
-bool scheduler_resume_task(task_scheduler_fc_t *sched, const char *name);
+// 设置空闲回调（NULL 关闭）。距下一个周期任务到期不足 min_idle_us 时不调用。
+// 回调依赖中断唤醒：至少需要一个周期性中断源（SysTick 1kHz、IMU EXTI）
+void scheduler_set_idle_hook(task_scheduler_fc_t *sched, scheduler_idle_cb_t hook, void *user,
+                             uint32_t min_idle_us);
+// 默认空闲回调：idle_cycles 大于唤醒间隔时 __WFI()，否则直接返回（忙等轮询），
+// 保证最迟的唤醒中断也早于下一个到期，周期任务不会被睡眠推迟。
+// user 可指向 uint32_t 唤醒间隔（微秒），NULL 时取 SCHEDULER_IDLE_WAKE_US
+void scheduler_idle_wfi(void *user, uint32_t idle_cycles);
+void scheduler_trigger_from_isr(task_scheduler_fc_t *sched, task_handle_t task);
+
+// 按名字查找任务句柄（线性 strcmp 查找，仅供 CLI/调试使用，不要在中断中调用）
+task_handle_t scheduler_find_task(task_scheduler_fc_t *sched, const char *name);
+// 在中断中向事件队列任务投递事件；队列满时丢弃并计入 event_drop_count，返回 false
+bool scheduler_post_from_isr(task_scheduler_fc_t *sched, task_handle_t task,
+                             uint16_t type, uint16_t arg, void *payload);
 
-const task_stats_t* scheduler_get_stats(task_scheduler_fc_t *sched, const char *name);
+// 实时通道：priority <= max_priority 的任务（含之后注册的）移出 scheduler_run，
+// 由 scheduler_rt_isr 在中断上下文中派发
+void scheduler_enable_rt_lane(task_scheduler_fc_t *sched, task_priority_t max_priority);
+void scheduler_disable_rt_lane(task_scheduler_fc_t *sched);
+// 在实时通道中断（PendSV，由 IMU EXTI 挂起）或定时器中断中调用：按优先级执行所有到期的实时通道任务
+void scheduler_rt_isr(task_scheduler_fc_t *sched);
+
+// 设置周期任务的相位与超时策略。相位以 scheduler_init 时刻为原点，同周期任务设置不同相位
+// 即可在一个 IMU 周期内流水排布（陀螺 -> 滤波 -> 姿态 -> PID）；需在 scheduler_init 后
+// 约 12s（2^31 个周期）内设置，超过后网格仍然锚定，但与其他任务的相对相位不再保证
+bool scheduler_set_task_timing(task_scheduler_fc_t *sched, task_handle_t task, const task_timing_t *timing);
+
+bool scheduler_suspend_task(task_scheduler_fc_t *sched, task_handle_t task);
+bool scheduler_resume_task(task_scheduler_fc_t *sched, task_handle_t task);
+
+const task_stats_t* scheduler_get_stats(task_scheduler_fc_t *sched, task_handle_t task);
+const task_lane_stats_t* scheduler_get_lane_stats(task_scheduler_fc_t *sched, task_lane_t lane);
+bool scheduler_get_percentiles(task_scheduler_fc_t *sched, task_handle_t task, task_percentiles_t *out);
 void scheduler_print_stats(task_scheduler_fc_t *sched);
+
+// 直方图二进制导出（小端）：
+//   'S' 'H' | u8 版本=1 | u8 任务数 N | u32 cpu_freq_hz | u8 线性桶数 | u8 子桶位数 | u8 桶总数
+//   N x { u8 名称长度 L(<=15) | 名称[L] | u8 优先级 | u8 通道 | u8 触发模式 | u32 exec_count |
+//         执行时间直方图 | 释放抖动直方图 }，直方图 = u8 非零桶数 K | K x { u8 桶号 | u16 计数 }
+//   u16 CRC-16/CCITT-FALSE（覆盖之前的全部字节）
+// 返回写出的字节数。未启用 SCHEDULER_HIST 时直方图均为空（K=0）
+uint32_t scheduler_dump_histograms(task_scheduler_fc_t *sched, scheduler_write_cb write, void *user);
+// 以文本行 "SCHED_HIST,<base64>" 通过 printf 输出，由上位机解析（html/js/serial.js）并在 Scheduler Timing 面板显示（html/js/ui-sched-hist.js）
+void scheduler_print_histograms(task_scheduler_fc_t *sched);
 float scheduler_get_cpu_load(task_scheduler_fc_t *sched);
+const scheduler_load_t* scheduler_get_load(task_scheduler_fc_t *sched);
 void scheduler_reset_stats(task_scheduler_fc_t *sched);
 
 #endif 
@@ -0,0 +1,89 @@
+/**
+ * @file    scheduler_hist.c
+ * @brief   调度器对数分桶直方图实现
+ */
+
+#include "scheduler_hist.h"
+#include <string.h>
+
+#define SUB_COUNT       (1U << TASK_HIST_SUB_BITS)
+#define FIRST_LOG2      (TASK_HIST_SUB_BITS + 1)     // 第一个对数区间 [8, 16) 的最高位
+
+void task_hist_reset(task_hist_t *h)
+{
+    memset(h, 0, sizeof(*h));
+}
+
+uint8_t task_hist_bucket(uint32_t cycles)
+{
+    if (cycles < TASK_HIST_LINEAR) {
+        return (uint8_t)cycles;
+    }
+
+    uint32_t msb = 31U - (uint32_t)__builtin_clz(cycles);
+    if (msb >= TASK_HIST_MAX_LOG2) {
+        return TASK_HIST_BUCKETS - 1;
+    }
+    uint32_t sub = (cycles >> (msb - TASK_HIST_SUB_BITS)) & (SUB_COUNT - 1U);
+    return (uint8_t)(TASK_HIST_LINEAR + (msb - FIRST_LOG2) * SUB_COUNT + sub);
+}
+
+uint32_t task_hist_bucket_low(uint8_t bucket)
+{
+    if (bucket < TASK_HIST_LINEAR) {
+        return bucket;
+    }
+    uint32_t b = (uint32_t)bucket - TASK_HIST_LINEAR;
+    uint32_t msb = b / SUB_COUNT + FIRST_LOG2;
+    return (SUB_COUNT + b % SUB_COUNT) << (msb - TASK_HIST_SUB_BITS);
+}
+
+uint32_t task_hist_bucket_width(uint8_t bucket)
+{
+    if (bucket < TASK_HIST_LINEAR) {
+        return 1;
+    }
+    uint32_t msb = ((uint32_t)bucket - TASK_HIST_LINEAR) / SUB_COUNT + FIRST_LOG2;
+    return 1UL << (msb - TASK_HIST_SUB_BITS);
+}
+
+void task_hist_record(task_hist_t *h, uint32_t cycles)
+{
+    uint8_t b = task_hist_bucket(cycles);
+
+    // 即将溢出：整体减半并向上取整（非空桶保持非空，稀有的尾部样本不会被抹掉），重新累计总数
+    if (h->count[b] == UINT16_MAX) {
+        h->total = 0;
+        for (uint8_t i = 0; i < TASK_HIST_BUCKETS; i++) {
+            h->count[i] = (uint16_t)((h->count[i] + 1U) >> 1);
+            h->total += h->count[i];
+        }
+    }
+
+    h->count[b]++;
+    h->total++;
+}
+
+uint32_t task_hist_percentile(const task_hist_t *h, uint16_t per10k)
+{
+    if (h->total == 0) return 0;
+
+    // 目标排名（1 起）：ceil(total * p)
+    uint32_t rank = (uint32_t)(((uint64_t)h->total * per10k + 9999U) / 10000U);
+    if (rank == 0) rank = 1;
+
+    uint32_t cum = 0;
+    for (uint8_t b = 0; b < TASK_HIST_BUCKETS; b++) {
+        uint32_t c = h->count[b];
+        if (c == 0) continue;
+        if (cum + c >= rank) {
+            // 桶内按排名线性插值
+            uint32_t width = task_hist_bucket_width(b);
+            uint32_t offset = (uint32_t)(((uint64_t)width * (rank - cum)) / c);
+            if (offset >= width) offset = width - 1;
+            return task_hist_bucket_low(b) + offset;
+        }
+        cum += c;
+    }
+    return task_hist_bucket_low(TASK_HIST_BUCKETS - 1);
+}
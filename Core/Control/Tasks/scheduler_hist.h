@@ -0,0 +1,37 @@
+/**
+ * @file    scheduler_hist.h
+ * @brief   调度器对数分桶直方图（单位：CPU 周期），用于执行时间与释放抖动的分位数统计
+ * @note    分桶：0..7 每个值一个桶；>= 8 时每个 2 的幂区间再等分 4 个子桶（桶宽 / 桶下限 <= 25%），
+ *          分位数在桶内按排名线性插值。上限 2^24 周期（168MHz 下约 100ms），更大的值计入最后一个桶。
+ *          计数为 16 位，任一桶将要溢出时所有桶整体减半（向上取整）：比例近似保持，
+ *          只出现过一两次的尾部桶保持非空，最大值与 p99.9 附近的长尾不会因减半而消失。
+ */
+
+#ifndef SCHEDULER_HIST_H
+#define SCHEDULER_HIST_H
+
+#include <stdint.h>
+
+#define TASK_HIST_SUB_BITS      2       // 每个 2 的幂区间 2^SUB_BITS 个子桶
+#define TASK_HIST_MAX_LOG2      24      // 覆盖 [0, 2^24) 周期
+#define TASK_HIST_LINEAR        (2 << TASK_HIST_SUB_BITS)   // 线性桶数（0..7）
+#define TASK_HIST_BUCKETS       (TASK_HIST_LINEAR + \
+                                 (TASK_HIST_MAX_LOG2 - TASK_HIST_SUB_BITS - 1) * (1 << TASK_HIST_SUB_BITS))
+
+typedef struct {
+    uint16_t count[TASK_HIST_BUCKETS];
+    uint32_t total;                     // 各桶计数之和
+} task_hist_t;
+
+void task_hist_reset(task_hist_t *h);
+void task_hist_record(task_hist_t *h, uint32_t cycles);
+
+// 分位数（per10k：万分位，5000=p50、9900=p99、9990=p99.9），返回周期数；空直方图返回 0
+uint32_t task_hist_percentile(const task_hist_t *h, uint16_t per10k);
+
+// 分桶布局（主机解码/上位机绘图与固件共用同一套公式）
+uint8_t  task_hist_bucket(uint32_t cycles);
+uint32_t task_hist_bucket_low(uint8_t bucket);
+uint32_t task_hist_bucket_width(uint8_t bucket);
+
+#endif // SCHEDULER_HIST_H
@@ -0,0 +1,192 @@
+/**
+ * @file    sensor_align.c
+ * @brief   板载/传感器安装方向实现
+ */
+
+#include "sensor_align.h"
+#include "task_gyro.h"
+#include "task_acc.h"
+#include "task_mag.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define ALIGN_DEG_TO_RAD    0.017453292519943295f
+#define ALIGN_SNAP_EPS      1e-5f       // 与 0/±1 相差在此范围内视为精确值（cosf(90°) 等舍入）
+
+// CW0..CW270(_FLIP) 对应的矩阵，out = m * in
+static const int8_t align_step_table[SENSOR_ALIGN_COUNT][3][3] = {
+    [SENSOR_ALIGN_CW0]       = { {  1,  0,  0 }, {  0,  1,  0 }, { 0, 0,  1 } },
+    [SENSOR_ALIGN_CW90]      = { {  0,  1,  0 }, { -1,  0,  0 }, { 0, 0,  1 } },
+    [SENSOR_ALIGN_CW180]     = { { -1,  0,  0 }, {  0, -1,  0 }, { 0, 0,  1 } },
+    [SENSOR_ALIGN_CW270]     = { {  0, -1,  0 }, {  1,  0,  0 }, { 0, 0,  1 } },
+    [SENSOR_ALIGN_CW0_FLIP]  = { { -1,  0,  0 }, {  0,  1,  0 }, { 0, 0, -1 } },
+    [SENSOR_ALIGN_CW90_FLIP] = { {  0,  1,  0 }, {  1,  0,  0 }, { 0, 0, -1 } },
+    [SENSOR_ALIGN_CW180_FLIP]= { {  1,  0,  0 }, {  0, -1,  0 }, { 0, 0, -1 } },
+    [SENSOR_ALIGN_CW270_FLIP]= { {  0, -1,  0 }, { -1,  0,  0 }, { 0, 0, -1 } },
+};
+
+static void mat3_mul(const float a[3][3], const float b[3][3], float out[3][3])
+{
+    float t[3][3];
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            t[i][j] = a[i][0] * b[0][j] + a[i][1] * b[1][j] + a[i][2] * b[2][j];
+        }
+    }
+    memcpy(out, t, sizeof(t));
+}
+
+/**
+ * @brief 单个安装方向的矩阵：Rz(-yaw) * Ry(-pitch) * Rx(-roll) * R_step
+ */
+static bool align_matrix(const sensor_align_t *align, float out[3][3])
+{
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            out[i][j] = (i == j) ? 1.0f : 0.0f;
+        }
+    }
+    if (!align) {
+        return true;
+    }
+    if ((unsigned)align->step >= SENSOR_ALIGN_COUNT ||
+        !isfinite(align->roll_deg) || !isfinite(align->pitch_deg) || !isfinite(align->yaw_deg)) {
+        return false;
+    }
+
+    float step[3][3];
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            step[i][j] = (float)align_step_table[align->step][i][j];
+        }
+    }
+    if (align->roll_deg == 0.0f && align->pitch_deg == 0.0f && align->yaw_deg == 0.0f) {
+        memcpy(out, step, sizeof(step));
+        return true;
+    }
+
+    // 与 CW 同旋向：角度取负后按右手系构建
+    const float r = -align->roll_deg * ALIGN_DEG_TO_RAD;
+    const float p = -align->pitch_deg * ALIGN_DEG_TO_RAD;
+    const float y = -align->yaw_deg * ALIGN_DEG_TO_RAD;
+    const float cr = cosf(r), sr = sinf(r);
+    const float cp = cosf(p), sp = sinf(p);
+    const float cy = cosf(y), sy = sinf(y);
+    const float trim[3][3] = {
+        { cy * cp, cy * sp * sr - sy * cr, cy * sp * cr + sy * sr },
+        { sy * cp, sy * sp * sr + cy * cr, sy * sp * cr - cy * sr },
+        { -sp,     cp * sr,                cp * cr                },
+    };
+    mat3_mul(trim, step, out);
+    return true;
+}
+
+/**
+ * @brief 由任意矩阵构建旋转，自动识别单位阵与置换/取反
+ */
+bool sensor_rotation_from_matrix(sensor_rotation_t *rot, const float m[3][3])
+{
+    sensor_rotation_t r;
+    bool permute = true;
+    uint8_t used = 0;
+
+    for (int i = 0; i < 3; i++) {
+        int nonzero = 0;
+        for (int j = 0; j < 3; j++) {
+            const float v = m[i][j];
+            if (!(v >= -1.001f && v <= 1.001f)) {
+                printf("[sensor_align] Rotation element %d,%d out of range\r\n", i, j);
+                return false;
+            }
+            r.m[i][j] = v;
+            if (fabsf(v) <= ALIGN_SNAP_EPS) {
+                r.m[i][j] = 0.0f;
+            } else if (fabsf(fabsf(v) - 1.0f) <= ALIGN_SNAP_EPS) {
+                r.m[i][j] = (v > 0.0f) ? 1.0f : -1.0f;
+                r.src[i] = (uint8_t)j;
+                r.sign[i] = (v > 0.0f) ? 1 : -1;
+                nonzero++;
+            } else {
+                permute = false;
+            }
+        }
+        if (nonzero != 1) {
+            permute = false;
+        } else {
+            used |= (uint8_t)(1U << r.src[i]);
+        }
+    }
+
+    if (permute && used == 0x07U) {
+        const bool identity = r.src[0] == 0 && r.src[1] == 1 && r.src[2] == 2 &&
+                              r.sign[0] > 0 && r.sign[1] > 0 && r.sign[2] > 0;
+        r.kind = identity ? SENSOR_ROTATION_IDENTITY : SENSOR_ROTATION_PERMUTE;
+    } else {
+        // 非置换：保留原始矩阵（不做近似到 0/±1 的修改）
+        memcpy(r.m, m, sizeof(r.m));
+        r.kind = SENSOR_ROTATION_MATRIX;
+        r.src[0] = 0; r.src[1] = 1; r.src[2] = 2;
+        r.sign[0] = r.sign[1] = r.sign[2] = 1;
+    }
+    *rot = r;
+    return true;
+}
+
+/**
+ * @brief 由板载方向和传感器方向构建总旋转
+ */
+bool sensor_rotation_build(sensor_rotation_t *rot, const sensor_align_t *board, const sensor_align_t *sensor)
+{
+    float rb[3][3], rs[3][3], m[3][3];
+    if (!align_matrix(board, rb) || !align_matrix(sensor, rs)) {
+        printf("[sensor_align] Invalid alignment\r\n");
+        return false;
+    }
+    mat3_mul(rb, rs, m);
+    return sensor_rotation_from_matrix(rot, m);
+}
+
+/**
+ * @brief 浮点数据原地旋转
+ */
+void sensor_rotation_apply(const sensor_rotation_t *rot, float v[3])
+{
+    const float x = v[0], y = v[1], z = v[2];
+
+    switch (rot->kind) {
+    case SENSOR_ROTATION_PERMUTE: {
+        const float in[3] = { x, y, z };
+        v[0] = rot->sign[0] > 0 ? in[rot->src[0]] : -in[rot->src[0]];
+        v[1] = rot->sign[1] > 0 ? in[rot->src[1]] : -in[rot->src[1]];
+        v[2] = rot->sign[2] > 0 ? in[rot->src[2]] : -in[rot->src[2]];
+        break;
+    }
+    case SENSOR_ROTATION_MATRIX:
+        v[0] = rot->m[0][0] * x + rot->m[0][1] * y + rot->m[0][2] * z;
+        v[1] = rot->m[1][0] * x + rot->m[1][1] * y + rot->m[1][2] * z;
+        v[2] = rot->m[2][0] * x + rot->m[2][1] * y + rot->m[2][2] * z;
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief 构建并下发到陀螺仪、加速度计与磁力计处理模块
+ */
+bool sensor_alignment_configure(const sensor_align_t *board, const sensor_align_t *imu, const sensor_align_t *mag)
+{
+    sensor_rotation_t imu_rot, mag_rot;
+    if (!sensor_rotation_build(&imu_rot, board, imu) || !sensor_rotation_build(&mag_rot, board, mag)) {
+        return false;
+    }
+
+    gyro_processing_set_alignment(&imu_rot);
+    accel_processing_set_alignment(&imu_rot);
+    mag_processing_set_alignment(&mag_rot);
+
+    static const char *const kind_name[] = { "identity", "permute", "matrix" };
+    printf("[sensor_align] IMU: %s, mag: %s\r\n", kind_name[imu_rot.kind], kind_name[mag_rot.kind]);
+    return true;
+}
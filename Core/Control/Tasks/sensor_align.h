@@ -0,0 +1,91 @@
+/**
+ * @file    sensor_align.h
+ * @brief   板载/传感器安装方向：90° 步进 + 任意微调，预编译为置换/取反快路径或 3x3 矩阵
+ * @note    总旋转 R = R_board * R_sensor，把传感器系的数据转到机体系（out = R * in）。
+ *          每个 R 都是 R_trim * R_step：R_step 为 CW0..CW270(_FLIP) 查表，R_trim 为微调欧拉角。
+ *          构建时若 R 的元素全部为 0/±1（纯 90° 步进的组合），预编译为“out[i] = sign[i] * in[src[i]]”，
+ *          每样本只有取数和取反；否则保留 3x3 矩阵。
+ *          ICM42688P（陀螺仪/加速度计）与 HMC5883L 各有一个传感器方向，共用同一个板载方向。
+ */
+
+#ifndef SENSOR_ALIGN_H
+#define SENSOR_ALIGN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief 90° 步进安装方向（绕 Z 轴顺时针，_FLIP 表示芯片倒装）
+ * @note  CW90: x' = y, y' = -x；CW0_FLIP: x' = -x, z' = -z（绕 Y 轴 180°）
+ */
+typedef enum {
+    SENSOR_ALIGN_CW0 = 0,       // 默认，不旋转
+    SENSOR_ALIGN_CW90,
+    SENSOR_ALIGN_CW180,
+    SENSOR_ALIGN_CW270,
+    SENSOR_ALIGN_CW0_FLIP,
+    SENSOR_ALIGN_CW90_FLIP,
+    SENSOR_ALIGN_CW180_FLIP,
+    SENSOR_ALIGN_CW270_FLIP,
+    SENSOR_ALIGN_COUNT,
+} sensor_align_step_e;
+
+/**
+ * @brief 安装方向配置
+ * @note  微调角与 CW 步进同一旋向（yaw_deg = 90 等价于 CW90），
+ *        按 roll → pitch → yaw 的顺序叠加在步进之后：R = Rz(-yaw) * Ry(-pitch) * Rx(-roll) * R_step
+ */
+typedef struct sensor_align_s {
+    sensor_align_step_e step;   // 90° 步进
+    float roll_deg;             // 绕 X 轴微调（度）
+    float pitch_deg;            // 绕 Y 轴微调（度）
+    float yaw_deg;              // 绕 Z 轴微调（度）
+} sensor_align_t;
+
+typedef enum {
+    SENSOR_ROTATION_IDENTITY = 0,   // 不旋转（零初始化即为此状态）
+    SENSOR_ROTATION_PERMUTE,        // 轴置换 + 取反
+    SENSOR_ROTATION_MATRIX,         // 一般 3x3 矩阵
+} sensor_rotation_kind_e;
+
+/**
+ * @brief 预编译后的旋转
+ */
+typedef struct sensor_rotation_s {
+    sensor_rotation_kind_e kind;
+    uint8_t src[3];         // PERMUTE：out[i] = sign[i] * in[src[i]]
+    int8_t  sign[3];
+    float   m[3][3];        // 完整矩阵（PERMUTE 时为精确的 0/±1，IDENTITY 时不使用）
+} sensor_rotation_t;
+
+/**
+ * @brief 由板载方向和传感器方向构建总旋转
+ * @param board 板载方向（飞控板相对机架），NULL=不旋转
+ * @param sensor 传感器方向（芯片相对飞控板），NULL=不旋转
+ * @return false=步进越界或微调角非有限值（rot 不变）
+ */
+bool sensor_rotation_build(sensor_rotation_t *rot, const sensor_align_t *board, const sensor_align_t *sensor);
+
+/**
+ * @brief 由任意矩阵构建旋转，自动识别单位阵与置换/取反
+ * @param m 按行给出的 3x3 矩阵（out = m * in），元素需在 [-1, 1] 内
+ * @return false=元素越界（rot 不变）
+ */
+bool sensor_rotation_from_matrix(sensor_rotation_t *rot, const float m[3][3]);
+
+/**
+ * @brief 浮点数据原地旋转（磁力计路径）
+ */
+void sensor_rotation_apply(const sensor_rotation_t *rot, float v[3]);
+
+/**
+ * @brief 构建并下发到陀螺仪、加速度计（ICM42688P）与磁力计（HMC5883L）处理模块
+ * @param board 板载方向，NULL=不旋转
+ * @param imu ICM42688P 安装方向，NULL=不旋转
+ * @param mag HMC5883L 安装方向，NULL=不旋转
+ * @return false=任一配置无效（不修改任何模块）
+ * @note  方向在 *_processing_init 之后依然保留，可在初始化前后调用
+ */
+bool sensor_alignment_configure(const sensor_align_t *board, const sensor_align_t *imu, const sensor_align_t *mag);
+
+#endif // SENSOR_ALIGN_H
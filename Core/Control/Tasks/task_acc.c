@@ -1,67 +1,64 @@
 /**
  * @file    task_acc.c
  * @brief   加速度计数据处理实现（零偏补偿 + 刻度转换）
+ * @note    零偏补偿、饱和与轴向旋转走整数前端（imu_frontend），刻度转换乘以缓存的倒数
+ * @note    设置了六面校准（accel_cal）后改走浮点路径：校准矩阵 C、零偏 b 与安装方向 R
+ *          预先合成为 a = F * raw + o（F = R * C，o = -F * b），每样本一次 3x3 乘加
  */
 
 #include "task_acc.h"
 #include "icm42688p.h"
+#include "imu_frontend.h"
+#include "accel_cal.h"
+#include <math.h>
 #include <stdio.h>
 #include <string.h>
 
 // 处理状态
 static bool accel_processing_ready = false;   // 是否已初始化
 
+// 定点前端（零偏 + 饱和 + 旋转）
+static imu_frontend_t accel_fe;
+static sensor_rotation_t accel_align;        // 安装方向（零初始化 = 不旋转），初始化时保留
+
+// 六面校准（传感器系）及与安装方向合成后的仿射变换，初始化时保留
+static bool  accel_calib_valid = false;
+static float accel_calib_c[3][3];            // g/LSB
+static float accel_calib_b[3];               // 计数
+static float accel_fused[3][3];              // F = R * C
+static float accel_fused_o[3];               // o = -F * b
+
 // 输出数据（全局变量，供外部访问）
 accel_compensated_t accel_compensated;         // 零偏补偿后的数据（原始值）
 accel_scaled_t accel_scaled;                   // 刻度转换后的数据（g）
 
 /**
- * @brief 对加速度计原始数据进行零偏补偿
- * @param raw_x 输入/输出：X轴原始数据
- * @param raw_y 输入/输出：Y轴原始数据
- * @param raw_z 输入/输出：Z轴原始数据
- * @note 使用 ICM42688P 的校准偏移量进行补偿
+ * @brief 合成校准与安装方向
  */
-static void accel_compensate_offset(int16_t *raw_x, int16_t *raw_y, int16_t *raw_z)
+static void accel_update_fused(void)
 {
-    extern icm42688p_dev_t icm;
-    
-    // 减去零偏（带溢出保护）
-    int32_t x = (int32_t)(*raw_x) - (int32_t)icm.accel_offset[0];
-    int32_t y = (int32_t)(*raw_y) - (int32_t)icm.accel_offset[1];
-    int32_t z = (int32_t)(*raw_z) - (int32_t)icm.accel_offset[2];
-    
-    // 限幅到 int16_t 范围
-    if (x > 32767) x = 32767;
-    if (x < -32768) x = -32768;
-    if (y > 32767) y = 32767;
-    if (y < -32768) y = -32768;
-    if (z > 32767) z = 32767;
-    if (z < -32768) z = -32768;
-    
-    *raw_x = (int16_t)x;
-    *raw_y = (int16_t)y;
-    *raw_z = (int16_t)z;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            float v = 0.0f;
+            for (int k = 0; k < 3; k++) {
+                const float r = (accel_align.kind == SENSOR_ROTATION_IDENTITY) ? ((i == k) ? 1.0f : 0.0f)
+                                                                              : accel_align.m[i][k];
+                v += r * accel_calib_c[k][j];
+            }
+            accel_fused[i][j] = v;
+        }
+    }
+    for (int i = 0; i < 3; i++) {
+        accel_fused_o[i] = -(accel_fused[i][0] * accel_calib_b[0] + accel_fused[i][1] * accel_calib_b[1] +
+                             accel_fused[i][2] * accel_calib_b[2]);
+    }
 }
 
-/**
- * @brief 刻度转换：将补偿后的原始值转换为 g
- * @param comp_x 零偏补偿后的X轴数据（原始值）
- * @param comp_y 零偏补偿后的Y轴数据（原始值）
- * @param comp_z 零偏补偿后的Z轴数据（原始值）
- * @param g_x 输出：X轴加速度（g）
- * @param g_y 输出：Y轴加速度（g）
- * @param g_z 输出：Z轴加速度（g）
- */
-static void accel_scale_to_g(int16_t comp_x, int16_t comp_y, int16_t comp_z,
-                             float *g_x, float *g_y, float *g_z)
+static int16_t accel_sat16f(float v)
 {
-    extern icm42688p_dev_t icm;
-    const float ascale = (icm.accel_scale > 0.0f) ? icm.accel_scale : 1.0f;
-    
-    *g_x = (float)comp_x / ascale;
-    *g_y = (float)comp_y / ascale;
-    *g_z = (float)comp_z / ascale;
+    if (v > 32767.0f) return 32767;
+    if (v < -32768.0f) return -32768;
+    return (int16_t)lrintf(v);
 }
 
 /**
@@ -69,6 +66,9 @@ static void accel_scale_to_g(int16_t comp_x, int16_t comp_y, int16_t comp_z,
  */
 void accel_processing_init(void)
 {
+    imu_frontend_init(&accel_fe);
+    imu_frontend_set_alignment(&accel_fe, &accel_align);
+
     // 清空输出数据
     memset(&accel_compensated, 0, sizeof(accel_compensated_t));
     memset(&accel_scaled, 0, sizeof(accel_scaled_t));
@@ -80,9 +80,42 @@ void accel_processing_init(void)
     printf("[accel_processing] Initialized\r\n");
 }
 
+/**
+ * @brief 设置加速度计安装方向（传感器系 → 机体系）
+ */
+void accel_processing_set_alignment(const sensor_rotation_t *rot)
+{
+    accel_align = *rot;
+    imu_frontend_set_alignment(&accel_fe, &accel_align);
+    accel_update_fused();
+}
+
+/**
+ * @brief 设置六面校准结果
+ */
+bool accel_processing_set_calibration(const float matrix[3][3], const float bias[3])
+{
+    if (!matrix || !bias) {
+        accel_calib_valid = false;
+        printf("[accel_processing] Calibration cleared\r\n");
+        return true;
+    }
+    for (int i = 0; i < 3; i++) {
+        if (!isfinite(bias[i]) || !isfinite(matrix[i][0]) || !isfinite(matrix[i][1]) || !isfinite(matrix[i][2])) {
+            printf("[accel_processing] Invalid calibration\r\n");
+            return false;
+        }
+    }
+    memcpy(accel_calib_c, matrix, sizeof(accel_calib_c));
+    memcpy(accel_calib_b, bias, sizeof(accel_calib_b));
+    accel_update_fused();
+    accel_calib_valid = true;
+    return true;
+}
+
 /**
  * @brief 处理一个加速度计原始样本
- * @note 处理流程：原始值 → 零偏补偿 → 刻度转换(g)
+ * @note 处理流程：原始值 → 零偏补偿/饱和/旋转（整数）→ 刻度转换(g)
  */
 bool accel_process_sample(int16_t raw_x, int16_t raw_y, int16_t raw_z)
 {
@@ -95,19 +128,40 @@ bool accel_process_sample(int16_t raw_x, int16_t raw_y, int16_t raw_z)
         return false;
     }
     
-    // 步骤1：零偏补偿
-    accel_compensate_offset(&raw_x, &raw_y, &raw_z);
+    extern icm42688p_dev_t icm;
+
+    const int16_t raw[3] = { raw_x, raw_y, raw_z };
+    accel_cal_push_sample(raw);     // 六面校准采集（未开始时不做任何事）
+
+    if (accel_calib_valid) {
+        // 校准 + 安装方向：一次 3x3 乘加（原始值 → 机体系 g）
+        const float x = (float)raw_x, y = (float)raw_y, z = (float)raw_z;
+        accel_scaled.g_x = accel_fused[0][0] * x + accel_fused[0][1] * y + accel_fused[0][2] * z + accel_fused_o[0];
+        accel_scaled.g_y = accel_fused[1][0] * x + accel_fused[1][1] * y + accel_fused[1][2] * z + accel_fused_o[1];
+        accel_scaled.g_z = accel_fused[2][0] * x + accel_fused[2][1] * y + accel_fused[2][2] * z + accel_fused_o[2];
+
+        // 补偿后的数据按标称刻度折回计数（机体系）
+        accel_compensated.x = accel_sat16f(accel_scaled.g_x * icm.accel_scale);
+        accel_compensated.y = accel_sat16f(accel_scaled.g_y * icm.accel_scale);
+        accel_compensated.z = accel_sat16f(accel_scaled.g_z * icm.accel_scale);
+        accel_scaled.ready = true;
+        return true;
+    }
+
+    // 步骤1：零偏补偿 + 饱和 + 轴向旋转（整数）
+    int16_t comp[3];
+    imu_frontend_apply(&accel_fe, raw, icm.accel_offset, comp);
     
     // 保存补偿后的数据（原始值）
-    accel_compensated.x = raw_x;
-    accel_compensated.y = raw_y;
-    accel_compensated.z = raw_z;
+    accel_compensated.x = comp[0];
+    accel_compensated.y = comp[1];
+    accel_compensated.z = comp[2];
     
-    // 步骤2：刻度转换（原始值 → g）
-    accel_scale_to_g(raw_x, raw_y, raw_z,
-                    &accel_scaled.g_x,
-                    &accel_scaled.g_y,
-                    &accel_scaled.g_z);
+    // 步骤2：刻度转换（原始值 → g，乘以缓存的刻度倒数）
+    const float k = imu_frontend_unit_per_lsb(&accel_fe, icm.accel_scale);
+    accel_scaled.g_x = (float)comp[0] * k;
+    accel_scaled.g_y = (float)comp[1] * k;
+    accel_scaled.g_z = (float)comp[2] * k;
     
     accel_scaled.ready = true;
     
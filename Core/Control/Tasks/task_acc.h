@@ -8,6 +8,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "sensor_align.h"
 
 /**
  * @brief 零偏补偿后的加速度数据（原始值）
@@ -37,6 +38,23 @@ extern accel_scaled_t accel_scaled;             // 刻度转换后的数据（g
  */
 void accel_processing_init(void);
 
+/**
+ * @brief 设置加速度计安装方向（传感器系 → 机体系）
+ * @note 与陀螺仪同一芯片，通常经 sensor_alignment_configure 一起下发；
+ *       零偏在传感器系中减去，之后再旋转。方向在 accel_processing_init 之后保留
+ */
+void accel_processing_set_alignment(const sensor_rotation_t *rot);
+
+/**
+ * @brief 设置六面校准结果（accel_cal 完成时自动调用，启动时可用保存的结果调用）
+ * @param matrix C（g/LSB，传感器系），NULL=清除校准，回到 icm.accel_offset + 标称刻度
+ * @param bias 零偏（计数，传感器系）
+ * @return false=参数含非有限值（保持原校准）
+ * @note 校准有效时 icm.accel_offset 不再使用；与安装方向合成为一次 3x3 乘加，
+ *       方向或校准变化时重新合成。校准在 accel_processing_init 之后保留
+ */
+bool accel_processing_set_calibration(const float matrix[3][3], const float bias[3]);
+
 /**
  * @brief 处理一个加速度计原始样本（零偏补偿 + 刻度转换）
  * @param raw_x X轴原始数据（ADC值）
@@ -44,9 +62,9 @@ void accel_processing_init(void);
  * @param raw_z Z轴原始数据（ADC值）
  * @return true=成功，false=未初始化
  * @note 
- * - 处理流程：原始值 → 零偏补偿 → 刻度转换(g)
+ * - 处理流程：原始值 → 零偏补偿 → 安装方向旋转 → 刻度转换(g)
  * - 每次IMU中断时调用
- * - 零偏补偿后的数据在 accel_compensated 中（原始值）
+ * - 零偏补偿后的数据在 accel_compensated 中（原始值；有六面校准时为校准后按标称刻度折回的计数）
  * - 刻度转换后的数据在 accel_scaled 中（g）
  */
 bool accel_process_sample(int16_t raw_x, int16_t raw_y, int16_t raw_z);
@@ -1,6 +1,6 @@
 /**
  * @file    task_filter.c
- * @brief   陀螺仪滤波实现（PT1 + 抗混叠低通滤波）
+ * @brief   陀螺仪滤波实现（按轴独立状态的滤波器组，默认 PT1 + 抗混叠低通）
  *          只负责纯滤波，输入输出单位均为°/s
  */
 
@@ -12,16 +12,17 @@
 // 全局变量
 // ============================================================================
 
-// 滤波器实例
-static pt1Filter_t pt1Filter_dev;         // PT1滤波器
-static biquadFilter_t aa_x, aa_y, aa_z;   // 抗混叠滤波器（X/Y/Z轴）
+// 滤波器组（系数三轴共用，状态每轴独立）
+static filterBank_t gyro_bank;
+
+// 动态陷波（每轴独立中心频率，跟踪电机噪声峰）
+static dynNotch_t gyro_dyn;
+static bool dyn_notch_enabled = false;
 
 // 滤波器状态
 static bool filter_ready = false;         // 滤波器是否已初始化
 
 // 滤波输出数据（全局变量，供外部访问）
-pt1raw pt1_raw;                           // PT1滤波输出
-gyro_antialias_t gyro_aa;                 // 抗混叠滤波输出
 gyro_filtered_t gyro_filtered;            // 最终滤波输出（°/s）
 
 // ============================================================================
@@ -46,20 +47,20 @@ static bool gyro_filter_process_sample(float gx, float gy, float gz)
         return false;
     }
 
-    // PT1 低通滤波
-    pt1_raw.pt1_gyro_x = pt1FilterApply(&pt1Filter_dev, gx);
-    pt1_raw.pt1_gyro_y = pt1FilterApply(&pt1Filter_dev, gy);
-    pt1_raw.pt1_gyro_z = pt1FilterApply(&pt1Filter_dev, gz);
-    
-    // 抗混叠滤波（Biquad LPF）
-    gyro_aa.x = biquadFilterApply(&aa_x, pt1_raw.pt1_gyro_x);
-    gyro_aa.y = biquadFilterApply(&aa_y, pt1_raw.pt1_gyro_y);
-    gyro_aa.z = biquadFilterApply(&aa_z, pt1_raw.pt1_gyro_z);
+    // 滤波器组（各轴独立状态）
+    const float in[FILTER_BANK_AXES] = { gx, gy, gz };
+    float out[FILTER_BANK_AXES];
+    filterBankApply(&gyro_bank, in, out);
+    if (dyn_notch_enabled) {
+        for (uint8_t axis = 0; axis < FILTER_BANK_AXES; axis++) {
+            out[axis] = dynNotchApply(&gyro_dyn, axis, out[axis]);
+        }
+    }
 
     // 输出滤波后的数据（单位已是°/s）
-    gyro_filtered.dps_x = gyro_aa.x;
-    gyro_filtered.dps_y = gyro_aa.y;
-    gyro_filtered.dps_z = gyro_aa.z;
+    gyro_filtered.dps_x = out[0];
+    gyro_filtered.dps_y = out[1];
+    gyro_filtered.dps_z = out[2];
     gyro_filtered.ready = true;
 
     return true;
@@ -77,6 +78,112 @@ bool gyro_filter_feed_sample(float gyro_x, float gyro_y, float gyro_z)
     return gyro_filter_process_sample(gyro_x, gyro_y, gyro_z);
 }
 
+/**
+ * @brief 成块喂入降采样后的陀螺仪样本
+ */
+bool gyro_filter_feed_block(const float *gyro_x, const float *gyro_y, const float *gyro_z,
+                            float *out_x, float *out_y, float *out_z, uint16_t count)
+{
+    if (!filter_ready) {
+        static uint8_t warn_count = 0;
+        if (warn_count++ < 5) {
+            printf("[gyro_filter] Filter not ready!\r\n");
+        }
+        return false;
+    }
+    if (count == 0) {
+        return true;
+    }
+
+    filterBankProcess(&gyro_bank, 0, gyro_x, out_x, count);
+    filterBankProcess(&gyro_bank, 1, gyro_y, out_y, count);
+    filterBankProcess(&gyro_bank, 2, gyro_z, out_z, count);
+    if (dyn_notch_enabled) {
+        for (uint16_t i = 0; i < count; i++) {
+            out_x[i] = dynNotchApply(&gyro_dyn, 0, out_x[i]);
+            out_y[i] = dynNotchApply(&gyro_dyn, 1, out_y[i]);
+            out_z[i] = dynNotchApply(&gyro_dyn, 2, out_z[i]);
+        }
+    }
+
+    gyro_filtered.dps_x = out_x[count - 1];
+    gyro_filtered.dps_y = out_y[count - 1];
+    gyro_filtered.dps_z = out_z[count - 1];
+    gyro_filtered.ready = true;
+    return true;
+}
+
+/**
+ * @brief 按级配置陀螺仪滤波器组
+ */
+bool gyro_filter_configure(const filterBankStage_t *stages, uint8_t count, float sample_hz)
+{
+    filter_ready = false;
+    if (!filterBankInit(&gyro_bank, stages, count, sample_hz)) {
+        printf("[gyro_filter] Invalid filter bank config (%d stages @ %.1f Hz)\r\n", count, sample_hz);
+        return false;
+    }
+
+    memset(&gyro_filtered, 0, sizeof(gyro_filtered_t));
+    gyro_filtered.ready = false;
+    filter_ready = true;
+    return true;
+}
+
+/**
+ * @brief 滤波器组实例（供动态陷波等模块更新系数）
+ */
+filterBank_t *gyro_filter_bank(void)
+{
+    return &gyro_bank;
+}
+
+/**
+ * @brief 启用/关闭动态陷波
+ */
+bool gyro_dyn_notch_init(const dynNotchConfig_t *cfg)
+{
+    dyn_notch_enabled = false;
+    if (!cfg) {
+        return true;
+    }
+    if (!dynNotchInit(&gyro_dyn, cfg)) {
+        printf("[gyro_filter] Invalid dynamic notch config (%.0f-%.0f Hz, notch rate %.0f Hz)\r\n",
+               cfg->min_hz, cfg->max_hz, cfg->notch_hz);
+        return false;
+    }
+    dyn_notch_enabled = true;
+    printf("[gyro_filter] Dynamic notch: %d per axis, %.0f-%.0f Hz, FFT %.0f Hz / %.1f Hz bins\r\n",
+           cfg->count, cfg->min_hz, cfg->max_hz, gyro_dyn.fft_hz, gyro_dyn.bin_hz);
+    return true;
+}
+
+/**
+ * @brief 送入一个滤波前的陀螺仪样本（陀螺 ODR）
+ */
+void gyro_dyn_notch_push(float gyro_x, float gyro_y, float gyro_z)
+{
+    if (dyn_notch_enabled) {
+        dynNotchPush(&gyro_dyn, gyro_x, gyro_y, gyro_z);
+    }
+}
+
+/**
+ * @brief 调度器任务：执行一步频谱分析
+ */
+void gyro_dyn_notch_task(void *user)
+{
+    (void)user;
+    if (dyn_notch_enabled) {
+        dynNotchUpdate(&gyro_dyn);
+    }
+}
+
+dynNotch_t *gyro_dyn_notch(void)
+{
+    return dyn_notch_enabled ? &gyro_dyn : NULL;
+}
+
 /**
  * @brief 初始化陀螺仪滤波器
  */
@@ -88,26 +195,14 @@ void gyro_filter_init(float sample_hz, float pt1_cut_hz, float aa_cut_hz)
         return;
     }
 
-    // 计算采样周期
-    const float dt = 1.0f / sample_hz;
-    const uint32_t refresh_us = (uint32_t)(1000000.0f / sample_hz);
-
-    // 初始化 PT1 滤波器
-    pt1FilterInit(&pt1Filter_dev, pt1FilterGain(pt1_cut_hz, dt));
-    
-    // 初始化抗混叠 Biquad 低通滤波器（三轴）
-    biquadFilterInitLPF(&aa_x, aa_cut_hz, refresh_us);
-    biquadFilterInitLPF(&aa_y, aa_cut_hz, refresh_us);
-    biquadFilterInitLPF(&aa_z, aa_cut_hz, refresh_us);
-
-    // 清空所有状态
-    memset(&pt1_raw, 0, sizeof(pt1raw));
-    memset(&gyro_aa, 0, sizeof(gyro_antialias_t));
-    memset(&gyro_filtered, 0, sizeof(gyro_filtered_t));
-    gyro_filtered.ready = false;
-
-    // 标记滤波器已就绪
-    filter_ready = true;
+    // PT1 -> 抗混叠 Biquad 低通（各轴独立状态）
+    const filterBankStage_t stages[] = {
+        { .type = FILTER_BANK_PT1, .cutoff_hz = pt1_cut_hz },
+        { .type = FILTER_BANK_LPF, .cutoff_hz = aa_cut_hz },
+    };
+    if (!gyro_filter_configure(stages, 2, sample_hz)) {
+        return;
+    }
     
     printf("[gyro_filter] Initialized: %.0f Hz input, PT1 cut %.0f Hz, AA cut %.0f Hz\r\n",
            sample_hz, pt1_cut_hz, aa_cut_hz);
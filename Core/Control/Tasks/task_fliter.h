@@ -1,6 +1,6 @@
 /**
  * @file    task_filter.h
- * @brief   陀螺仪滤波模块（PT1 + 抗混叠低通滤波）
+ * @brief   陀螺仪滤波模块（按轴独立状态的滤波器组，默认 PT1 + 抗混叠低通滤波）
  *          接收降采样后的数据，输出滤波后的角速度（°/s）
  */
 
@@ -10,24 +10,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "filter.h"
-
-/**
- * @brief PT1滤波后的陀螺仪数据（°/s）
- */
-typedef struct pt1raw_s {
-    float pt1_gyro_x;  // °/s
-    float pt1_gyro_y;  // °/s
-    float pt1_gyro_z;  // °/s
-} pt1raw;
-
-/**
- * @brief 抗混叠滤波后的陀螺仪数据（°/s）
- */
-typedef struct gyro_antialias_s {
-    float x;  // °/s
-    float y;  // °/s
-    float z;  // °/s
-} gyro_antialias_t;
+#include "filter_bank.h"
+#include "dyn_notch.h"
 
 /**
  * @brief 滤波并转换为物理单位后的陀螺仪数据
@@ -39,8 +23,6 @@ typedef struct gyro_filtered_s {
     bool  ready;    // 数据就绪标志
 } gyro_filtered_t;
 
-extern pt1raw pt1_raw;                  // PT1滤波输出
-extern gyro_antialias_t gyro_aa;        // 抗混叠滤波输出
 extern gyro_filtered_t gyro_filtered;   // 最终滤波输出（°/s）
 
 
@@ -70,4 +52,67 @@ void gyro_filter_init(float sample_hz, float pt1_cut_hz, float aa_cut_hz);
  */
 bool gyro_filter_feed_sample(float gyro_x, float gyro_y, float gyro_z);
 
+/**
+ * @brief 按级配置滤波器组（替代 gyro_filter_init 的固定 PT1 + LPF 组合）
+ * @param stages 滤波级列表（PT1/PT2/PT3/LPF/NOTCH），按顺序串联
+ * @param count 级数（展开后的二阶节总数不超过 FILTER_BANK_MAX_SECTIONS）
+ * @param sample_hz 滤波器输入频率（Hz）
+ * @return true=成功，false=配置无效（滤波器保持未就绪）
+ *
+ * @example
+ * const filterBankStage_t stages[] = {
+ *     { FILTER_BANK_PT2,   150.0f, 0.0f },
+ *     { FILTER_BANK_NOTCH, 200.0f, 300.0f },   // 陷波中心 300Hz，下截止 200Hz
+ * };
+ * gyro_filter_configure(stages, 2, 1000.0f);
+ */
+bool gyro_filter_configure(const filterBankStage_t *stages, uint8_t count, float sample_hz);
+
+/**
+ * @brief 成块喂入降采样后的陀螺仪样本（每轴一次 CMSIS-DSP 级联调用）
+ * @param gyro_x/gyro_y/gyro_z 各轴输入块（°/s）
+ * @param out_x/out_y/out_z 各轴输出块（°/s，可与输入相同以原地滤波）
+ * @param count 每轴样本数
+ * @return true=处理成功，false=滤波器未初始化
+ * @note 与逐个调用 gyro_filter_feed_sample 结果相同；gyro_filtered 为块内最后一个样本
+ */
+bool gyro_filter_feed_block(const float *gyro_x, const float *gyro_y, const float *gyro_z,
+                            float *out_x, float *out_y, float *out_z, uint16_t count);
+
+/**
+ * @brief 获取滤波器组实例（动态陷波等模块在线更新系数用）
+ */
+filterBank_t *gyro_filter_bank(void);
+
+/**
+ * @brief 启用动态陷波（FFT 跟踪电机噪声峰，在滤波器组之后逐轴陷波）
+ * @param cfg 配置（input_hz=陀螺 ODR，notch_hz=滤波器输入频率），NULL 表示关闭
+ * @return true=成功，false=配置无效（动态陷波保持关闭）
+ *
+ * @example
+ * dynNotchConfig_t dn;
+ * dynNotchGetDefaultConfig(&dn);              // 8kHz 输入，1kHz 陷波，80-450Hz，每轴 2 个
+ * gyro_dyn_notch_init(&dn);
+ * scheduler_register_periodic(&sched, "dyn_notch", gyro_dyn_notch_task, NULL,
+ *                             TASK_PRIORITY_NORMAL, 1000, 50);
+ */
+bool gyro_dyn_notch_init(const dynNotchConfig_t *cfg);
+
+/**
+ * @brief 送入一个滤波前的陀螺仪样本（°/s，陀螺 ODR 调用，task_gyro 内部已调用）
+ */
+void gyro_dyn_notch_push(float gyro_x, float gyro_y, float gyro_z);
+
+/**
+ * @brief 调度器任务回调：执行一步有界的频谱分析（快照/一级蝶形/实数拆分/找峰/重设系数）
+ * @note 一次完整三轴分析需要 DYN_NOTCH_STEPS_PER_ANALYSIS 次调用，
+ *       调用频率应不低于 分析采样率 * DYN_NOTCH_STEPS_PER_ANALYSIS / DYN_NOTCH_HOP
+ */
+void gyro_dyn_notch_task(void *user);
+
+/**
+ * @brief 动态陷波实例（未启用时返回 NULL）
+ */
+dynNotch_t *gyro_dyn_notch(void);
+
 #endif // TASK_FILTER_H
@@ -1,10 +1,18 @@
 /**
  * @file    task_gyro.c
  * @brief   陀螺仪原始数据处理实现（零偏补偿 + 降采样）
+ * @note    降采样比为 2/4/8 时使用多相 FIR 抗混叠降采样（fir_decimator.c，系数离线设计），
+ *          其他比值退回到方波平均
+ * @note    零偏补偿、饱和、轴向旋转与降采样全部为整数运算（imu_frontend + Q15 FIR），
+ *          降采样输出时才乘以缓存的 1/刻度 转换为°/s，不再逐样本做浮点除法
  */
 
 #include "task_gyro.h"
 #include "icm42688p.h"
+#include "task_fliter.h"
+#include "fir_decimator.h"
+#include "imu_frontend.h"
+#include "gyro_cal.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -13,14 +21,21 @@
 // 处理状态
 static bool gyro_processing_ready = false;   // 是否已初始化
 
+// 定点前端（零偏 + 饱和 + 旋转）
+static imu_frontend_t gyro_fe;
+static sensor_rotation_t gyro_align;         // 安装方向（零初始化 = 不旋转），初始化时保留
+
 // 降采样参数
 static uint8_t decim_n = 1;                  // 降采样因子
 static uint8_t decim_count = 0;              // 降采样计数器
+static float decim_inv_n = 1.0f;             // 1 / decim_n
+static bool decim_use_fir = false;           // true=多相 FIR，false=方波平均
+static firDecimatorQ15_t decim_fir;
 
-// 降采样累加缓冲区（刻度转换后的°/s）
-static float sum_dps_x = 0.0f;
-static float sum_dps_y = 0.0f;
-static float sum_dps_z = 0.0f;
+// 方波平均累加缓冲区（补偿后的计数）
+static int32_t sum_x = 0;
+static int32_t sum_y = 0;
+static int32_t sum_z = 0;
 
 // 输出数据（全局变量，供外部访问）
 gyro_compensated_t gyro_compensated;         // 零偏补偿后的数据（原始值）
@@ -30,82 +45,48 @@ gyro_decimated_t gyro_decimated;             // 降采样后的数据（°/s）
 
 
 /**
- * @brief 对陀螺仪原始数据进行零偏补偿
- * @param raw_x 输入/输出：X轴原始数据
- * @param raw_y 输入/输出：Y轴原始数据
- * @param raw_z 输入/输出：Z轴原始数据
- * @note 使用 ICM42688P 的校准偏移量进行补偿
+ * @brief 处理降采样（整数）
+ * @param comp 零偏补偿后的计数
+ * @param dps_per_lsb 刻度倒数（°/s 每 LSB）
+ * @return true=降采样输出就绪；false=继续累加
+ * @note FIR 路径每个样本固定 K 次乘加/轴，输出样本上没有额外的突发计算；
+ *       只在输出时转换一次浮点
  */
-static void gyro_compensate_offset(int16_t *raw_x, int16_t *raw_y, int16_t *raw_z)
+static bool gyro_decimate(const int16_t comp[3], float dps_per_lsb)
 {
-    extern icm42688p_dev_t icm;
-    
-    // 减去零偏（带溢出保护）
-    int32_t x = (int32_t)(*raw_x) - (int32_t)icm.gyro_offset[0];
-    int32_t y = (int32_t)(*raw_y) - (int32_t)icm.gyro_offset[1];
-    int32_t z = (int32_t)(*raw_z) - (int32_t)icm.gyro_offset[2];
-    
-    // 限幅到 int16_t 范围
-    if (x > 32767) x = 32767;
-    if (x < -32768) x = -32768;
-    if (y > 32767) y = 32767;
-    if (y < -32768) y = -32768;
-    if (z > 32767) z = 32767;
-    if (z < -32768) z = -32768;
-    
-    *raw_x = (int16_t)x;
-    *raw_y = (int16_t)y;
-    *raw_z = (int16_t)z;
-}
-
-/**
- * @brief 刻度转换：将补偿后的原始值转换为°/s
- * @param comp_x 零偏补偿后的X轴数据（原始值）
- * @param comp_y 零偏补偿后的Y轴数据（原始值）
- * @param comp_z 零偏补偿后的Z轴数据（原始值）
- * @param dps_x 输出：X轴角速度（°/s）
- * @param dps_y 输出：Y轴角速度（°/s）
- * @param dps_z 输出：Z轴角速度（°/s）
- */
-static void gyro_scale_to_dps(int16_t comp_x, int16_t comp_y, int16_t comp_z,
-                              float *dps_x, float *dps_y, float *dps_z)
-{
-    extern icm42688p_dev_t icm;
-    const float gscale = (icm.gyro_scale > 0.0f) ? icm.gyro_scale : 1.0f;
-    
-    *dps_x = (float)comp_x / gscale;
-    *dps_y = (float)comp_y / gscale;
-    *dps_z = (float)comp_z / gscale;
-}
+    if (decim_use_fir) {
+        int32_t out[3];
+        if (firDecimatorQ15Apply(&decim_fir, comp, out)) {
+            const float k = dps_per_lsb * (1.0f / 32768.0f);   // Q15 -> 计数 -> °/s
+            gyro_decimated.dps_x = (float)out[0] * k;
+            gyro_decimated.dps_y = (float)out[1] * k;
+            gyro_decimated.dps_z = (float)out[2] * k;
+            gyro_decimated.ready = true;
+            return true;
+        }
+        gyro_decimated.ready = false;
+        return false;
+    }
 
-/**
- * @brief 处理降采样
- * @param dps_x X轴角速度（°/s）
- * @param dps_y Y轴角速度（°/s）
- * @param dps_z Z轴角速度（°/s）
- * @return true=降采样窗口已满，输出数据就绪；false=继续累加
- */
-static bool gyro_decimate(float dps_x, float dps_y, float dps_z)
-{
-    // 累加刻度转换后的数据（°/s）
-    sum_dps_x += dps_x;
-    sum_dps_y += dps_y;
-    sum_dps_z += dps_z;
+    // 累加补偿后的计数
+    sum_x += comp[0];
+    sum_y += comp[1];
+    sum_z += comp[2];
     decim_count++;
     
     // 当累积足够的样本后，计算平均值并输出
     if (decim_count >= decim_n) {
-        const float inv = 1.0f / (float)decim_n;
+        const float k = dps_per_lsb * decim_inv_n;
         
         // 计算平均值（降采样输出，单位°/s）
-        gyro_decimated.dps_x = sum_dps_x * inv;
-        gyro_decimated.dps_y = sum_dps_y * inv;
-        gyro_decimated.dps_z = sum_dps_z * inv;
+        gyro_decimated.dps_x = (float)sum_x * k;
+        gyro_decimated.dps_y = (float)sum_y * k;
+        gyro_decimated.dps_z = (float)sum_z * k;
         gyro_decimated.ready = true;
         
         // 重置计数器和累加器
         decim_count = 0;
-        sum_dps_x = sum_dps_y = sum_dps_z = 0.0f;
+        sum_x = sum_y = sum_z = 0;
         
         return true;  // 数据就绪
     }
@@ -126,9 +107,13 @@ void gyro_processing_init(uint8_t decim_factor)
     }
     decim_n = decim_factor;
     decim_count = 0;
+    decim_inv_n = 1.0f / (float)decim_factor;
+    decim_use_fir = firDecimatorQ15Init(&decim_fir, decim_factor);
+    imu_frontend_init(&gyro_fe);
+    imu_frontend_set_alignment(&gyro_fe, &gyro_align);
     
     // 清空累加器
-    sum_dps_x = sum_dps_y = sum_dps_z = 0.0f;
+    sum_x = sum_y = sum_z = 0;
     
     // 清空输出数据
     memset(&gyro_compensated, 0, sizeof(gyro_compensated_t));
@@ -139,12 +124,34 @@ void gyro_processing_init(uint8_t decim_factor)
     // 标记已就绪
     gyro_processing_ready = true;
     
-    printf("[gyro_processing] Initialized: decimation %d:1\r\n", decim_factor);
+    printf("[gyro_processing] Initialized: decimation %d:1 (%s)\r\n", decim_factor,
+           decim_use_fir ? "FIR" : "boxcar");
+}
+
+/**
+ * @brief 设置陀螺仪安装方向（传感器系 → 机体系）
+ */
+void gyro_processing_set_alignment(const sensor_rotation_t *rot)
+{
+    gyro_align = *rot;
+    imu_frontend_set_alignment(&gyro_fe, &gyro_align);
+}
+
+/**
+ * @brief 降采样引入的群延迟（输入样本数）
+ */
+float gyro_processing_group_delay(void)
+{
+    if (decim_use_fir) {
+        const firDecimatorDesign_t *d = decim_fir.design;
+        return 0.5f * (float)(d->phase_taps * d->ratio - 1);
+    }
+    return 0.5f * (float)(decim_n - 1);
 }
 
 /**
  * @brief 处理一个陀螺仪原始样本
- * @note 处理流程：原始值 → 零偏补偿 → 刻度转换(°/s) → 降采样
+ * @note 处理流程：原始值 → 零偏补偿/饱和/旋转（整数）→ 降采样（整数）→ 刻度转换(°/s)
  */
 bool gyro_process_sample(int16_t raw_x, int16_t raw_y, int16_t raw_z)
 {
@@ -157,22 +164,86 @@ bool gyro_process_sample(int16_t raw_x, int16_t raw_y, int16_t raw_z)
         return false;
     }
     
-    // 步骤1：零偏补偿
-    gyro_compensate_offset(&raw_x, &raw_y, &raw_z);
+    extern icm42688p_dev_t icm;
+
+    // 步骤1：零偏补偿 + 饱和 + 轴向旋转（整数）
+    const int16_t raw[3] = { raw_x, raw_y, raw_z };
+    int16_t comp[3];
+    gyro_cal_push_sample(raw);      // 在线零偏估计：只累加，判断在调度器任务中
+    imu_frontend_apply(&gyro_fe, raw, icm.gyro_offset, comp);
     
     // 保存补偿后的数据（原始值）
-    gyro_compensated.x = raw_x;
-    gyro_compensated.y = raw_y;
-    gyro_compensated.z = raw_z;
+    gyro_compensated.x = comp[0];
+    gyro_compensated.y = comp[1];
+    gyro_compensated.z = comp[2];
     
-    // 步骤2：刻度转换（原始值 → °/s）
-    gyro_scale_to_dps(raw_x, raw_y, raw_z,
-                     &gyro_scaled.dps_x,
-                     &gyro_scaled.dps_y,
-                     &gyro_scaled.dps_z);
+    // 步骤2：全速率°/s（乘以缓存的刻度倒数），供监控与动态陷波频谱分析
+    const float k = imu_frontend_unit_per_lsb(&gyro_fe, icm.gyro_scale);
+    gyro_scaled.dps_x = (float)comp[0] * k;
+    gyro_scaled.dps_y = (float)comp[1] * k;
+    gyro_scaled.dps_z = (float)comp[2] * k;
     
-    // 步骤3：降采样（累加并求平均）
-    gyro_decimate(gyro_scaled.dps_x, gyro_scaled.dps_y, gyro_scaled.dps_z);
+    // 动态陷波频谱分析使用滤波前的全速率数据
+    gyro_dyn_notch_push(gyro_scaled.dps_x, gyro_scaled.dps_y, gyro_scaled.dps_z);
+
+    // 步骤3：降采样（整数 FIR 抗混叠或方波平均），输出时转换为°/s
+    gyro_decimate(comp, k);
     
     return true;
 }
+
+/**
+ * @brief 处理一帧 ICM42688P DMA 数据
+ */
+bool gyro_process_frame(const icm42688p_dma_frame_t *frame)
+{
+    if (!frame || !frame->raw) {
+        return false;
+    }
+
+    int16_t raw_x, raw_y, raw_z;
+    icm42688p_dma_frame_gyro(frame, &raw_x, &raw_y, &raw_z);
+    return gyro_process_sample(raw_x, raw_y, raw_z);
+}
+
+/**
+ * @brief 批量处理 FIFO 样本
+ */
+uint16_t gyro_process_batch(const icm42688p_fifo_sample_t *samples, uint16_t count,
+                            gyro_decimated_cb_t on_ready, void *user)
+{
+    if (!samples) {
+        return 0;
+    }
+
+    uint16_t outputs = 0;
+    const icm42688p_fifo_sample_t *last = NULL;
+    for (uint16_t i = 0; i < count; i++) {
+        const icm42688p_fifo_sample_t *s = &samples[i];
+        if (!s->gyro_valid) {
+            continue;
+        }
+        last = s;
+        if (!gyro_process_sample(s->gyro[0], s->gyro[1], s->gyro[2])) {
+            break;
+        }
+        if (gyro_decimated.ready) {
+            gyro_decimated.timestamp_us = s->timestamp_us;
+            outputs++;
+            if (on_ready) {
+                on_ready(&gyro_decimated, s->timestamp_us, user);
+            }
+        }
+    }
+
+    // 芯片温度每批更新一次，供零偏温度模型使用
+    if (last) {
+        gyro_cal_set_temperature(last->temp_c);
+    }
+
+    // 无回调时保留最后一个输出：批末未凑满窗口的样本会清掉就绪标志，这里恢复
+    if (outputs > 0 && !on_ready) {
+        gyro_decimated.ready = true;
+    }
+    return outputs;
+}
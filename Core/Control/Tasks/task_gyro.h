@@ -8,6 +8,9 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "icm42688p_dma.h"
+#include "icm42688p_lib.h"
+#include "sensor_align.h"
 
 
 /**
@@ -32,10 +35,12 @@ typedef struct gyro_scaled_s {
  * @brief 降采样后的陀螺仪数据（°/s，未滤波）
  */
 typedef struct gyro_decimated_s {
-    float dps_x;    // X轴平均角速度（度/秒）
-    float dps_y;    // Y轴平均角速度（度/秒）
-    float dps_z;    // Z轴平均角速度（度/秒）
+    float dps_x;    // X轴降采样角速度（度/秒）
+    float dps_y;    // Y轴降采样角速度（度/秒）
+    float dps_z;    // Z轴降采样角速度（度/秒）
     bool  ready;    // 数据就绪标志
+    uint32_t timestamp_us;  // 窗口最后一个样本的传感器时间戳（仅 FIFO 批量路径填写）
+                            // 数据本身滞后 gyro_processing_group_delay() 个输入样本
 } gyro_decimated_t;
 
 
@@ -49,6 +54,8 @@ extern gyro_decimated_t gyro_decimated;       // 降采样后的数据（°/s）
  * @brief 初始化陀螺仪处理模块
  * @param decim_factor 降采样因子（例如8表示8:1降采样）
  * @note 必须在使用前调用
+ * @note 2/4/8 使用多相 FIR 抗混叠降采样（8kHz 输入时分别约 0.56/1.19/1.94ms 群延迟，
+ *       混叠抑制约 50dB）；1 为不降采样；其他比值使用方波平均
  * 
  * @example
  * // 8:1降采样（8KHz -> 1KHz）
@@ -56,6 +63,21 @@ extern gyro_decimated_t gyro_decimated;       // 降采样后的数据（°/s）
  */
 void gyro_processing_init(uint8_t decim_factor);
 
+/**
+ * @brief 设置陀螺仪安装方向（传感器系 → 机体系）
+ * @param rot sensor_rotation_build 的结果，通常经 sensor_alignment_configure 下发
+ * @note 零偏（icm.gyro_offset）仍在传感器系中减去，之后再旋转；
+ *       gyro_compensated / gyro_scaled / gyro_decimated 均为机体系。
+ *       方向在 gyro_processing_init 之后保留
+ */
+void gyro_processing_set_alignment(const sensor_rotation_t *rot);
+
+/**
+ * @brief 降采样引入的群延迟（输入样本数）
+ * @return FIR 为 (N-1)/2，方波平均为 (M-1)/2
+ */
+float gyro_processing_group_delay(void);
+
 /**
  * @brief 处理一个陀螺仪原始样本（零偏补偿 + 刻度转换 + 降采样）
  * @param raw_x X轴原始数据（ADC值）
@@ -63,7 +85,9 @@ void gyro_processing_init(uint8_t decim_factor);
  * @param raw_z Z轴原始数据（ADC值）
  * @return true=成功，false=未初始化
  * @note 
- * - 处理流程：原始值 → 零偏补偿 → 刻度转换(°/s) → 降采样
+ * - 处理流程：原始值 → 零偏补偿 → 安装方向旋转 → 刻度转换(°/s) → 降采样
+ * - 原始样本同时交给 gyro_cal 在线零偏估计（gyro_cal_init 之前不做任何事），
+ *   零偏由 gyro_cal_task 写入 icm.gyro_offset
  * - 每次IMU中断时调用
  * - 零偏补偿后的数据在 gyro_compensated 中（原始值）
  * - 刻度转换后的数据在 gyro_scaled 中（°/s）
@@ -72,4 +96,45 @@ void gyro_processing_init(uint8_t decim_factor);
  */
 bool gyro_process_sample(int16_t raw_x, int16_t raw_y, int16_t raw_z);
 
+/**
+ * @brief 处理一帧 ICM42688P DMA 数据（直接在 DMA 缓冲区上解码陀螺仪字段）
+ * @param frame icm42688p_dma_acquire 得到的帧，调用后由调用方 release
+ * @return true=成功，false=未初始化或 frame 为空
+ * @note 等价于解码后调用 gyro_process_sample，但不复制帧缓冲区
+ *
+ * @example
+ * icm42688p_dma_frame_t f;
+ * if (icm42688p_dma_acquire(&icm_dma, &f)) {
+ *     gyro_process_frame(&f);
+ *     icm42688p_dma_release(&icm_dma);
+ * }
+ */
+bool gyro_process_frame(const icm42688p_dma_frame_t *frame);
+
+/**
+ * @brief 降采样输出回调（批量处理时每产生一个降采样输出调用一次）
+ * @param out 降采样结果（即 gyro_decimated）
+ * @param timestamp_us 该输出窗口最后一个样本的传感器时间戳
+ * @param user 用户参数
+ */
+typedef void (*gyro_decimated_cb_t)(const gyro_decimated_t *out, uint32_t timestamp_us, void *user);
+
+/**
+ * @brief 批量处理 FIFO 样本（逐个样本走 gyro_process_sample 流程）
+ * @param samples icm42688p_fifo_drain/icm42688p_fifo_read 得到的样本
+ * @param count 样本数
+ * @param on_ready 降采样输出回调（可为 NULL，此时只保留最后一个输出）
+ * @param user 回调用户参数
+ * @return 产生的降采样输出个数
+ * @note 无效样本（传感器无新数据）被跳过，不计入降采样窗口；
+ *       一批中可能产生多个输出，下游需要逐个消费时必须提供回调
+ *
+ * @example
+ * static icm42688p_fifo_sample_t batch[32];
+ * uint16_t n = icm42688p_fifo_drain(batch, 32);
+ * gyro_process_batch(batch, n, on_gyro_1khz, NULL);
+ */
+uint16_t gyro_process_batch(const icm42688p_fifo_sample_t *samples, uint16_t count,
+                            gyro_decimated_cb_t on_ready, void *user);
+
 #endif // TASK_GYRO_H
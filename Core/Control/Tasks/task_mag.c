@@ -1,6 +1,7 @@
 /**
  * @file    task_mag.c
- * @brief   磁力计数据处理实现（校准 + 刻度转换）
+ * @brief   磁力计数据处理实现（校准 + 刻度转换 + 安装方向）
+ * @note    硬/软铁校准在传感器系中进行（与 hmc5883l 校准一致），之后再旋转到机体系
  */
 
 #include "task_mag.h"
@@ -23,6 +24,9 @@ static float mag_scale_x = 1.0f;
 static float mag_scale_y = 1.0f;
 static float mag_scale_z = 1.0f;
 
+// 安装方向（零初始化 = 不旋转），初始化时保留
+static sensor_rotation_t mag_align;
+
 // 输出数据（全局变量，供外部访问）
 mag_raw_t mag_raw;                           // 原始数据
 mag_calibrated_t mag_calibrated;             // 校准后的数据（gauss）
@@ -88,6 +92,14 @@ void mag_set_calibration(float offset_x, float offset_y, float offset_z,
     printf("[mag_set_calibration] 校准参数已设置\r\n");
 }
 
+/**
+ * @brief 设置磁力计安装方向
+ */
+void mag_processing_set_alignment(const sensor_rotation_t *rot)
+{
+    mag_align = *rot;
+}
+
 /**
  * @brief 应用校准参数并转换为 gauss
  */
@@ -134,10 +146,14 @@ bool mag_process_sample(int16_t raw_x, int16_t raw_y, int16_t raw_z)
     mag_raw.z = raw_z;
     
     // 应用校准并转换为 gauss
-    mag_apply_calibration(raw_x, raw_y, raw_z,
-                         &mag_calibrated.gauss_x,
-                         &mag_calibrated.gauss_y,
-                         &mag_calibrated.gauss_z);
+    float gauss[3];
+    mag_apply_calibration(raw_x, raw_y, raw_z, &gauss[0], &gauss[1], &gauss[2]);
+
+    // 传感器系 → 机体系（置换快路径或 3x3 矩阵）
+    sensor_rotation_apply(&mag_align, gauss);
+    mag_calibrated.gauss_x = gauss[0];
+    mag_calibrated.gauss_y = gauss[1];
+    mag_calibrated.gauss_z = gauss[2];
 
     mag_calibrated.magnitude_gauss = sqrtf(
         mag_calibrated.gauss_x * mag_calibrated.gauss_x +
@@ -8,6 +8,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "sensor_align.h"
 
 typedef struct mag_raw_s {
     int16_t x;
@@ -37,7 +38,10 @@ bool mag_calibrate(uint16_t samples);
 void mag_set_calibration(float offset_x, float offset_y, float offset_z,
                         float scale_x, float scale_y, float scale_z);
 
-// 处理一个磁力计原始样本（校准 + 刻度转换）
+// 设置磁力计安装方向（传感器系 → 机体系），在硬/软铁校准之后应用，mag_processing_init 后保留
+void mag_processing_set_alignment(const sensor_rotation_t *rot);
+
+// 处理一个磁力计原始样本（校准 + 刻度转换 + 安装方向旋转）
 bool mag_process_sample(int16_t raw_x, int16_t raw_y, int16_t raw_z);
 
 // 获取归一化后的磁力计向量（单位向量）
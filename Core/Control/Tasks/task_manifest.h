@@ -0,0 +1,149 @@
+/**
+ * @file    task_manifest.h
+ * @brief   声明式任务清单 -> 编译期静态任务表
+ * @note    任务在一个 X-macro 清单里声明一次，由本文件展开为：
+ *          - 句柄枚举（TASK_ID_<id>，即任务表下标，也是 scheduler_* 的 task_handle_t）
+ *          - const task_desc_t 数组与 const task_table_t（放在 Flash，周期已换算为 CPU 周期数）
+ *          - 编译期检查：周期/最小间隔非零、单任务 max_exec_us 不超过周期、
+ *            全部任务利用率之和 sum(max_exec_us / period) <= 1，否则编译失败
+ *          运行时只需 task_entry_t state[TASK_COUNT_<table>] 与 scheduler_init_static。
+ *
+ *          清单格式：
+ *          #define FC_TASKS(PERIODIC, EVENT_FLAG, EVENT_CB, EVENT_QUEUE)                      \
+ *              PERIODIC(gyro, gyro_task, NULL, TASK_PRIORITY_CRITICAL, 1000, 150)              \
+ *              EVENT_FLAG(rc, rc_task, NULL, TASK_PRIORITY_HIGH, &rc_ready, 2000, 80)          \
+ *              EVENT_CB(baro, baro_task, baro_ready, NULL, TASK_PRIORITY_LOW, 0, 500)          \
+ *              EVENT_QUEUE(link, link_task, NULL, TASK_PRIORITY_NORMAL, link_events, 8, 0, 60)
+ *
+ *          PERIODIC   (id, callback, user_data, priority, period_us, max_exec_us)
+ *          EVENT_FLAG (id, callback, user_data, priority, event_flag, min_interval_us, max_exec_us)
+ *          EVENT_CB   (id, callback, should_run, user_data, priority, min_interval_us, max_exec_us)
+ *          EVENT_QUEUE(id, event_cb, user_data, priority, event_buf, depth, min_interval_us, max_exec_us)
+ *
+ *          事件任务的 min_interval_us 是触发源的最小间隔（如 RC 帧间隔），只用于利用率检查；
+ *          0 表示触发频率未知，不计入利用率。
+ *
+ *          头文件中：TASK_MANIFEST_IDS(fc, FC_TASKS)
+ *          一个 .c 中：TASK_MANIFEST_DEFINE(fc, FC_TASKS)  -> const task_table_t fc_task_table
+ *
+ *          周期按 SCHEDULER_CPU_HZ 换算；scheduler_init_static 会核对它与运行时主频，
+ *          时钟配置改动后若忘了同步，初始化直接失败而不是以错误的频率运行。
+ *
+ *          固件的清单见 Core/Test/test_flight_loop.c（FLIGHT_TASKS，RUN_MODE 5）。
+ */
+
+#ifndef TASK_MANIFEST_H
+#define TASK_MANIFEST_H
+
+#include <stdint.h>
+#include "scheduler.h"
+
+// 换算任务周期使用的主频（须与 SystemClock_Config 一致）
+#ifndef SCHEDULER_CPU_HZ
+#define SCHEDULER_CPU_HZ        168000000UL
+#endif
+
+#define TASK_US_TO_CYCLES(us)   ((uint32_t)(((uint64_t)(us) * SCHEDULER_CPU_HZ) / 1000000ULL))
+
+// 利用率以 ppm 累加（1000000 = 100% CPU）
+#define TASK_MANIFEST_PPM(max_exec_us, interval_us) \
+    ((interval_us) ? ((uint64_t)(max_exec_us) * 1000000ULL / ((interval_us) ? (interval_us) : 1)) : 0ULL)
+
+// ============================================================================
+// 句柄枚举
+// ============================================================================
+#define TASK_MANIFEST_ID_P(id, ...)         TASK_ID_##id,
+#define TASK_MANIFEST_ID_EF(id, ...)        TASK_ID_##id,
+#define TASK_MANIFEST_ID_EC(id, ...)        TASK_ID_##id,
+#define TASK_MANIFEST_ID_EQ(id, ...)        TASK_ID_##id,
+
+#define TASK_MANIFEST_IDS(table, MANIFEST)                                              \
+    enum {                                                                              \
+        MANIFEST(TASK_MANIFEST_ID_P, TASK_MANIFEST_ID_EF, TASK_MANIFEST_ID_EC, TASK_MANIFEST_ID_EQ) \
+        TASK_COUNT_##table                                                              \
+    };                                                                                  \
+    extern const task_table_t table##_task_table
+
+// ============================================================================
+// 描述符
+// ============================================================================
+#define TASK_MANIFEST_DESC_P(id, cb, user, prio, period_us, max_us)                    \
+    [TASK_ID_##id] = { .name = #id, .callback = (cb), .user_data = (user),              \
+                       .priority = (prio), .trigger_mode = TASK_TRIGGER_PERIODIC,       \
+                       .period_cycles = TASK_US_TO_CYCLES(period_us),                   \
+                       .max_exec_us = (max_us) },
+
+#define TASK_MANIFEST_DESC_EF(id, cb, user, prio, flag, min_us, max_us)                \
+    [TASK_ID_##id] = { .name = #id, .callback = (cb), .user_data = (user),              \
+                       .priority = (prio), .trigger_mode = TASK_TRIGGER_EVENT,          \
+                       .event_flag = (flag), .max_exec_us = (max_us) },
+
+#define TASK_MANIFEST_DESC_EC(id, cb, run, user, prio, min_us, max_us)                 \
+    [TASK_ID_##id] = { .name = #id, .callback = (cb), .should_run = (run),              \
+                       .user_data = (user), .priority = (prio),                         \
+                       .trigger_mode = TASK_TRIGGER_EVENT, .max_exec_us = (max_us) },
+
+#define TASK_MANIFEST_DESC_EQ(id, cb, user, prio, buf, depth, min_us, max_us)          \
+    [TASK_ID_##id] = { .name = #id, .event_cb = (cb), .user_data = (user),              \
+                       .priority = (prio), .trigger_mode = TASK_TRIGGER_EVENT,          \
+                       .event_buf = (buf), .event_depth = (depth),                      \
+                       .max_exec_us = (max_us) },
+
+// ============================================================================
+// 逐任务检查
+// ============================================================================
+#define TASK_MANIFEST_CHECK_P(id, cb, user, prio, period_us, max_us)                   \
+    _Static_assert((period_us) > 0 && TASK_US_TO_CYCLES(period_us) > 0,                 \
+                   "task " #id ": period must be at least one CPU cycle");              \
+    _Static_assert((uint64_t)(max_us) <= (uint64_t)(period_us),                         \
+                   "task " #id ": max_exec_us exceeds its period");
+
+#define TASK_MANIFEST_CHECK_EF(id, cb, user, prio, flag, min_us, max_us)               \
+    _Static_assert((min_us) == 0 || (uint64_t)(max_us) <= (uint64_t)(min_us),           \
+                   "task " #id ": max_exec_us exceeds its minimum event interval");
+
+#define TASK_MANIFEST_CHECK_EC(id, cb, run, user, prio, min_us, max_us)                \
+    _Static_assert((min_us) == 0 || (uint64_t)(max_us) <= (uint64_t)(min_us),           \
+                   "task " #id ": max_exec_us exceeds its minimum event interval");
+
+#define TASK_MANIFEST_CHECK_EQ(id, cb, user, prio, buf, depth, min_us, max_us)         \
+    _Static_assert((depth) >= 2 && (depth) <= 128 && ((depth) & ((depth) - 1)) == 0,    \
+                   "task " #id ": event queue depth must be a power of two in [2, 128]"); \
+    _Static_assert((min_us) == 0 || (uint64_t)(max_us) <= (uint64_t)(min_us),           \
+                   "task " #id ": max_exec_us exceeds its minimum event interval");
+
+// ============================================================================
+// 利用率
+// ============================================================================
+#define TASK_MANIFEST_UTIL_P(id, cb, user, prio, period_us, max_us)                    \
+    + TASK_MANIFEST_PPM(max_us, period_us)
+#define TASK_MANIFEST_UTIL_EF(id, cb, user, prio, flag, min_us, max_us)                \
+    + TASK_MANIFEST_PPM(max_us, min_us)
+#define TASK_MANIFEST_UTIL_EC(id, cb, run, user, prio, min_us, max_us)                 \
+    + TASK_MANIFEST_PPM(max_us, min_us)
+#define TASK_MANIFEST_UTIL_EQ(id, cb, user, prio, buf, depth, min_us, max_us)          \
+    + TASK_MANIFEST_PPM(max_us, min_us)
+
+// 清单的最坏情况 CPU 利用率（ppm，常量表达式）
+#define TASK_MANIFEST_UTIL_PPM(MANIFEST)                                                \
+    (0ULL MANIFEST(TASK_MANIFEST_UTIL_P, TASK_MANIFEST_UTIL_EF, TASK_MANIFEST_UTIL_EC, TASK_MANIFEST_UTIL_EQ))
+
+// ============================================================================
+// 任务表定义（放在一个 .c 中，须先展开 TASK_MANIFEST_IDS）
+// ============================================================================
+#define TASK_MANIFEST_DEFINE(table, MANIFEST)                                           \
+    MANIFEST(TASK_MANIFEST_CHECK_P, TASK_MANIFEST_CHECK_EF, TASK_MANIFEST_CHECK_EC, TASK_MANIFEST_CHECK_EQ) \
+    _Static_assert(TASK_COUNT_##table <= SCHEDULER_MAX_TASKS,                           \
+                   "task manifest " #table ": too many tasks");                         \
+    _Static_assert(TASK_MANIFEST_UTIL_PPM(MANIFEST) <= 1000000ULL,                      \
+                   "task manifest " #table ": sum(max_exec_us / period) exceeds 100% CPU"); \
+    static const task_desc_t table##_task_desc[TASK_COUNT_##table] = {                  \
+        MANIFEST(TASK_MANIFEST_DESC_P, TASK_MANIFEST_DESC_EF, TASK_MANIFEST_DESC_EC, TASK_MANIFEST_DESC_EQ) \
+    };                                                                                  \
+    const task_table_t table##_task_table = {                                           \
+        .tasks = table##_task_desc,                                                     \
+        .count = TASK_COUNT_##table,                                                    \
+        .cpu_freq_hz = SCHEDULER_CPU_HZ,                                                \
+    }
+
+#endif // TASK_MANIFEST_H
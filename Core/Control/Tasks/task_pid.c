@@ -2,7 +2,6 @@
 #include <string.h>
 #include "task_pid.h"
 #include "task_rc.h"
-#include "task_gyro.h"
 
 // 轴索引
 enum { AXIS_ROLL = 0, AXIS_PITCH = 1, AXIS_YAW = 2 };
@@ -63,7 +62,8 @@ void task_pid_init(float control_rate_hz)
     memset(&pid_out, 0, sizeof(pid_out));
 }
 
-const pid_output_t *task_pid_step(float dt, float max_rate_dps)
+const pid_output_t *task_pid_update(const Euler_angles *angles, const gyro_filtered_t *rate,
+                                    float dt, float max_rate_dps)
 {
     // 清零输出
     memset(&pid_out, 0, sizeof(pid_out));
@@ -81,10 +81,9 @@ const pid_output_t *task_pid_step(float dt, float max_rate_dps)
     pid_out.link_active = true;
 
     // 姿态反馈（deg）
-    Euler_angles ang = Attitude_Get_Angles();
-    pid_out.angle_meas[0] = ang.roll;
-    pid_out.angle_meas[1] = ang.pitch;
-    pid_out.angle_meas[2] = ang.yaw;
+    pid_out.angle_meas[0] = angles->roll;
+    pid_out.angle_meas[1] = angles->pitch;
+    pid_out.angle_meas[2] = angles->yaw;
 
     // 角度期望（deg），yaw 此处也走角度环，保持简单
     pid_out.angle_sp[0] = rc->roll_deg;
@@ -105,10 +104,10 @@ const pid_output_t *task_pid_step(float dt, float max_rate_dps)
     pid_out.rate_sp[1] = sp_rate_pitch;
     pid_out.rate_sp[2] = sp_rate_yaw;
 
-    // 角速度反馈（dps）
-    pid_out.rate_meas[0] = gyro_scaled.dps_x;
-    pid_out.rate_meas[1] = gyro_scaled.dps_y;
-    pid_out.rate_meas[2] = gyro_scaled.dps_z;
+    // 角速度反馈（dps，滤波后）
+    pid_out.rate_meas[0] = rate->dps_x;
+    pid_out.rate_meas[1] = rate->dps_y;
+    pid_out.rate_meas[2] = rate->dps_z;
 
     // 速率环输出力矩指令
     float u_roll  = pid_update(&pid_rate[AXIS_ROLL],  pid_out.rate_sp[0], pid_out.rate_meas[0]);
@@ -129,3 +128,9 @@ const pid_output_t *task_pid_step(float dt, float max_rate_dps)
 
     return &pid_out;
 }
+
+const pid_output_t *task_pid_step(float dt, float max_rate_dps)
+{
+    Euler_angles ang = Attitude_Get_Angles();
+    return task_pid_update(&ang, &gyro_filtered, dt, max_rate_dps);
+}
@@ -6,6 +6,7 @@
 #include "attitude.h"
 #include "task_rc.h"
 #include "pid.h"
+#include "task_fliter.h"
 
 typedef struct {
     float motor[4];      // 归一化电机输出 0..1
@@ -17,6 +18,10 @@ typedef struct {
 } pid_output_t;
 
 void task_pid_init(float control_rate_hz);
+// 用给定的姿态（deg）与角速度（°/s）反馈计算一步，流水线阶段直接传入上游输出
+const pid_output_t *task_pid_update(const Euler_angles *angles, const gyro_filtered_t *rate,
+                                    float dt, float max_rate_dps);
+// 以当前姿态与滤波后的角速度（gyro_filtered）调用 task_pid_update
 const pid_output_t *task_pid_step(float dt, float max_rate_dps);
 
 #endif // TASK_PID_H
@@ -0,0 +1,262 @@
+#include "task_pipeline.h"
+#include "task_mag.h"
+#include "latency_trace.h"
+#include "bsp_System.h"
+#include <string.h>
+#include <stdio.h>
+
+// ============================================================================
+// 排序与校验
+// ============================================================================
+
+/**
+ * @brief 阶段 j 依赖阶段 i（i 的输出是 j 的必需或可选输入）
+ */
+static inline bool stage_depends_on(const pipeline_stage_t *j, const pipeline_stage_t *i)
+{
+    return ((j->inputs | j->optional) & i->outputs) != 0;
+}
+
+bool pipeline_init(pipeline_t *p, const pipeline_stage_t *stages, uint8_t count)
+{
+    memset(p, 0, sizeof(*p));
+    task_hist_reset(&p->latency_hist);
+
+    if (count > PIPELINE_MAX_STAGES) {
+        printf("[pipeline] too many stages (%u > %u)\r\n", count, PIPELINE_MAX_STAGES);
+        return false;
+    }
+
+    // 每个信号只能有一个生产者，帧输入不能由阶段产生
+    uint32_t produced = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        const uint32_t dup = stages[i].outputs & (produced | PIPE_SIG_FRAME_INPUTS);
+        if (dup) {
+            printf("[pipeline] stage '%s' re-produces signal mask 0x%lx\r\n",
+                   stages[i].name, (unsigned long)dup);
+            return false;
+        }
+        if (!stages[i].run) {
+            printf("[pipeline] stage '%s' has no run function\r\n", stages[i].name);
+            return false;
+        }
+        produced |= stages[i].outputs;
+    }
+
+    // 必需输入必须有来源（帧输入或某个阶段的输出）
+    for (uint8_t i = 0; i < count; i++) {
+        const uint32_t missing = stages[i].inputs & ~(produced | PIPE_SIG_FRAME_INPUTS);
+        if (missing) {
+            printf("[pipeline] stage '%s' input mask 0x%lx has no producer\r\n",
+                   stages[i].name, (unsigned long)missing);
+            return false;
+        }
+    }
+
+    // Kahn 拓扑排序：每轮取声明顺序最靠前的就绪阶段，无依赖关系的阶段保持声明顺序
+    uint8_t indegree[PIPELINE_MAX_STAGES] = {0};
+    bool placed[PIPELINE_MAX_STAGES] = {false};
+    for (uint8_t j = 0; j < count; j++) {
+        for (uint8_t i = 0; i < count; i++) {
+            if (i != j && stage_depends_on(&stages[j], &stages[i])) indegree[j]++;
+        }
+    }
+
+    for (uint8_t n = 0; n < count; n++) {
+        uint8_t pick = count;
+        for (uint8_t i = 0; i < count; i++) {
+            if (!placed[i] && indegree[i] == 0) {
+                pick = i;
+                break;
+            }
+        }
+        if (pick == count) {
+            printf("[pipeline] dependency cycle among remaining stages:");
+            for (uint8_t i = 0; i < count; i++) {
+                if (!placed[i]) printf(" %s", stages[i].name);
+            }
+            printf("\r\n");
+            p->count = 0;
+            return false;
+        }
+
+        placed[pick] = true;
+        p->stages[n] = stages[pick];
+        for (uint8_t j = 0; j < count; j++) {
+            if (!placed[j] && stage_depends_on(&stages[j], &stages[pick])) indegree[j]--;
+        }
+    }
+
+    p->count = count;
+    return true;
+}
+
+// ============================================================================
+// 运行
+// ============================================================================
+
+uint32_t pipeline_run(pipeline_t *p, pipeline_frame_t *frame)
+{
+    for (uint8_t i = 0; i < p->count; i++) {
+        const pipeline_stage_t *stage = &p->stages[i];
+        if ((frame->valid & stage->inputs) != stage->inputs) continue;
+
+        const uint32_t start = DWT_GetTick();
+        const bool produced = stage->run(frame, stage->user);
+        const uint32_t exec = DWT_GetTick() - start;
+
+        pipeline_stage_stats_t *st = &p->stats[i];
+        st->runs++;
+        st->exec_cycles_total += exec;
+        if (exec > st->exec_cycles_max) st->exec_cycles_max = exec;
+
+        if (produced) frame->valid |= stage->outputs;
+    }
+
+    if (frame->valid & PIPE_SIG(PIPE_SIG_MOTOR)) {
+        const uint32_t latency = DWT_GetTick() - frame->t_sample;
+        p->latency_last = latency;
+        if (latency > p->latency_max) p->latency_max = latency;
+        p->latency_count++;
+        task_hist_record(&p->latency_hist, latency);
+    }
+
+    return frame->valid;
+}
+
+uint32_t pipeline_latency_percentile(const pipeline_t *p, uint16_t per10k)
+{
+    return task_hist_percentile(&p->latency_hist, per10k);
+}
+
+void pipeline_reset_stats(pipeline_t *p)
+{
+    memset(p->stats, 0, sizeof(p->stats));
+    p->latency_count = 0;
+    p->latency_last = 0;
+    p->latency_max = 0;
+    task_hist_reset(&p->latency_hist);
+}
+
+void pipeline_print_stats(const pipeline_t *p)
+{
+    const float cycles_per_us = (float)SystemCoreClock / 1e6f;
+
+    printf("\r\n========== 流水线统计 ==========\r\n");
+    printf("%-12s %-10s %-10s %-10s\r\n", "阶段", "次数", "平均(us)", "最大(us)");
+    for (uint8_t i = 0; i < p->count; i++) {
+        const pipeline_stage_stats_t *st = &p->stats[i];
+        const float avg = st->runs ? (float)st->exec_cycles_total / (float)st->runs : 0.0f;
+        printf("%-12s %-10lu %-10.2f %-10.2f\r\n", p->stages[i].name, (unsigned long)st->runs,
+               avg / cycles_per_us, (float)st->exec_cycles_max / cycles_per_us);
+    }
+    printf("端到端延迟 (采样 -> 电机, %lu 次): p50 %.1f us, p99 %.1f us, 最大 %.1f us\r\n",
+           (unsigned long)p->latency_count,
+           (float)pipeline_latency_percentile(p, 5000) / cycles_per_us,
+           (float)pipeline_latency_percentile(p, 9900) / cycles_per_us,
+           (float)p->latency_max / cycles_per_us);
+    printf("================================\r\n\r\n");
+}
+
+// ============================================================================
+// 默认飞控图
+// ============================================================================
+
+typedef struct {
+    pipeline_flight_config_t cfg;
+    uint32_t                 last_t;        // 上一次控制的采样时刻（DWT 周期）
+    bool                     have_last;
+} flight_pid_state_t;
+
+static flight_pid_state_t flight_pid;
+
+static bool stage_gyro(pipeline_frame_t *f, void *user)
+{
+    (void)user;
+    gyro_process_sample(f->gyro_raw[0], f->gyro_raw[1], f->gyro_raw[2]);
+    latency_trace_mark(f->trace_id, LATENCY_TRACE_GYRO);
+    if (!gyro_decimated.ready) return false;
+    f->gyro_decimated = &gyro_decimated;
+    return true;
+}
+
+// 加速度/磁力计：原始值为可选输入，本帧没有新样本时沿用模块内最近一次的结果
+static bool stage_accel(pipeline_frame_t *f, void *user)
+{
+    (void)user;
+    if (f->valid & PIPE_SIG(PIPE_SIG_ACCEL_RAW)) {
+        accel_process_sample(f->accel_raw[0], f->accel_raw[1], f->accel_raw[2]);
+    }
+    if (!accel_scaled.ready) return false;
+    f->accel = &accel_scaled;
+    return true;
+}
+
+static bool stage_mag(pipeline_frame_t *f, void *user)
+{
+    (void)user;
+    float strength;
+    if (f->valid & PIPE_SIG(PIPE_SIG_MAG_RAW)) {
+        mag_process_sample(f->mag_raw[0], f->mag_raw[1], f->mag_raw[2]);
+    }
+    if (!mag_calibrated.ready) return false;
+    return mag_get_normalized(&f->mag[0], &f->mag[1], &f->mag[2], &strength);
+}
+
+static bool stage_filter(pipeline_frame_t *f, void *user)
+{
+    (void)user;
+    const gyro_decimated_t *g = f->gyro_decimated;
+    gyro_filter_feed_sample(g->dps_x, g->dps_y, g->dps_z);
+    latency_trace_mark(f->trace_id, LATENCY_TRACE_FILTER);
+    f->gyro_filtered = &gyro_filtered;
+    return true;
+}
+
+static bool stage_attitude(pipeline_frame_t *f, void *user)
+{
+    (void)user;
+    const accel_scaled_t *a = f->accel;
+    const gyro_filtered_t *g = f->gyro_filtered;
+    if (f->valid & PIPE_SIG(PIPE_SIG_MAG)) {
+        f->attitude = Attitude_Update(a->g_x, a->g_y, a->g_z, g->dps_x, g->dps_y, g->dps_z,
+                                      f->mag[0], f->mag[1], f->mag[2]);
+    } else {
+        f->attitude = Attitude_Update_IMU_Only(a->g_x, a->g_y, a->g_z, g->dps_x, g->dps_y, g->dps_z);
+    }
+    latency_trace_mark(f->trace_id, LATENCY_TRACE_ATTITUDE);
+    return true;
+}
+
+static bool stage_pid(pipeline_frame_t *f, void *user)
+{
+    flight_pid_state_t *s = (flight_pid_state_t *)user;
+    const float dt = s->have_last ? (float)(f->t_sample - s->last_t) / (float)SystemCoreClock
+                                  : 1.0f / s->cfg.control_hz;
+    s->last_t = f->t_sample;
+    s->have_last = true;
+
+    f->motor = task_pid_update(&f->attitude, f->gyro_filtered, dt, s->cfg.max_rate_dps);
+    latency_trace_mark(f->trace_id, LATENCY_TRACE_PID);
+    return true;
+}
+
+bool pipeline_flight_init(pipeline_t *p, const pipeline_flight_config_t *cfg)
+{
+    memset(&flight_pid, 0, sizeof(flight_pid));
+    flight_pid.cfg = *cfg;
+
+    const pipeline_stage_t stages[] = {
+        { "gyro",     PIPE_SIG(PIPE_SIG_GYRO_RAW), 0, PIPE_SIG(PIPE_SIG_GYRO_DECIMATED), stage_gyro, NULL },
+        { "accel",    0, PIPE_SIG(PIPE_SIG_ACCEL_RAW), PIPE_SIG(PIPE_SIG_ACCEL), stage_accel, NULL },
+        { "filter",   PIPE_SIG(PIPE_SIG_GYRO_DECIMATED), 0, PIPE_SIG(PIPE_SIG_GYRO_FILTERED), stage_filter, NULL },
+        { "attitude", PIPE_SIG(PIPE_SIG_GYRO_FILTERED) | PIPE_SIG(PIPE_SIG_ACCEL), PIPE_SIG(PIPE_SIG_MAG),
+                      PIPE_SIG(PIPE_SIG_ATTITUDE), stage_attitude, NULL },
+        { "pid",      PIPE_SIG(PIPE_SIG_ATTITUDE) | PIPE_SIG(PIPE_SIG_GYRO_FILTERED), 0,
+                      PIPE_SIG(PIPE_SIG_MOTOR), stage_pid, &flight_pid },
+        { "mag",      0, PIPE_SIG(PIPE_SIG_MAG_RAW), PIPE_SIG(PIPE_SIG_MAG), stage_mag, NULL },
+    };
+    const uint8_t count = (uint8_t)(sizeof(stages) / sizeof(stages[0])) - (cfg->use_mag ? 0 : 1);
+
+    return pipeline_init(p, stages, count);
+}
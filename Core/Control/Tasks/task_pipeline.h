@@ -0,0 +1,157 @@
+/**
+ * @file    task_pipeline.h
+ * @brief   传感器 -> 电机数据流的静态流水线图
+ * @note    每个阶段声明自己读哪些信号、写哪些信号，pipeline_init 时按依赖做一次拓扑排序，
+ *          之后每个 IMU 节拍调用一次 pipeline_run，按排好的顺序一遍跑完。
+ *          - 信号就绪由帧内的 valid 位图表示（替代各模块的 ready 全局标志）：
+ *            阶段的全部输入在本帧就绪才运行，返回 true 时其输出置位
+ *          - 阶段之间零拷贝：帧里保存指向生产者输出缓冲区的指针（gyro_decimated、gyro_filtered、
+ *            accel_scaled 等），消费者直接读
+ *          - 帧带有 SPI 采样时刻（DWT 周期），产出 PIPE_SIG_MOTOR 时记录端到端延迟；
+ *            帧带 trace_id 时默认飞控图的各阶段同时给 latency_trace 打点
+ *
+ *          默认飞控图（pipeline_flight_init）：
+ *            gyro_raw  -> [gyro]   -> gyro_decimated -> [filter] -> gyro_filtered --+
+ *            accel_raw -> [accel]  -> accel ----------------------------------------+-> [attitude] -> attitude
+ *            mag_raw   -> [mag]    -> mag（可选输入）-----------------------------------+
+ *            attitude + gyro_filtered -> [pid] -> motor
+ */
+
+#ifndef TASK_PIPELINE_H
+#define TASK_PIPELINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "attitude.h"
+#include "task_gyro.h"
+#include "task_acc.h"
+#include "task_fliter.h"
+#include "task_pid.h"
+#include "scheduler_hist.h"
+
+#define PIPELINE_MAX_STAGES     12
+
+// ============================================================================
+// 信号
+// ============================================================================
+typedef enum {
+    PIPE_SIG_GYRO_RAW = 0,      // 帧输入：陀螺仪原始值
+    PIPE_SIG_ACCEL_RAW,         // 帧输入：加速度计原始值
+    PIPE_SIG_MAG_RAW,           // 帧输入：磁力计原始值
+    PIPE_SIG_GYRO_DECIMATED,    // 降采样输出（°/s，未滤波）
+    PIPE_SIG_GYRO_FILTERED,     // 滤波输出（°/s）
+    PIPE_SIG_ACCEL,             // 加速度（g）
+    PIPE_SIG_MAG,               // 归一化磁场方向
+    PIPE_SIG_ATTITUDE,          // 姿态角（deg）
+    PIPE_SIG_MOTOR,             // 混控输出
+    PIPE_SIG_COUNT
+} pipeline_signal_t;
+
+#define PIPE_SIG(s)             (1UL << (s))
+#define PIPE_SIG_FRAME_INPUTS   (PIPE_SIG(PIPE_SIG_GYRO_RAW) | PIPE_SIG(PIPE_SIG_ACCEL_RAW) | \
+                                 PIPE_SIG(PIPE_SIG_MAG_RAW))
+
+// ============================================================================
+// 每节拍的帧（信号存储）
+// ============================================================================
+typedef struct {
+    uint32_t                 valid;          // 本帧已就绪的信号位图
+    uint32_t                 t_sample;       // SPI 采样时刻（DWT 周期，延迟起点）
+    uint32_t                 trace_id;       // latency_trace 记录 id（LATENCY_TRACE_NONE = 不打点）
+
+    // 帧输入（调用方填写并置 valid）
+    int16_t                  gyro_raw[3];
+    int16_t                  accel_raw[3];
+    int16_t                  mag_raw[3];
+
+    // 阶段输出（指向生产者的输出缓冲区）
+    const gyro_decimated_t  *gyro_decimated;
+    const gyro_filtered_t   *gyro_filtered;
+    const accel_scaled_t    *accel;
+    float                    mag[3];
+    Euler_angles             attitude;
+    const pid_output_t      *motor;
+} pipeline_frame_t;
+
+typedef bool (*pipeline_stage_fn)(pipeline_frame_t *frame, void *user);
+
+// ============================================================================
+// 阶段声明
+// ============================================================================
+typedef struct {
+    const char          *name;
+    uint32_t             inputs;        // 必需输入（全部就绪才运行）
+    uint32_t             optional;      // 可选输入（只影响排序，未就绪也运行）
+    uint32_t             outputs;       // 输出（返回 true 时置位）
+    pipeline_stage_fn    run;
+    void                *user;
+} pipeline_stage_t;
+
+typedef struct {
+    uint32_t runs;                      // 运行次数
+    uint32_t exec_cycles_max;           // 最大执行时间（CPU 周期）
+    uint32_t exec_cycles_total;         // 累计执行时间（CPU 周期）
+} pipeline_stage_stats_t;
+
+// ============================================================================
+// 流水线
+// ============================================================================
+typedef struct {
+    pipeline_stage_t        stages[PIPELINE_MAX_STAGES];    // 已按拓扑顺序排列
+    pipeline_stage_stats_t  stats[PIPELINE_MAX_STAGES];
+    uint8_t                 count;
+
+    // 端到端延迟（t_sample -> 产出 PIPE_SIG_MOTOR）
+    uint32_t                latency_count;
+    uint32_t                latency_last;   // CPU 周期
+    uint32_t                latency_max;    // CPU 周期
+    task_hist_t             latency_hist;
+} pipeline_t;
+
+/**
+ * @brief 按依赖关系排序并校验阶段表（声明顺序任意）
+ * @return false=同一信号有多个生产者、必需输入无人生产、存在环或阶段过多（打印原因）
+ */
+bool pipeline_init(pipeline_t *p, const pipeline_stage_t *stages, uint8_t count);
+
+/**
+ * @brief 按拓扑顺序跑一遍
+ * @param frame 调用方填好帧输入（valid 中置对应位）与 t_sample
+ * @return 本帧最终就绪的信号位图
+ */
+uint32_t pipeline_run(pipeline_t *p, pipeline_frame_t *frame);
+
+// 延迟分位数（CPU 周期，per10k 同 task_hist_percentile）
+uint32_t pipeline_latency_percentile(const pipeline_t *p, uint16_t per10k);
+void pipeline_reset_stats(pipeline_t *p);
+void pipeline_print_stats(const pipeline_t *p);
+
+// ============================================================================
+// 默认飞控图
+// ============================================================================
+typedef struct {
+    float    control_hz;        // 控制频率（PID 首帧 dt）
+    float    max_rate_dps;      // task_pid_update 参数
+    bool     use_mag;           // 磁力计就绪时使用 9DoF 融合
+} pipeline_flight_config_t;
+
+/**
+ * @brief 建立默认飞控图（gyro/accel/mag/filter/attitude/pid）
+ * @note  各模块需已初始化（gyro_processing_init、accel_processing_init、gyro_filter_init、
+ *        task_pid_init 等）；磁力计阶段在 use_mag=false 时不加入
+ *
+ * @example
+ * // IMU 事件任务（scheduler_register_event_queue）中每个样本调用一次
+ * pipeline_frame_t f = { .valid = PIPE_SIG(PIPE_SIG_GYRO_RAW) | PIPE_SIG(PIPE_SIG_ACCEL_RAW),
+ *                        .t_sample = frame->timestamp,
+ *                        .trace_id = latency_trace_find(frame->timestamp) };
+ * icm42688p_dma_frame_gyro(frame, &f.gyro_raw[0], &f.gyro_raw[1], &f.gyro_raw[2]);
+ * icm42688p_dma_frame_accel(frame, &f.accel_raw[0], &f.accel_raw[1], &f.accel_raw[2]);
+ * if (pipeline_run(&flight, &f) & PIPE_SIG(PIPE_SIG_MOTOR)) {
+ *     motors_write(f.motor->motor);
+ *     latency_trace_mark(f.trace_id, LATENCY_TRACE_MOTOR);
+ * }
+ */
+bool pipeline_flight_init(pipeline_t *p, const pipeline_flight_config_t *cfg);
+
+#endif // TASK_PIPELINE_H
@@ -15,6 +15,9 @@ static bool push_item(const task_reg_item_t *item)
     if (reg_count >= TASK_REGISTER_MAX) {
         return false;
     }
+    if (item->handle) {
+        *item->handle = TASK_HANDLE_INVALID;
+    }
     registry[reg_count++] = *item;
     return true;
 }
@@ -24,7 +27,8 @@ bool task_register_event_flag(const char *name,
                               void *user_data,
                               task_priority_t priority,
                               volatile bool *event_flag,
-                              uint32_t max_exec_us)
+                              uint32_t max_exec_us,
+                              task_handle_t *handle)
 {
     if (!name || !callback || !event_flag) return false;
     task_reg_item_t it = {
@@ -37,6 +41,7 @@ bool task_register_event_flag(const char *name,
         .event_flag = event_flag,
         .period_us = 0,
         .max_exec_us = max_exec_us,
+        .handle = handle,
     };
     return push_item(&it);
 }
@@ -46,7 +51,8 @@ bool task_register_event_cb(const char *name,
                             task_should_run_cb_t should_run,
                             void *user_data,
                             task_priority_t priority,
-                            uint32_t max_exec_us)
+                            uint32_t max_exec_us,
+                            task_handle_t *handle)
 {
     if (!name || !callback || !should_run) return false;
     task_reg_item_t it = {
@@ -59,6 +65,7 @@ bool task_register_event_cb(const char *name,
         .event_flag = NULL,
         .period_us = 0,
         .max_exec_us = max_exec_us,
+        .handle = handle,
     };
     return push_item(&it);
 }
@@ -68,7 +75,8 @@ bool task_register_periodic(const char *name,
                             void *user_data,
                             task_priority_t priority,
                             uint32_t period_us,
-                            uint32_t max_exec_us)
+                            uint32_t max_exec_us,
+                            task_handle_t *handle)
 {
     if (!name || !callback || period_us == 0) return false;
     task_reg_item_t it = {
@@ -81,6 +89,35 @@ bool task_register_periodic(const char *name,
         .event_flag = NULL,
         .period_us = period_us,
         .max_exec_us = max_exec_us,
+        .handle = handle,
+    };
+    return push_item(&it);
+}
+
+bool task_register_event_queue(const char *name,
+                              task_event_cb_t callback,
+                              void *user_data,
+                              task_priority_t priority,
+                              task_event_t *buffer,
+                              uint8_t depth,
+                              uint32_t max_exec_us,
+                               task_handle_t *handle)
+{
+    if (!name || !callback || !buffer || depth == 0) return false;
+    task_reg_item_t it = {
+        .type = TASK_REG_TYPE_EVENT_QUEUE,
+        .name = name,
+        .callback = NULL,
+        .should_run = NULL,
+        .user_data = user_data,
+        .priority = priority,
+        .event_flag = NULL,
+        .period_us = 0,
+        .event_cb = callback,
+        .event_buf = buffer,
+        .event_depth = depth,
+        .max_exec_us = max_exec_us,
+        .handle = handle,
     };
     return push_item(&it);
 }
@@ -91,24 +128,32 @@ int task_register_apply(task_scheduler_fc_t *sched)
     int ok = 0;
     for (uint8_t i = 0; i < reg_count; i++) {
         task_reg_item_t *it = &registry[i];
-        bool res = false;
+        task_handle_t h = TASK_HANDLE_INVALID;
         switch (it->type) {
             case TASK_REG_TYPE_EVENT_FLAG:
-                res = scheduler_register_event_flag(sched, it->name, it->callback, it->user_data,
-                                                    it->priority, it->event_flag, it->max_exec_us);
+                h = scheduler_register_event_flag(sched, it->name, it->callback, it->user_data,
+                                                  it->priority, it->event_flag, it->max_exec_us);
                 break;
             case TASK_REG_TYPE_EVENT_CB:
-                res = scheduler_register_event_callback(sched, it->name, it->callback, it->should_run,
-                                                        it->user_data, it->priority, it->max_exec_us);
+                h = scheduler_register_event_callback(sched, it->name, it->callback, it->should_run,
+                                                      it->user_data, it->priority, it->max_exec_us);
                 break;
             case TASK_REG_TYPE_PERIODIC:
-                res = scheduler_register_periodic(sched, it->name, it->callback, it->user_data,
-                                                  it->priority, it->period_us, it->max_exec_us);
+                h = scheduler_register_periodic(sched, it->name, it->callback, it->user_data,
+                                                it->priority, it->period_us, it->max_exec_us);
+                break;
+            case TASK_REG_TYPE_EVENT_QUEUE:
+                h = scheduler_register_event_queue(sched, it->name, it->event_cb, it->user_data,
+                                                   it->priority, it->event_buf, it->event_depth,
+                                                   it->max_exec_us);
                 break;
             default:
                 break;
         }
-        if (res) ok++;
+        if (it->handle) {
+            *it->handle = h;
+        }
+        if (h != TASK_HANDLE_INVALID) ok++;
     }
     return ok;
 }
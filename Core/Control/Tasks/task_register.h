@@ -10,14 +10,21 @@
 #include <stdbool.h>
 #include "scheduler.h"
 
+// The registry stages scheduler_register_* calls, which need the descriptor pool.
+// Static-table builds (the firmware) declare their tasks in a manifest instead (task_manifest.h).
+#if SCHEDULER_DYNAMIC_TASKS == 0
+#error "task_register needs SCHEDULER_DYNAMIC_TASKS > 0; use a task manifest (task_manifest.h)"
+#endif
+
 #ifndef TASK_REGISTER_MAX
-#define TASK_REGISTER_MAX 16
+#define TASK_REGISTER_MAX SCHEDULER_MAX_TASKS
 #endif
 
 typedef enum {
     TASK_REG_TYPE_EVENT_FLAG,
     TASK_REG_TYPE_EVENT_CB,
     TASK_REG_TYPE_PERIODIC,
+    TASK_REG_TYPE_EVENT_QUEUE,
 } task_reg_type_t;
 
 typedef struct {
@@ -29,31 +36,51 @@ typedef struct {
     task_priority_t     priority;
     volatile bool      *event_flag;    // for EVENT_FLAG
     uint32_t            period_us;     // for PERIODIC
+    task_event_cb_t     event_cb;      // for EVENT_QUEUE
+    task_event_t       *event_buf;     // for EVENT_QUEUE
+    uint8_t             event_depth;   // for EVENT_QUEUE
     uint32_t            max_exec_us;
+    task_handle_t      *handle;        // optional, filled by task_register_apply
 } task_reg_item_t;
 
 void task_register_clear(void);
 
+// The optional handle pointer receives the scheduler handle once the item is applied
+// (TASK_HANDLE_INVALID until then, or if the scheduler rejects it). It must stay valid
+// until task_register_apply returns, so point it at a static/global.
+
 bool task_register_event_flag(const char *name,
                               task_cb_t callback,
                               void *user_data,
                               task_priority_t priority,
                               volatile bool *event_flag,
-                              uint32_t max_exec_us);
+                              uint32_t max_exec_us,
+                              task_handle_t *handle);
 
 bool task_register_event_cb(const char *name,
                             task_cb_t callback,
                             task_should_run_cb_t should_run,
                             void *user_data,
                             task_priority_t priority,
-                            uint32_t max_exec_us);
+                            uint32_t max_exec_us,
+                            task_handle_t *handle);
 
 bool task_register_periodic(const char *name,
                             task_cb_t callback,
                             void *user_data,
                             task_priority_t priority,
                             uint32_t period_us,
-                            uint32_t max_exec_us);
+                            uint32_t max_exec_us,
+                            task_handle_t *handle);
+
+bool task_register_event_queue(const char *name,
+                              task_event_cb_t callback,
+                              void *user_data,
+                              task_priority_t priority,
+                              task_event_t *buffer,
+                              uint8_t depth,
+                              uint32_t max_exec_us,
+                               task_handle_t *handle);
 
 // Apply staged tasks to scheduler after scheduler_init.
 int task_register_apply(task_scheduler_fc_t *sched);
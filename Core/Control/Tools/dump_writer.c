@@ -0,0 +1,51 @@
+#include "dump_writer.h"
+
+uint16_t crc16_ccitt_update(uint16_t crc, const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+void dump_writer_init(dump_writer_t *d, dump_write_cb write, void *user)
+{
+    d->write = write;
+    d->user = user;
+    d->crc = CRC16_CCITT_INIT;
+    d->bytes = 0;
+}
+
+void dump_writer_put(dump_writer_t *d, const uint8_t *data, uint16_t len)
+{
+    d->crc = crc16_ccitt_update(d->crc, data, len);
+    d->write(d->user, data, len);
+    d->bytes += len;
+}
+
+void dump_writer_u8(dump_writer_t *d, uint8_t v)
+{
+    dump_writer_put(d, &v, 1);
+}
+
+void dump_writer_u16(dump_writer_t *d, uint16_t v)
+{
+    const uint8_t b[2] = { (uint8_t)v, (uint8_t)(v >> 8) };
+    dump_writer_put(d, b, 2);
+}
+
+void dump_writer_u32(dump_writer_t *d, uint32_t v)
+{
+    const uint8_t b[4] = { (uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24) };
+    dump_writer_put(d, b, 4);
+}
+
+uint32_t dump_writer_finish(dump_writer_t *d)
+{
+    const uint16_t crc = d->crc;
+    dump_writer_u16(d, crc);
+    return d->bytes;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// CRC-16/CCITT-FALSE: poly 0x1021, init 0xFFFF, no reflection, no final xor.
+// Used by every binary export (scheduler histograms, latency trace) and by the gyro_cal flash record.
+#define CRC16_CCITT_INIT    0xFFFFU
+
+uint16_t crc16_ccitt_update(uint16_t crc, const uint8_t *data, size_t len);
+
+static inline uint16_t crc16_ccitt(const uint8_t *data, size_t len)
+{
+    return crc16_ccitt_update(CRC16_CCITT_INIT, data, len);
+}
+
+// Streaming little-endian binary writer: every byte goes to the sink and into a running CRC,
+// dump_writer_finish() appends that CRC (u16 LE) as the frame trailer.
+typedef void (*dump_write_cb)(void *user, const uint8_t *data, uint16_t len);
+
+typedef struct {
+    dump_write_cb write;
+    void         *user;
+    uint16_t      crc;
+    uint32_t      bytes;
+} dump_writer_t;
+
+void dump_writer_init(dump_writer_t *d, dump_write_cb write, void *user);
+void dump_writer_put(dump_writer_t *d, const uint8_t *data, uint16_t len);
+void dump_writer_u8(dump_writer_t *d, uint8_t v);
+void dump_writer_u16(dump_writer_t *d, uint16_t v);
+void dump_writer_u32(dump_writer_t *d, uint32_t v);
+// Appends the CRC of everything written so far; returns the total byte count including it
+uint32_t dump_writer_finish(dump_writer_t *d);
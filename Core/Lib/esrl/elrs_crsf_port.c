@@ -10,6 +10,9 @@ static elrs_crsf_t g_crsf;
 // RC 状态（由 ISR 回调更新）
 static volatile elrs_rc_state_t g_rc;
 
+// ELRS_CRSF_InitOnUART1 之后 UART1 归 CRSF 解析器；之前 UART1 仍是调试控制台
+static volatile bool g_crsf_bound = false;
+
 // 启用 DWT 周期计数器（CYCCNT）用于微秒时间戳
 static void dwt_setup_cycle_counter(void)
 {
@@ -120,12 +123,14 @@ static void crsf_on_link_stats(elrs_crsf_t *ctx, const elrs_crsf_link_stats_t *s
     // TODO: 记录 RSSI / LQ 等指标
 }
 
-// 串口字节回调：绑定到 UART1 -> 输入到 CRSF 解析器
+// 串口字节回调：绑定后 UART1 -> CRSF 解析器（字节不外泄）；其余字节转交控制台钩子
 void BSP_UART_RxByteCallback(uint8_t uart_id, uint8_t byte)
 {
-    if (uart_id == 1) {
+    if (uart_id == 1 && g_crsf_bound) {
         elrs_crsf_input_byte(&g_crsf, byte);
+        return;
     }
+    BSP_UART_ConsoleByteCallback(uart_id, byte);
 }
 
 void ELRS_CRSF_InitOnUART1(void)
@@ -143,6 +148,7 @@ void ELRS_CRSF_InitOnUART1(void)
     cfg.frame_timeout_us = 0;  // 使用缺省
 
     elrs_crsf_init(&g_crsf, &cfg);
+    g_crsf_bound = true;
 
     // 设置 UART1 波特率为 CRSF 推荐值，并确保使能接收中断
     BSP_UART_Open(1, ELRS_CRSF_BAUD_DEFAULT);
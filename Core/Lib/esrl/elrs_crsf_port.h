@@ -6,12 +6,14 @@
 #define ELRS_CRSF_PORT_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 // 初始化并将 elrs_crsf 绑定到 UART1（默认 420000 波特）
+// 绑定前 UART1 字节转交 BSP_UART_ConsoleByteCallback（调试控制台），绑定后全部进入 CRSF 解析器
 void ELRS_CRSF_InitOnUART1(void);
 
 // ========================= RC 映射与访问接口 =========================
@@ -2,6 +2,7 @@
 #include "icm42688p_lib.h"
 #include "bsp_pins.h"
 #include "attitude.h"
+#include "latency_trace.h"
 #include <stdlib.h>
 #include <limits.h>
 
@@ -52,19 +53,176 @@ void icm_spi_read_burst(uint8_t reg, uint8_t *buffer, uint16_t len)
 {
     reg |= 0x80;  // read command
 
-    // 使用稳定的轮询模式（不用DMA）
     ICM42688P_CS_LOW();
 
-    // 发送寄存器地址并接收数据
-    uint8_t tx_dummy = 0xFF;
+    // 地址 + 整段数据各一次轮询传输（不再逐字节调用 HAL）
+    // HAL_SPI_Receive 在双线主机模式下会把 buffer 本身作为 dummy 发出，传感器忽略读阶段的 MOSI
     HAL_SPI_Transmit(&hspi1, &reg, 1, 100);
+    HAL_SPI_Receive(&hspi1, buffer, len, 100);
 
-    // 接收数据（轮询模式）
-    for (uint16_t i = 0; i < len; i++) {
-        HAL_SPI_TransmitReceive(&hspi1, &tx_dummy, &buffer[i], 1, 100);
+    ICM42688P_CS_HIGH();
+}
+
+#ifdef ICM_USE_DMA
+// ============================================================================
+// DMA 突发读取：数据就绪 EXTI -> 15 字节 DMA 传输 -> 双缓冲帧
+// ============================================================================
+
+icm42688p_dma_t icm_dma;
+static volatile bool icm_dma_streaming = false;
+static volatile bool icm_dma_stopping = false;   // 停止中：EXTI 不再发起传输，完成/错误回调照常处理
+
+static bool icm_dma_start_xfer(const uint8_t *tx, uint8_t *rx, uint16_t len, void *user)
+{
+    (void)user;
+    return HAL_SPI_TransmitReceive_DMA(&hspi1, (uint8_t *)tx, rx, len) == HAL_OK;
+}
+
+static void icm_dma_chip_select(bool assert, void *user)
+{
+    (void)user;
+    if (assert) {
+        ICM42688P_CS_LOW();
+    } else {
+        ICM42688P_CS_HIGH();
     }
-    
-            ICM42688P_CS_HIGH();
+}
+
+/**
+ * @brief 开始 DMA 采样流（须在初始化/校准等轮询访问全部完成后调用）
+ * @note 流模式期间 SPI1 由 EXTI/DMA 独占，icm42688p_get_all_data/icm42688p_update
+ *       改为从最新 DMA 帧取数，不再发起轮询传输
+ */
+void icm42688p_dma_start_stream(void)
+{
+    const icm42688p_dma_ops_t ops = {
+        .start_xfer  = icm_dma_start_xfer,
+        .chip_select = icm_dma_chip_select,
+        .user        = NULL,
+    };
+    icm42688p_dma_init(&icm_dma, &ops);
+    icm42688p_data_ready = 0;
+    icm_dma_stopping = false;
+    icm_dma_streaming = true;
+}
+
+/**
+ * @brief 停止 DMA 采样流（等待在途传输结束后返回，之后可恢复轮询访问）
+ * @note 先只停止发起新传输，icm_dma_streaming 保持到在途传输由完成/错误回调收尾（释放片选）之后；
+ *       回调始终未到时中止 SPI 传输并按错误收尾
+ */
+void icm42688p_dma_stop_stream(void)
+{
+    if (!icm_dma_streaming) {
+        return;
+    }
+
+    icm_dma_stopping = true;
+    uint32_t timeout = 10000;
+    while (icm42688p_dma_state(&icm_dma) == ICM42688P_DMA_BUSY && timeout--) {
+    }
+    if (icm42688p_dma_state(&icm_dma) == ICM42688P_DMA_BUSY) {
+        HAL_SPI_Abort(&hspi1);
+        icm42688p_dma_on_error(&icm_dma);   // 释放片选，丢弃半帧
+        printf("[icm_dma] stop: transfer did not complete, aborted\r\n");
+    }
+
+    icm_dma_streaming = false;
+    icm_dma_stopping = false;
+}
+
+bool icm42688p_dma_is_streaming(void)
+{
+    return icm_dma_streaming;
+}
+
+// 从最新 DMA 帧解码（原地解码，不复制缓冲区）
+static bool icm_dma_read_latest(int16_t *gyro_x, int16_t *gyro_y, int16_t *gyro_z,
+                                int16_t *accel_x, int16_t *accel_y, int16_t *accel_z,
+                                float *temp_celsius)
+{
+    icm42688p_dma_frame_t f;
+    if (!icm42688p_dma_acquire(&icm_dma, &f)) {
+        return false;
+    }
+    int16_t gx, gy, gz, ax, ay, az;
+    icm42688p_dma_frame_gyro(&f, &gx, &gy, &gz);
+    icm42688p_dma_frame_accel(&f, &ax, &ay, &az);
+    if (gyro_x)  *gyro_x  = gx;
+    if (gyro_y)  *gyro_y  = gy;
+    if (gyro_z)  *gyro_z  = gz;
+    if (accel_x) *accel_x = ax;
+    if (accel_y) *accel_y = ay;
+    if (accel_z) *accel_z = az;
+    if (temp_celsius) *temp_celsius = icm42688p_dma_frame_temp(&f);
+    icm42688p_dma_release(&icm_dma);
+    return true;
+}
+#endif // ICM_USE_DMA
+
+// ============================================================================
+// 硬件 FIFO 批量模式：水位中断 -> 一次突发读出全部完整数据包（带传感器时间戳）
+// ============================================================================
+
+static icm42688p_fifo_state_t icm_fifo_state;
+static uint8_t icm_fifo_buf[ICM42688P_FIFO_SIZE] __attribute__((aligned(4)));
+static volatile bool icm_fifo_active = false;
+volatile uint8_t icm42688p_fifo_ready = 0;
+
+/**
+ * @brief 启动 FIFO 批量模式
+ * @param watermark 每次水位中断的样本数（8kHz ODR 下 8 = 1kHz 中断）
+ * @param hires true 使用 20 位 packet 4
+ * @note 与 DMA 流模式互斥；FIFO 模式下 INT1 只输出水位中断
+ */
+bool icm42688p_fifo_start(uint16_t watermark, bool hires)
+{
+#ifdef ICM_USE_DMA
+    if (icm42688p_dma_is_streaming()) {
+        printf("[icm_fifo] stop DMA stream first\r\n");
+        return false;
+    }
+#endif
+    const icm42688p_fifo_config_t cfg = {
+        .watermark    = watermark,
+        .hires        = hires,
+        .stop_on_full = false,
+    };
+    if (!icm42688p_fifo_init(&icm, &cfg, &icm_fifo_state)) {
+        printf("[icm_fifo] invalid watermark %u\r\n", watermark);
+        return false;
+    }
+    icm42688p_fifo_ready = 0;
+    icm_fifo_active = true;
+    return true;
+}
+
+/**
+ * @brief 关闭 FIFO 批量模式，恢复数据就绪中断
+ */
+void icm42688p_fifo_stop(void)
+{
+    icm_fifo_active = false;
+    icm42688p_fifo_disable(&icm);
+}
+
+bool icm42688p_fifo_is_active(void)
+{
+    return icm_fifo_active;
+}
+
+/**
+ * @brief 读出 FIFO 中所有完整样本（时间戳已展开为 32 位微秒）
+ * @return 样本数
+ */
+uint16_t icm42688p_fifo_drain(icm42688p_fifo_sample_t *out, uint16_t max_samples)
+{
+    if (!icm_fifo_active) {
+        return 0;
+    }
+    icm42688p_fifo_ready = 0;
+    return icm42688p_fifo_read(&icm, &icm_fifo_state, icm_fifo_buf, sizeof(icm_fifo_buf),
+                               out, max_samples);
 }
 
 void icm_delay_ms(uint32_t ms)
@@ -166,6 +324,12 @@ bool icm42688p_get_all_data(int16_t *gyro_x, int16_t *gyro_y, int16_t *gyro_z,
                             int16_t *accel_x, int16_t *accel_y, int16_t *accel_z,
                             float *temp_celsius)
 {
+#ifdef ICM_USE_DMA
+    if (icm_dma_streaming) {
+        return icm_dma_read_latest(gyro_x, gyro_y, gyro_z, accel_x, accel_y, accel_z, temp_celsius);
+    }
+#endif
+
     icm42688p_gyro_data_t  gd;
     icm42688p_accel_data_t ad;
     icm42688p_temp_data_t  td;
@@ -188,10 +352,29 @@ bool icm42688p_get_all_data(int16_t *gyro_x, int16_t *gyro_y, int16_t *gyro_z,
 void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
 {
     if (GPIO_Pin == ICM42688P_INT_PIN) {
+        const uint32_t t = DWT->CYCCNT;   // 采样时刻：延迟追踪记录与回调使用同一个时间戳
         icm42688p_data_ready = 1;
+        if (icm_fifo_active) {
+            icm42688p_fifo_ready = 1;
+            latency_trace_begin(t);       // FIFO 由任务读出，读完后按 t 找回记录打 SPI_DONE
+        }
+#ifdef ICM_USE_DMA
+        if (icm_dma_streaming && !icm_dma_stopping) {
+            // 只有真正启动了传输才开新记录，与 SPI 完成中断一一对应
+            if (icm42688p_dma_on_data_ready(&icm_dma, t)) {
+                latency_trace_begin(t);
+            }
+        }
+#endif
+        icm42688p_on_data_ready_isr(t);
     }
 }
 
+__attribute__((weak)) void icm42688p_on_data_ready_isr(uint32_t timestamp)
+{
+    (void)timestamp;
+}
+
 // Update using data-ready flag
 bool icm42688p_update(int16_t *gyro_x, int16_t *gyro_y, int16_t *gyro_z,
                       int16_t *accel_x, int16_t *accel_y, int16_t *accel_z,
@@ -334,6 +517,18 @@ void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef *hspi)
     }
 }
 
+#ifdef ICM_USE_DMA
+// SPI1 全双工 DMA 完成回调（HAL_SPI_TransmitReceive_DMA）
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    if (hspi->Instance == SPI1 && icm_dma_streaming)
+    {
+        icm42688p_dma_on_complete(&icm_dma);
+        latency_trace_mark(latency_trace_current(), LATENCY_TRACE_SPI_DONE);
+    }
+}
+#endif
+
 // DMA错误回调（可选，用于调试）
 void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
 {
@@ -342,5 +537,10 @@ void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
         ICM42688P_CS_HIGH();
         hspi->State = HAL_SPI_STATE_READY;
         spi1_dma_flag = 1;
+#ifdef ICM_USE_DMA
+        if (icm_dma_streaming) {
+            icm42688p_dma_on_error(&icm_dma);
+        }
+#endif
     }
 }
@@ -1,5 +1,6 @@
 #include "bsp_spi.h"
 #include "icm42688p_lib.h"
+#include "icm42688p_dma.h"
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdint.h>
@@ -45,6 +46,26 @@ bool icm42688p_dataPreprocess(int16_t *gyro_x, int16_t *gyro_y, int16_t *gyro_z,
                       float *accel_x_norm,float *accel_y_norm,float *accel_z_norm,
                       float *temp_celsius);
 
+#ifdef ICM_USE_DMA
+// DMA 突发读取（数据就绪 EXTI 触发，双缓冲帧，见 icm42688p_dma.h）
+extern icm42688p_dma_t icm_dma;
+void icm42688p_dma_start_stream(void);
+void icm42688p_dma_stop_stream(void);
+bool icm42688p_dma_is_streaming(void);
+#endif
+
+// 硬件 FIFO 批量模式（水位中断 + 一次突发读出，见 icm42688p_lib.h）
+bool icm42688p_fifo_start(uint16_t watermark, bool hires);
+void icm42688p_fifo_stop(void);
+bool icm42688p_fifo_is_active(void);
+uint16_t icm42688p_fifo_drain(icm42688p_fifo_sample_t *out, uint16_t max_samples);
+extern volatile uint8_t icm42688p_fifo_ready;
+
+// 数据就绪中断钩子：在 EXTI 中断末尾调用（弱定义为空）。EXTI 与 SPI DMA 同为优先级 1，
+// 不要在这里直接运行 scheduler_rt_isr；应置位任务标志后 BSP_RT_Lane_Pend()，
+// 实时通道在更低一级的 PendSV 中派发（见 bsp_IO.h、test_flight_loop.c）
+void icm42688p_on_data_ready_isr(uint32_t timestamp);
+
 // 数据就绪标志位（外部可访问，中断中设置）
 extern volatile uint8_t icm42688p_data_ready;
 extern volatile uint8_t spi1_dma_flag;
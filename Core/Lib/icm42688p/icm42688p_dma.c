@@ -0,0 +1,192 @@
+/**
+ * @file    icm42688p_dma.c
+ * @brief   ICM42688P DMA burst-read state machine with double-buffered frames
+ * @date    2025
+ */
+
+#include "icm42688p_dma.h"
+#include <string.h>
+
+// Compiler barrier: keep the held/ready handshake in program order
+#define ICM_DMA_BARRIER()   __asm__ volatile("" ::: "memory")
+
+static void icm_dma_cs(icm42688p_dma_t *ctx, bool assert)
+{
+    if (ctx->ops.chip_select) {
+        ctx->ops.chip_select(assert, ctx->ops.user);
+    }
+}
+
+/**
+ * @brief Initialise the state machine and pre-build the TX command
+ */
+void icm42688p_dma_init(icm42688p_dma_t *ctx, const icm42688p_dma_ops_t *ops)
+{
+    if (!ctx) {
+        return;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    if (ops) {
+        ctx->ops = *ops;
+    }
+
+    // Address with read bit, then dummy bytes to clock the data out
+    memset(ctx->tx, 0xFF, sizeof(ctx->tx));
+    ctx->tx[0] = ICM42688P_DMA_FIRST_REG | ICM42688P_SPI_READ_BIT;
+
+    ctx->state     = ICM42688P_DMA_IDLE;
+    ctx->ready_idx = -1;
+    ctx->held_idx  = -1;
+}
+
+/**
+ * @brief Data-ready EXTI: start a burst if idle
+ */
+bool icm42688p_dma_on_data_ready(icm42688p_dma_t *ctx, uint32_t timestamp)
+{
+    if (!ctx || !ctx->ops.start_xfer) {
+        return false;
+    }
+
+    if (ctx->state == ICM42688P_DMA_BUSY) {
+        ctx->stats.overruns++;
+        return false;
+    }
+
+    // Never target the buffer the consumer holds; otherwise keep the newest frame readable
+    const int8_t held  = ctx->held_idx;
+    const int8_t ready = ctx->ready_idx;
+    uint8_t target;
+    if (held >= 0) {
+        target = (uint8_t)(held ^ 1);
+    } else if (ready >= 0) {
+        target = (uint8_t)(ready ^ 1);
+    } else {
+        target = 0;
+    }
+
+    // Overwriting the published (unread) frame: withdraw it first
+    if (ready == (int8_t)target) {
+        ctx->ready_idx = -1;
+        if (ctx->rx_seq[target] != ctx->consumed_seq) {
+            ctx->stats.dropped++;
+        }
+    }
+
+    ctx->write_idx = target;
+    ctx->pending_timestamp = timestamp;
+    ctx->state = ICM42688P_DMA_BUSY;
+    ICM_DMA_BARRIER();
+
+    icm_dma_cs(ctx, true);
+    if (!ctx->ops.start_xfer(ctx->tx, ctx->rx[target], ICM42688P_DMA_XFER_LEN, ctx->ops.user)) {
+        icm_dma_cs(ctx, false);
+        ctx->state = ICM42688P_DMA_ERROR;
+        ctx->stats.errors++;
+        return false;
+    }
+
+    ctx->stats.started++;
+    return true;
+}
+
+/**
+ * @brief Transfer complete: release CS and publish the frame
+ */
+void icm42688p_dma_on_complete(icm42688p_dma_t *ctx)
+{
+    if (!ctx) {
+        return;
+    }
+    if (ctx->state != ICM42688P_DMA_BUSY) {
+        ctx->stats.spurious++;
+        return;
+    }
+
+    icm_dma_cs(ctx, false);
+
+    const uint8_t idx = ctx->write_idx;
+    const int8_t prev = ctx->ready_idx;
+    if (prev >= 0 && ctx->rx_seq[prev] != ctx->consumed_seq) {
+        ctx->stats.dropped++;
+    }
+
+    ctx->seq++;
+    ctx->rx_seq[idx] = ctx->seq;
+    ctx->rx_timestamp[idx] = ctx->pending_timestamp;
+    ICM_DMA_BARRIER();
+    ctx->ready_idx = (int8_t)idx;
+    ctx->state = ICM42688P_DMA_IDLE;
+    ctx->stats.completed++;
+}
+
+/**
+ * @brief Transfer error: release CS and drop the partial frame
+ */
+void icm42688p_dma_on_error(icm42688p_dma_t *ctx)
+{
+    if (!ctx) {
+        return;
+    }
+    if (ctx->state != ICM42688P_DMA_BUSY) {
+        ctx->stats.spurious++;
+        return;
+    }
+
+    icm_dma_cs(ctx, false);
+    ctx->state = ICM42688P_DMA_ERROR;
+    ctx->stats.errors++;
+}
+
+/**
+ * @brief Take the newest unread frame without copying
+ */
+bool icm42688p_dma_acquire(icm42688p_dma_t *ctx, icm42688p_dma_frame_t *frame)
+{
+    if (!ctx || !frame) {
+        return false;
+    }
+
+    icm42688p_dma_release(ctx);
+
+    // Lock-free handshake with the ISR: claim the ready buffer, then confirm
+    // it was neither withdrawn nor targeted by a transfer in the meantime.
+    int8_t idx;
+    for (;;) {
+        idx = ctx->ready_idx;
+        if (idx < 0) {
+            return false;
+        }
+        ctx->held_idx = idx;
+        ICM_DMA_BARRIER();
+        if (ctx->ready_idx == idx &&
+            !(ctx->state == ICM42688P_DMA_BUSY && ctx->write_idx == (uint8_t)idx)) {
+            break;
+        }
+        ctx->held_idx = -1;
+    }
+
+    if (ctx->rx_seq[idx] == ctx->consumed_seq) {
+        ctx->held_idx = -1;   // already consumed
+        return false;
+    }
+
+    ctx->consumed_seq = ctx->rx_seq[idx];
+    frame->raw       = ctx->rx[idx];
+    frame->seq       = ctx->rx_seq[idx];
+    frame->timestamp = ctx->rx_timestamp[idx];
+    return true;
+}
+
+/**
+ * @brief Return the held frame buffer to the DMA pool
+ */
+void icm42688p_dma_release(icm42688p_dma_t *ctx)
+{
+    if (!ctx) {
+        return;
+    }
+    ICM_DMA_BARRIER();
+    ctx->held_idx = -1;
+}
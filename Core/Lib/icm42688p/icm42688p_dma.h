@@ -0,0 +1,174 @@
+/**
+ * @file    icm42688p_dma.h
+ * @brief   ICM42688P DMA burst-read state machine with double-buffered frames
+ * @date    2025
+ *
+ * One data-ready EXTI kicks a single 15-byte SPI DMA transfer
+ * (address + TEMP_DATA1..GYRO_DATA_Z0). The transfer lands in one of two
+ * frame buffers; when it completes the buffer is published and the consumer
+ * decodes it in place (no memcpy). The buffer the consumer currently holds
+ * is never chosen as a DMA target.
+ *
+ * State machine (all transitions are ISR-safe, no HAL dependency):
+ *
+ *   IDLE  --on_data_ready--> BUSY        (CS low, start_xfer ok)
+ *   IDLE  --on_data_ready--> ERROR       (start_xfer refused)
+ *   BUSY  --on_complete----> IDLE        (CS high, frame published)
+ *   BUSY  --on_error-------> ERROR       (CS high, frame dropped)
+ *   BUSY  --on_data_ready--> BUSY        (overrun counted, EXTI ignored)
+ *   ERROR --on_data_ready--> BUSY/ERROR  (automatic retry)
+ *
+ * Hardware access goes through the ops table so the same code runs on the
+ * target (HAL_SPI_TransmitReceive_DMA) and in host tests.
+ */
+
+#ifndef ICM42688P_DMA_H
+#define ICM42688P_DMA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "icm42688p_lib.h"
+
+// Burst: TEMP_DATA1(0x1D) .. GYRO_DATA_Z0(0x2A)
+#define ICM42688P_DMA_FIRST_REG     ICM42688P_REG_TEMP_DATA1
+#define ICM42688P_DMA_DATA_LEN      14U
+#define ICM42688P_DMA_XFER_LEN      (1U + ICM42688P_DMA_DATA_LEN)   // address byte + data
+
+// Offsets inside a received frame (byte 0 is clocked in while the address is sent)
+#define ICM42688P_DMA_OFS_TEMP      1U
+#define ICM42688P_DMA_OFS_ACCEL     3U
+#define ICM42688P_DMA_OFS_GYRO      9U
+
+typedef enum {
+    ICM42688P_DMA_IDLE = 0,
+    ICM42688P_DMA_BUSY,
+    ICM42688P_DMA_ERROR,
+} icm42688p_dma_state_t;
+
+/**
+ * @brief Hardware hooks
+ */
+typedef struct {
+    // Start a full-duplex transfer of len bytes; return false if the peripheral refused
+    bool (*start_xfer)(const uint8_t *tx, uint8_t *rx, uint16_t len, void *user);
+    // Drive chip select (true = asserted / low)
+    void (*chip_select)(bool assert, void *user);
+    void *user;
+} icm42688p_dma_ops_t;
+
+/**
+ * @brief A published frame (points into the DMA buffer, valid until released)
+ */
+typedef struct {
+    const uint8_t *raw;         // ICM42688P_DMA_XFER_LEN bytes, raw[0] is the address slot
+    uint32_t seq;               // completed-frame sequence number
+    uint32_t timestamp;         // timestamp passed to on_data_ready (e.g. DWT cycles)
+} icm42688p_dma_frame_t;
+
+/**
+ * @brief Transfer statistics
+ */
+typedef struct {
+    uint32_t started;           // transfers started
+    uint32_t completed;         // frames published
+    uint32_t errors;            // start refusals + DMA/SPI errors
+    uint32_t overruns;          // data-ready while a transfer was still in flight
+    uint32_t spurious;          // completion/error without a transfer in flight
+    uint32_t dropped;           // published frames overwritten before being consumed
+} icm42688p_dma_stats_t;
+
+typedef struct {
+    icm42688p_dma_ops_t ops;
+
+    // Word aligned for the DMA engine
+    uint8_t tx[ICM42688P_DMA_XFER_LEN + 1U] __attribute__((aligned(4)));
+    uint8_t rx[2][ICM42688P_DMA_XFER_LEN + 1U] __attribute__((aligned(4)));
+    uint32_t rx_timestamp[2];
+    uint32_t rx_seq[2];
+
+    volatile uint8_t state;         // icm42688p_dma_state_t
+    volatile uint8_t write_idx;     // buffer targeted by the in-flight transfer
+    volatile int8_t  ready_idx;     // newest published buffer, -1 = none
+    volatile int8_t  held_idx;      // buffer held by the consumer, -1 = none
+    volatile uint32_t seq;          // published frame counter
+    uint32_t consumed_seq;          // last seq handed to the consumer
+    uint32_t pending_timestamp;     // timestamp of the in-flight transfer
+
+    icm42688p_dma_stats_t stats;
+} icm42688p_dma_t;
+
+/**
+ * @brief Initialise the state machine and pre-build the TX command
+ */
+void icm42688p_dma_init(icm42688p_dma_t *ctx, const icm42688p_dma_ops_t *ops);
+
+/**
+ * @brief Data-ready EXTI: start a burst if idle (call from the EXTI ISR)
+ * @param timestamp sample timestamp stored with the frame
+ * @return true if a transfer was started
+ */
+bool icm42688p_dma_on_data_ready(icm42688p_dma_t *ctx, uint32_t timestamp);
+
+/**
+ * @brief Transfer complete (call from the SPI/DMA complete ISR)
+ */
+void icm42688p_dma_on_complete(icm42688p_dma_t *ctx);
+
+/**
+ * @brief Transfer error (call from the SPI/DMA error ISR)
+ */
+void icm42688p_dma_on_error(icm42688p_dma_t *ctx);
+
+/**
+ * @brief Take the newest unread frame without copying
+ * @return true if a new frame is available; it stays valid until icm42688p_dma_release()
+ * @note Releases any frame still held by the caller.
+ */
+bool icm42688p_dma_acquire(icm42688p_dma_t *ctx, icm42688p_dma_frame_t *frame);
+
+/**
+ * @brief Return the held frame buffer to the DMA pool
+ */
+void icm42688p_dma_release(icm42688p_dma_t *ctx);
+
+static inline icm42688p_dma_state_t icm42688p_dma_state(const icm42688p_dma_t *ctx)
+{
+    return (icm42688p_dma_state_t)ctx->state;
+}
+
+// Big-endian field decoders working directly on the DMA buffer
+static inline int16_t icm42688p_dma_be16(const uint8_t *p)
+{
+    return (int16_t)(((uint16_t)p[0] << 8) | p[1]);
+}
+
+static inline void icm42688p_dma_frame_gyro(const icm42688p_dma_frame_t *f, int16_t *x, int16_t *y, int16_t *z)
+{
+    const uint8_t *p = &f->raw[ICM42688P_DMA_OFS_GYRO];
+    *x = icm42688p_dma_be16(&p[0]);
+    *y = icm42688p_dma_be16(&p[2]);
+    *z = icm42688p_dma_be16(&p[4]);
+}
+
+static inline void icm42688p_dma_frame_accel(const icm42688p_dma_frame_t *f, int16_t *x, int16_t *y, int16_t *z)
+{
+    const uint8_t *p = &f->raw[ICM42688P_DMA_OFS_ACCEL];
+    *x = icm42688p_dma_be16(&p[0]);
+    *y = icm42688p_dma_be16(&p[2]);
+    *z = icm42688p_dma_be16(&p[4]);
+}
+
+static inline float icm42688p_dma_frame_temp(const icm42688p_dma_frame_t *f)
+{
+    return ((float)icm42688p_dma_be16(&f->raw[ICM42688P_DMA_OFS_TEMP]) / 132.48f) + 25.0f;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ICM42688P_DMA_H
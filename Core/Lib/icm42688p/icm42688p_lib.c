@@ -478,3 +478,248 @@ float icm42688p_get_accel_scale(uint8_t fsr)
         default: return 2048.0f;
     }
 }
+
+/* ============================================================================
+ * FIFO
+ * ============================================================================ */
+
+static inline int16_t icm42688p_fifo_be16(const uint8_t *p)
+{
+    return (int16_t)(((uint16_t)p[0] << 8) | p[1]);
+}
+
+/**
+ * @brief Packet size implied by a FIFO header, 0 if the header is invalid
+ */
+static uint8_t icm42688p_fifo_packet_size(uint8_t header)
+{
+    if (header & ICM42688P_FIFO_HEADER_MSG) {
+        return 0;
+    }
+    if (header & ICM42688P_FIFO_HEADER_20) {
+        return ICM42688P_FIFO_PACKET4_SIZE;
+    }
+    const bool accel = (header & ICM42688P_FIFO_HEADER_ACCEL) != 0;
+    const bool gyro  = (header & ICM42688P_FIFO_HEADER_GYRO) != 0;
+    if (accel && gyro) {
+        return ICM42688P_FIFO_PACKET3_SIZE;
+    }
+    if (accel || gyro) {
+        return ICM42688P_FIFO_PACKET1_SIZE;
+    }
+    return 0;
+}
+
+/**
+ * @brief Configure and start the FIFO
+ */
+bool icm42688p_fifo_init(icm42688p_dev_t *dev, const icm42688p_fifo_config_t *cfg,
+                         icm42688p_fifo_state_t *state)
+{
+    if (!dev || !cfg || !state || !dev->spi_write_reg) {
+        return false;
+    }
+
+    const uint8_t packet_size = cfg->hires ? ICM42688P_FIFO_PACKET4_SIZE : ICM42688P_FIFO_PACKET3_SIZE;
+    const uint32_t wm_bytes = (uint32_t)cfg->watermark * packet_size;
+    if (cfg->watermark == 0 || wm_bytes > ICM42688P_FIFO_SIZE - packet_size) {
+        return false;
+    }
+
+    memset(state, 0, sizeof(*state));
+    state->packet_size = packet_size;
+    state->tmst_res_us = 1;
+
+    icm42688p_set_bank(dev, ICM42688P_BANK_SEL_0);
+    dev->spi_write_reg(ICM42688P_REG_FIFO_CONFIG, ICM42688P_FIFO_MODE_BYPASS);
+
+    // ODR timestamp at 1us resolution, absolute (not delta) so packets can be unwrapped independently
+    dev->spi_write_reg(ICM42688P_REG_TMST_CONFIG, ICM42688P_TMST_TO_REGS_EN | ICM42688P_TMST_EN);
+
+    // Byte count, big endian (INTF_CONFIG0 reset value)
+    dev->spi_write_reg(ICM42688P_REG_INTF_CONFIG0, 0x30);
+
+    uint8_t cfg1 = ICM42688P_FIFO_ACCEL_EN | ICM42688P_FIFO_GYRO_EN | ICM42688P_FIFO_TEMP_EN |
+                   ICM42688P_FIFO_WM_GT_TH;
+    if (cfg->hires) {
+        cfg1 |= ICM42688P_FIFO_HIRES_EN;
+    }
+    dev->spi_write_reg(ICM42688P_REG_FIFO_CONFIG1, cfg1);
+
+    dev->spi_write_reg(ICM42688P_REG_FIFO_CONFIG2, (uint8_t)(wm_bytes & 0xFF));
+    dev->spi_write_reg(ICM42688P_REG_FIFO_CONFIG3, (uint8_t)((wm_bytes >> 8) & 0x0F));
+
+    // Watermark replaces data ready on INT1
+    dev->spi_write_reg(ICM42688P_REG_INT_SOURCE0, ICM42688P_FIFO_THS_INT1_ENABLE);
+
+    dev->spi_write_reg(ICM42688P_REG_FIFO_CONFIG,
+                       cfg->stop_on_full ? ICM42688P_FIFO_MODE_STOP_FULL : ICM42688P_FIFO_MODE_STREAM);
+    icm42688p_fifo_flush(dev);
+
+    // Hi-res data ignores FSR: parsed samples are rescaled to ±2000dps / ±16g
+    if (cfg->hires) {
+        dev->gyro_scale  = icm42688p_get_gyro_scale(0);
+        dev->accel_scale = icm42688p_get_accel_scale(0);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Stop the FIFO and restore the data-ready interrupt
+ */
+void icm42688p_fifo_disable(icm42688p_dev_t *dev)
+{
+    icm42688p_set_bank(dev, ICM42688P_BANK_SEL_0);
+    dev->spi_write_reg(ICM42688P_REG_FIFO_CONFIG, ICM42688P_FIFO_MODE_BYPASS);
+    dev->spi_write_reg(ICM42688P_REG_FIFO_CONFIG1, 0);
+    icm42688p_fifo_flush(dev);
+    icm42688p_enable_data_ready_interrupt(dev, true);
+    dev->gyro_scale  = icm42688p_get_gyro_scale(dev->config.gyro_fsr);
+    dev->accel_scale = icm42688p_get_accel_scale(dev->config.accel_fsr);
+}
+
+/**
+ * @brief Flush the FIFO
+ */
+void icm42688p_fifo_flush(icm42688p_dev_t *dev)
+{
+    dev->spi_write_reg(ICM42688P_REG_SIGNAL_PATH_RESET, ICM42688P_FIFO_FLUSH);
+}
+
+/**
+ * @brief Read the FIFO byte count
+ */
+uint16_t icm42688p_fifo_get_count(icm42688p_dev_t *dev)
+{
+    uint8_t buf[2];
+    dev->spi_read_burst(ICM42688P_REG_FIFO_COUNTH, buf, 2);
+    return (uint16_t)icm42688p_fifo_be16(buf);
+}
+
+/**
+ * @brief Parse a FIFO byte stream
+ */
+uint16_t icm42688p_fifo_parse(icm42688p_fifo_state_t *state, const uint8_t *buf, uint16_t len,
+                              icm42688p_fifo_sample_t *out, uint16_t max_samples, uint16_t *consumed)
+{
+    uint16_t pos = 0;
+    uint16_t n = 0;
+
+    if (state && buf && out) {
+        while (n < max_samples && pos < len) {
+            const uint8_t header = buf[pos];
+            const uint8_t size = icm42688p_fifo_packet_size(header);
+            if (size == 0) {
+                // Empty FIFO marker or garbage: nothing valid follows in this read
+                state->invalid++;
+                pos = len;
+                break;
+            }
+            if ((uint16_t)(len - pos) < size) {
+                break;   // partial trailing packet
+            }
+
+            const uint8_t *p = &buf[pos];
+            icm42688p_fifo_sample_t *s = &out[n];
+            memset(s, 0, sizeof(*s));
+            s->header = header;
+
+            const bool hires = (header & ICM42688P_FIFO_HEADER_20) != 0;
+            const bool has_accel = (header & ICM42688P_FIFO_HEADER_ACCEL) != 0;
+            const bool has_gyro  = (header & ICM42688P_FIFO_HEADER_GYRO) != 0;
+
+            bool accel_invalid, gyro_invalid;
+
+            if (size == ICM42688P_FIFO_PACKET1_SIZE) {
+                // Packet 1/2: header, 6 data bytes, temp8
+                for (int i = 0; i < 3; i++) {
+                    const int16_t v = icm42688p_fifo_be16(&p[1 + 2 * i]);
+                    if (has_accel) s->accel[i] = v; else s->gyro[i] = v;
+                }
+                s->temp_c = (float)(int8_t)p[7] / 2.07f + 25.0f;
+                accel_invalid = s->accel[0] == ICM42688P_FIFO_INVALID_SAMPLE;
+                gyro_invalid  = s->gyro[0] == ICM42688P_FIFO_INVALID_SAMPLE;
+            } else {
+                for (int i = 0; i < 3; i++) {
+                    s->accel[i] = icm42688p_fifo_be16(&p[1 + 2 * i]);
+                    s->gyro[i]  = icm42688p_fifo_be16(&p[7 + 2 * i]);
+                }
+                accel_invalid = s->accel[0] == ICM42688P_FIFO_INVALID_SAMPLE;
+                gyro_invalid  = s->gyro[0] == ICM42688P_FIFO_INVALID_SAMPLE;
+
+                uint16_t ts_raw;
+                if (hires) {
+                    s->temp_c = (float)icm42688p_fifo_be16(&p[13]) / 132.48f + 25.0f;
+                    ts_raw = (uint16_t)icm42688p_fifo_be16(&p[15]);
+                    // 20-bit: 16 MSBs from the data fields, 4 LSBs from the extension bytes
+                    for (int i = 0; i < 3; i++) {
+                        const uint8_t ext = p[17 + i];
+                        s->accel_hr[i] = (int32_t)s->accel[i] * 16 + (ext >> 4);
+                        s->gyro_hr[i]  = (int32_t)s->gyro[i] * 16 + (ext & 0x0F);
+                        // 8192 LSB/g -> 2048, 131 LSB/dps -> 16.4 (arithmetic shift, floor)
+                        s->accel[i] = (int16_t)(s->accel_hr[i] >> 2);
+                        s->gyro[i]  = (int16_t)(s->gyro_hr[i] >> 3);
+                    }
+                } else {
+                    s->temp_c = (float)(int8_t)p[13] / 2.07f + 25.0f;
+                    ts_raw = (uint16_t)icm42688p_fifo_be16(&p[14]);
+                }
+
+                if ((header & ICM42688P_FIFO_HEADER_TMST_MASK) == ICM42688P_FIFO_HEADER_TMST_ODR) {
+                    const uint32_t res = state->tmst_res_us ? state->tmst_res_us : 1U;
+                    if (state->have_last) {
+                        state->timestamp_us += (uint32_t)(uint16_t)(ts_raw - state->last_raw) * res;
+                    } else {
+                        state->timestamp_us = (uint32_t)ts_raw * res;
+                        state->have_last = true;
+                    }
+                    state->last_raw = ts_raw;
+                    s->timestamp_us = state->timestamp_us;
+                    s->timestamp_valid = true;
+                }
+            }
+
+            // -32768 marks a sensor that is off or has no new sample for this packet
+            s->accel_valid = has_accel && !accel_invalid;
+            s->gyro_valid  = has_gyro && !gyro_invalid;
+
+            state->packets++;
+            pos = (uint16_t)(pos + size);
+            n++;
+        }
+    }
+
+    if (consumed) {
+        *consumed = pos;
+    }
+    return n;
+}
+
+/**
+ * @brief Drain all complete packets in one burst and parse them
+ */
+uint16_t icm42688p_fifo_read(icm42688p_dev_t *dev, icm42688p_fifo_state_t *state,
+                             uint8_t *buf, uint16_t buf_len,
+                             icm42688p_fifo_sample_t *out, uint16_t max_samples)
+{
+    if (!dev || !state || !buf || !out || !dev->spi_read_burst || state->packet_size == 0) {
+        return 0;
+    }
+
+    uint16_t packets = (uint16_t)(icm42688p_fifo_get_count(dev) / state->packet_size);
+    if (packets > buf_len / state->packet_size) {
+        packets = (uint16_t)(buf_len / state->packet_size);
+    }
+    if (packets > max_samples) {
+        packets = max_samples;
+    }
+    if (packets == 0) {
+        return 0;
+    }
+
+    // Whole packets only: a partial read would require FIFO_RESUME_PARTIAL_RD
+    const uint16_t bytes = (uint16_t)(packets * state->packet_size);
+    dev->spi_read_burst(ICM42688P_REG_FIFO_DATA, buf, bytes);
+    return icm42688p_fifo_parse(state, buf, bytes, out, max_samples, NULL);
+}
@@ -43,6 +43,7 @@ extern "C" {
 
 #define ICM42688P_REG_DEVICE_CONFIG     0x11        // Device configuration
 #define ICM42688P_REG_INT_CONFIG        0x14        // Interrupt configuration
+#define ICM42688P_REG_FIFO_CONFIG       0x16        // FIFO mode
 #define ICM42688P_REG_ACCEL_DATA_X1     0x1F        // Accel X-axis data [15:8]
 #define ICM42688P_REG_ACCEL_DATA_X0     0x20        // Accel X-axis data [7:0]
 #define ICM42688P_REG_ACCEL_DATA_Y1     0x21        // Accel Y-axis data [15:8]
@@ -57,11 +58,21 @@ extern "C" {
 #define ICM42688P_REG_GYRO_DATA_Z0      0x2A        // Gyro Z-axis data [7:0]
 #define ICM42688P_REG_TEMP_DATA1        0x1D        // Temperature data [15:8]
 #define ICM42688P_REG_TEMP_DATA0        0x1E        // Temperature data [7:0]
+#define ICM42688P_REG_INT_STATUS        0x2D        // Interrupt status (FIFO THS/FULL)
+#define ICM42688P_REG_FIFO_COUNTH       0x2E        // FIFO byte count [15:8]
+#define ICM42688P_REG_FIFO_COUNTL       0x2F        // FIFO byte count [7:0]
+#define ICM42688P_REG_FIFO_DATA         0x30        // FIFO data port
+#define ICM42688P_REG_SIGNAL_PATH_RESET 0x4B        // FIFO flush / signal path reset
+#define ICM42688P_REG_INTF_CONFIG0      0x4C        // Interface configuration 0 (FIFO count format)
 #define ICM42688P_REG_INTF_CONFIG1      0x4D        // Interface configuration 1
 #define ICM42688P_REG_PWR_MGMT0         0x4E        // Power management 0
 #define ICM42688P_REG_GYRO_CONFIG0      0x4F        // Gyro configuration 0
 #define ICM42688P_REG_ACCEL_CONFIG0     0x50        // Accel configuration 0
 #define ICM42688P_REG_GYRO_ACCEL_CONFIG0 0x52       // Gyro/Accel UI filter config
+#define ICM42688P_REG_TMST_CONFIG       0x54        // Timestamp configuration
+#define ICM42688P_REG_FIFO_CONFIG1      0x5F        // FIFO content selection
+#define ICM42688P_REG_FIFO_CONFIG2      0x60        // FIFO watermark [7:0]
+#define ICM42688P_REG_FIFO_CONFIG3      0x61        // FIFO watermark [11:8]
 #define ICM42688P_REG_INT_CONFIG0       0x63        // Interrupt config 0
 #define ICM42688P_REG_INT_CONFIG1       0x64        // Interrupt config 1
 #define ICM42688P_REG_INT_SOURCE0       0x65        // Interrupt source 0
@@ -190,6 +201,55 @@ extern "C" {
 
 #define ICM42688P_UI_DRDY_INT1_DISABLE  (0 << 3)
 #define ICM42688P_UI_DRDY_INT1_ENABLE   (1 << 3)
+#define ICM42688P_FIFO_THS_INT1_ENABLE  (1 << 2)
+#define ICM42688P_FIFO_FULL_INT1_ENABLE (1 << 1)
+
+/* ============================================================================
+ * FIFO Registers (0x16, 0x2D, 0x4B, 0x54, 0x5F-0x61)
+ * ============================================================================ */
+
+// FIFO_CONFIG (0x16)
+#define ICM42688P_FIFO_MODE_BYPASS      (0 << 6)
+#define ICM42688P_FIFO_MODE_STREAM      (1 << 6)    // Stream-to-FIFO (oldest data overwritten)
+#define ICM42688P_FIFO_MODE_STOP_FULL   (2 << 6)    // Stop when full
+
+// INT_STATUS (0x2D)
+#define ICM42688P_INT_STATUS_FIFO_THS   (1 << 2)
+#define ICM42688P_INT_STATUS_FIFO_FULL  (1 << 1)
+
+// SIGNAL_PATH_RESET (0x4B)
+#define ICM42688P_FIFO_FLUSH            (1 << 1)
+
+// TMST_CONFIG (0x54)
+#define ICM42688P_TMST_TO_REGS_EN       (1 << 4)
+#define ICM42688P_TMST_RES_16US         (1 << 3)    // 0 = 1us resolution
+#define ICM42688P_TMST_DELTA_EN         (1 << 2)
+#define ICM42688P_TMST_FSYNC_EN         (1 << 1)
+#define ICM42688P_TMST_EN               (1 << 0)
+
+// FIFO_CONFIG1 (0x5F)
+#define ICM42688P_FIFO_RESUME_PARTIAL_RD (1 << 6)
+#define ICM42688P_FIFO_WM_GT_TH         (1 << 5)    // Interrupt on every ODR while count >= watermark
+#define ICM42688P_FIFO_HIRES_EN         (1 << 4)    // 20-bit packet 4
+#define ICM42688P_FIFO_TMST_FSYNC_EN    (1 << 3)
+#define ICM42688P_FIFO_TEMP_EN          (1 << 2)
+#define ICM42688P_FIFO_GYRO_EN          (1 << 1)
+#define ICM42688P_FIFO_ACCEL_EN         (1 << 0)
+
+// FIFO packet header
+#define ICM42688P_FIFO_HEADER_MSG       (1 << 7)    // FIFO empty / invalid packet
+#define ICM42688P_FIFO_HEADER_ACCEL     (1 << 6)
+#define ICM42688P_FIFO_HEADER_GYRO      (1 << 5)
+#define ICM42688P_FIFO_HEADER_20        (1 << 4)
+#define ICM42688P_FIFO_HEADER_TMST_MASK (3 << 2)
+#define ICM42688P_FIFO_HEADER_TMST_ODR  (2 << 2)    // Packet carries an ODR timestamp
+
+#define ICM42688P_FIFO_SIZE             2048U       // Bytes
+#define ICM42688P_FIFO_PACKET1_SIZE     8U          // Header + accel + temp8
+#define ICM42688P_FIFO_PACKET2_SIZE     8U          // Header + gyro + temp8
+#define ICM42688P_FIFO_PACKET3_SIZE     16U         // Header + accel + gyro + temp8 + timestamp
+#define ICM42688P_FIFO_PACKET4_SIZE     20U         // Packet 3 with temp16 + 20-bit extension
+#define ICM42688P_FIFO_INVALID_SAMPLE   (-32768)    // Sensor off / no data
 
 /* ============================================================================
  * INTF_CONFIG1 Register (0x4D) - Interface Configuration
@@ -266,6 +326,47 @@ typedef struct {
     bool use_ext_clk;       // Use external clock (CLKIN)
 } icm42688p_config_t;
 
+/**
+ * @brief One sample drained from the FIFO
+ * @note In hi-res (packet 4) mode the sensor ignores FSR: gyro is 131 LSB/dps and
+ *       accel 8192 LSB/g (20-bit). gyro/accel then hold the values rescaled to the
+ *       ±2000dps / ±16g 16-bit format, gyro_hr/accel_hr keep the full 20-bit data.
+ */
+typedef struct {
+    int16_t  gyro[3];
+    int16_t  accel[3];
+    int32_t  gyro_hr[3];        // 20-bit data (packet 4 only)
+    int32_t  accel_hr[3];
+    float    temp_c;
+    uint32_t timestamp_us;      // Sensor ODR timestamp, unwrapped to 32 bits
+    uint8_t  header;
+    bool     gyro_valid;
+    bool     accel_valid;
+    bool     timestamp_valid;
+} icm42688p_fifo_sample_t;
+
+/**
+ * @brief FIFO configuration
+ */
+typedef struct {
+    uint16_t watermark;         // Samples per watermark interrupt (1..FIFO capacity)
+    bool     hires;             // Packet 4 (20-bit) instead of packet 3
+    bool     stop_on_full;      // Stop-on-full instead of stream (overwrite oldest)
+} icm42688p_fifo_config_t;
+
+/**
+ * @brief FIFO parser state (timestamp unwrapping)
+ */
+typedef struct {
+    uint8_t  packet_size;       // Expected packet size for icm42688p_fifo_read
+    uint8_t  tmst_res_us;       // Timestamp resolution (1 or 16 us)
+    bool     have_last;
+    uint16_t last_raw;          // Last 16-bit timestamp
+    uint32_t timestamp_us;      // Unwrapped timestamp of the last packet
+    uint32_t packets;           // Packets parsed
+    uint32_t invalid;           // Empty/invalid headers seen
+} icm42688p_fifo_state_t;
+
 typedef struct {
     // SPI communication function pointers (user must implement)
     uint8_t (*spi_read_reg)(uint8_t reg);
@@ -426,7 +527,9 @@ bool icm42688p_calibrate_gyro(icm42688p_dev_t *dev, uint16_t samples);
  * @brief 校准加速度计（计算偏移量）
  * @param dev 指向设备结构体的指针
  * @param samples 平均采样数量，用于计算偏置
- * @return 如果校准成功返回 true，否则返回 false
+ * @return 如果校准成功返回 true，否则返回 false（samples 为 0 时直接返回，不修改零偏）
+ * @note 阻塞；平均值减 1g，仅在 Z 轴严格朝上时成立，且不校刻度与交叉轴。
+ *       飞控使用 Core/Control/Tasks/accel_cal（六面最小二乘）
  */
 bool icm42688p_calibrate_accel(icm42688p_dev_t *dev, uint16_t samples);
 
@@ -444,6 +547,59 @@ float icm42688p_get_gyro_scale(uint8_t fsr);
  */
 float icm42688p_get_accel_scale(uint8_t fsr);
 
+/**
+ * @brief 配置并启动硬件 FIFO（packet 3/4 + ODR 时间戳 + 水位中断）
+ * @param dev 指向设备结构体的指针
+ * @param cfg FIFO 配置（水位单位为样本数）
+ * @param state 解析器状态（在此复位）
+ * @return 配置有效返回 true
+ * @note 水位中断替代数据就绪中断输出到 INT1；hires 模式下会把 dev 比例因子设为 ±2000dps/±16g
+ */
+bool icm42688p_fifo_init(icm42688p_dev_t *dev, const icm42688p_fifo_config_t *cfg,
+                         icm42688p_fifo_state_t *state);
+
+/**
+ * @brief 关闭 FIFO，恢复数据就绪中断
+ */
+void icm42688p_fifo_disable(icm42688p_dev_t *dev);
+
+/**
+ * @brief 清空 FIFO
+ */
+void icm42688p_fifo_flush(icm42688p_dev_t *dev);
+
+/**
+ * @brief 读取 FIFO 当前字节数
+ */
+uint16_t icm42688p_fifo_get_count(icm42688p_dev_t *dev);
+
+/**
+ * @brief 解析一段 FIFO 字节流（纯函数，不访问硬件）
+ * @param state 解析器状态（时间戳展开）
+ * @param buf FIFO 原始字节
+ * @param len 字节数
+ * @param out 输出样本数组
+ * @param max_samples 输出数组容量
+ * @param consumed 输出：已解析的字节数（不完整的尾包不计入，可为 NULL）
+ * @return 解析出的样本数
+ */
+uint16_t icm42688p_fifo_parse(icm42688p_fifo_state_t *state, const uint8_t *buf, uint16_t len,
+                              icm42688p_fifo_sample_t *out, uint16_t max_samples, uint16_t *consumed);
+
+/**
+ * @brief 一次突发读取清空 FIFO 中的完整数据包并解析
+ * @param dev 指向设备结构体的指针
+ * @param state 解析器状态
+ * @param buf 读取缓冲区（建议 ICM42688P_FIFO_SIZE 字节）
+ * @param buf_len 缓冲区大小
+ * @param out 输出样本数组
+ * @param max_samples 输出数组容量
+ * @return 读出的样本数
+ */
+uint16_t icm42688p_fifo_read(icm42688p_dev_t *dev, icm42688p_fifo_state_t *state,
+                             uint8_t *buf, uint16_t buf_len,
+                             icm42688p_fifo_sample_t *out, uint16_t max_samples);
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,123 @@
+/**
+ * @file    sil_hal.c
+ * @brief   SIL 最小 HAL 替身实现（虚拟时钟 + bsp_System 计时接口）
+ */
+
+#include "sil_hal.h"
+#include "bsp_System.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+DWT_Type       sil_dwt;
+CoreDebug_Type sil_core_debug;
+GPIO_TypeDef   sil_gpioa, sil_gpiob, sil_gpioc;
+
+uint32_t SystemCoreClock = SIL_CPU_FREQ_HZ;
+uint32_t sil_wfi_count = 0;
+
+static uint64_t total_cycles = 0;   // 累计周期数（不回绕）
+static uint32_t usTicks = 0;        // 每微秒周期数
+
+// ============================================================================
+// 虚拟时钟
+// ============================================================================
+
+void sil_time_reset(void)
+{
+    total_cycles = 0;
+    sil_dwt.CYCCNT = 0;
+}
+
+void sil_time_advance_cycles(uint32_t cycles)
+{
+    total_cycles += cycles;
+    // CYCCNT 与硬件一样 32 位回绕；固件写 CYCCNT=0 只影响它自身
+    sil_dwt.CYCCNT += cycles;
+}
+
+void sil_time_advance_us(uint32_t us)
+{
+    sil_time_advance_cycles(us * (SystemCoreClock / 1000000U));
+}
+
+uint64_t sil_time_now_cycles(void)
+{
+    return total_cycles;
+}
+
+uint64_t sil_time_now_us(void)
+{
+    return total_cycles / (SystemCoreClock / 1000000U);
+}
+
+// ============================================================================
+// HAL 时基
+// ============================================================================
+
+uint32_t HAL_GetTick(void)
+{
+    return (uint32_t)(total_cycles / (SystemCoreClock / 1000U));
+}
+
+void HAL_Delay(uint32_t ms)
+{
+    // 不阻塞，直接推进虚拟时间
+    while (ms--) {
+        sil_time_advance_us(1000U);
+    }
+}
+
+void HAL_IncTick(void)
+{
+}
+
+void Error_Handler(void)
+{
+    fprintf(stderr, "[sil] Error_Handler called\n");
+    abort();
+}
+
+// ============================================================================
+// GPIO（只记录输出电平，供测试检查片选等时序）
+// ============================================================================
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state)
+{
+    if (state == GPIO_PIN_SET) {
+        port->ODR |= pin;
+    } else {
+        port->ODR &= ~(uint32_t)pin;
+    }
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *port, uint16_t pin)
+{
+    port->ODR ^= pin;
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *port, uint16_t pin)
+{
+    return (port->ODR & pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+// ============================================================================
+// bsp_System 计时接口（与 bsp_System.c 同名同义）
+// ============================================================================
+
+void cycleCounterInit(void)
+{
+    usTicks = SystemCoreClock / 1000000U;
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32_t DWT_GetTick(void)
+{
+    return (uint32_t)(DWT->CYCCNT);
+}
+
+uint32_t clockMicrosToCycles(uint32_t micros)
+{
+    return micros * usTicks;
+}
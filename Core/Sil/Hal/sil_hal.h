@@ -0,0 +1,31 @@
+/**
+ * @file    sil_hal.h
+ * @brief   SIL 虚拟时钟接口
+ * @note    主机上没有真实的 DWT/SysTick，所有时间都由测试/回放程序显式推进：
+ *          DWT->CYCCNT 按 SystemCoreClock 累加，HAL_GetTick() 由累计周期数折算，
+ *          HAL_Delay() 只推进虚拟时间而不阻塞，因此固件代码可以远快于实时运行。
+ */
+
+#ifndef SIL_HAL_H
+#define SIL_HAL_H
+
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+
+// 默认 CPU 频率（与 SystemClock_Config 的 168MHz 配置一致）
+#ifndef SIL_CPU_FREQ_HZ
+#define SIL_CPU_FREQ_HZ 168000000U
+#endif
+
+// 复位虚拟时钟（CYCCNT 与毫秒节拍清零）
+void sil_time_reset(void);
+
+// 推进虚拟时间
+void sil_time_advance_cycles(uint32_t cycles);
+void sil_time_advance_us(uint32_t us);
+
+// 读取虚拟时间（从 sil_time_reset 起累计，不回绕）
+uint64_t sil_time_now_cycles(void);
+uint64_t sil_time_now_us(void);
+
+#endif // SIL_HAL_H
@@ -0,0 +1,11 @@
+/**
+ * @file    stm32f4xx.h
+ * @brief   SIL 主机构建：转发到最小 HAL 替身
+ */
+
+#ifndef SIL_STM32F4XX_H
+#define SIL_STM32F4XX_H
+
+#include "stm32f4xx_hal.h"
+
+#endif // SIL_STM32F4XX_H
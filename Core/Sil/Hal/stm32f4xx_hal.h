@@ -0,0 +1,140 @@
+/**
+ * @file    stm32f4xx_hal.h
+ * @brief   SIL 主机构建用的最小 HAL 替身
+ * @note    只提供 Core/Control、Core/Lib 与任务流水线实际用到的符号：
+ *          DWT/CoreDebug 周期计数器、HAL_GetTick/HAL_Delay、SPI/I2C/UART/DMA 句柄、
+ *          中断开关与内存屏障。时间由 sil_hal.h 中的虚拟时钟驱动，不走真实时间。
+ */
+
+#ifndef SIL_STM32F4XX_HAL_H
+#define SIL_STM32F4XX_HAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define __IO volatile
+
+typedef enum {
+    HAL_OK      = 0x00U,
+    HAL_ERROR   = 0x01U,
+    HAL_BUSY    = 0x02U,
+    HAL_TIMEOUT = 0x03U,
+} HAL_StatusTypeDef;
+
+#define HAL_MAX_DELAY 0xFFFFFFFFU
+
+// ============================================================================
+// 内核外设：DWT 周期计数器 / CoreDebug
+// ============================================================================
+typedef struct {
+    __IO uint32_t CTRL;
+    __IO uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+    __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+extern DWT_Type       sil_dwt;
+extern CoreDebug_Type sil_core_debug;
+
+#define DWT        (&sil_dwt)
+#define CoreDebug  (&sil_core_debug)
+
+#define DWT_CTRL_CYCCNTENA_Msk      (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL << 24)
+
+extern uint32_t SystemCoreClock;
+extern uint32_t sil_wfi_count;     // __WFI() 调用次数（主机上不睡眠，只计数）
+
+static inline void __disable_irq(void) {}
+static inline void __enable_irq(void) {}
+static inline void __DSB(void) {}
+static inline void __ISB(void) {}
+static inline void __DMB(void) {}
+static inline void __WFI(void) { sil_wfi_count++; }
+static inline void __NOP(void) {}
+
+// ============================================================================
+// GPIO
+// ============================================================================
+typedef struct {
+    uint32_t ODR;
+} GPIO_TypeDef;
+
+typedef enum {
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET,
+} GPIO_PinState;
+
+extern GPIO_TypeDef sil_gpioa, sil_gpiob, sil_gpioc;
+#define GPIOA (&sil_gpioa)
+#define GPIOB (&sil_gpiob)
+#define GPIOC (&sil_gpioc)
+
+#define GPIO_PIN_0   ((uint16_t)0x0001)
+#define GPIO_PIN_1   ((uint16_t)0x0002)
+#define GPIO_PIN_2   ((uint16_t)0x0004)
+#define GPIO_PIN_3   ((uint16_t)0x0008)
+#define GPIO_PIN_5   ((uint16_t)0x0020)
+#define GPIO_PIN_6   ((uint16_t)0x0040)
+#define GPIO_PIN_7   ((uint16_t)0x0080)
+#define GPIO_PIN_8   ((uint16_t)0x0100)
+#define GPIO_PIN_9   ((uint16_t)0x0200)
+#define GPIO_PIN_10  ((uint16_t)0x0400)
+#define GPIO_PIN_11  ((uint16_t)0x0800)
+
+void          HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state);
+void          HAL_GPIO_TogglePin(GPIO_TypeDef *port, uint16_t pin);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *port, uint16_t pin);
+
+// ============================================================================
+// 外设句柄（仅保留驱动代码访问到的字段）
+// ============================================================================
+typedef enum {
+    HAL_SPI_STATE_RESET = 0x00U,
+    HAL_SPI_STATE_READY = 0x01U,
+    HAL_SPI_STATE_BUSY  = 0x02U,
+} HAL_SPI_StateTypeDef;
+
+typedef struct {
+    void *Instance;
+    uint32_t State;
+} DMA_HandleTypeDef;
+
+typedef struct {
+    void                 *Instance;
+    __IO HAL_SPI_StateTypeDef State;
+    DMA_HandleTypeDef    *hdmatx;
+    DMA_HandleTypeDef    *hdmarx;
+} SPI_HandleTypeDef;
+
+typedef struct {
+    void *Instance;
+    uint32_t State;
+} I2C_HandleTypeDef;
+
+typedef struct {
+    void *Instance;
+    uint32_t State;
+} UART_HandleTypeDef;
+
+// ============================================================================
+// 系统时基
+// ============================================================================
+uint32_t HAL_GetTick(void);
+void     HAL_Delay(uint32_t ms);
+void     HAL_IncTick(void);
+
+void Error_Handler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIL_STM32F4XX_HAL_H
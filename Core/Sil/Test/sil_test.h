@@ -0,0 +1,39 @@
+/**
+ * @file    sil_test.h
+ * @brief   SIL 测试公用断言：CHECK 打印 [PASS]/[FAIL] 并计数，sil_test_report 输出汇总
+ * @note    每个测试是单独的可执行文件，只应在测试 .c 中包含一次。
+ *
+ * @example
+ * CHECK(err < 0.1f, "error %.3f", (double)err);
+ * int main(void) { ...; return sil_test_report(); }
+ */
+
+#ifndef SIL_TEST_H
+#define SIL_TEST_H
+
+#include <stdio.h>
+
+static int failures = 0;
+
+#define CHECK(cond, ...)                                  \
+    do {                                                  \
+        if (cond) {                                       \
+            printf("[PASS] " __VA_ARGS__);                \
+        } else {                                          \
+            printf("[FAIL] " __VA_ARGS__);                \
+            failures++;                                   \
+        }                                                 \
+        printf("\n");                                     \
+    } while (0)
+
+/**
+ * @brief 打印汇总
+ * @return 进程退出码：0=全部通过
+ */
+static inline int sil_test_report(void)
+{
+    printf("%s (%d failure%s)\n", failures ? "FAILED" : "OK", failures, failures == 1 ? "" : "s");
+    return failures ? 1 : 0;
+}
+
+#endif // SIL_TEST_H
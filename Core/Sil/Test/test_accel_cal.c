@@ -0,0 +1,263 @@
+/**
+ * @file    test_accel_cal.c
+ * @brief   SIL 测试：加速度计六面校准（accel_cal）
+ * @note    用已知的零偏、刻度误差与交叉轴矩阵合成原始数据：
+ *          - 求解器：精确数据恢复零偏/矩阵；带噪声时任意姿态下校准后模长误差小；朝向重复时判奇异
+ *          - 引导流程：经 accel_process_sample + 调度器任务，任意顺序放置 6 面（中间有晃动），
+ *            采齐后自动求解并下发；校准后的输出与真实重力一致，明显优于仅减平均值的旧做法
+ *          - 校准与安装方向合成为一次仿射变换；清除校准回到整数前端
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "sil_board.h"
+#include "accel_cal.h"
+#include "sensor_align.h"
+#include "task_acc.h"
+#include "icm42688p_lib.h"
+#include "sil_test.h"
+
+static uint32_t rng = 0x2B7E1516U;
+
+static uint32_t rand_u32(void)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static double noise(double sigma)
+{
+    double s = 0.0;
+    for (int i = 0; i < 4; i++) s += (double)rand_u32() / 4294967296.0 - 0.5;
+    return s * sigma * 1.7320508;
+}
+
+// 真实传感器：raw = K * g + bias，K = diag(scale) * (I + 交叉轴)（LSB/g）
+static const double true_bias[3] = { 310.0, -245.0, 520.0 };
+static double true_k[3][3];
+
+static void make_sensor(double nominal)
+{
+    static const double scale_err[3] = { 0.03, -0.02, 0.045 };
+    static const double cross[3][3] = {
+        { 0.0,    0.012, -0.008 },
+        { -0.006, 0.0,    0.015 },
+        { 0.010,  0.004,  0.0   },
+    };
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            true_k[i][j] = nominal * (1.0 + scale_err[i]) * ((i == j ? 1.0 : 0.0) + cross[i][j]);
+        }
+    }
+}
+
+static void sensor_raw(const double g[3], double sigma_g, double out[3])
+{
+    for (int i = 0; i < 3; i++) {
+        out[i] = true_bias[i];
+        for (int j = 0; j < 3; j++) out[i] += true_k[i][j] * (g[j] + noise(sigma_g));
+    }
+}
+
+static void pos_gravity(int pos, double g[3])
+{
+    g[0] = g[1] = g[2] = 0.0;
+    g[pos / 2] = (pos & 1) ? -1.0 : 1.0;
+}
+
+static void random_gravity(double g[3])
+{
+    double n = 0.0;
+    do {
+        for (int a = 0; a < 3; a++) g[a] = (double)rand_u32() / 2147483648.0 - 1.0;
+        n = sqrt(g[0] * g[0] + g[1] * g[1] + g[2] * g[2]);
+    } while (n < 0.1 || n > 1.0);
+    for (int a = 0; a < 3; a++) g[a] /= n;
+}
+
+static double calibrated_error(const accel_cal_result_t *r, const double raw[3], const double g[3])
+{
+    double e = 0.0;
+    for (int i = 0; i < 3; i++) {
+        double a = 0.0;
+        for (int j = 0; j < 3; j++) a += r->matrix[i][j] * (raw[j] - r->bias[j]);
+        e = fmax(e, fabs(a - g[i]));
+    }
+    return e;
+}
+
+static void test_solver(void)
+{
+    const float nominal = icm.accel_scale;
+    float mean[ACCEL_CAL_POS_COUNT][3];
+    for (int p = 0; p < ACCEL_CAL_POS_COUNT; p++) {
+        double g[3], raw[3];
+        pos_gravity(p, g);
+        sensor_raw(g, 0.0, raw);
+        for (int a = 0; a < 3; a++) mean[p][a] = (float)raw[a];
+    }
+
+    accel_cal_result_t r;
+    CHECK(accel_cal_solve(mean, nominal, &r), "exact six-position data solved");
+    double bias_err = 0.0, scale_err = 0.0;
+    for (int a = 0; a < 3; a++) {
+        bias_err = fmax(bias_err, fabs(r.bias[a] - true_bias[a]));
+        scale_err = fmax(scale_err, fabs(r.scale[a] / true_k[a][a] - 1.0));
+    }
+    double worst = 0.0;
+    for (int i = 0; i < 2000; i++) {
+        double g[3], raw[3];
+        random_gravity(g);
+        sensor_raw(g, 0.0, raw);
+        worst = fmax(worst, calibrated_error(&r, raw, g));
+    }
+    CHECK(bias_err < 0.5 && scale_err < 0.02 && worst < 1e-4 && r.residual_g < 1e-4,
+          "bias within %.3f counts, scale within %.2f%%, any orientation within %.1e g",
+          bias_err, scale_err * 100.0, worst);
+
+    // 带噪声（每面平均值噪声 2mg）
+    for (int p = 0; p < ACCEL_CAL_POS_COUNT; p++) {
+        double g[3], raw[3];
+        pos_gravity(p, g);
+        sensor_raw(g, 0.002, raw);
+        for (int a = 0; a < 3; a++) mean[p][a] = (float)raw[a];
+    }
+    CHECK(accel_cal_solve(mean, nominal, &r), "noisy data solved");
+    worst = 0.0;
+    double flat = 0.0;
+    for (int i = 0; i < 2000; i++) {
+        double g[3], raw[3];
+        random_gravity(g);
+        sensor_raw(g, 0.0, raw);
+        worst = fmax(worst, calibrated_error(&r, raw, g));
+        // 旧做法：减掉 Z 朝上时的平均值（再加 1g），按标称刻度换算
+        for (int a = 0; a < 3; a++) {
+            const double z_up = true_bias[a] + true_k[a][2];
+            const double off = z_up - (a == 2 ? nominal : 0.0);
+            flat = fmax(flat, fabs((raw[a] - off) / nominal - g[a]));
+        }
+    }
+    CHECK(worst < 0.01 && flat > 0.04,
+          "noisy calibration within %.4f g at any orientation (flat-average method: %.3f g)", worst, flat);
+
+    // 两面相同：方程奇异
+    memcpy(mean[ACCEL_CAL_POS_X_DOWN], mean[ACCEL_CAL_POS_X_UP], sizeof(mean[0]));
+    memcpy(mean[ACCEL_CAL_POS_Y_DOWN], mean[ACCEL_CAL_POS_Y_UP], sizeof(mean[0]));
+    memcpy(mean[ACCEL_CAL_POS_Z_DOWN], mean[ACCEL_CAL_POS_Z_UP], sizeof(mean[0]));
+    CHECK(!accel_cal_solve(mean, nominal, &r), "repeated orientations rejected");
+}
+
+// 以 1kHz 运行 n 个样本（可叠加晃动），按需执行调度器任务
+static void run(uint32_t n, const double g[3], double shake_g)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        double gi[3];
+        for (int a = 0; a < 3; a++) gi[a] = g[a] + noise(shake_g);
+        double raw[3];
+        sensor_raw(gi, 0.004, raw);
+        accel_process_sample((int16_t)lrint(raw[0]), (int16_t)lrint(raw[1]), (int16_t)lrint(raw[2]));
+        if (accel_cal_should_run(NULL)) {
+            accel_cal_task(NULL);
+        }
+    }
+}
+
+static void test_guided(void)
+{
+    accel_processing_init();
+    CHECK(accel_cal_start(NULL), "guided calibration started");
+
+    // 任意顺序，每面之间手持晃动
+    static const int order[ACCEL_CAL_POS_COUNT] = { 4, 1, 2, 5, 0, 3 };
+    accel_cal_status_t st;
+    for (int k = 0; k < ACCEL_CAL_POS_COUNT; k++) {
+        double g[3];
+        pos_gravity(order[k], g);
+        run(600, g, 0.3);           // 晃动：不应采集
+        accel_cal_get_status(&st);
+        if (st.captured & (1U << order[k])) break;
+        run(1500, g, 0.0);          // 静止 1.5s
+        if (k == 0) {
+            // 重复放同一面不会覆盖
+            run(1500, g, 0.0);
+        }
+    }
+    accel_cal_get_status(&st);
+    CHECK(st.state == ACCEL_CAL_STATE_DONE && st.captured == 0x3F && st.overruns == 0,
+          "all six faces captured in any order, solved and applied (mask 0x%02X)", st.captured);
+
+    // 下发后的输出：任意姿态
+    double worst = 0.0;
+    for (int i = 0; i < 500; i++) {
+        double g[3], raw[3];
+        random_gravity(g);
+        sensor_raw(g, 0.0, raw);
+        accel_process_sample((int16_t)lrint(raw[0]), (int16_t)lrint(raw[1]), (int16_t)lrint(raw[2]));
+        const double got[3] = { accel_scaled.g_x, accel_scaled.g_y, accel_scaled.g_z };
+        for (int a = 0; a < 3; a++) worst = fmax(worst, fabs(got[a] - g[a]));
+    }
+    CHECK(worst < 0.01, "accel_process_sample applies the calibration: %.4f g worst error", worst);
+
+    // 初始化后保留
+    accel_processing_init();
+    double raw[3];
+    const double up[3] = { 0.0, 0.0, 1.0 };
+    sensor_raw(up, 0.0, raw);
+    accel_process_sample((int16_t)lrint(raw[0]), (int16_t)lrint(raw[1]), (int16_t)lrint(raw[2]));
+    CHECK(fabsf(accel_scaled.g_z - 1.0f) < 0.01f && accel_compensated.z > 16000,
+          "calibration survives accel_processing_init (z %.4f g, %d counts)", (double)accel_scaled.g_z,
+          accel_compensated.z);
+}
+
+static void test_fused_alignment(void)
+{
+    accel_cal_result_t r;
+    CHECK(accel_cal_get_result(&r), "result available");
+
+    // 安装方向倒装 CW90：机体系 = R * 校准后的传感器系
+    const sensor_align_t flip = { .step = SENSOR_ALIGN_CW90_FLIP };
+    sensor_rotation_t rot;
+    sensor_rotation_build(&rot, NULL, &flip);
+    accel_processing_set_alignment(&rot);
+
+    double worst = 0.0;
+    for (int i = 0; i < 200; i++) {
+        double g[3], raw[3];
+        random_gravity(g);
+        sensor_raw(g, 0.0, raw);
+        accel_process_sample((int16_t)lrint(raw[0]), (int16_t)lrint(raw[1]), (int16_t)lrint(raw[2]));
+        float body[3] = { (float)g[0], (float)g[1], (float)g[2] };
+        sensor_rotation_apply(&rot, body);
+        worst = fmax(worst, fabs(accel_scaled.g_x - body[0]));
+        worst = fmax(worst, fabs(accel_scaled.g_y - body[1]));
+        worst = fmax(worst, fabs(accel_scaled.g_z - body[2]));
+    }
+    CHECK(worst < 0.01, "calibration fused with board alignment (%.4f g)", worst);
+
+    // 清除：回到整数前端（icm.accel_offset + 标称刻度）
+    const sensor_rotation_t identity = { .kind = SENSOR_ROTATION_IDENTITY };
+    accel_processing_set_alignment(&identity);
+    CHECK(accel_processing_set_calibration(NULL, NULL), "calibration cleared");
+    accel_process_sample(0, 0, (int16_t)icm.accel_scale);
+    CHECK(accel_scaled.g_z == 1.0f && accel_compensated.z == (int16_t)icm.accel_scale, "integer path restored");
+
+    const float bad[3][3] = { { NAN, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+    const float zero[3] = { 0, 0, 0 };
+    CHECK(!accel_processing_set_calibration(bad, zero), "non-finite calibration rejected");
+}
+
+int main(void)
+{
+    sil_board_init();
+    icm.accel_offset[0] = icm.accel_offset[1] = icm.accel_offset[2] = 0;
+    make_sensor(icm.accel_scale);
+
+    test_solver();
+    test_guided();
+    test_fused_alignment();
+
+    return sil_test_report();
+}
@@ -0,0 +1,134 @@
+/**
+ * @file    test_attitude_dt.c
+ * @brief   姿态 dt 时基主机测试：1/2/4/8kHz 定速旋转积分误差（DWT 周期时基、微秒传感器时间戳、
+ *          采样抖动、计数器回绕）
+ * @note    旧实现用 1ms 的 HAL_GetTick 计算 dt 并钳位到 >=100us，kHz 级更新时绝大多数 dt 被算成
+ *          100us 或 1ms；这里检查显式时间戳下的积分误差随更新率保持在小范围内。
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include "sil_board.h"
+#include "attitude.h"
+#include "sil_test.h"
+
+#define YAW_RATE_DPS    90.0f
+#define ROLL_RATE_DPS   45.0f
+#define ERR_MAX_DEG     0.01f
+
+static const uint32_t rates_hz[] = { 1000U, 2000U, 4000U, 8000U };
+
+// 估计四元数与真值（绕单轴转过 angle_deg）之间的旋转角误差，带符号取转角差。
+// 直接比较四元数，避免把 atan2_approx 的欧拉角近似误差算进积分误差。
+static float quat_error_deg(int axis, float angle_deg)
+{
+    const float h = 0.5f * angle_deg * DEG2RAD;
+    const float t[4] = { cosf(h), axis == 0 ? sinf(h) : 0.0f, 0.0f, axis == 2 ? sinf(h) : 0.0f };
+    const float q[4] = { attitude_q.p0, attitude_q.p1, attitude_q.p2, attitude_q.p3 };
+    // q_err = conj(t) * q 的标量部与对应轴分量
+    const float w = t[0] * q[0] + t[1] * q[1] + t[3] * q[3];
+    const float v = (axis == 0) ? (t[0] * q[1] - t[1] * q[0]) : (t[0] * q[3] - t[3] * q[0]);
+    return 2.0f * atan2f(v, w) * RAD2DEG;
+}
+
+// 默认时基：更新函数自己读取 DWT->CYCCNT，虚拟时钟按周期推进
+static float yaw_error_dwt(uint32_t rate_hz)
+{
+    sil_board_init();
+    Attitude_SetTimeBase(0);
+    Attitude_InitFromAccelerometer(0.0f, 0.0f, 1.0f);
+
+    const uint32_t period_cycles = SIL_CPU_FREQ_HZ / rate_hz;
+    for (uint32_t i = 0; i < rate_hz; i++) {   // 1s
+        sil_time_advance_cycles(period_cycles);
+        Attitude_Update_IMU_Only(0.0f, 0.0f, 1.0f, 0.0f, 0.0f, YAW_RATE_DPS);
+    }
+    return quat_error_deg(2, YAW_RATE_DPS);
+}
+
+// 微秒传感器时间戳，采样间隔 ±20% 抖动，起点靠近 32 位回绕
+static float yaw_error_stamped(uint32_t rate_hz, float *dt_min, float *dt_max)
+{
+    sil_board_init();
+    Attitude_SetTimeBase(1000000U);
+    Attitude_InitFromAccelerometer(0.0f, 0.0f, 1.0f);
+
+    const uint32_t period_us = 1000000U / rate_hz;
+    uint32_t stamp = 0xFFFFFFFFU - 300000U;
+    uint32_t elapsed_us = 0;
+    uint32_t lcg = 1U;
+    *dt_min = 1.0f;
+    *dt_max = 0.0f;
+
+    Attitude_Update_IMU_Only_Stamped(0.0f, 0.0f, 1.0f, 0.0f, 0.0f, YAW_RATE_DPS, stamp);  // 建立时间参考
+    while (elapsed_us < 1000000U) {
+        lcg = lcg * 1664525U + 1013904223U;
+        const int32_t jitter = (int32_t)((lcg >> 16) % (2U * period_us / 5U + 1U)) - (int32_t)(period_us / 5U);
+        const uint32_t step = (uint32_t)((int32_t)period_us + jitter);
+        stamp += step;
+        elapsed_us += step;
+        Attitude_Update_IMU_Only_Stamped(0.0f, 0.0f, 1.0f, 0.0f, 0.0f, YAW_RATE_DPS, stamp);
+        const float dt = Attitude_GetDiagnostics()->dt;
+        if (dt < *dt_min) *dt_min = dt;
+        if (dt > *dt_max) *dt_max = dt;
+    }
+    return quat_error_deg(2, YAW_RATE_DPS * (float)elapsed_us * 1e-6f);
+}
+
+// 横滚定速旋转，加速度计与真实姿态一致（互补项不应把积分结果拉偏）
+static float roll_error_stamped(uint32_t rate_hz)
+{
+    sil_board_init();
+    Attitude_SetTimeBase(1000000U);
+    Attitude_InitFromAccelerometer(0.0f, 0.0f, 1.0f);
+
+    const uint32_t period_us = 1000000U / rate_hz;
+    uint32_t stamp = 0;
+    Attitude_Update_IMU_Only_Stamped(0.0f, 0.0f, 1.0f, ROLL_RATE_DPS, 0.0f, 0.0f, stamp);
+    for (uint32_t i = 1; i <= rate_hz; i++) {
+        stamp += period_us;
+        const float roll = ROLL_RATE_DPS * (float)i / (float)rate_hz * DEG2RAD;
+        Attitude_Update_IMU_Only_Stamped(0.0f, sinf(roll), cosf(roll), ROLL_RATE_DPS, 0.0f, 0.0f, stamp);
+    }
+    return quat_error_deg(0, ROLL_RATE_DPS);
+}
+
+int main(void)
+{
+    printf("  rate     yaw err(DWT)  yaw err(us+jitter)  roll err(us)   dt range\n");
+    for (uint32_t r = 0; r < sizeof(rates_hz) / sizeof(rates_hz[0]); r++) {
+        const uint32_t hz = rates_hz[r];
+        float dt_min, dt_max;
+        const float e_dwt = yaw_error_dwt(hz);
+        const float e_us = yaw_error_stamped(hz, &dt_min, &dt_max);
+        const float e_roll = roll_error_stamped(hz);
+        printf("  %4u Hz  %+10.4f deg  %+14.4f deg  %+10.4f deg   %.0f..%.0f us\n",
+               hz, e_dwt, e_us, e_roll, dt_min * 1e6f, dt_max * 1e6f);
+
+        CHECK(fabsf(e_dwt) < ERR_MAX_DEG, "%u Hz: DWT time base, 1s at %.0f dps -> yaw error %.4f deg",
+              hz, YAW_RATE_DPS, e_dwt);
+        CHECK(fabsf(e_us) < ERR_MAX_DEG, "%u Hz: jittered us timestamps across wraparound -> yaw error %.4f deg",
+              hz, e_us);
+        // 加速度修正项比较的是本次加速度与上一步姿态，稳态下领先约一个采样周期的转角
+        const float one_step = ROLL_RATE_DPS / (float)hz;
+        CHECK(fabsf(e_roll) < 1.1f * one_step, "%u Hz: roll %.0f dps with consistent accel -> roll error %.4f deg "
+              "(one step = %.4f deg)", hz, ROLL_RATE_DPS, e_roll, one_step);
+    }
+
+    // 同一时间戳重复送入：不积分
+    sil_board_init();
+    Attitude_SetTimeBase(1000000U);
+    Attitude_InitFromAccelerometer(0.0f, 0.0f, 1.0f);
+    Attitude_Update_IMU_Only_Stamped(0.0f, 0.0f, 1.0f, 0.0f, 0.0f, YAW_RATE_DPS, 5000U);
+    Attitude_Update_IMU_Only_Stamped(0.0f, 0.0f, 1.0f, 0.0f, 0.0f, YAW_RATE_DPS, 5000U);
+    CHECK(Attitude_GetDiagnostics()->dt == 0.0f && fabsf(Attitude_Get_Yaw()) < 1e-4f,
+          "first stamp only sets the reference, repeated stamp integrates nothing");
+
+    // 长时间无数据：单步积分被限制
+    Attitude_Update_IMU_Only_Stamped(0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 5000U + 2000000U);
+    CHECK(fabsf(Attitude_GetDiagnostics()->dt - 0.05f) < 1e-6f, "2s gap clamped to dt=%.3f s",
+          Attitude_GetDiagnostics()->dt);
+    Attitude_SetTimeBase(0);
+
+    return sil_test_report();
+}
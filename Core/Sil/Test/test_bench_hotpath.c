@@ -0,0 +1,15 @@
+/**
+ * @file    test_bench_hotpath.c
+ * @brief   SIL 入口：在主机上运行热路径微基准（Core/Test/bench_hotpath.c）
+ * @note    主机 ns 预算只作参考（墙钟时间受负载影响），只有基准输入无效时失败；
+ *          预算门限是板上的 cycles（RUN_MODE 3）。
+ */
+
+#include "sil_board.h"
+#include "bench_hotpath.h"
+
+int main(void)
+{
+    sil_board_init();
+    return bench_hotpath_run() ? 1 : 0;
+}
@@ -0,0 +1,219 @@
+/**
+ * @file    test_dyn_notch.c
+ * @brief   动态陷波主机测试：64 点实数 FFT 对照 DFT、单步分析步数有界、峰值跟踪（含扫频）、陷波衰减、
+ *          task_gyro/task_filter 接入
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "dyn_notch.h"
+#include "sil_board.h"
+#include "task_gyro.h"
+#include "task_fliter.h"
+#include "sil_test.h"
+
+#define PI_F        3.14159265358979f
+#define GYRO_HZ     8000U
+#define DECIM       8U
+
+static void test_rfft_matches_dft(void)
+{
+    static dynNotch_t dn;
+    dynNotchConfig_t cfg;
+    dynNotchGetDefaultConfig(&cfg);
+    dynNotchInit(&dn, &cfg);
+
+    float x[DYN_NOTCH_FFT_SIZE], buf[DYN_NOTCH_FFT_SIZE];
+    uint32_t lcg = 7U;
+    for (int n = 0; n < DYN_NOTCH_FFT_SIZE; n++) {
+        lcg = lcg * 1664525U + 1013904223U;
+        x[n] = (float)(lcg >> 8) / 16777216.0f - 0.5f + 0.3f * sinf(2.0f * PI_F * 5.3f * n / DYN_NOTCH_FFT_SIZE);
+        buf[n] = x[n];
+    }
+    dynNotchRfft(&dn, buf);
+
+    double max_err = 0.0;
+    for (int k = 0; k <= DYN_NOTCH_FFT_SIZE / 2; k++) {
+        double re = 0.0, im = 0.0;
+        for (int n = 0; n < DYN_NOTCH_FFT_SIZE; n++) {
+            const double a = 2.0 * 3.14159265358979 * k * n / DYN_NOTCH_FFT_SIZE;
+            re += x[n] * cos(a);
+            im -= x[n] * sin(a);
+        }
+        double gr, gi;
+        if (k == 0) {
+            gr = buf[0]; gi = 0.0;
+        } else if (k == DYN_NOTCH_FFT_SIZE / 2) {
+            gr = buf[1]; gi = 0.0;
+        } else {
+            gr = buf[2 * k]; gi = buf[2 * k + 1];
+        }
+        const double e = fabs(gr - re) + fabs(gi - im);
+        if (e > max_err) max_err = e;
+    }
+    CHECK(max_err < 1e-4, "64-point real FFT (arm_rfft_fast_f32 layout) vs DFT: max err %.2e", max_err);
+}
+
+// 8kHz 合成陀螺：低频机动 + 每轴噪声音调
+typedef struct {
+    float f[3][2];      // 每轴两个音调频率（0=无）
+    float amp;
+    double phase[3][2];
+} tones_t;
+
+static void tones_sample(tones_t *t, uint32_t i, float out[3])
+{
+    const float slow = 20.0f * sinf(2.0f * PI_F * 2.0f * (float)i / GYRO_HZ);
+    for (int a = 0; a < 3; a++) {
+        out[a] = slow;
+        for (int j = 0; j < 2; j++) {
+            if (t->f[a][j] > 0.0f) {
+                t->phase[a][j] += 2.0 * 3.14159265358979 * t->f[a][j] / GYRO_HZ;
+                out[a] += t->amp * (float)sin(t->phase[a][j]);
+            }
+        }
+    }
+}
+
+static void run(dynNotch_t *dn, tones_t *t, uint32_t samples, uint32_t *max_steps_per_tick)
+{
+    static uint32_t i = 0;
+    for (uint32_t n = 0; n < samples; n++, i++) {
+        float g[3];
+        tones_sample(t, i, g);
+        dynNotchPush(dn, g[0], g[1], g[2]);
+        if ((i % DECIM) == 0) {
+            const uint32_t before = dn->steps;
+            dynNotchUpdate(dn);   // 1kHz 调度片：每次最多一步
+            if (max_steps_per_tick && dn->steps - before > *max_steps_per_tick) {
+                *max_steps_per_tick = dn->steps - before;
+            }
+        }
+    }
+}
+
+static bool near(float a, float b, float tol)
+{
+    return fabsf(a - b) <= tol;
+}
+
+static void test_tracking(void)
+{
+    static dynNotch_t dn;
+    dynNotchConfig_t cfg;
+    dynNotchGetDefaultConfig(&cfg);
+    bool ok = dynNotchInit(&dn, &cfg);
+    CHECK(ok && dn.decim == 8 && near(dn.fft_hz, 1000.0f, 0.1f) && near(dn.bin_hz, 15.625f, 0.01f),
+          "default config: decimate 8kHz by %u -> %.0f Hz analysis, %.2f Hz bins", dn.decim, dn.fft_hz, dn.bin_hz);
+
+    tones_t t = { .f = { { 200.0f, 0 }, { 310.0f, 0 }, { 150.0f, 380.0f } }, .amp = 30.0f };
+    uint32_t max_steps = 0;
+    run(&dn, &t, GYRO_HZ / 2U, &max_steps);   // 0.5s
+
+    CHECK(max_steps == 1 && dn.overruns == 0 && dn.analyses > 10,
+          "bounded: max %u step per tick, %u analyses, %u overruns (%d steps per analysis)",
+          max_steps, dn.analyses, dn.overruns, DYN_NOTCH_STEPS_PER_ANALYSIS);
+    CHECK(near(dn.center_hz[0][0], 200.0f, 6.0f) || near(dn.center_hz[0][1], 200.0f, 6.0f),
+          "X tracks 200Hz: notches %.1f / %.1f Hz", dn.center_hz[0][0], dn.center_hz[0][1]);
+    CHECK(near(dn.center_hz[1][0], 310.0f, 6.0f) || near(dn.center_hz[1][1], 310.0f, 6.0f),
+          "Y tracks 310Hz: notches %.1f / %.1f Hz", dn.center_hz[1][0], dn.center_hz[1][1]);
+    CHECK(near(dn.center_hz[2][0], 150.0f, 6.0f) && near(dn.center_hz[2][1], 380.0f, 8.0f),
+          "Z tracks two peaks 150/380Hz: notches %.1f / %.1f Hz", dn.center_hz[2][0], dn.center_hz[2][1]);
+
+    // 油门上升：X 音调 1s 内从 200Hz 扫到 300Hz
+    for (int s = 0; s <= 100; s++) {
+        t.f[0][0] = 200.0f + (float)s;
+        run(&dn, &t, GYRO_HZ / 100U, NULL);
+    }
+    run(&dn, &t, GYRO_HZ / 5U, NULL);
+    const float fx = near(dn.center_hz[0][0], 300.0f, 10.0f) ? dn.center_hz[0][0] : dn.center_hz[0][1];
+    CHECK(near(fx, 300.0f, 8.0f), "X follows a 200->300Hz sweep: %.1f Hz", fx);
+}
+
+// 陷波输出的音调残余（1kHz 采样的 PT1/LPF 前，直接测陷波本身）
+static void test_attenuation(void)
+{
+    static dynNotch_t dn;
+    dynNotchConfig_t cfg;
+    dynNotchGetDefaultConfig(&cfg);
+    cfg.count = 1;
+    dynNotchInit(&dn, &cfg);
+
+    tones_t t = { .f = { { 240.0f, 0 }, { 240.0f, 0 }, { 240.0f, 0 } }, .amp = 30.0f };
+    double sum_in = 0.0, sum_out = 0.0;
+    uint32_t i = 0;
+    float acc = 0.0f;
+    for (uint32_t n = 0; n < GYRO_HZ; n++, i++) {
+        float g[3];
+        tones_sample(&t, i, g);
+        dynNotchPush(&dn, g[0], g[1], g[2]);
+        acc += g[0] - 20.0f * sinf(2.0f * PI_F * 2.0f * (float)i / GYRO_HZ);
+        if ((i % DECIM) == DECIM - 1) {
+            dynNotchUpdate(&dn);
+            const float in = acc / DECIM;
+            acc = 0.0f;
+            const float out = dynNotchApply(&dn, 0, in);
+            if (n > GYRO_HZ / 2U) {
+                sum_in += (double)in * in;
+                sum_out += (double)out * out;
+            }
+        }
+    }
+    const double ratio = sqrt(sum_out / sum_in);
+    CHECK(ratio < 0.15, "240Hz noise after notch: %.1f%% RMS of input (notch at %.1f Hz)", ratio * 100.0,
+          dn.center_hz[0][0]);
+}
+
+static void test_invalid_config(void)
+{
+    static dynNotch_t dn;
+    dynNotchConfig_t cfg;
+    dynNotchGetDefaultConfig(&cfg);
+    cfg.max_hz = 600.0f;   // 超过 1kHz 陷波速率的 Nyquist
+    bool a = dynNotchInit(&dn, &cfg);
+    dynNotchGetDefaultConfig(&cfg);
+    cfg.count = 4;
+    bool b = dynNotchInit(&dn, &cfg);
+    CHECK(!a && !b && !dn.ready && dynNotchApply(&dn, 0, 1.5f) == 1.5f && !dynNotchUpdate(&dn),
+          "invalid config rejected, disabled instance passes through");
+}
+
+static void test_task_wiring(void)
+{
+    sil_board_init();
+    gyro_processing_init(DECIM);
+    gyro_filter_init(1000.0f, 400.0f, 450.0f);
+    dynNotchConfig_t cfg;
+    dynNotchGetDefaultConfig(&cfg);
+    cfg.count = 1;
+    bool ok = gyro_dyn_notch_init(&cfg);
+
+    tones_t t = { .f = { { 260.0f, 0 }, { 0, 0 }, { 0, 0 } }, .amp = 40.0f };
+    for (uint32_t i = 0; i < GYRO_HZ / 2U; i++) {
+        float g[3];
+        tones_sample(&t, i, g);
+        gyro_process_sample((int16_t)lrintf(g[0] * icm.gyro_scale), (int16_t)lrintf(g[1] * icm.gyro_scale),
+                            (int16_t)lrintf(g[2] * icm.gyro_scale));
+        if (gyro_decimated.ready) {
+            gyro_filter_feed_sample(gyro_decimated.dps_x, gyro_decimated.dps_y, gyro_decimated.dps_z);
+            gyro_dyn_notch_task(NULL);
+        }
+    }
+    const dynNotch_t *dn = gyro_dyn_notch();
+    CHECK(ok && dn && near(dn->center_hz[0][0], 260.0f, 6.0f),
+          "task_gyro feeds 8kHz pre-filter data, task slice tunes notch to %.1f Hz", dn ? dn->center_hz[0][0] : 0.0f);
+    gyro_dyn_notch_init(NULL);
+    CHECK(gyro_dyn_notch() == NULL, "gyro_dyn_notch_init(NULL) disables");
+}
+
+int main(void)
+{
+    test_rfft_matches_dft();
+    test_tracking();
+    test_attenuation();
+    test_invalid_config();
+    test_task_wiring();
+
+    return sil_test_report();
+}
@@ -0,0 +1,200 @@
+/**
+ * @file    test_filter_bank.c
+ * @brief   滤波器组主机测试：CMSIS-DSP 级联与标量 DF2T 参考逐位一致、各轴状态独立、PT1/PT2/PT3 与标量 PT1 等价、
+ *          陷波衰减、块处理与逐样本一致
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "filter_bank.h"
+#include "task_fliter.h"
+#include "sil_test.h"
+
+#define FS_HZ   1000.0f
+#define N       2000U
+
+// 可复现的宽带测试信号：多音 + 线性同余噪声
+static float test_signal(uint32_t i, uint8_t axis)
+{
+    static uint32_t lcg = 12345U;
+    lcg = lcg * 1664525U + 1013904223U;
+    const float noise = ((float)(lcg >> 8) / 16777216.0f - 0.5f) * 40.0f;
+    const float t = (float)i / FS_HZ;
+    return 200.0f * sinf(2.0f * 3.14159265f * (3.0f + axis) * t) +
+           50.0f * sinf(2.0f * 3.14159265f * 180.0f * t) + noise;
+}
+
+static void test_bit_exact_vs_scalar(void)
+{
+    const filterBankStage_t stages[] = {
+        { FILTER_BANK_PT1,   90.0f,  0.0f },
+        { FILTER_BANK_PT2,   150.0f, 0.0f },
+        { FILTER_BANK_LPF,   250.0f, 0.0f },
+        { FILTER_BANK_NOTCH, 140.0f, 180.0f },
+    };
+    static filterBank_t bank;
+    static filterBankScalar_t ref;
+    bool ok = filterBankInit(&bank, stages, 4, FS_HZ);
+    filterBankScalarInit(&ref, &bank);
+
+    static float in[FILTER_BANK_AXES][N], out[FILTER_BANK_AXES][N];
+    for (uint32_t i = 0; i < N; i++) {
+        for (uint8_t a = 0; a < FILTER_BANK_AXES; a++) {
+            in[a][i] = test_signal(i, a);
+        }
+    }
+
+    // 不同块长交替，验证跨块状态延续
+    const uint32_t blocks[] = { 1, 7, 32, 3, 16 };
+    for (uint8_t a = 0; a < FILTER_BANK_AXES; a++) {
+        uint32_t pos = 0, b = 0;
+        while (pos < N) {
+            uint32_t n = blocks[b++ % 5];
+            if (pos + n > N) n = N - pos;
+            filterBankProcess(&bank, a, &in[a][pos], &out[a][pos], n);
+            pos += n;
+        }
+    }
+
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < N; i++) {
+        for (uint8_t a = 0; a < FILTER_BANK_AXES; a++) {
+            const float r = filterBankScalarApply(&ref, a, in[a][i]);
+            if (memcmp(&r, &out[a][i], sizeof(float)) != 0) {
+                mismatches++;
+            }
+        }
+    }
+    CHECK(ok && bank.num_sections == 5 && mismatches == 0,
+          "CMSIS df2T cascade (%u sections, mixed block sizes) bit-exact vs scalar: %u mismatches",
+          bank.num_sections, mismatches);
+
+    // 与 filter.c 的 biquadFilterApply 只差舍入
+    biquadFilter_t bq[5];
+    for (uint8_t s = 0; s < 5; s++) {
+        const float *c = &bank.coeffs[5 * s];
+        bq[s] = (biquadFilter_t){ .b0 = c[0], .b1 = c[1], .b2 = c[2], .a1 = -c[3], .a2 = -c[4], .weight = 1.0f };
+    }
+    float max_err = 0.0f;
+    for (uint32_t i = 0; i < N; i++) {
+        float y = in[0][i];
+        for (uint8_t s = 0; s < 5; s++) {
+            y = biquadFilterApply(&bq[s], y);
+        }
+        const float e = fabsf(y - out[0][i]);
+        if (e > max_err) max_err = e;
+    }
+    CHECK(max_err < 1e-3f, "biquadFilterApply cascade agrees to rounding (max err %.2e dps)", max_err);
+}
+
+static void test_axes_independent(void)
+{
+    // 旧实现三轴共用一个 PT1 状态：单轴输入被衰减约一半
+    const filterBankStage_t stages[] = { { FILTER_BANK_PT1, 100.0f, 0.0f } };
+    static filterBank_t bank;
+    filterBankInit(&bank, stages, 1, FS_HZ);
+
+    pt1Filter_t pt1;
+    pt1FilterInit(&pt1, pt1FilterGain(100.0f, 1.0f / FS_HZ));
+
+    float out[3] = { 0 };
+    float max_err = 0.0f;
+    for (uint32_t i = 0; i < 500; i++) {
+        const float in[3] = { 100.0f, 0.0f, -30.0f };
+        filterBankApply(&bank, in, out);
+        const float e = fabsf(out[0] - pt1FilterApply(&pt1, 100.0f));
+        if (e > max_err) max_err = e;
+    }
+    CHECK(fabsf(out[0] - 100.0f) < 1e-3f && fabsf(out[1]) < 1e-6f && fabsf(out[2] + 30.0f) < 1e-3f,
+          "per-axis state: steady state (%.3f, %.3f, %.3f)", out[0], out[1], out[2]);
+    CHECK(max_err < 1e-3f, "PT1 section matches pt1FilterApply (max err %.2e)", max_err);
+}
+
+// 正弦稳态幅值
+static float gain_at(filterBank_t *bank, float f_hz)
+{
+    filterBankReset(bank);
+    float peak = 0.0f;
+    for (uint32_t i = 0; i < 4000; i++) {
+        float x = sinf(2.0f * 3.14159265f * f_hz * (float)i / FS_HZ);
+        float y;
+        filterBankProcess(bank, 0, &x, &y, 1);
+        if (i > 3000 && fabsf(y) > peak) peak = fabsf(y);
+    }
+    return peak;
+}
+
+static void test_responses(void)
+{
+    static filterBank_t bank;
+    // pt1FilterGain 是 ω/(ω+1) 近似，截止频率远低于采样率时才准确
+    const filterBankStage_t pt2[] = { { FILTER_BANK_PT2, 20.0f, 0.0f } };
+    const filterBankStage_t pt3[] = { { FILTER_BANK_PT3, 20.0f, 0.0f } };
+    const filterBankStage_t notch[] = { { FILTER_BANK_NOTCH, 150.0f, 200.0f } };
+
+    filterBankInit(&bank, pt2, 1, FS_HZ);
+    const float g2 = gain_at(&bank, 20.0f);
+    filterBankInit(&bank, pt3, 1, FS_HZ);
+    const float g3 = gain_at(&bank, 20.0f);
+    CHECK(bank.num_sections == 3 && fabsf(g2 - 0.707f) < 0.08f && fabsf(g3 - 0.707f) < 0.08f,
+          "PT2/PT3 cutoff corrected: |H(20Hz)| = %.3f / %.3f", g2, g3);
+
+    filterBankInit(&bank, notch, 1, FS_HZ);
+    const float gn = gain_at(&bank, 200.0f);
+    const float gp = gain_at(&bank, 20.0f);
+    CHECK(gn < 0.05f && gp > 0.95f, "notch 200Hz: |H(200)|=%.4f |H(20)|=%.3f", gn, gp);
+
+    bool ok = filterBankUpdateNotch(&bank, 0, 300.0f, 220.0f);
+    const float gm = gain_at(&bank, 300.0f);
+    CHECK(ok && gm < 0.05f, "notch retuned to 300Hz: |H(300)|=%.4f", gm);
+}
+
+static void test_invalid_config(void)
+{
+    static filterBank_t bank;
+    filterBankStage_t too_many[4];
+    for (int i = 0; i < 4; i++) {
+        too_many[i] = (filterBankStage_t){ FILTER_BANK_PT3, 100.0f, 0.0f };
+    }
+    const filterBankStage_t above_nyquist[] = { { FILTER_BANK_LPF, 600.0f, 0.0f } };
+    const filterBankStage_t bad_notch[] = { { FILTER_BANK_NOTCH, 300.0f, 200.0f } };
+    CHECK(!filterBankInit(&bank, too_many, 4, FS_HZ) && !filterBankInit(&bank, above_nyquist, 1, FS_HZ) &&
+          !filterBankInit(&bank, bad_notch, 1, FS_HZ) && bank.num_sections == 0,
+          "rejects >%d sections, cutoff above Nyquist, notch cutoff above centre", FILTER_BANK_MAX_SECTIONS);
+}
+
+static void test_task_filter_block(void)
+{
+    static float x[64], y[64], z[64], ox[64], oy[64], oz[64];
+    for (int i = 0; i < 64; i++) {
+        x[i] = test_signal((uint32_t)i, 0);
+        y[i] = test_signal((uint32_t)i, 1);
+        z[i] = test_signal((uint32_t)i, 2);
+    }
+
+    gyro_filter_init(FS_HZ, 100.0f, 300.0f);
+    float sx[64];
+    for (int i = 0; i < 64; i++) {
+        gyro_filter_feed_sample(x[i], y[i], z[i]);
+        sx[i] = gyro_filtered.dps_x;
+    }
+    const float last_z = gyro_filtered.dps_z;
+
+    gyro_filter_init(FS_HZ, 100.0f, 300.0f);
+    bool ok = gyro_filter_feed_block(x, y, z, ox, oy, oz, 32);
+    ok = ok && gyro_filter_feed_block(&x[32], &y[32], &z[32], &ox[32], &oy[32], &oz[32], 32);
+    CHECK(ok && memcmp(sx, ox, sizeof(sx)) == 0 && gyro_filtered.dps_z == last_z,
+          "gyro_filter_feed_block == per-sample gyro_filter_feed_sample");
+}
+
+int main(void)
+{
+    test_bit_exact_vs_scalar();
+    test_axes_independent();
+    test_responses();
+    test_invalid_config();
+    test_task_filter_block();
+
+    return sil_test_report();
+}
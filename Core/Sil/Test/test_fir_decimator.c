@@ -0,0 +1,212 @@
+/**
+ * @file    test_fir_decimator.c
+ * @brief   SIL 测试：8kHz 陀螺多相 FIR 降采样（fir_decimator）
+ * @note    对 2/4/8 三种降采样比分别用正弦激励实测：通带增益、群延迟（拟合输出相位）
+ *          与混叠抑制（折叠到 0..fp 的频带 k*fout ± fp 上的最坏增益），并与同比值的方波平均对比；
+ *          浮点版本与整数 Q15 版本（int16 计数输入）分别测量；
+ *          另检查恒定输入预置无启动瞬态，以及 gyro_process_sample 的 FIR 路径与模块直接输出一致。
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "sil_board.h"
+#include "fir_decimator.h"
+#include "task_gyro.h"
+#include "icm42688p_lib.h"
+#include "sil_test.h"
+
+#define FS_HZ           8000.0
+#define PI              3.14159265358979323846
+#define SETTLE_OUT      16          // 丢弃的输出数（覆盖滤波器长度与预置瞬态）
+#define MEASURE_IN      8000        // 每个频点的输入样本数（1 s）
+#define Q15_AMPLITUDE   16000.0     // Q15 版本的输入幅值（计数）
+
+typedef enum {
+    RUN_FIR = 0,
+    RUN_FIR_Q15,
+    RUN_BOXCAR,                     // 同比值的方波平均（对比用）
+} run_mode_t;
+
+typedef struct {
+    double gain;                    // 输出在 f_out_hz 处的幅值 / 输入幅值
+    double delay;                   // 相对输入的延迟（输入样本）
+} tone_resp_t;
+
+/**
+ * @brief 单频激励，最小二乘拟合输出在 f_out_hz（混叠后的频率）处的幅值与相位
+ */
+static tone_resp_t tone(uint8_t ratio, double f_in_hz, double f_out_hz, run_mode_t mode)
+{
+    firDecimator_t dec;
+    firDecimatorQ15_t dec_q;
+    firDecimatorInit(&dec, ratio);
+    firDecimatorQ15Init(&dec_q, ratio);
+
+    const double w_in = 2.0 * PI * f_in_hz / FS_HZ;
+    const double w_out = 2.0 * PI * f_out_hz / FS_HZ;
+    double ss = 0.0, sc = 0.0, cc = 0.0, ys = 0.0, yc = 0.0;
+    float box = 0.0f;
+    int outputs = 0;
+
+    for (int n = 0; n < MEASURE_IN + SETTLE_OUT * ratio; n++) {
+        const float x = (float)sin(w_in * n);
+        const float in[3] = { x, -x, 0.5f * x };
+        float out[3];
+        bool ready;
+        if (mode == RUN_BOXCAR) {
+            box += x;
+            ready = (n % ratio) == ratio - 1;
+            out[0] = box / (float)ratio;
+            if (ready) box = 0.0f;
+        } else if (mode == RUN_FIR_Q15) {
+            const int16_t in_q[3] = { (int16_t)lrint(x * Q15_AMPLITUDE), 0, 0 };
+            int32_t out_q[3];
+            ready = firDecimatorQ15Apply(&dec_q, in_q, out_q);
+            out[0] = (float)((double)out_q[0] / (32768.0 * Q15_AMPLITUDE));
+        } else {
+            ready = firDecimatorApply(&dec, in, out);
+        }
+        if (!ready || outputs++ < SETTLE_OUT) {
+            continue;
+        }
+        // 输出样本对齐到产生它的最后一个输入样本 n
+        const double s = sin(w_out * n), c = cos(w_out * n);
+        ss += s * s; sc += s * c; cc += c * c;
+        ys += out[0] * s; yc += out[0] * c;
+    }
+
+    // y ≈ S*sin(wn) + C*cos(wn) = g*sin(w(n - d))
+    const double det = ss * cc - sc * sc;
+    const double S = (ys * cc - yc * sc) / det;
+    const double C = (yc * ss - ys * sc) / det;
+    tone_resp_t r;
+    r.gain = sqrt(S * S + C * C);
+    r.delay = atan2(-C, S) / w_out;
+    return r;
+}
+
+static double db(double g) { return 20.0 * log10(g); }
+
+static void test_ratio(uint8_t ratio)
+{
+    firDecimator_t dec;
+    const bool ok = firDecimatorInit(&dec, ratio);
+    const firDecimatorDesign_t *design = dec.design;
+    CHECK(ok && design && design->phase_taps <= FIR_DECIMATOR_MAX_PHASE_TAPS,
+          "%u:1 design: %u taps, %u per input sample and axis",
+          ratio, design ? design->phase_taps * ratio : 0, design ? design->phase_taps : 0);
+    if (!ok) return;
+
+    const double fout = FS_HZ / ratio;
+    const double fp = design->passband_hz;
+
+    // 通带与群延迟：线性相位 FIR 的延迟与频率无关
+    const double expect_delay = firDecimatorGroupDelay(&dec);
+    double pb_min = 0.0, delay_err = 0.0, delay_fp = 0.0;
+    for (int i = 1; i <= 4; i++) {
+        const double f = fp * i / 4.0;
+        const tone_resp_t r = tone(ratio, f, f, RUN_FIR);
+        if (db(r.gain) < pb_min) pb_min = db(r.gain);
+        if (fabs(r.delay - expect_delay) > delay_err) delay_err = fabs(r.delay - expect_delay);
+        delay_fp = r.delay;
+    }
+    const tone_resp_t box_pb = tone(ratio, fp, fp, RUN_BOXCAR);
+    CHECK(pb_min > -0.7, "%u:1 passband gain >= %.2f dB up to %.0f Hz (boxcar %.2f dB)",
+          ratio, pb_min, fp, db(box_pb.gain));
+    CHECK(delay_err < 0.05, "%u:1 group delay at %.0f Hz %.3f samples = %.3f ms (design %.1f, max error %.3f)",
+          ratio, fp, delay_fp, delay_fp / FS_HZ * 1e3, expect_delay, delay_err);
+
+    // 混叠：k*fout ± f（f 在 0..fp）折叠到 f
+    double fir_worst = 0.0, q15_worst = 0.0, box_worst = 0.0;
+    for (int k = 1; k <= ratio / 2; k++) {
+        for (int i = 1; i <= 4; i++) {
+            const double f = fp * i / 4.0;
+            for (int sgn = -1; sgn <= 1; sgn += 2) {
+                const double f_in = k * fout + sgn * f;
+                if (f_in >= FS_HZ / 2.0) continue;
+                const double g_fir = tone(ratio, f_in, f, RUN_FIR).gain;
+                const double g_q15 = tone(ratio, f_in, f, RUN_FIR_Q15).gain;
+                const double g_box = tone(ratio, f_in, f, RUN_BOXCAR).gain;
+                if (g_fir > fir_worst) fir_worst = g_fir;
+                if (g_q15 > q15_worst) q15_worst = g_q15;
+                if (g_box > box_worst) box_worst = g_box;
+            }
+        }
+    }
+    CHECK(db(fir_worst) < -45.0 && db(q15_worst) < -45.0 && db(box_worst) > -15.0,
+          "%u:1 alias rejection %.1f dB, Q15 %.1f dB (boxcar %.1f dB)",
+          ratio, db(fir_worst), db(q15_worst), db(box_worst));
+
+    // Q15 版本：通带增益与延迟与浮点版本一致
+    const tone_resp_t q_pb = tone(ratio, fp, fp, RUN_FIR_Q15);
+    const tone_resp_t f_pb = tone(ratio, fp, fp, RUN_FIR);
+    CHECK(fabs(db(q_pb.gain) - db(f_pb.gain)) < 0.01 && fabs(q_pb.delay - expect_delay) < 0.05,
+          "%u:1 Q15 at %.0f Hz: gain %.3f dB (float %.3f dB), delay %.3f samples",
+          ratio, fp, db(q_pb.gain), db(f_pb.gain), q_pb.delay);
+}
+
+static void test_prime_and_ratios(void)
+{
+    firDecimator_t dec;
+    const float in[3] = { 12.5f, -3.0f, 250.0f };
+    float out[3];
+    float worst = 0.0f;
+    firDecimatorInit(&dec, 8);
+    for (int n = 0; n < 64; n++) {
+        if (firDecimatorApply(&dec, in, out)) {
+            for (int a = 0; a < 3; a++) {
+                const float e = fabsf(out[a] - in[a]);
+                if (e > worst) worst = e;
+            }
+        }
+    }
+    CHECK(worst < 1e-3f, "constant input primes the history: no start-up transient (max error %.2e)",
+          (double)worst);
+
+    CHECK(!firDecimatorInit(&dec, 3) && !firDecimatorInit(&dec, 1) && firDecimatorDesign(16) == NULL,
+          "ratios without a coefficient table rejected");
+}
+
+static void test_gyro_path(void)
+{
+    sil_board_init();
+    gyro_processing_init(8);
+    CHECK(fabsf(gyro_processing_group_delay() - 15.5f) < 1e-6f, "gyro_processing 8:1 group delay %.1f samples",
+          (double)gyro_processing_group_delay());
+
+    // 陀螺仪路径用整数 Q15 版本，输出时乘以 1/刻度
+    firDecimatorQ15_t ref;
+    firDecimatorQ15Init(&ref, 8);
+    const float k = (1.0f / icm.gyro_scale) * (1.0f / 32768.0f);
+    int outputs = 0, mismatches = 0;
+    for (int n = 0; n < 800; n++) {
+        const int16_t raw = (int16_t)(2000.0 * sin(2.0 * PI * 170.0 * n / FS_HZ));
+        const int16_t in[3] = { raw, 0, (int16_t)-raw };
+        int32_t out[3];
+        gyro_process_sample(raw, 0, (int16_t)-raw);
+        const bool ready = firDecimatorQ15Apply(&ref, in, out);
+        if (ready != gyro_decimated.ready) {
+            mismatches++;
+        } else if (ready) {
+            outputs++;
+            if (gyro_decimated.dps_x != (float)out[0] * k || gyro_decimated.dps_z != (float)out[2] * k) mismatches++;
+        }
+    }
+    CHECK(outputs == 100 && mismatches == 0, "gyro_process_sample 8:1 uses the Q15 FIR (%d outputs, %d mismatches)",
+          outputs, mismatches);
+
+    gyro_processing_init(3);
+    CHECK(fabsf(gyro_processing_group_delay() - 1.0f) < 1e-6f, "ratio without a table falls back to boxcar");
+}
+
+int main(void)
+{
+    test_ratio(2);
+    test_ratio(4);
+    test_ratio(8);
+    test_prime_and_ratios();
+    test_gyro_path();
+
+    return sil_test_report();
+}
@@ -0,0 +1,291 @@
+/**
+ * @file    test_gyro_cal.c
+ * @brief   SIL 测试：陀螺仪在线零偏估计（gyro_cal）
+ * @note    8kHz 原始样本走 gyro_process_sample，调度器任务按 gyro_cal_should_run 执行。
+ *          检查：静止 0.5s 内得到零偏且误差 < 1 计数（不阻塞）；运动、解锁期间不接受窗口；
+ *          温度扫描后拟合出二次模型，预测误差小；解锁飞行中温度变化时零偏按模型跟随；
+ *          导出/导入往返（CRC 损坏被拒绝），导入后首块即按模型给出零偏；
+ *          Flash 配置扇区：拟合变化且空闲时保存、"重启"后载入、最新记录损坏时退回上一条、写满擦除；
+ *          块溢出计数；无效参数。
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "sil_board.h"
+#include "gyro_cal.h"
+#include "bsp_flash.h"
+#include "task_gyro.h"
+#include "icm42688p_lib.h"
+#include "sil_test.h"
+
+#define PI          3.14159265358979323846
+#define ODR_HZ      8000
+
+static uint32_t rng = 0x13579BDFU;
+
+static uint32_t rand_u32(void)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+// 近似高斯噪声（4 个均匀分布之和），标准差约 sigma
+static double noise(double sigma)
+{
+    double s = 0.0;
+    for (int i = 0; i < 4; i++) s += (double)rand_u32() / 4294967296.0 - 0.5;
+    return s * sigma * 1.7320508;
+}
+
+// 真实零偏（°/s）：各轴不同的二次温度曲线
+static void true_bias(double temp_c, double out[3])
+{
+    const double x = temp_c - 25.0;
+    out[0] = 0.8 + 0.020 * x + 0.0008 * x * x;
+    out[1] = -1.5 - 0.035 * x + 0.0003 * x * x;
+    out[2] = 2.2 + 0.010 * x - 0.0005 * x * x;
+}
+
+static uint32_t sample_n = 0;
+
+/**
+ * @brief 以 8kHz 运行 n 个样本：零偏 + 噪声 + 可选正弦运动，按需执行调度器任务
+ */
+static void run(uint32_t n, double temp_c, double motion_dps)
+{
+    gyro_cal_set_temperature((float)temp_c);
+    double b[3];
+    true_bias(temp_c, b);
+    for (uint32_t i = 0; i < n; i++, sample_n++) {
+        const double t = (double)sample_n / ODR_HZ;
+        int16_t raw[3];
+        for (int a = 0; a < 3; a++) {
+            const double dps = b[a] + noise(0.3) + motion_dps * sin(2.0 * PI * (5.0 + a) * t);
+            raw[a] = (int16_t)lrint(dps * icm.gyro_scale);
+        }
+        gyro_process_sample(raw[0], raw[1], raw[2]);
+        if (gyro_cal_should_run(NULL)) {
+            gyro_cal_task(NULL);
+        }
+    }
+}
+
+static double offset_error_counts(double temp_c)
+{
+    double b[3], worst = 0.0;
+    true_bias(temp_c, b);
+    for (int a = 0; a < 3; a++) {
+        worst = fmax(worst, fabs(icm.gyro_offset[a] - b[a] * icm.gyro_scale));
+    }
+    return worst;
+}
+
+static void test_boot(void)
+{
+    gyro_cal_status_t st;
+    CHECK(gyro_cal_init(NULL) && !gyro_cal_is_ready(), "init: no bias before the first still window");
+
+    run(3999, 30.0, 0.0);
+    gyro_cal_get_status(&st);
+    CHECK(st.state == GYRO_CAL_STATE_WAIT_STILL && icm.gyro_offset[0] == 0, "not ready after 7.9 blocks");
+
+    run(1, 30.0, 0.0);
+    gyro_cal_get_status(&st);
+    const double err = offset_error_counts(30.0);
+    CHECK(st.state == GYRO_CAL_STATE_READY && st.windows == 1 && err < 1.0,
+          "bias after 0.5s of stillness without blocking, error %.2f counts", err);
+
+    run(800, 30.0, 0.0);
+    CHECK(gyro_decimated.ready && fabsf(gyro_decimated.dps_x) < 0.3f && fabsf(gyro_decimated.dps_z) < 0.3f,
+          "compensated gyro near zero (%.3f, %.3f, %.3f dps)", (double)gyro_decimated.dps_x,
+          (double)gyro_decimated.dps_y, (double)gyro_decimated.dps_z);
+}
+
+static void test_rejects(void)
+{
+    gyro_cal_status_t st;
+    gyro_cal_get_status(&st);
+    const uint32_t windows = st.windows;
+    const int16_t before = icm.gyro_offset[1];
+
+    run(ODR_HZ * 2, 30.0, 30.0);
+    gyro_cal_get_status(&st);
+    CHECK(st.windows == windows && icm.gyro_offset[1] == before, "motion (30 dps) never accepted as still");
+
+    gyro_cal_set_idle(false);
+    run(ODR_HZ * 2, 30.0, 0.0);
+    gyro_cal_get_status(&st);
+    CHECK(st.windows == windows, "no new windows while armed");
+    gyro_cal_set_idle(true);
+}
+
+static void test_temperature_model(void)
+{
+    // 空闲静止升温 5 -> 55°C，每 2°C 停留 0.75s
+    for (double temp = 5.0; temp <= 55.0; temp += 2.0) {
+        run(ODR_HZ * 3 / 4, temp, 0.0);
+    }
+    gyro_cal_status_t st;
+    gyro_cal_get_status(&st);
+
+    double worst = 0.0;
+    for (double temp = 5.0; temp <= 55.0; temp += 1.0) {
+        float p[3];
+        double b[3];
+        gyro_cal_predict((float)temp, p);
+        true_bias(temp, b);
+        for (int a = 0; a < 3; a++) worst = fmax(worst, fabs(p[a] - b[a]));
+    }
+    CHECK(st.model_order == 2 && st.bins_used >= 12 && worst < 0.05,
+          "quadratic model from %u bins, worst prediction error %.3f dps over 5..55C", st.bins_used, worst);
+
+    // 解锁飞行中从 20°C 升到 50°C：不接受窗口，零偏按模型跟随
+    run(ODR_HZ / 2, 20.0, 0.0);
+    gyro_cal_set_idle(false);
+    double fixed = 0.0, tracked = 0.0;
+    double b20[3];
+    true_bias(20.0, b20);
+    for (double temp = 20.0; temp <= 50.0; temp += 2.0) {
+        run(ODR_HZ / 4, temp, 50.0);
+        double b[3];
+        true_bias(temp, b);
+        for (int a = 0; a < 3; a++) fixed = fmax(fixed, fabs(b[a] - b20[a]) * icm.gyro_scale);
+        tracked = fmax(tracked, offset_error_counts(temp));
+    }
+    gyro_cal_set_idle(true);
+    CHECK(tracked < 1.5 && fixed > 10.0,
+          "armed warm-up tracked within %.2f counts (fixed offset would drift %.1f counts)", tracked, fixed);
+}
+
+static void test_persistence(void)
+{
+    gyro_cal_store_t store;
+    CHECK(gyro_cal_model_changed(), "model marked changed after learning");
+    gyro_cal_export(&store);
+    CHECK(!gyro_cal_model_changed(), "export clears the changed flag");
+
+    gyro_cal_store_t bad = store;
+    bad.bin[3].bias_dps[1] += 0.5f;
+    gyro_cal_init(NULL);
+    CHECK(!gyro_cal_import(&bad) && !gyro_cal_is_ready(), "corrupted store rejected (CRC)");
+
+    icm.gyro_offset[0] = icm.gyro_offset[1] = icm.gyro_offset[2] = 0;
+    CHECK(gyro_cal_import(&store), "store imported");
+    gyro_cal_status_t st;
+    gyro_cal_get_status(&st);
+    CHECK(st.state == GYRO_CAL_STATE_MODEL && st.model_order == 2, "import -> MODEL state, quadratic model");
+
+    // 冷启动、一直在动：第一块（62.5ms）就按模型给出零偏
+    run(500, 12.0, 30.0);
+    const double err = offset_error_counts(12.0);
+    CHECK(gyro_cal_is_ready() && err < 1.5, "boot from stored model: first block gives bias, error %.2f counts", err);
+}
+
+// 按调度器的方式轮询保存任务
+static uint32_t poll_save(void)
+{
+    if (!gyro_cal_save_should_run(NULL)) return 0;
+    gyro_cal_save_task(NULL);
+    return 1;
+}
+
+static void test_flash_store(void)
+{
+    const uint32_t slots = BSP_FLASH_CONFIG_SIZE / sizeof(gyro_cal_store_t);
+    gyro_cal_status_t st;
+
+    sil_flash_config_reset();
+    gyro_cal_init(NULL);
+    CHECK(!gyro_cal_load() && !gyro_cal_is_ready(), "blank config sector: nothing loaded");
+
+    run(ODR_HZ / 2, 30.0, 0.0);
+    CHECK(gyro_cal_save_should_run(NULL), "first still window changes the fit -> save due");
+    gyro_cal_set_idle(false);
+    CHECK(!gyro_cal_save_should_run(NULL), "no save while armed");
+    gyro_cal_set_idle(true);
+    uint32_t saves = poll_save();
+    CHECK(saves == 1 && !gyro_cal_save_should_run(NULL), "saved once, nothing pending");
+
+    // 空闲升温：新分箱/升阶时保存，同一拟合内的细化不重复写
+    for (double temp = 10.0; temp <= 50.0; temp += 2.0) {
+        run(ODR_HZ * 3 / 4, temp, 0.0);
+        saves += poll_save();
+    }
+    gyro_cal_get_status(&st);
+    const uint8_t bins = st.bins_used;
+    CHECK(st.model_order == 2 && saves > 2 && saves <= (uint32_t)bins + 2,
+          "%lu saves for %u bins (only when the fit changes)", (unsigned long)saves, bins);
+
+    // 拟合未变的细化：保存间隔到了才写
+    run(ODR_HZ, 50.0, 0.0);
+    CHECK(gyro_cal_model_changed() && !gyro_cal_save_should_run(NULL), "refinement alone waits for the save interval");
+    for (uint32_t s = 0; s < GYRO_CAL_SAVE_INTERVAL_MS / 1000U; s++) sil_time_advance_us(1000000U);
+    saves += poll_save();
+    CHECK(!gyro_cal_model_changed(), "refinement saved after %u s", GYRO_CAL_SAVE_INTERVAL_MS / 1000U);
+    float before[3], after[3];
+    gyro_cal_predict(40.0f, before);
+
+    // "重启"：温度表只来自 Flash
+    gyro_cal_init(NULL);
+    icm.gyro_offset[0] = icm.gyro_offset[1] = icm.gyro_offset[2] = 0;
+    CHECK(gyro_cal_load(), "model loaded after reboot");
+    gyro_cal_get_status(&st);
+    gyro_cal_predict(40.0f, after);
+    CHECK(st.state == GYRO_CAL_STATE_MODEL && st.bins_used == bins &&
+          memcmp(before, after, sizeof(before)) == 0, "reboot restores the same %u-bin model", st.bins_used);
+    run(500, 15.0, 30.0);
+    const double err = offset_error_counts(15.0);
+    CHECK(gyro_cal_is_ready() && err < 1.5, "first block after reboot uses the stored model, error %.2f counts", err);
+
+    // 最新记录掉电写坏（清掉 CRC 的位）：退回上一条
+    const uint32_t zero = 0;
+    BSP_Flash_ConfigWrite((saves - 1) * sizeof(gyro_cal_store_t) + offsetof(gyro_cal_store_t, crc), &zero, 4);
+    gyro_cal_init(NULL);
+    CHECK(gyro_cal_load(), "falls back to the previous record");
+    gyro_cal_get_status(&st);
+    CHECK(st.bins_used > 0 && st.bins_used <= bins, "previous record has %u bins", st.bins_used);
+
+    // 其余空槽被占（无效数据）：保存时跳过，到扇区末尾后擦除重写
+    for (uint32_t i = saves; i < slots; i++) {
+        BSP_Flash_ConfigWrite(i * sizeof(gyro_cal_store_t), &zero, 4);
+    }
+    CHECK(gyro_cal_save() && sil_flash_config_erase_count() == 1, "full sector erased once, record rewritten");
+    gyro_cal_init(NULL);
+    CHECK(gyro_cal_load(), "record at slot 0 loads after the erase");
+}
+
+static void test_overrun_and_config(void)
+{
+    gyro_cal_init(NULL);
+    const int16_t raw[3] = { 1, 2, 3 };
+    for (int i = 0; i < 1000; i++) gyro_cal_push_sample(raw);
+    gyro_cal_status_t st;
+    gyro_cal_get_status(&st);
+    CHECK(st.overruns == 1 && gyro_cal_should_run(NULL), "second block dropped while the first is pending");
+
+    const gyro_cal_config_t bad = { .block_samples = 0, .window_blocks = 8, .still_std_dps = 2.0f,
+                                    .still_drift_dps = 0.3f, .track_alpha = 0.25f };
+    CHECK(!gyro_cal_init(&bad), "invalid config rejected");
+
+    gyro_cal_stop();
+    CHECK(!gyro_cal_should_run(NULL), "stopped");
+}
+
+int main(void)
+{
+    sil_board_init();
+    icm.gyro_offset[0] = icm.gyro_offset[1] = icm.gyro_offset[2] = 0;
+    gyro_processing_init(8);
+
+    test_boot();
+    test_rejects();
+    test_temperature_model();
+    test_persistence();
+    test_flash_store();
+    test_overrun_and_config();
+
+    return sil_test_report();
+}
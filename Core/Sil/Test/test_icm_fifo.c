@@ -0,0 +1,360 @@
+/**
+ * @file    test_icm_fifo.c
+ * @brief   ICM42688P 硬件 FIFO 主机测试：packet 3/4 解析、时间戳展开、空包/尾包、寄存器配置、批量降采样
+ * @note    用假寄存器文件 + 字节队列模拟 FIFO_COUNT/FIFO_DATA，测试代码扮演传感器。
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "sil_board.h"
+#include "icm42688p_lib.h"
+#include "task_gyro.h"
+#include "fir_decimator.h"
+#include "sil_test.h"
+
+// ---------------------------------------------------------------------------
+// 数据包构造
+// ---------------------------------------------------------------------------
+
+static void put_be16(uint8_t *p, int16_t v)
+{
+    p[0] = (uint8_t)((uint16_t)v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+static uint16_t make_packet3(uint8_t *p, const int16_t a[3], const int16_t g[3], int8_t temp, uint16_t ts)
+{
+    p[0] = ICM42688P_FIFO_HEADER_ACCEL | ICM42688P_FIFO_HEADER_GYRO | ICM42688P_FIFO_HEADER_TMST_ODR;
+    for (int i = 0; i < 3; i++) {
+        put_be16(&p[1 + 2 * i], a[i]);
+        put_be16(&p[7 + 2 * i], g[i]);
+    }
+    p[13] = (uint8_t)temp;
+    put_be16(&p[14], (int16_t)ts);
+    return ICM42688P_FIFO_PACKET3_SIZE;
+}
+
+// 20 位数据：高 16 位在数据字段，低 4 位在扩展字节
+static uint16_t make_packet4(uint8_t *p, const int32_t a[3], const int32_t g[3], int16_t temp, uint16_t ts)
+{
+    p[0] = ICM42688P_FIFO_HEADER_ACCEL | ICM42688P_FIFO_HEADER_GYRO | ICM42688P_FIFO_HEADER_20 |
+           ICM42688P_FIFO_HEADER_TMST_ODR;
+    for (int i = 0; i < 3; i++) {
+        put_be16(&p[1 + 2 * i], (int16_t)(a[i] >> 4));
+        put_be16(&p[7 + 2 * i], (int16_t)(g[i] >> 4));
+        p[17 + i] = (uint8_t)(((a[i] & 0x0F) << 4) | (g[i] & 0x0F));
+    }
+    put_be16(&p[13], temp);
+    put_be16(&p[15], (int16_t)ts);
+    return ICM42688P_FIFO_PACKET4_SIZE;
+}
+
+// ---------------------------------------------------------------------------
+// 假设备：寄存器文件 + FIFO 字节队列
+// ---------------------------------------------------------------------------
+
+static struct {
+    uint8_t  regs[256];
+    uint8_t  fifo[ICM42688P_FIFO_SIZE * 2];
+    uint16_t fifo_len;
+    uint32_t data_bursts;
+    uint16_t last_burst_len;
+    bool     flushed;
+} fake;
+
+static uint8_t fake_read_reg(uint8_t reg)
+{
+    return fake.regs[reg];
+}
+
+static void fake_write_reg(uint8_t reg, uint8_t value)
+{
+    fake.regs[reg] = value;
+    if (reg == ICM42688P_REG_SIGNAL_PATH_RESET && (value & ICM42688P_FIFO_FLUSH)) {
+        fake.fifo_len = 0;
+        fake.flushed = true;
+    }
+}
+
+static void fake_read_burst(uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    if (reg == ICM42688P_REG_FIFO_COUNTH) {
+        buf[0] = (uint8_t)(fake.fifo_len >> 8);
+        buf[1] = (uint8_t)fake.fifo_len;
+        return;
+    }
+    if (reg == ICM42688P_REG_FIFO_DATA) {
+        fake.data_bursts++;
+        fake.last_burst_len = len;
+        for (uint16_t i = 0; i < len; i++) {
+            buf[i] = (i < fake.fifo_len) ? fake.fifo[i] : 0xFF;   // 读空时返回无效头
+        }
+        uint16_t n = (len < fake.fifo_len) ? len : fake.fifo_len;
+        memmove(fake.fifo, &fake.fifo[n], fake.fifo_len - n);
+        fake.fifo_len = (uint16_t)(fake.fifo_len - n);
+        return;
+    }
+    memcpy(buf, &fake.regs[reg], len);
+}
+
+static void fake_delay(uint32_t ms)
+{
+    (void)ms;
+}
+
+static void fake_dev(icm42688p_dev_t *dev)
+{
+    memset(&fake, 0, sizeof(fake));
+    memset(dev, 0, sizeof(*dev));
+    dev->spi_read_reg   = fake_read_reg;
+    dev->spi_write_reg  = fake_write_reg;
+    dev->spi_read_burst = fake_read_burst;
+    dev->delay_ms       = fake_delay;
+    dev->gyro_scale     = 16.4f;
+    dev->accel_scale    = 16384.0f;
+}
+
+// ---------------------------------------------------------------------------
+
+static void test_parse_packet3(void)
+{
+    icm42688p_fifo_state_t st = { .packet_size = ICM42688P_FIFO_PACKET3_SIZE, .tmst_res_us = 1 };
+    uint8_t buf[64];
+    const int16_t a[3] = { 100, -200, 2048 };
+    const int16_t g[3] = { -1640, 0, 32767 };
+    uint16_t len = make_packet3(buf, a, g, 21, 1000);      // 21/2.07+25 = 35.1°C
+    len += make_packet3(&buf[len], a, g, 21, 1125);
+
+    icm42688p_fifo_sample_t s[4];
+    uint16_t consumed = 0;
+    uint16_t n = icm42688p_fifo_parse(&st, buf, len, s, 4, &consumed);
+    CHECK(n == 2 && consumed == 32, "packet 3: 2 samples, %u bytes consumed", consumed);
+    CHECK(s[0].gyro[0] == -1640 && s[0].gyro[2] == 32767 && s[0].accel[1] == -200 && s[0].accel[2] == 2048 &&
+          s[0].gyro_valid && s[0].accel_valid,
+          "packet 3: fields decoded g=(%d,%d,%d) a=(%d,%d,%d)",
+          s[0].gyro[0], s[0].gyro[1], s[0].gyro[2], s[0].accel[0], s[0].accel[1], s[0].accel[2]);
+    CHECK(s[0].temp_c > 35.0f && s[0].temp_c < 35.2f, "packet 3: temp8 %.2f C", s[0].temp_c);
+    CHECK(s[0].timestamp_valid && s[0].timestamp_us == 1000 && s[1].timestamp_us == 1125,
+          "packet 3: timestamps %u, %u us", s[0].timestamp_us, s[1].timestamp_us);
+}
+
+static void test_parse_packet4(void)
+{
+    icm42688p_fifo_state_t st = { .packet_size = ICM42688P_FIFO_PACKET4_SIZE, .tmst_res_us = 1 };
+    uint8_t buf[32];
+    const int32_t a[3] = { 8192, -8193, 16 };       // 8192 LSB/g
+    const int32_t g[3] = { 13100, -131, -262000 };  // 131 LSB/dps
+    uint16_t len = make_packet4(buf, a, g, 1325, 7);   // 1325/132.48+25 = 35.0°C
+
+    icm42688p_fifo_sample_t s;
+    uint16_t n = icm42688p_fifo_parse(&st, buf, len, &s, 1, NULL);
+    CHECK(n == 1 && s.accel_hr[0] == 8192 && s.accel_hr[1] == -8193 && s.gyro_hr[0] == 13100 &&
+          s.gyro_hr[1] == -131 && s.gyro_hr[2] == -262000,
+          "packet 4: 20-bit reassembly a=(%d,%d,%d) g=(%d,%d,%d)",
+          s.accel_hr[0], s.accel_hr[1], s.accel_hr[2], s.gyro_hr[0], s.gyro_hr[1], s.gyro_hr[2]);
+    // 100 dps * 16.4 = 1640, 1 g * 2048
+    CHECK(s.gyro[0] == 1637 && s.accel[0] == 2048 && s.gyro[2] == -32750,
+          "packet 4: rescaled to 2000dps/16g format g0=%d a0=%d g2=%d", s.gyro[0], s.accel[0], s.gyro[2]);
+    CHECK(s.temp_c > 34.9f && s.temp_c < 35.1f && s.timestamp_us == 7, "packet 4: temp16 %.2f C ts=%u",
+          s.temp_c, s.timestamp_us);
+}
+
+static void test_timestamp_wrap(void)
+{
+    icm42688p_fifo_state_t st = { .packet_size = ICM42688P_FIFO_PACKET3_SIZE, .tmst_res_us = 1 };
+    const int16_t z[3] = { 0, 0, 0 };
+    uint8_t buf[16 * 4];
+    uint16_t len = 0;
+    const uint16_t ts[4] = { 65400, 65525, 114, 239 };   // 125us 步进，跨越 16 位回绕
+    for (int i = 0; i < 4; i++) {
+        len += make_packet3(&buf[len], z, z, 0, ts[i]);
+    }
+    icm42688p_fifo_sample_t s[4];
+    icm42688p_fifo_parse(&st, buf, len, s, 4, NULL);
+    CHECK(s[1].timestamp_us - s[0].timestamp_us == 125 && s[2].timestamp_us - s[1].timestamp_us == 125 &&
+          s[3].timestamp_us == 65400 + 3 * 125,
+          "timestamp unwrap across 16-bit wrap: %u %u %u %u",
+          s[0].timestamp_us, s[1].timestamp_us, s[2].timestamp_us, s[3].timestamp_us);
+
+    // 跨批次保持展开状态
+    len = make_packet3(buf, z, z, 0, 364);
+    icm42688p_fifo_parse(&st, buf, len, s, 1, NULL);
+    CHECK(s[0].timestamp_us == 65400 + 4 * 125, "unwrap state carries across reads: %u", s[0].timestamp_us);
+
+    st.tmst_res_us = 16;
+    len = make_packet3(buf, z, z, 0, 365);
+    icm42688p_fifo_parse(&st, buf, len, s, 1, NULL);
+    CHECK(s[0].timestamp_us == 65400 + 4 * 125 + 16, "16us resolution scales the delta: %u", s[0].timestamp_us);
+}
+
+static void test_parse_edge_cases(void)
+{
+    icm42688p_fifo_state_t st = { .packet_size = ICM42688P_FIFO_PACKET3_SIZE, .tmst_res_us = 1 };
+    const int16_t a[3] = { ICM42688P_FIFO_INVALID_SAMPLE, 0, 0 };
+    const int16_t g[3] = { 10, 20, 30 };
+    uint8_t buf[64];
+    icm42688p_fifo_sample_t s[4];
+    uint16_t consumed;
+
+    // 完整包 + 半个包：尾包不解析，也不计入 consumed
+    uint16_t len = make_packet3(buf, a, g, 0, 0);
+    make_packet3(&buf[len], a, g, 0, 0);
+    uint16_t n = icm42688p_fifo_parse(&st, buf, (uint16_t)(len + 9), s, 4, &consumed);
+    CHECK(n == 1 && consumed == 16, "partial trailing packet left unparsed (consumed=%u)", consumed);
+    CHECK(s[0].gyro_valid && !s[0].accel_valid, "accel -32768 marks accel invalid, gyro still valid");
+
+    // 空 FIFO 头 (0x80/0xFF) 结束解析
+    len = make_packet3(buf, a, g, 0, 0);
+    memset(&buf[len], 0xFF, 16);
+    n = icm42688p_fifo_parse(&st, buf, (uint16_t)(len + 16), s, 4, &consumed);
+    CHECK(n == 1 && st.invalid == 1 && consumed == len + 16, "empty header stops parsing (invalid=%u)", st.invalid);
+
+    // 输出数组满
+    len = 0;
+    for (int i = 0; i < 3; i++) {
+        len += make_packet3(&buf[len], a, g, 0, 0);
+    }
+    n = icm42688p_fifo_parse(&st, buf, len, s, 2, &consumed);
+    CHECK(n == 2 && consumed == 32, "stops at max_samples, consumed=%u", consumed);
+}
+
+static void test_config_registers(void)
+{
+    icm42688p_dev_t dev;
+    icm42688p_fifo_state_t st;
+    fake_dev(&dev);
+
+    icm42688p_fifo_config_t cfg = { .watermark = 8, .hires = false, .stop_on_full = false };
+    bool ok = icm42688p_fifo_init(&dev, &cfg, &st);
+    const uint16_t wm = (uint16_t)(fake.regs[ICM42688P_REG_FIFO_CONFIG2] | (fake.regs[ICM42688P_REG_FIFO_CONFIG3] << 8));
+    CHECK(ok && fake.regs[ICM42688P_REG_FIFO_CONFIG] == ICM42688P_FIFO_MODE_STREAM && wm == 8 * 16 &&
+          st.packet_size == 16 && fake.flushed,
+          "init: stream mode, watermark %u bytes, flushed", wm);
+    const uint8_t c1 = fake.regs[ICM42688P_REG_FIFO_CONFIG1];
+    CHECK((c1 & (ICM42688P_FIFO_ACCEL_EN | ICM42688P_FIFO_GYRO_EN | ICM42688P_FIFO_TEMP_EN)) ==
+          (ICM42688P_FIFO_ACCEL_EN | ICM42688P_FIFO_GYRO_EN | ICM42688P_FIFO_TEMP_EN) &&
+          !(c1 & ICM42688P_FIFO_HIRES_EN) &&
+          (fake.regs[ICM42688P_REG_TMST_CONFIG] & ICM42688P_TMST_EN) &&
+          !(fake.regs[ICM42688P_REG_TMST_CONFIG] & (ICM42688P_TMST_DELTA_EN | ICM42688P_TMST_RES_16US)) &&
+          fake.regs[ICM42688P_REG_INT_SOURCE0] == ICM42688P_FIFO_THS_INT1_ENABLE,
+          "init: packet 3 content, absolute 1us timestamps, watermark on INT1 (CONFIG1=0x%02X)", c1);
+
+    cfg.hires = true;
+    ok = icm42688p_fifo_init(&dev, &cfg, &st);
+    CHECK(ok && (fake.regs[ICM42688P_REG_FIFO_CONFIG1] & ICM42688P_FIFO_HIRES_EN) && st.packet_size == 20 &&
+          dev.accel_scale == 2048.0f && dev.gyro_scale == 16.4f,
+          "hires: packet 4, scales forced to 2000dps/16g");
+
+    cfg.watermark = 0;
+    CHECK(!icm42688p_fifo_init(&dev, &cfg, &st), "watermark 0 rejected");
+    cfg.watermark = 200;   // 200*20 > 2048
+    CHECK(!icm42688p_fifo_init(&dev, &cfg, &st), "watermark beyond FIFO capacity rejected");
+
+    dev.config.accel_fsr = ICM42688P_ACCEL_FSR_2G;
+    icm42688p_fifo_disable(&dev);
+    CHECK(fake.regs[ICM42688P_REG_FIFO_CONFIG] == ICM42688P_FIFO_MODE_BYPASS &&
+          fake.regs[ICM42688P_REG_INT_SOURCE0] == ICM42688P_UI_DRDY_INT1_ENABLE && dev.accel_scale == 16384.0f,
+          "disable: bypass, data ready restored, FSR scale restored");
+}
+
+static void test_read_single_burst(void)
+{
+    icm42688p_dev_t dev;
+    icm42688p_fifo_state_t st;
+    fake_dev(&dev);
+    icm42688p_fifo_config_t cfg = { .watermark = 8 };
+    icm42688p_fifo_init(&dev, &cfg, &st);
+
+    // 10 个完整包 + 5 字节正在写入的半包
+    const int16_t a[3] = { 0, 0, 2048 };
+    for (int i = 0; i < 10; i++) {
+        const int16_t g[3] = { (int16_t)i, 0, 0 };
+        fake.fifo_len = (uint16_t)(fake.fifo_len + make_packet3(&fake.fifo[fake.fifo_len], a, g, 0, (uint16_t)(i * 125)));
+    }
+    fake.fifo_len += 5;
+
+    static uint8_t buf[ICM42688P_FIFO_SIZE];
+    icm42688p_fifo_sample_t s[16];
+    uint16_t n = icm42688p_fifo_read(&dev, &st, buf, sizeof(buf), s, 16);
+    CHECK(n == 10 && fake.data_bursts == 1 && fake.last_burst_len == 160 && fake.fifo_len == 5,
+          "read: %u samples in %u burst of %u bytes, partial packet left in FIFO", n, fake.data_bursts,
+          fake.last_burst_len);
+    CHECK(s[9].gyro[0] == 9 && s[9].timestamp_us == 9 * 125, "read: order and timestamps preserved");
+
+    fake.fifo_len = 0;
+    n = icm42688p_fifo_read(&dev, &st, buf, sizeof(buf), s, 16);
+    CHECK(n == 0 && fake.data_bursts == 1, "read: empty FIFO -> no data burst");
+}
+
+typedef struct {
+    int      calls;
+    uint32_t ts[8];
+    float    dps[8];
+} batch_sink_t;
+
+static void on_decimated(const gyro_decimated_t *out, uint32_t timestamp_us, void *user)
+{
+    batch_sink_t *b = (batch_sink_t *)user;
+    if (b->calls < 8) {
+        b->ts[b->calls]  = timestamp_us;
+        b->dps[b->calls] = out->dps_x;
+    }
+    b->calls++;
+}
+
+static void test_gyro_batch(void)
+{
+    sil_board_init();
+    gyro_processing_init(8);
+
+    // 8kHz、水位 20：一批 20 个样本 -> 2 个 1kHz 输出，剩 4 个留在窗口
+    icm42688p_fifo_sample_t s[20];
+    memset(s, 0, sizeof(s));
+    for (int i = 0; i < 20; i++) {
+        const float dps = (i < 8) ? 100.0f : -50.0f;
+        s[i].gyro[0] = (int16_t)(dps * icm.gyro_scale);
+        s[i].gyro_valid = true;
+        s[i].timestamp_us = (uint32_t)(i * 125);
+    }
+    s[3].gyro_valid = false;   // 传感器无新数据的包被跳过：有效序列为 7×100 后接 -50
+
+    // 8:1 走 FIR：第 k 个输出 = sum h[n] * v[8k+7-n]，v[0..6]=100、v[7..]=-50，
+    // 首个样本之前的历史按恒定值 100 预置
+    const firDecimatorDesign_t *fir = firDecimatorDesign(8);
+    float expect[2] = { 0.0f, 0.0f };
+    for (int k = 0; k < 2; k++) {
+        for (int n = 0; n < fir->phase_taps * fir->ratio; n++) {
+            const int j = 8 * k + 7 - n;
+            expect[k] += fir->coeffs[n] * ((j >= 7) ? -50.0f : 100.0f);
+        }
+    }
+
+    batch_sink_t sink = { 0 };
+    uint16_t outs = gyro_process_batch(s, 20, on_decimated, &sink);
+    CHECK(outs == 2 && sink.calls == 2, "batch: 20 samples (1 invalid) -> %u decimated outputs", outs);
+    CHECK(sink.ts[0] == 8 * 125 && sink.ts[1] == 16 * 125,
+          "batch: output timestamps %u, %u us (last sample of each window)", sink.ts[0], sink.ts[1]);
+    CHECK(fabsf(sink.dps[0] - expect[0]) < 0.01f && fabsf(sink.dps[1] - expect[1]) < 0.01f,
+          "batch: FIR outputs %.3f, %.3f dps (expected %.3f, %.3f)",
+          sink.dps[0], sink.dps[1], expect[0], expect[1]);
+
+    // 无回调：最后一个输出保持就绪
+    gyro_processing_init(8);
+    outs = gyro_process_batch(s, 20, NULL, NULL);
+    CHECK(outs == 2 && gyro_decimated.ready && gyro_decimated.timestamp_us == 16 * 125,
+          "batch without callback keeps the last output ready (ts=%u)", gyro_decimated.timestamp_us);
+}
+
+int main(void)
+{
+    test_parse_packet3();
+    test_parse_packet4();
+    test_timestamp_wrap();
+    test_parse_edge_cases();
+    test_config_registers();
+    test_read_single_burst();
+    test_gyro_batch();
+
+    return sil_test_report();
+}
@@ -0,0 +1,246 @@
+/**
+ * @file    test_imu_frontend.c
+ * @brief   SIL 测试：IMU 定点前端与原浮点路径的等价性
+ * @note    原实现：int32 减零偏 + 限幅、逐样本除以刻度、浮点降采样。新实现：__QSUB16/__SSAT 饱和减法、
+ *          Q14 旋转（__SMUAD）、整数 Q15 FIR / 整数方波平均、降采样后乘以刻度倒数。
+ *          检查：零偏饱和逐位一致；轴置换/取反矩阵走快路径且与矩阵运算逐位一致；任意旋转与浮点参考相差不超过 Q14 量化界；
+ *          加速度计输出与除法参考相差在 1 ulp 量级；陀螺仪降采样输出与原浮点 FIR 的差不超过
+ *          Q15 系数舍入给出的上界，方波平均路径与原实现一致。
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "sil_board.h"
+#include "imu_frontend.h"
+#include "fir_decimator.h"
+#include "task_gyro.h"
+#include "task_acc.h"
+#include "icm42688p_lib.h"
+#include "sil_test.h"
+
+#define PI  3.14159265358979323846
+
+static uint32_t rng = 0x2468ACE1U;
+
+static uint32_t rand_u32(void)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+// 偏向满量程附近的随机 int16，覆盖饱和边界
+static int16_t rand_i16(void)
+{
+    static const int16_t edges[] = { -32768, -32767, -1, 0, 1, 32766, 32767 };
+    const uint32_t r = rand_u32();
+    if ((r & 7U) == 0U) {
+        return edges[(r >> 3) % (sizeof(edges) / sizeof(edges[0]))];
+    }
+    return (int16_t)(r >> 16);
+}
+
+static int16_t ref_sat16(int32_t v)
+{
+    if (v > 32767) return 32767;
+    if (v < -32768) return -32768;
+    return (int16_t)v;
+}
+
+// 原 gyro_compensate_offset 的行为
+static void ref_offset(const int16_t raw[3], const int16_t off[3], int16_t out[3])
+{
+    for (int a = 0; a < 3; a++) {
+        out[a] = ref_sat16((int32_t)raw[a] - (int32_t)off[a]);
+    }
+}
+
+static void test_offset_saturation(void)
+{
+    imu_frontend_t fe;
+    imu_frontend_init(&fe);
+    int mismatches = 0;
+    for (int i = 0; i < 200000; i++) {
+        const int16_t raw[3] = { rand_i16(), rand_i16(), rand_i16() };
+        const int16_t off[3] = { rand_i16(), rand_i16(), rand_i16() };
+        int16_t got[3], ref[3];
+        imu_frontend_apply(&fe, raw, off, got);
+        ref_offset(raw, off, ref);
+        if (memcmp(got, ref, sizeof(got)) != 0) mismatches++;
+    }
+    CHECK(mismatches == 0, "offset + saturation bit-exact vs int32 clamp (200000 samples, %d mismatches)",
+          mismatches);
+}
+
+static void test_rotation(void)
+{
+    imu_frontend_t fe;
+    imu_frontend_init(&fe);
+
+    // 绕 z 轴 90°（x' = -y, y' = x）与倒装（绕 x 轴 180°）：整数结果必须逐位一致
+    static const float yaw90[3][3] = { { 0, -1, 0 }, { 1, 0, 0 }, { 0, 0, 1 } };
+    static const float flip[3][3]  = { { 1, 0, 0 }, { 0, -1, 0 }, { 0, 0, -1 } };
+    const float (*perms[2])[3] = { yaw90, flip };
+    int mismatches = 0;
+    for (int p = 0; p < 2; p++) {
+        imu_frontend_set_rotation(&fe, perms[p]);
+        for (int i = 0; i < 50000; i++) {
+            const int16_t raw[3] = { rand_i16(), rand_i16(), rand_i16() };
+            const int16_t off[3] = { 0, 0, 0 };
+            int16_t got[3], comp[3];
+            imu_frontend_apply(&fe, raw, off, got);
+            ref_offset(raw, off, comp);
+            for (int r = 0; r < 3; r++) {
+                int32_t v = 0;
+                for (int c = 0; c < 3; c++) v += (int32_t)perms[p][r][c] * comp[c];
+                if (got[r] != ref_sat16(v)) mismatches++;
+            }
+        }
+    }
+    CHECK(fe.mode == SENSOR_ROTATION_PERMUTE && mismatches == 0,
+          "axis permutation / sign flip takes the fast path, bit-exact (%d mismatches)", mismatches);
+
+    // 任意旋转：roll 30°、yaw 10°；输入限制在 ±16384 内（旋转后不饱和），
+    // Q14 量化误差 <= 3 * 16384 * 2^-15 + 0.5 计数
+    const float cr = cosf(0.5235988f), sr = sinf(0.5235988f);
+    const float cy = cosf(0.1745329f), sy = sinf(0.1745329f);
+    const float m[3][3] = {
+        { cy, -sy * cr,  sy * sr },
+        { sy,  cy * cr, -cy * sr },
+        { 0.0f,     sr,       cr },
+    };
+    CHECK(imu_frontend_set_rotation(&fe, m), "arbitrary rotation accepted");
+    double worst = 0.0;
+    for (int i = 0; i < 50000; i++) {
+        const int16_t raw[3] = { (int16_t)((int32_t)(rand_u32() >> 17) - 16384),
+                                 (int16_t)((int32_t)(rand_u32() >> 17) - 16384),
+                                 (int16_t)((int32_t)(rand_u32() >> 17) - 16384) };
+        const int16_t off[3] = { 0, 0, 0 };
+        int16_t got[3];
+        imu_frontend_apply(&fe, raw, off, got);
+        for (int r = 0; r < 3; r++) {
+            const double ref = (double)m[r][0] * raw[0] + (double)m[r][1] * raw[1] + (double)m[r][2] * raw[2];
+            if (fabs(got[r] - ref) > worst) worst = fabs(got[r] - ref);
+        }
+    }
+    CHECK(worst <= 2.0, "Q14 rotation within %.2f counts of the float reference", worst);
+
+    const float bad[3][3] = { { 2.5f, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+    CHECK(!imu_frontend_set_rotation(&fe, bad), "matrix element outside [-1, 1] rejected");
+}
+
+static void test_accel_equivalence(float scale)
+{
+    sil_board_init();
+    accel_processing_init();
+    icm.accel_scale = scale;
+    icm.accel_offset[0] = 37; icm.accel_offset[1] = -120; icm.accel_offset[2] = 5;
+
+    double worst = 0.0;
+    for (int i = 0; i < 100000; i++) {
+        const int16_t raw[3] = { rand_i16(), rand_i16(), rand_i16() };
+        int16_t comp[3];
+        ref_offset(raw, icm.accel_offset, comp);
+        accel_process_sample(raw[0], raw[1], raw[2]);
+        const float got[3] = { accel_scaled.g_x, accel_scaled.g_y, accel_scaled.g_z };
+        for (int a = 0; a < 3; a++) {
+            const float ref = (float)comp[a] / icm.accel_scale;     // 原实现：逐样本除法
+            const double err = fabs((double)got[a] - (double)ref) / (fabs((double)ref) + 1e-30);
+            if (comp[a] != 0 && err > worst) worst = err;
+        }
+    }
+    icm.accel_offset[0] = icm.accel_offset[1] = icm.accel_offset[2] = 0;
+    CHECK(worst < 2.4e-7, "accel %.1f LSB/g: reciprocal multiply vs divide, max relative error %.2e",
+          (double)scale, worst);
+}
+
+static void test_gyro_equivalence(uint8_t ratio)
+{
+    sil_board_init();
+    icm.gyro_scale = 16.4f;
+    icm.gyro_offset[0] = -23; icm.gyro_offset[1] = 8; icm.gyro_offset[2] = 310;
+    gyro_processing_init(ratio);
+
+    // 原实现：逐样本除法 + 浮点 FIR（浮点系数）/ 浮点方波平均
+    firDecimator_t ref_fir;
+    const bool fir = firDecimatorInit(&ref_fir, ratio);
+    float box[3] = { 0.0f, 0.0f, 0.0f };
+    int box_n = 0;
+
+    // Q15 系数舍入的误差上界：sum|h_q15/32768 - h| * max|x|
+    double bound = 1e-3;
+    if (fir) {
+        const firDecimatorDesign_t *d = ref_fir.design;
+        double dh = 0.0;
+        for (int n = 0; n < d->phase_taps * d->ratio; n++) {
+            dh += fabs(d->coeffs_q15[n] / 32768.0 - d->coeffs[n]);
+        }
+        bound = dh * 32768.0 / icm.gyro_scale + 1e-3;
+    }
+
+    double worst = 0.0;
+    int outputs = 0, ready_mismatch = 0;
+    for (int n = 0; n < 16000; n++) {
+        // 满量程附近的多音 + 噪声
+        const double t = n / 8000.0;
+        int16_t raw[3];
+        for (int a = 0; a < 3; a++) {
+            const double v = 20000.0 * sin(2.0 * PI * (37.0 + 90.0 * a) * t) +
+                             9000.0 * sin(2.0 * PI * (1130.0 + 400.0 * a) * t) +
+                             (double)((int32_t)(rand_u32() >> 20) - 2048);
+            raw[a] = ref_sat16((int32_t)lrint(v));
+        }
+        int16_t comp[3];
+        ref_offset(raw, icm.gyro_offset, comp);
+        const float dps[3] = { (float)comp[0] / icm.gyro_scale, (float)comp[1] / icm.gyro_scale,
+                               (float)comp[2] / icm.gyro_scale };
+        float ref[3];
+        bool ref_ready;
+        if (fir) {
+            ref_ready = firDecimatorApply(&ref_fir, dps, ref);
+        } else {
+            for (int a = 0; a < 3; a++) box[a] += dps[a];
+            ref_ready = ++box_n >= ratio;
+            if (ref_ready) {
+                for (int a = 0; a < 3; a++) {
+                    ref[a] = box[a] / (float)ratio;
+                    box[a] = 0.0f;
+                }
+                box_n = 0;
+            }
+        }
+
+        gyro_process_sample(raw[0], raw[1], raw[2]);
+        if (gyro_decimated.ready != ref_ready) {
+            ready_mismatch++;
+            continue;
+        }
+        if (!ref_ready) continue;
+        outputs++;
+        const float got[3] = { gyro_decimated.dps_x, gyro_decimated.dps_y, gyro_decimated.dps_z };
+        for (int a = 0; a < 3; a++) {
+            if (fabs((double)got[a] - (double)ref[a]) > worst) worst = fabs((double)got[a] - (double)ref[a]);
+        }
+    }
+    icm.gyro_offset[0] = icm.gyro_offset[1] = icm.gyro_offset[2] = 0;
+    CHECK(ready_mismatch == 0 && outputs == 16000 / ratio && worst <= bound,
+          "gyro %u:1 %s: %d outputs, max |integer - float| %.4f dps (bound %.4f dps)",
+          ratio, fir ? "FIR" : "boxcar", outputs, worst, bound);
+}
+
+int main(void)
+{
+    test_offset_saturation();
+    test_rotation();
+    test_accel_equivalence(2048.0f);
+    test_accel_equivalence(1000.0f);
+    test_gyro_equivalence(1);
+    test_gyro_equivalence(3);
+    test_gyro_equivalence(2);
+    test_gyro_equivalence(4);
+    test_gyro_equivalence(8);
+
+    return sil_test_report();
+}
@@ -0,0 +1,205 @@
+/**
+ * @file    test_latency_trace.c
+ * @brief   SIL 测试：陀螺仪 -> 电机延迟追踪（latency_trace）与主机解码（sil_trace）
+ * @note    用虚拟时钟模拟 EXTI -> SPI 完成 -> 飞控流水线 -> 电机输出，检查各节点时间戳、
+ *          环形缓冲区覆盖与 stale 计数、二进制导出经 sil_trace_decode 往返后的延迟统计。
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include "sil_board.h"
+#include "sil_trace.h"
+#include "latency_trace.h"
+#include "task_pipeline.h"
+#include "task_mag.h"
+#include "bsp_System.h"
+#include "sil_test.h"
+
+#define GYRO_ODR_HZ     8000U
+#define DECIM           8U
+#define CONTROL_HZ      (GYRO_ODR_HZ / DECIM)
+
+#define SPI_US          12U     // EXTI -> SPI 完成
+#define WAKE_US         6U      // SPI 完成 -> 任务取帧
+#define MOTOR_US        3U      // 流水线结束 -> 电机写入
+
+static uint8_t dump_buf[64 + LATENCY_TRACE_DEPTH * 40];
+static uint32_t dump_len;
+
+static void dump_to_buf(void *user, const uint8_t *data, uint16_t len)
+{
+    (void)user;
+    if (dump_len + len <= sizeof(dump_buf)) memcpy(&dump_buf[dump_len], data, len);
+    dump_len += len;
+}
+
+static pipeline_t flight;
+
+static void flight_init(void)
+{
+    sil_board_init();
+    gyro_processing_init(DECIM);
+    accel_processing_init();
+    gyro_filter_init((float)CONTROL_HZ, 100.0f, 300.0f);
+    Attitude_InitFromAccelerometer(0.0f, 0.0f, 1.0f);
+    task_pid_init((float)CONTROL_HZ);
+
+    const pipeline_flight_config_t cfg = { .control_hz = (float)CONTROL_HZ, .max_rate_dps = 400.0f,
+                                           .use_mag = false };
+    pipeline_flight_init(&flight, &cfg);
+    latency_trace_init();
+}
+
+/**
+ * @brief 模拟一个 IMU 样本：EXTI 开记录 -> SPI 完成打点 -> 任务按时间戳找回记录跑流水线 -> 电机
+ * @return 本样本的记录 id
+ */
+static uint32_t imu_sample(void)
+{
+    sil_time_advance_us(1000000U / GYRO_ODR_HZ - SPI_US - WAKE_US);
+
+    // EXTI
+    const uint32_t t_exti = DWT_GetTick();
+    latency_trace_begin(t_exti);
+
+    // SPI/DMA 完成
+    sil_time_advance_us(SPI_US);
+    latency_trace_mark(latency_trace_current(), LATENCY_TRACE_SPI_DONE);
+
+    // IMU 任务
+    sil_time_advance_us(WAKE_US);
+    pipeline_frame_t f = { .valid = PIPE_SIG(PIPE_SIG_GYRO_RAW) | PIPE_SIG(PIPE_SIG_ACCEL_RAW),
+                           .t_sample = t_exti,
+                           .trace_id = latency_trace_find(t_exti) };
+    f.accel_raw[2] = 2048;
+    if (pipeline_run(&flight, &f) & PIPE_SIG(PIPE_SIG_MOTOR)) {
+        sil_time_advance_us(MOTOR_US);
+        latency_trace_mark(f.trace_id, LATENCY_TRACE_MOTOR);
+    }
+    return f.trace_id;
+}
+
+static void test_stamps(void)
+{
+    flight_init();
+    uint32_t ids[2 * DECIM];
+    for (uint32_t i = 0; i < 2 * DECIM; i++) ids[i] = imu_sample();
+
+    CHECK(ids[0] != LATENCY_TRACE_NONE && ids[1] == ids[0] + 1,
+          "records get consecutive ids: %lu %lu", (unsigned long)ids[0], (unsigned long)ids[1]);
+
+    const uint32_t cpm = SystemCoreClock / 1000000U;
+    latency_trace_record_t r;
+    bool ok = latency_trace_get(ids[DECIM - 1], &r);
+    const uint8_t all = (1U << LATENCY_TRACE_POINTS) - 1U;
+    CHECK(ok && r.mask == all, "decimated sample reaches every point: mask=0x%02x", r.mask);
+    CHECK(r.t[LATENCY_TRACE_SPI_DONE] - r.t[LATENCY_TRACE_EXTI] == SPI_US * cpm &&
+          r.t[LATENCY_TRACE_GYRO] - r.t[LATENCY_TRACE_EXTI] == (SPI_US + WAKE_US) * cpm &&
+          r.t[LATENCY_TRACE_MOTOR] - r.t[LATENCY_TRACE_EXTI] == (SPI_US + WAKE_US + MOTOR_US) * cpm,
+          "timestamps: spi=%lu gyro=%lu motor=%lu us after EXTI",
+          (unsigned long)((r.t[LATENCY_TRACE_SPI_DONE] - r.t[LATENCY_TRACE_EXTI]) / cpm),
+          (unsigned long)((r.t[LATENCY_TRACE_GYRO] - r.t[LATENCY_TRACE_EXTI]) / cpm),
+          (unsigned long)((r.t[LATENCY_TRACE_MOTOR] - r.t[LATENCY_TRACE_EXTI]) / cpm));
+
+    ok = latency_trace_get(ids[0], &r);
+    const uint8_t front = (1U << LATENCY_TRACE_EXTI) | (1U << LATENCY_TRACE_SPI_DONE) | (1U << LATENCY_TRACE_GYRO);
+    CHECK(ok && r.mask == front, "non-decimated sample stops after gyro: mask=0x%02x", r.mask);
+
+    CHECK(latency_trace_find(12345U) == LATENCY_TRACE_NONE, "unknown EXTI timestamp not found");
+    CHECK(latency_trace_count() == 2 * DECIM && latency_trace_stale() == 0,
+          "count=%lu stale=%lu", (unsigned long)latency_trace_count(), (unsigned long)latency_trace_stale());
+}
+
+static void test_wrap_and_stale(void)
+{
+    flight_init();
+    const uint32_t first = imu_sample();
+    for (uint32_t i = 1; i < LATENCY_TRACE_DEPTH + 10U; i++) imu_sample();
+
+    latency_trace_record_t r;
+    CHECK(latency_trace_count() == LATENCY_TRACE_DEPTH && !latency_trace_get(first, &r),
+          "ring keeps the newest %u records", LATENCY_TRACE_DEPTH);
+
+    latency_trace_mark(first, LATENCY_TRACE_MOTOR);
+    CHECK(latency_trace_stale() == 1, "late mark on an overwritten record counted as stale");
+
+    latency_trace_enable(false);
+    const uint32_t id = latency_trace_begin(DWT_GetTick());
+    latency_trace_mark(id, LATENCY_TRACE_SPI_DONE);
+    CHECK(id == LATENCY_TRACE_NONE && latency_trace_stale() == 1, "paused trace ignores begin/mark");
+    latency_trace_enable(true);
+}
+
+static void test_dump_roundtrip(void)
+{
+    flight_init();
+    const uint32_t samples = LATENCY_TRACE_DEPTH + 3U * DECIM;
+    for (uint32_t i = 0; i < samples; i++) imu_sample();
+    const uint32_t newest = latency_trace_current();
+
+    // 抓包里夹杂文本日志
+    static const char noise[] = "[gyro_processing] Initialized: LT\r\n";
+    memcpy(dump_buf, noise, sizeof(noise) - 1);
+    dump_len = sizeof(noise) - 1;
+    const uint32_t bytes = latency_trace_dump(dump_to_buf, NULL);
+    const uint32_t expect = 14U + LATENCY_TRACE_DEPTH * (9U + 4U * (LATENCY_TRACE_POINTS - 1U)) + 2U;
+    CHECK(bytes == expect, "dump size %lu bytes (expect %lu)", (unsigned long)bytes, (unsigned long)expect);
+
+    sil_trace_dump_t d;
+    bool ok = sil_trace_decode(dump_buf, dump_len, &d);
+    CHECK(ok && d.count == LATENCY_TRACE_DEPTH && d.points == LATENCY_TRACE_POINTS && d.cpu_hz == SystemCoreClock,
+          "decoded %u records, %u points, %lu Hz", d.count, d.points, (unsigned long)d.cpu_hz);
+    if (!ok) return;
+
+    CHECK(d.records[d.count - 1].id == newest && d.records[0].id == newest - (LATENCY_TRACE_DEPTH - 1U),
+          "records ordered oldest -> newest (%lu .. %lu)",
+          (unsigned long)d.records[0].id, (unsigned long)d.records[d.count - 1].id);
+
+    sil_trace_span_t spi, total, front;
+    sil_trace_span(&d, LATENCY_TRACE_EXTI, LATENCY_TRACE_SPI_DONE, &spi);
+    sil_trace_span(&d, LATENCY_TRACE_EXTI, LATENCY_TRACE_MOTOR, &total);
+    sil_trace_span(&d, LATENCY_TRACE_SPI_DONE, LATENCY_TRACE_GYRO, &front);
+    CHECK(spi.n == LATENCY_TRACE_DEPTH && fabsf(spi.p50_us - SPI_US) < 0.01f && fabsf(spi.max_us - SPI_US) < 0.01f,
+          "exti->spi: n=%lu p50=%.2f us", (unsigned long)spi.n, spi.p50_us);
+    CHECK(total.n == LATENCY_TRACE_DEPTH / DECIM &&
+          fabsf(total.p99_us - (SPI_US + WAKE_US + MOTOR_US)) < 0.01f,
+          "exti->motor only over decimated samples: n=%lu p99=%.2f us", (unsigned long)total.n, total.p99_us);
+    CHECK(front.n == LATENCY_TRACE_DEPTH && fabsf(front.mean_us - WAKE_US) < 0.01f,
+          "spi->gyro: mean=%.2f us", front.mean_us);
+    sil_trace_print(&d);
+    sil_trace_free(&d);
+
+    // 单字节损坏 -> CRC 不通过
+    dump_buf[dump_len / 2] ^= 0x40;
+    CHECK(!sil_trace_decode(dump_buf, dump_len, &d), "corrupted dump rejected by CRC");
+
+    // 记录在导出后继续
+    const uint32_t id = imu_sample();
+    CHECK(id == newest + 1, "recording resumes after dump");
+}
+
+static void test_dump_uart(void)
+{
+    sil_board_init();
+    latency_trace_init();
+    latency_trace_begin(DWT_GetTick());
+
+    const uint32_t bytes = latency_trace_dump_uart(1);
+    const uint8_t *tx;
+    const uint16_t n = sil_uart_tx_captured(&tx);
+    sil_trace_dump_t d;
+    const bool ok = (n == bytes) && sil_trace_decode(tx, n, &d);
+    CHECK(ok && d.count == 1, "UART dump decodes (%u bytes)", n);
+    if (ok) sil_trace_free(&d);
+}
+
+int main(void)
+{
+    test_stamps();
+    test_wrap_and_stale();
+    test_dump_roundtrip();
+    test_dump_uart();
+
+    return sil_test_report();
+}
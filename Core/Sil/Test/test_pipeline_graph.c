@@ -0,0 +1,342 @@
+/**
+ * @file    test_pipeline_graph.c
+ * @brief   SIL 测试：静态流水线图（task_pipeline）
+ * @note    检查拓扑排序、非法图（重复生产者 / 输入无来源 / 环）的拒绝、输入门控，
+ *          默认飞控图与手工串联调用逐位一致，以及端到端延迟的打点。
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include "sil_board.h"
+#include "task_pipeline.h"
+#include "task_mag.h"
+#include "task_rc.h"
+#include "bsp_System.h"
+#include "elrs_crsf_uart.h"
+#include "elrs_crsf_port.h"
+#include "sil_test.h"
+
+#define GYRO_ODR_HZ     8000U
+#define DECIM           8U
+#define CONTROL_HZ      (GYRO_ODR_HZ / DECIM)
+
+// ============================================================================
+// 测试阶段：记录运行顺序，可选推进虚拟时间
+// ============================================================================
+static char run_log[32];
+static uint8_t run_len;
+
+typedef struct {
+    char     tag;
+    uint32_t cost_us;       // 运行时推进的虚拟时间
+    bool     produce;       // 返回值
+} probe_t;
+
+static bool probe_run(pipeline_frame_t *f, void *user)
+{
+    (void)f;
+    const probe_t *p = (const probe_t *)user;
+    if (run_len < sizeof(run_log) - 1) run_log[run_len++] = p->tag;
+    run_log[run_len] = '\0';
+    if (p->cost_us) sil_time_advance_us(p->cost_us);
+    return p->produce;
+}
+
+static void log_reset(void)
+{
+    run_len = 0;
+    run_log[0] = '\0';
+}
+
+#define SIG(s)  PIPE_SIG(PIPE_SIG_##s)
+
+static void test_topological_order(void)
+{
+    probe_t a = { 'a', 0, true }, b = { 'b', 0, true }, c = { 'c', 0, true }, d = { 'd', 0, true };
+    // 声明顺序打乱：d 依赖 c，c 依赖 a 与 b，b 依赖 a
+    const pipeline_stage_t stages[] = {
+        { "d", SIG(ATTITUDE),                     0, SIG(MOTOR),          probe_run, &d },
+        { "c", SIG(GYRO_FILTERED) | SIG(ACCEL),   0, SIG(ATTITUDE),       probe_run, &c },
+        { "b", SIG(GYRO_DECIMATED),               0, SIG(GYRO_FILTERED),  probe_run, &b },
+        { "a", SIG(GYRO_RAW),                     0, SIG(GYRO_DECIMATED) | SIG(ACCEL), probe_run, &a },
+    };
+    pipeline_t p;
+    bool ok = pipeline_init(&p, stages, 4);
+    CHECK(ok && p.count == 4, "shuffled graph accepted");
+
+    log_reset();
+    pipeline_frame_t f = { .valid = SIG(GYRO_RAW) };
+    uint32_t valid = pipeline_run(&p, &f);
+    CHECK(strcmp(run_log, "abcd") == 0, "topological run order: %s (expect abcd)", run_log);
+    CHECK(valid & SIG(MOTOR), "all outputs valid after one pass: 0x%lx", (unsigned long)valid);
+
+    // 可选输入只影响排序：m 声明在后但排在 c 前面，且未就绪时 c 仍然运行
+    probe_t m = { 'm', 0, false };
+    const pipeline_stage_t with_opt[] = {
+        { "c", SIG(GYRO_RAW), SIG(MAG), SIG(ATTITUDE), probe_run, &c },
+        { "m", 0,             0,        SIG(MAG),      probe_run, &m },
+    };
+    ok = pipeline_init(&p, with_opt, 2);
+    log_reset();
+    memset(&f, 0, sizeof(f));
+    f.valid = SIG(GYRO_RAW);
+    valid = pipeline_run(&p, &f);
+    CHECK(ok && strcmp(run_log, "mc") == 0 && !(valid & SIG(MAG)) && (valid & SIG(ATTITUDE)),
+          "optional input orders producer first, consumer runs without it: %s", run_log);
+}
+
+static void test_invalid_graphs(void)
+{
+    probe_t x = { 'x', 0, true };
+    pipeline_t p;
+
+    const pipeline_stage_t dup[] = {
+        { "a", SIG(GYRO_RAW), 0, SIG(GYRO_DECIMATED), probe_run, &x },
+        { "b", SIG(GYRO_RAW), 0, SIG(GYRO_DECIMATED), probe_run, &x },
+    };
+    CHECK(!pipeline_init(&p, dup, 2), "duplicate producer rejected");
+
+    const pipeline_stage_t frame_out[] = {
+        { "a", 0, 0, SIG(GYRO_RAW), probe_run, &x },
+    };
+    CHECK(!pipeline_init(&p, frame_out, 1), "stage producing a frame input rejected");
+
+    const pipeline_stage_t missing[] = {
+        { "a", SIG(GYRO_RAW),  0, SIG(GYRO_DECIMATED), probe_run, &x },
+        { "b", SIG(ATTITUDE),  0, SIG(MOTOR),          probe_run, &x },
+    };
+    CHECK(!pipeline_init(&p, missing, 2), "required input without producer rejected");
+
+    const pipeline_stage_t cycle[] = {
+        { "src", SIG(GYRO_RAW),                         0, SIG(GYRO_DECIMATED), probe_run, &x },
+        { "a",   SIG(GYRO_DECIMATED) | SIG(ATTITUDE),   0, SIG(GYRO_FILTERED),  probe_run, &x },
+        { "b",   SIG(GYRO_FILTERED),                    0, SIG(ATTITUDE),       probe_run, &x },
+    };
+    CHECK(!pipeline_init(&p, cycle, 3) && p.count == 0, "dependency cycle rejected");
+}
+
+static void test_input_gating(void)
+{
+    probe_t a = { 'a', 0, false }, b = { 'b', 0, true };
+    const pipeline_stage_t stages[] = {
+        { "a", SIG(GYRO_RAW),       0, SIG(GYRO_DECIMATED), probe_run, &a },
+        { "b", SIG(GYRO_DECIMATED), 0, SIG(MOTOR),          probe_run, &b },
+    };
+    pipeline_t p;
+    pipeline_init(&p, stages, 2);
+
+    log_reset();
+    pipeline_frame_t f = { .valid = SIG(ACCEL_RAW) };
+    pipeline_run(&p, &f);
+    CHECK(run_len == 0, "no stage runs without its input: '%s'", run_log);
+
+    f.valid = SIG(GYRO_RAW);
+    pipeline_run(&p, &f);
+    CHECK(strcmp(run_log, "a") == 0 && p.stats[1].runs == 0 && p.latency_count == 0,
+          "producer returning false gates its consumer: '%s'", run_log);
+}
+
+static void test_latency_stamp(void)
+{
+    sil_board_init();
+    probe_t a = { 'a', 20, true }, b = { 'b', 30, true };
+    const pipeline_stage_t stages[] = {
+        { "a", SIG(GYRO_RAW),       0, SIG(GYRO_DECIMATED), probe_run, &a },
+        { "b", SIG(GYRO_DECIMATED), 0, SIG(MOTOR),          probe_run, &b },
+    };
+    pipeline_t p;
+    pipeline_init(&p, stages, 2);
+
+    // 采样后 10us 才开始处理（SPI/DMA 传输），延迟应从采样时刻算起
+    for (int i = 0; i < 100; i++) {
+        pipeline_frame_t f = { .valid = SIG(GYRO_RAW), .t_sample = DWT_GetTick() };
+        sil_time_advance_us(10);
+        pipeline_run(&p, &f);
+        sil_time_advance_us(65);
+    }
+    const uint32_t cpm = SystemCoreClock / 1000000U;
+    CHECK(p.latency_count == 100 && p.latency_last == 60 * cpm && p.latency_max == 60 * cpm,
+          "latency sample->motor = %lu us (expect 60)", (unsigned long)(p.latency_last / cpm));
+    const uint32_t p50 = pipeline_latency_percentile(&p, 5000);
+    CHECK(p50 >= 50 * cpm && p50 <= 65 * cpm, "latency p50 = %lu us", (unsigned long)(p50 / cpm));
+    CHECK(p.stats[0].exec_cycles_max == 20 * cpm && p.stats[1].exec_cycles_max == 30 * cpm,
+          "per-stage exec time: a=%lu us b=%lu us",
+          (unsigned long)(p.stats[0].exec_cycles_max / cpm), (unsigned long)(p.stats[1].exec_cycles_max / cpm));
+    pipeline_print_stats(&p);
+}
+
+// ============================================================================
+// 默认飞控图 vs 手工串联
+// ============================================================================
+static int16_t to_raw(float v, float scale)
+{
+    float r = v * scale;
+    if (r > 32767.0f) r = 32767.0f;
+    if (r < -32768.0f) r = -32768.0f;
+    return (int16_t)lrintf(r);
+}
+
+// 构造一帧 CRSF RC_CHANNELS_PACKED（16 通道 x 11bit），同 test_sil_pipeline
+static uint8_t build_rc_frame(uint8_t *out, const uint16_t ch[16])
+{
+    uint8_t payload[22];
+    memset(payload, 0, sizeof(payload));
+    for (uint16_t i = 0; i < 16; i++) {
+        uint16_t bit = (uint16_t)(i * 11U);
+        for (uint8_t b = 0; b < 11; b++, bit++) {
+            if (ch[i] & (1U << b)) {
+                payload[bit >> 3] |= (uint8_t)(1U << (bit & 7U));
+            }
+        }
+    }
+    out[0] = ELRS_CRSF_ADDRESS_FLIGHT_CONTROLLER;
+    out[1] = (uint8_t)(sizeof(payload) + 2U);
+    out[2] = ELRS_CRSF_FRAMETYPE_RC_CHANNELS_PACKED;
+    memcpy(&out[3], payload, sizeof(payload));
+
+    uint8_t crc = 0;
+    for (uint8_t i = 2; i < 3U + sizeof(payload); i++) {
+        crc ^= out[i];
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0xD5) : (uint8_t)(crc << 1);
+        }
+    }
+    out[3 + sizeof(payload)] = crc;
+    return (uint8_t)(4U + sizeof(payload));
+}
+
+// 初始化全部模块并建立 RC 链路（横滚杆偏右，否则 PID 输出全零，比较没有意义）
+static void flight_init(void)
+{
+    sil_board_init();
+    gyro_processing_init(DECIM);
+    accel_processing_init();
+    mag_processing_init();
+    gyro_filter_init((float)CONTROL_HZ, 100.0f, 300.0f);
+    Attitude_InitFromAccelerometer(0.0f, 0.0f, 1.0f);
+    task_pid_init((float)CONTROL_HZ);
+
+    ELRS_CRSF_InitOnUART1();
+    uint16_t ch[16];
+    for (uint8_t i = 0; i < 16; i++) ch[i] = 1024;
+    ch[0] = 1300;
+    uint8_t frame[ELRS_CRSF_FRAME_MAX];
+    const uint8_t len = build_rc_frame(frame, ch);
+    sil_uart_inject(1, frame, len);
+    rc_update(30.0f, 30.0f, 180.0f, 100);
+}
+
+// 第 i 个样本：roll/yaw 正弦摆动 + 轻微倾斜 + 固定磁场
+static void make_sample(uint32_t i, int16_t g[3], int16_t a[3], int16_t m[3])
+{
+    const float t = (float)i / (float)GYRO_ODR_HZ;
+    g[0] = to_raw(60.0f * sinf(2.0f * 3.14159265f * 2.0f * t), 16.4f);
+    g[1] = to_raw(5.0f, 16.4f);
+    g[2] = to_raw(30.0f * sinf(2.0f * 3.14159265f * 0.5f * t), 16.4f);
+    a[0] = to_raw(0.05f, 2048.0f);
+    a[1] = to_raw(-0.03f, 2048.0f);
+    a[2] = to_raw(1.0f, 2048.0f);
+    m[0] = 200;
+    m[1] = -50;
+    m[2] = 400;
+}
+
+#define FLIGHT_SAMPLES  (GYRO_ODR_HZ / 2U)
+
+static pid_output_t manual_out[FLIGHT_SAMPLES / DECIM];
+static Euler_angles manual_att[FLIGHT_SAMPLES / DECIM];
+
+static uint32_t run_manual(bool use_mag)
+{
+    flight_init();
+    uint32_t n = 0, last_t = 0;
+    bool have_last = false;
+
+    for (uint32_t i = 0; i < FLIGHT_SAMPLES; i++) {
+        int16_t g[3], a[3], m[3];
+        make_sample(i, g, a, m);
+        sil_time_advance_us(1000000U / GYRO_ODR_HZ);
+        const uint32_t t = DWT_GetTick();
+
+        gyro_process_sample(g[0], g[1], g[2]);
+        accel_process_sample(a[0], a[1], a[2]);
+        if (use_mag) mag_process_sample(m[0], m[1], m[2]);
+        if (!gyro_decimated.ready || !accel_scaled.ready) continue;
+
+        gyro_filter_feed_sample(gyro_decimated.dps_x, gyro_decimated.dps_y, gyro_decimated.dps_z);
+        float mx, my, mz, strength;
+        Euler_angles ang;
+        if (use_mag && mag_calibrated.ready && mag_get_normalized(&mx, &my, &mz, &strength)) {
+            ang = Attitude_Update(accel_scaled.g_x, accel_scaled.g_y, accel_scaled.g_z,
+                                  gyro_filtered.dps_x, gyro_filtered.dps_y, gyro_filtered.dps_z, mx, my, mz);
+        } else {
+            ang = Attitude_Update_IMU_Only(accel_scaled.g_x, accel_scaled.g_y, accel_scaled.g_z,
+                                           gyro_filtered.dps_x, gyro_filtered.dps_y, gyro_filtered.dps_z);
+        }
+        const float dt = have_last ? (float)(t - last_t) / (float)SystemCoreClock : 1.0f / (float)CONTROL_HZ;
+        last_t = t;
+        have_last = true;
+
+        manual_att[n] = ang;
+        manual_out[n] = *task_pid_update(&ang, &gyro_filtered, dt, 400.0f);
+        n++;
+    }
+    return n;
+}
+
+static void check_flight_graph(bool use_mag)
+{
+    const uint32_t expected = run_manual(use_mag);
+
+    flight_init();
+    pipeline_t p;
+    const pipeline_flight_config_t cfg = { .control_hz = (float)CONTROL_HZ, .max_rate_dps = 400.0f,
+                                           .use_mag = use_mag };
+    const bool ok = pipeline_flight_init(&p, &cfg);
+    CHECK(ok && p.count == (use_mag ? 6 : 5), "flight graph (mag=%d) built with %u stages", use_mag, p.count);
+
+    uint32_t n = 0, mismatches = 0, rate_meas_bad = 0;
+    for (uint32_t i = 0; i < FLIGHT_SAMPLES; i++) {
+        int16_t g[3], a[3], m[3];
+        make_sample(i, g, a, m);
+        sil_time_advance_us(1000000U / GYRO_ODR_HZ);
+
+        pipeline_frame_t f = { .valid = SIG(GYRO_RAW) | SIG(ACCEL_RAW) | (use_mag ? SIG(MAG_RAW) : 0),
+                               .t_sample = DWT_GetTick() };
+        memcpy(f.gyro_raw, g, sizeof(g));
+        memcpy(f.accel_raw, a, sizeof(a));
+        memcpy(f.mag_raw, m, sizeof(m));
+        if (!(pipeline_run(&p, &f) & SIG(MOTOR))) continue;
+
+        if (!f.motor->link_active) rate_meas_bad++;
+        if (n < expected) {
+            if (memcmp(f.motor, &manual_out[n], sizeof(pid_output_t)) != 0 ||
+                memcmp(&f.attitude, &manual_att[n], sizeof(Euler_angles)) != 0) {
+                mismatches++;
+            }
+        }
+        // 角速度反馈必须来自滤波输出而不是 gyro_scaled
+        if (f.motor->rate_meas[0] != gyro_filtered.dps_x || f.motor->rate_meas[2] != gyro_filtered.dps_z) {
+            rate_meas_bad++;
+        }
+        n++;
+    }
+    CHECK(n == expected && mismatches == 0,
+          "flight graph (mag=%d) bit-identical to manual chain: %lu/%lu steps, %lu mismatches",
+          use_mag, (unsigned long)n, (unsigned long)expected, (unsigned long)mismatches);
+    CHECK(rate_meas_bad == 0, "PID rate feedback uses gyro_filtered (%lu bad)", (unsigned long)rate_meas_bad);
+    CHECK(p.latency_count == n, "latency stamped for every motor output (%lu)", (unsigned long)p.latency_count);
+}
+
+int main(void)
+{
+    test_topological_order();
+    test_invalid_graphs();
+    test_input_gating();
+    test_latency_stamp();
+    check_flight_graph(false);
+    check_flight_graph(true);
+
+    return sil_test_report();
+}
@@ -0,0 +1,896 @@
+/**
+ * @file    test_scheduler.c
+ * @brief   调度器主机测试：两级通道（慢速 LOW 任务阻塞主循环时实时通道的释放抖动）、
+ *          最小堆 + 就绪位图派发核心（24+ 任务的周期精度、同时到期按优先级、堆不变量）、
+ *          任务在回调中挂起自己（不再入堆，resume 后恢复）、
+ *          时间网格锚定的周期任务（长时间无漂移、三种超时策略、相位流水）、
+ *          执行时间/抖动直方图（分桶布局、p50/p99/p99.9、二进制导出解码）、
+ *          中断 -> 任务事件队列（标志位丢事件对比、负载传递、队列满丢弃计数）、
+ *          CPU 时间分解（任务净占用不重复计算抢占、空闲回调模拟 WFI）、
+ *          清单生成的静态任务表（与动态注册调度结果一致、句柄即枚举、主频/容量不符时拒绝）
+ * @note    任务回调通过推进虚拟时间模拟执行耗时；虚拟时间每跨过一个 125us 节拍就“进入”一次
+ *          定时器中断（scheduler_rt_isr），从而在主机上模拟中断抢占协作任务。
+ *          中断正在派发时跨过的节拍挂起，返回后立即补发（与 NVIC 同优先级尾链一致）。
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "sil_board.h"
+#include "scheduler.h"
+#include "task_manifest.h"
+#include "sil_test.h"
+
+#define RT_TICK_US      125U     // 8kHz，与 IMU 数据就绪中断同频
+
+static task_scheduler_fc_t sched;
+static task_entry_t storage[SCHEDULER_MAX_TASKS];
+
+static uint64_t next_tick_us;
+static int      isr_depth;
+static bool     tick_pending;
+static void   (*tick_hook)(void);   // 节拍中断里额外执行的生产者（模拟 EXTI/DMA 中断投递事件）
+
+// 推进虚拟时间；跨过节拍时模拟定时器中断抢占当前代码
+static void sim_advance_us(uint32_t us)
+{
+    while (us--) {
+        sil_time_advance_us(1);
+        if (sil_time_now_us() < next_tick_us) continue;
+        next_tick_us += RT_TICK_US;
+
+        if (isr_depth > 0) {
+            tick_pending = true;
+            continue;
+        }
+        do {
+            tick_pending = false;
+            isr_depth++;
+            if (tick_hook) tick_hook();
+            scheduler_rt_isr(&sched);
+            isr_depth--;
+        } while (tick_pending);
+    }
+}
+
+static void busy_task(void *user)
+{
+    sim_advance_us((uint32_t)(uintptr_t)user);
+}
+
+static void setup(void)
+{
+    sil_board_init();
+    memset(&sched, 0, sizeof(sched));
+    scheduler_init(&sched, storage, SCHEDULER_MAX_TASKS, NULL);
+    next_tick_us = sil_time_now_us() + RT_TICK_US;
+    isr_depth = 0;
+    tick_pending = false;
+    tick_hook = NULL;
+}
+
+static task_handle_t gyro_h, pid_h, baro_h, led_h;
+
+static void run_mix_1s(void);
+
+// 1kHz 陀螺 + 1kHz PID + 50Hz 气压计（3ms 阻塞）+ 10Hz LED，运行 1 秒
+static void run_flight_mix(bool rt_lane)
+{
+    setup();
+    gyro_h = scheduler_register_periodic(&sched, "gyro", busy_task, (void *)20, TASK_PRIORITY_CRITICAL, 1000, 0);
+    pid_h = scheduler_register_periodic(&sched, "pid", busy_task, (void *)30, TASK_PRIORITY_HIGH, 1000, 0);
+    baro_h = scheduler_register_periodic(&sched, "baro", busy_task, (void *)3000, TASK_PRIORITY_LOW, 20000, 0);
+    led_h = scheduler_register_periodic(&sched, "led", busy_task, (void *)5, TASK_PRIORITY_IDLE, 100000, 0);
+    if (rt_lane) {
+        scheduler_enable_rt_lane(&sched, TASK_PRIORITY_HIGH);
+    }
+    run_mix_1s();
+}
+
+static void run_mix_1s(void)
+{
+    const uint64_t end_us = sil_time_now_us() + 1000000U;
+    while (sil_time_now_us() < end_us) {
+        scheduler_run(&sched);
+        sim_advance_us(1);
+    }
+}
+
+static void test_cooperative_baseline(void)
+{
+    run_flight_mix(false);
+    const task_stats_t *gyro = scheduler_get_stats(&sched, gyro_h);
+    const task_lane_stats_t *coop = scheduler_get_lane_stats(&sched, TASK_LANE_COOPERATIVE);
+    const task_lane_stats_t *rt = scheduler_get_lane_stats(&sched, TASK_LANE_RT);
+
+    CHECK(gyro && gyro->jitter_max_us >= 1500,
+          "cooperative only: 3ms baro blocks gyro, jitter max %u us", gyro ? gyro->jitter_max_us : 0);
+    CHECK(rt->dispatch_count == 0 && coop->jitter_max_us >= 1500,
+          "cooperative only: RT lane idle, coop lane jitter max %u us", coop->jitter_max_us);
+}
+
+static void test_rt_lane_bounds_jitter(void)
+{
+    run_flight_mix(true);
+    const task_stats_t *gyro = scheduler_get_stats(&sched, gyro_h);
+    const task_stats_t *pid = scheduler_get_stats(&sched, pid_h);
+    const task_stats_t *baro = scheduler_get_stats(&sched, baro_h);
+    const task_lane_stats_t *coop = scheduler_get_lane_stats(&sched, TASK_LANE_COOPERATIVE);
+    const task_lane_stats_t *rt = scheduler_get_lane_stats(&sched, TASK_LANE_RT);
+
+    CHECK(sched.tasks[0].lane == TASK_LANE_RT && sched.tasks[1].lane == TASK_LANE_RT &&
+          sched.tasks[2].lane == TASK_LANE_COOPERATIVE && sched.tasks[3].lane == TASK_LANE_COOPERATIVE,
+          "CRITICAL/HIGH -> RT lane, LOW/IDLE stay cooperative");
+    CHECK(gyro->jitter_max_us <= RT_TICK_US && gyro->missed_count == 0 && gyro->exec_count > 800,
+          "RT lane: gyro jitter max %u us (tick %u us), runs %u, missed %u",
+          gyro->jitter_max_us, RT_TICK_US, gyro->exec_count, gyro->missed_count);
+    CHECK(pid->jitter_max_us <= RT_TICK_US + 20 && pid->missed_count == 0,
+          "RT lane: pid jitter max %u us (behind gyro in the same ISR)", pid->jitter_max_us);
+    CHECK(baro->exec_count >= 40 && baro->exec_count <= 50,
+          "baro still runs cooperatively while preempted: %u runs", baro->exec_count);
+    CHECK(rt->dispatch_count == gyro->exec_count + pid->exec_count && rt->reentry_count == 0 &&
+          rt->jitter_max_us <= RT_TICK_US + 20,
+          "RT lane stats: %u dispatches, jitter avg %u / max %u us",
+          rt->dispatch_count, rt->jitter_samples ? rt->jitter_total_us / rt->jitter_samples : 0,
+          rt->jitter_max_us);
+    CHECK(coop->dispatch_count == baro->exec_count + scheduler_get_stats(&sched, led_h)->exec_count,
+          "coop lane stats: %u dispatches, jitter max %u us", coop->dispatch_count, coop->jitter_max_us);
+}
+
+static volatile bool imu_flag;
+static int imu_runs;
+static void imu_task(void *user) { (void)user; imu_runs++; sim_advance_us(10); }
+
+static void test_event_task_in_rt_lane(void)
+{
+    setup();
+    imu_flag = false;
+    imu_runs = 0;
+    scheduler_enable_rt_lane(&sched, TASK_PRIORITY_HIGH);
+    task_handle_t imu = scheduler_register_event_flag(&sched, "imu", imu_task, NULL, TASK_PRIORITY_CRITICAL,
+                                                      &imu_flag, 0);
+    CHECK(imu == 0 && sched.tasks[imu].lane == TASK_LANE_RT,
+          "task registered after enabling the lane goes to RT");
+
+    imu_flag = true;
+    scheduler_run(&sched);
+    CHECK(imu_runs == 0 && imu_flag, "scheduler_run leaves RT-lane tasks alone");
+
+    isr_depth++;                       // 模拟 EXTI：置标志后立即派发
+    scheduler_rt_isr(&sched);
+    isr_depth--;
+    const task_stats_t *st = scheduler_get_stats(&sched, imu);
+    CHECK(imu_runs == 1 && !imu_flag && st->jitter_us == 0,
+          "EXTI dispatch runs the event task at once and clears the flag");
+
+    scheduler_suspend_task(&sched, imu);
+    imu_flag = true;
+    scheduler_rt_isr(&sched);
+    CHECK(imu_runs == 1, "suspended RT task is skipped");
+    scheduler_resume_task(&sched, imu);
+
+    sched.rt_in_isr = true;            // 另一个中断源正在派发
+    scheduler_rt_isr(&sched);
+    sched.rt_in_isr = false;
+    CHECK(imu_runs == 1 && sched.lane_stats[TASK_LANE_RT].reentry_count == 1,
+          "nested entry is rejected and counted");
+
+    scheduler_disable_rt_lane(&sched);
+    scheduler_run(&sched);
+    CHECK(imu_runs == 2 && sched.tasks[0].lane == TASK_LANE_COOPERATIVE,
+          "disable_rt_lane hands the task back to scheduler_run");
+
+    scheduler_reset_stats(&sched);
+    CHECK(sched.lane_stats[TASK_LANE_RT].dispatch_count == 0 && st->exec_count == 0,
+          "reset_stats clears task and lane stats");
+    CHECK(scheduler_get_lane_stats(&sched, TASK_LANE_COUNT) == NULL, "invalid lane -> NULL");
+}
+
+// 检查两条通道的堆：父节点不晚于子节点，heap_pos 与位置一致
+static bool heap_valid(void)
+{
+    for (int l = 0; l < TASK_LANE_COUNT; l++) {
+        const task_queue_t *q = &sched.queue[l];
+        for (uint8_t pos = 0; pos < q->heap_size; pos++) {
+            const task_entry_t *t = &sched.tasks[q->heap[pos]];
+            if (t->heap_pos != pos) return false;
+            if (pos > 0) {
+                const task_entry_t *parent = &sched.tasks[q->heap[(pos - 1) / 2]];
+                if ((int32_t)(t->next_run_time - parent->next_run_time) < 0) return false;
+            }
+        }
+    }
+    return true;
+}
+
+static char    order_log[SCHEDULER_MAX_TASKS];
+static uint8_t order_len;
+static void order_task(void *user)
+{
+    if (order_len < sizeof(order_log)) order_log[order_len++] = (char)(uintptr_t)user;
+}
+
+static void test_heap_dispatch_many_tasks(void)
+{
+    setup();
+    static char names[SCHEDULER_MAX_TASKS][8];
+    static task_handle_t handles[SCHEDULER_MAX_TASKS];
+    static volatile bool flags[4];
+    static const uint32_t periods_us[] = { 500, 1000, 2000, 3000, 5000, 7000, 10000, 20000 };
+
+    // 24 个周期任务 + 4 个事件任务，优先级交错注册
+    bool ok = true;
+    for (int i = 0; i < 24; i++) {
+        snprintf(names[i], sizeof(names[i]), "p%02d", i);
+        handles[i] = scheduler_register_periodic(&sched, names[i], busy_task, (void *)0,
+                                                 (task_priority_t)(i % TASK_PRIORITY_COUNT),
+                                                 periods_us[i % 8], 0);
+        ok &= handles[i] == i;
+    }
+    for (int i = 0; i < 4; i++) {
+        snprintf(names[24 + i], sizeof(names[24 + i]), "e%d", i);
+        flags[i] = false;
+        handles[24 + i] = scheduler_register_event_flag(&sched, names[24 + i], busy_task, (void *)0,
+                                                        (task_priority_t)i, &flags[i], 0);
+        ok &= handles[24 + i] == 24 + i;
+    }
+    CHECK(ok && sched.task_count == 28 && sched.queue[TASK_LANE_COOPERATIVE].heap_size == 24 &&
+          __builtin_popcount(sched.queue[TASK_LANE_COOPERATIVE].event_mask) == 4 && heap_valid(),
+          "28 tasks registered: 24 in the heap, 4 in the event bitmap");
+
+    const uint64_t end_us = sil_time_now_us() + 1000000U;
+    uint32_t sets = 0;
+    while (sil_time_now_us() < end_us) {
+        if ((sil_time_now_us() % 997U) == 0) {
+            flags[sets % 4] = true;
+            sets++;
+        }
+        scheduler_run(&sched);
+        sim_advance_us(1);
+    }
+
+    int worst = 0;
+    uint32_t jitter_max = 0;
+    for (int i = 0; i < 24; i++) {
+        const task_stats_t *st = scheduler_get_stats(&sched, handles[i]);
+        int expected = (int)(1000000U / periods_us[i % 8]);
+        int err = (int)st->exec_count - expected;
+        if (err < 0) err = -err;
+        if (err > worst) worst = err;
+        if (st->jitter_max_us > jitter_max) jitter_max = st->jitter_max_us;
+    }
+    CHECK(worst <= 1 && jitter_max <= 1,
+          "1s run: every periodic task within %d run of nominal, jitter max %u us", worst, jitter_max);
+
+    uint32_t events = 0;
+    for (int i = 0; i < 4; i++) events += scheduler_get_stats(&sched, handles[24 + i])->exec_count;
+    CHECK(events == sets && heap_valid(), "event tasks: %u runs for %u flag sets, heap still valid", events, sets);
+
+    ok = true;
+    for (int i = 0; i < 24; i += 3) ok &= scheduler_suspend_task(&sched, handles[i]);
+    ok &= heap_valid() && sched.queue[TASK_LANE_COOPERATIVE].heap_size == 16;
+    for (int i = 0; i < 24; i += 6) ok &= scheduler_resume_task(&sched, handles[i]);
+    ok &= scheduler_resume_task(&sched, handles[1]);  // 未挂起的任务：重排 next_run_time
+    CHECK(ok && heap_valid() && sched.queue[TASK_LANE_COOPERATIVE].heap_size == 20,
+          "suspend/resume keep the heap ordered (%u queued)", sched.queue[TASK_LANE_COOPERATIVE].heap_size);
+
+    for (int i = 28; i < SCHEDULER_MAX_TASKS; i++) {
+        snprintf(names[i], sizeof(names[i]), "x%d", i);
+        scheduler_register_periodic(&sched, names[i], busy_task, (void *)0, TASK_PRIORITY_IDLE, 1000, 0);
+    }
+    CHECK(sched.task_count == SCHEDULER_MAX_TASKS &&
+          scheduler_register_periodic(&sched, "over", busy_task, (void *)0, TASK_PRIORITY_IDLE, 1000, 0) ==
+              TASK_HANDLE_INVALID &&
+          !scheduler_suspend_task(&sched, TASK_HANDLE_INVALID) && !scheduler_get_stats(&sched, SCHEDULER_MAX_TASKS),
+          "capacity is %d tasks, invalid handles are rejected", SCHEDULER_MAX_TASKS);
+}
+
+static void test_same_deadline_priority_order(void)
+{
+    setup();
+    order_len = 0;
+    // 逆优先级注册、同一周期：同时到期时必须按 CRITICAL -> IDLE 执行
+    scheduler_register_periodic(&sched, "idle", order_task, (void *)'I', TASK_PRIORITY_IDLE, 1000, 0);
+    scheduler_register_periodic(&sched, "low", order_task, (void *)'L', TASK_PRIORITY_LOW, 1000, 0);
+    scheduler_register_periodic(&sched, "norm", order_task, (void *)'N', TASK_PRIORITY_NORMAL, 1000, 0);
+    scheduler_register_periodic(&sched, "high", order_task, (void *)'H', TASK_PRIORITY_HIGH, 1000, 0);
+    scheduler_register_periodic(&sched, "crit", order_task, (void *)'C', TASK_PRIORITY_CRITICAL, 1000, 0);
+
+    scheduler_run(&sched);
+    CHECK(order_len == 0, "nothing runs before the first deadline");
+    sil_time_advance_us(1000);
+    scheduler_run(&sched);
+    CHECK(order_len == 5 && memcmp(order_log, "CHNLI", 5) == 0,
+          "simultaneous deadlines dispatch by priority: %.*s", order_len, order_log);
+}
+
+// 在协作通道中运行 duration_us，每步 1us
+static void run_for_us(uint64_t duration_us)
+{
+    const uint64_t end_us = sil_time_now_us() + duration_us;
+    while (sil_time_now_us() < end_us) {
+        scheduler_run(&sched);
+        sim_advance_us(1);
+    }
+}
+
+static bool on_grid(const task_entry_t *t)
+{
+    return ((t->next_run_time - sched.epoch - t->phase_cycles) % t->desc->period_cycles) == 0;
+}
+
+static task_handle_t self_suspend_h;
+static uint32_t      self_suspend_runs;
+
+// 第 3 次运行时在回调里把自己挂起
+static void self_suspend_task(void *user)
+{
+    (void)user;
+    if (++self_suspend_runs == 3) scheduler_suspend_task(&sched, self_suspend_h);
+}
+
+static void test_self_suspend(void)
+{
+    // 协作通道与实时通道各跑一遍：回调返回后不能把 SUSPENDED 改回 READY 重新入堆
+    for (int rt = 0; rt < 2; rt++) {
+        setup();
+        self_suspend_runs = 0;
+        if (rt) scheduler_enable_rt_lane(&sched, TASK_PRIORITY_HIGH);
+        self_suspend_h = scheduler_register_periodic(&sched, "self", self_suspend_task, NULL,
+                                                     rt ? TASK_PRIORITY_CRITICAL : TASK_PRIORITY_NORMAL, 1000, 0);
+        const task_entry_t *t = &sched.tasks[self_suspend_h];
+        const char *lane = rt ? "RT" : "cooperative";
+
+        run_for_us(10000);
+        CHECK(self_suspend_runs == 3 && t->state == TASK_STATE_SUSPENDED &&
+              sched.queue[t->lane].heap_size == 0 && heap_valid(),
+              "%s lane: task that suspends itself stays out of the heap (%u runs)", lane, self_suspend_runs);
+
+        scheduler_resume_task(&sched, self_suspend_h);
+        run_for_us(5000);
+        CHECK(self_suspend_runs >= 7 && t->state == TASK_STATE_READY && sched.queue[t->lane].heap_size == 1,
+              "%s lane: resume re-queues it (%u runs)", lane, self_suspend_runs);
+    }
+}
+
+static void test_anchored_no_drift(void)
+{
+    // 1kHz、每次执行 200us：旧的“结束时刻 + period”实际只有 833Hz
+    setup();
+    task_handle_t pid = scheduler_register_periodic(&sched, "pid", busy_task, (void *)200, TASK_PRIORITY_HIGH, 1000, 0);
+    run_for_us(30000000U);    // 30s，跨过 CYCCNT 在 25.6s 处的回绕
+    const task_stats_t *st = scheduler_get_stats(&sched, pid);
+    CHECK(st->exec_count >= 29999 && st->exec_count <= 30000 && st->jitter_max_us == 0 && st->missed_count == 0,
+          "anchored 1kHz task with 200us body: %u runs in 30s across the CYCCNT wrap, jitter max %u us",
+          st->exec_count, st->jitter_max_us);
+
+    setup();
+    pid = scheduler_register_periodic(&sched, "pid", busy_task, (void *)200, TASK_PRIORITY_HIGH, 1000, 0);
+    const task_timing_t rephase = { 0, TASK_OVERRUN_REPHASE, 0 };
+    scheduler_set_task_timing(&sched, pid, &rephase);
+    run_for_us(1000000U);
+    st = scheduler_get_stats(&sched, pid);
+    CHECK(st->exec_count >= 999 && st->exec_count <= 1000,
+          "REPHASE only re-anchors after a miss, so a fitting body still runs %u/1000", st->exec_count);
+}
+
+// 1kHz 控制任务 + 每 100ms 一次 3.5ms 的阻塞任务，运行 1 秒
+static const task_stats_t *run_overrun(task_overrun_policy_t policy, uint8_t catch_up_max)
+{
+    setup();
+    task_handle_t ctl = scheduler_register_periodic(&sched, "ctl", busy_task, (void *)10, TASK_PRIORITY_HIGH, 1000, 0);
+    scheduler_register_periodic(&sched, "hog", busy_task, (void *)3500, TASK_PRIORITY_LOW, 100000, 0);
+    const task_timing_t timing = { 0, policy, catch_up_max };
+    scheduler_set_task_timing(&sched, ctl, &timing);
+    run_for_us(1000000U);
+    return scheduler_get_stats(&sched, ctl);
+}
+
+static void test_overrun_policies(void)
+{
+    const task_stats_t *st = run_overrun(TASK_OVERRUN_SKIP, 0);
+    uint32_t slots = st->exec_count + st->missed_count;
+    CHECK(st->missed_count >= 15 && slots >= 999 && slots <= 1001 && on_grid(&sched.tasks[0]),
+          "SKIP: %u runs + %u skipped = %u slots, still on the grid", st->exec_count, st->missed_count, slots);
+
+    st = run_overrun(TASK_OVERRUN_CATCH_UP, 1);
+    slots = st->exec_count + st->missed_count;
+    CHECK(st->catch_up_count >= 9 && st->missed_count > 0 && slots >= 999 && slots <= 1001 &&
+          on_grid(&sched.tasks[0]),
+          "CATCH_UP(1): %u catch-up runs, %u skipped, %u slots, on the grid",
+          st->catch_up_count, st->missed_count, slots);
+
+    st = run_overrun(TASK_OVERRUN_CATCH_UP, 8);
+    CHECK(st->missed_count == 0 && st->exec_count >= 999 && st->exec_count <= 1001 && on_grid(&sched.tasks[0]),
+          "CATCH_UP(8): every slot served (%u runs, %u catch-up)", st->exec_count, st->catch_up_count);
+
+    st = run_overrun(TASK_OVERRUN_REPHASE, 0);
+    CHECK(st->exec_count + st->missed_count < 990 && !on_grid(&sched.tasks[0]),
+          "REPHASE: grid restarts after each block, %u runs", st->exec_count);
+}
+
+static uint32_t stage_offset_us[4];
+static bool     stage_offset_ok[4];
+static uint64_t epoch_us;
+
+static void stage_task(void *user)
+{
+    int stage = (int)(uintptr_t)user;
+    uint32_t off = (uint32_t)((sil_time_now_us() - epoch_us) % 1000U);
+    if (stage_offset_us[stage] != off) stage_offset_ok[stage] = false;
+    if (order_len < sizeof(order_log)) order_log[order_len++] = (char)('0' + stage);
+    sim_advance_us(50);
+}
+
+static void test_phase_pipeline(void)
+{
+    setup();
+    epoch_us = sil_time_now_us();
+    order_len = 0;
+
+    // 注册顺序打乱，相位决定同一个 1ms 周期内的先后：陀螺 0 -> 滤波 250 -> 姿态 500 -> PID 750
+    static const char *names[4] = { "gyro", "filter", "attitude", "pid" };
+    const int reg_order[4] = { 3, 1, 0, 2 };
+    task_handle_t handles[4];
+    bool ok = true;
+    for (int i = 0; i < 4; i++) {
+        int stage = reg_order[i];
+        handles[stage] = scheduler_register_periodic(&sched, names[stage], stage_task, (void *)(uintptr_t)stage,
+                                                     TASK_PRIORITY_HIGH, 1000, 0);
+        ok &= handles[stage] != TASK_HANDLE_INVALID;
+        sim_advance_us(37);   // 注册时刻各不相同
+    }
+    for (int stage = 0; stage < 4; stage++) {
+        const task_timing_t timing = { (uint32_t)(250 * stage), TASK_OVERRUN_SKIP, 0 };
+        stage_offset_us[stage] = (uint32_t)(250 * stage);
+        stage_offset_ok[stage] = true;
+        ok &= scheduler_set_task_timing(&sched, handles[stage], &timing);
+    }
+    run_for_us(1000000U);
+
+    bool all_on_phase = true;
+    uint32_t runs = 0;
+    for (int stage = 0; stage < 4; stage++) {
+        all_on_phase &= stage_offset_ok[stage];
+        runs += scheduler_get_stats(&sched, handles[stage])->exec_count;
+    }
+    // 设置时已过 148us：第一个周期的陀螺相位已过，从滤波开始
+    CHECK(ok && all_on_phase && runs >= 3996 && memcmp(order_log, "12301230123", 11) == 0,
+          "4 stages pipelined at 0/250/500/750 us of every 1ms period (%u runs, order %.11s)", runs, order_log);
+
+    const task_timing_t bad = { 1000, TASK_OVERRUN_SKIP, 0 };
+    static volatile bool flag;
+    task_handle_t evt = scheduler_register_event_flag(&sched, "evt", busy_task, (void *)0, TASK_PRIORITY_LOW, &flag, 0);
+    const task_timing_t good = { 0, TASK_OVERRUN_SKIP, 0 };
+    CHECK(!scheduler_set_task_timing(&sched, handles[0], &bad) && !scheduler_set_task_timing(&sched, evt, &good) &&
+          !scheduler_set_task_timing(&sched, TASK_HANDLE_INVALID, &good),
+          "timing rejected for phase >= period, event tasks and invalid handles");
+}
+
+static void test_hist_layout(void)
+{
+    bool contiguous = true, self_consistent = true, fine = true;
+    for (uint8_t b = 0; b < TASK_HIST_BUCKETS; b++) {
+        uint32_t lo = task_hist_bucket_low(b), w = task_hist_bucket_width(b);
+        self_consistent &= task_hist_bucket(lo) == b && task_hist_bucket(lo + w - 1) == b;
+        if (b + 1 < TASK_HIST_BUCKETS) contiguous &= task_hist_bucket_low((uint8_t)(b + 1)) == lo + w;
+        if (b >= TASK_HIST_LINEAR) fine &= w * 4 <= lo;
+    }
+    CHECK(contiguous && self_consistent && fine && TASK_HIST_BUCKETS == 92 &&
+          task_hist_bucket_low(TASK_HIST_BUCKETS - 1) + task_hist_bucket_width(TASK_HIST_BUCKETS - 1) == (1UL << 24),
+          "%d buckets tile [0, 2^24) cycles, width <= 25%% of lower bound", TASK_HIST_BUCKETS);
+
+    static task_hist_t h;
+    task_hist_reset(&h);
+    for (uint32_t i = 0; i < 140000; i++) task_hist_record(&h, (i % 10 == 0) ? 5000 : 100);
+    uint32_t p50 = task_hist_percentile(&h, 5000), p95 = task_hist_percentile(&h, 9500);
+    CHECK(h.total < 140000 && task_hist_bucket(p50) == task_hist_bucket(100) &&
+          task_hist_bucket(p95) == task_hist_bucket(5000) &&
+          task_hist_bucket(0xFFFFFFFFU) == TASK_HIST_BUCKETS - 1,
+          "16-bit counts halve on overflow and keep ratios: total %u, p50 %u, p95 %u", h.total, p50, p95);
+
+    // 单次长尾样本经过多次减半仍然保留
+    task_hist_reset(&h);
+    task_hist_record(&h, 500000);
+    for (uint32_t i = 0; i < 300000; i++) task_hist_record(&h, 100);
+    const uint8_t tail_b = task_hist_bucket(500000);
+    CHECK(h.count[tail_b] == 1 && task_hist_bucket(task_hist_percentile(&h, 10000)) == tail_b,
+          "a single outlier survives repeated halving (max %u cycles)", task_hist_percentile(&h, 10000));
+}
+
+static uint32_t tail_runs;
+static void tail_task(void *user)
+{
+    (void)user;
+    sim_advance_us((++tail_runs % 200 == 0) ? 1000 : 100);   // 0.5% 的长尾
+}
+
+static void test_percentiles_tail(void)
+{
+    setup();
+    tail_runs = 0;
+    task_handle_t ctl = scheduler_register_periodic(&sched, "ctl", tail_task, NULL, TASK_PRIORITY_HIGH, 2000, 0);
+    scheduler_register_periodic(&sched, "hog", busy_task, (void *)1500, TASK_PRIORITY_LOW, 50000, 0);
+    run_for_us(4000000U);
+
+    task_percentiles_t p;
+    const uint32_t cyc_per_us = SIL_CPU_FREQ_HZ / 1000000U;
+    bool ok = scheduler_get_percentiles(&sched, ctl, &p);
+    // 分位数落在真实值所在的桶内（桶宽 <= 25%）
+    const uint8_t short_b = task_hist_bucket(100 * cyc_per_us), long_b = task_hist_bucket(1000 * cyc_per_us);
+    CHECK(ok && task_hist_bucket(p.exec_p50) == short_b && task_hist_bucket(p.exec_p99) == short_b &&
+          task_hist_bucket(p.exec_p999) == long_b,
+          "exec p50/p99/p99.9 = %.1f/%.1f/%.1f us (0.5%% tail at 1000 us)",
+          p.exec_p50 / (float)cyc_per_us, p.exec_p99 / (float)cyc_per_us, p.exec_p999 / (float)cyc_per_us);
+    CHECK(p.jitter_p50 == 0 && p.jitter_p999 >= 500 * cyc_per_us && p.jitter_p999 <= 1500 * cyc_per_us,
+          "jitter p50/p99/p99.9 = %.1f/%.1f/%.1f us (1.5 ms LOW task every 50 ms)",
+          p.jitter_p50 / (float)cyc_per_us, p.jitter_p99 / (float)cyc_per_us, p.jitter_p999 / (float)cyc_per_us);
+    CHECK(!scheduler_get_percentiles(&sched, 2, &p), "unregistered handle -> false");
+}
+
+static uint8_t  dump_buf[8192];
+static uint32_t dump_len;
+static void dump_capture(void *user, const uint8_t *data, uint16_t len)
+{
+    (void)user;
+    for (uint16_t i = 0; i < len && dump_len < sizeof(dump_buf); i++) dump_buf[dump_len++] = data[i];
+}
+
+static uint16_t crc16_ccitt(const uint8_t *p, uint32_t len)
+{
+    uint16_t crc = 0xFFFF;
+    while (len--) {
+        crc ^= (uint16_t)(*p++) << 8;
+        for (int b = 0; b < 8; b++) crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+// 按 scheduler.h 中的格式解码一个直方图，重建 task_hist_t
+static const uint8_t *decode_hist(const uint8_t *p, task_hist_t *h)
+{
+    task_hist_reset(h);
+    uint8_t k = *p++;
+    for (uint8_t i = 0; i < k; i++) {
+        uint8_t b = p[0];
+        h->count[b] = (uint16_t)(p[1] | (p[2] << 8));
+        h->total += h->count[b];
+        p += 3;
+    }
+    return p;
+}
+
+static void test_hist_dump_decode(void)
+{
+    // 复用上一个测试的任务与统计
+    dump_len = 0;
+    uint32_t n = scheduler_dump_histograms(&sched, dump_capture, NULL);
+    const uint8_t *p = dump_buf;
+    uint32_t freq = (uint32_t)p[4] | ((uint32_t)p[5] << 8) | ((uint32_t)p[6] << 16) | ((uint32_t)p[7] << 24);
+    uint16_t crc = (uint16_t)(dump_buf[n - 2] | (dump_buf[n - 1] << 8));
+    CHECK(n == dump_len && p[0] == 'S' && p[1] == 'H' && p[2] == 1 && p[3] == 2 && freq == SIL_CPU_FREQ_HZ &&
+          p[8] == TASK_HIST_LINEAR && p[9] == TASK_HIST_SUB_BITS && p[10] == TASK_HIST_BUCKETS &&
+          crc == crc16_ccitt(dump_buf, n - 2),
+          "dump header ok, %u bytes for 2 tasks, CRC 0x%04X", n, crc);
+
+    p += 11;
+    bool match = true;
+    for (int t = 0; t < 2; t++) {
+        char name[16] = { 0 };
+        uint8_t len = *p++;
+        memcpy(name, p, len);
+        p += len;
+        const task_entry_t *e = &sched.tasks[t];
+        match &= strcmp(name, e->desc->name) == 0 && p[0] == e->desc->priority && p[1] == e->lane && p[2] == e->desc->trigger_mode;
+        uint32_t exec_count = (uint32_t)p[3] | ((uint32_t)p[4] << 8) | ((uint32_t)p[5] << 16) | ((uint32_t)p[6] << 24);
+        p += 7;
+
+        static task_hist_t exec_h, jitter_h;
+        p = decode_hist(p, &exec_h);
+        p = decode_hist(p, &jitter_h);
+        task_percentiles_t ref;
+        scheduler_get_percentiles(&sched, (task_handle_t)t, &ref);
+        match &= exec_count == e->stats.exec_count && exec_h.total == exec_count &&
+                 task_hist_percentile(&exec_h, 9990) == ref.exec_p999 &&
+                 task_hist_percentile(&jitter_h, 9900) == ref.jitter_p99;
+    }
+    CHECK(match && (uint32_t)(p - dump_buf) == n - 2,
+          "decoded names, counts and percentiles match the live histograms");
+
+    scheduler_print_histograms(&sched);
+    scheduler_reset_stats(&sched);
+    task_percentiles_t z;
+    scheduler_get_percentiles(&sched, 0, &z);
+    CHECK(sched.tasks[0].exec_hist.total == 0 && z.exec_p999 == 0, "reset_stats clears the histograms");
+}
+
+typedef struct {
+    uint32_t seq;
+} fake_frame_t;
+
+static fake_frame_t    frames[16];
+static uint32_t        posted, tick_count;
+static task_handle_t   queue_handle;
+static volatile bool   frame_flag;
+static uint32_t        flag_frames, queue_frames, queue_next_seq;
+static bool            queue_in_order;
+static task_event_t    queue_buf[8];
+
+// 每 4 个节拍（500us）一帧：同时置标志位并投递事件
+static void frame_isr(void)
+{
+    if (++tick_count % 4) return;
+    fake_frame_t *f = &frames[posted % 16];
+    f->seq = posted++;
+    frame_flag = true;
+    scheduler_post_from_isr(&sched, queue_handle, 1, (uint16_t)sizeof(*f), f);
+}
+
+static void flag_consumer(void *user)
+{
+    (void)user;
+    flag_frames++;
+    sim_advance_us(300);   // 处理期间到达的帧：标志位在返回后被清除，帧丢失
+}
+
+static void queue_consumer(void *user, const task_event_t *ev)
+{
+    (void)user;
+    const fake_frame_t *f = (const fake_frame_t *)ev->payload;
+    queue_in_order &= ev->type == 1 && ev->arg == sizeof(fake_frame_t) && f->seq == queue_next_seq;
+    queue_next_seq = f->seq + 1;
+    queue_frames++;
+    sim_advance_us(300);
+}
+
+static void test_event_queue_vs_flag(void)
+{
+    setup();
+    posted = tick_count = flag_frames = queue_frames = queue_next_seq = 0;
+    queue_in_order = true;
+    frame_flag = false;
+
+    task_handle_t flag = scheduler_register_event_flag(&sched, "flag", flag_consumer, NULL, TASK_PRIORITY_NORMAL,
+                                                       &frame_flag, 0);
+    queue_handle = scheduler_register_event_queue(&sched, "queue", queue_consumer, NULL, TASK_PRIORITY_NORMAL,
+                                                  queue_buf, 8, 0);
+    tick_hook = frame_isr;
+    run_for_us(1000000U);
+    tick_hook = NULL;
+    run_for_us(5000U);     // 处理完剩余事件
+
+    const task_stats_t *st = scheduler_get_stats(&sched, queue_handle);
+    CHECK(flag == 0 && queue_handle == 1 && posted == 2000, "2000 frames posted from the tick ISR");
+    CHECK(flag_frames < posted * 3 / 4, "volatile bool flag loses frames that arrive while busy: %u/%u",
+          flag_frames, posted);
+    CHECK(queue_frames == posted && queue_in_order && st->event_drop_count == 0,
+          "event queue delivers every payload in order: %u/%u, drops %u", queue_frames, posted,
+          st->event_drop_count);
+
+    task_percentiles_t p;
+    scheduler_get_percentiles(&sched, queue_handle, &p);
+    CHECK(p.jitter_p999 > 0 && st->jitter_max_us <= 700,
+          "queue jitter is measured from the post timestamp: max %u us", st->jitter_max_us);
+}
+
+static void test_event_queue_overflow(void)
+{
+    setup();
+    static task_event_t small_buf[4];
+    queue_frames = queue_next_seq = posted = 0;
+    queue_in_order = true;
+
+    CHECK(scheduler_register_event_queue(&sched, "bad", queue_consumer, NULL, TASK_PRIORITY_LOW, small_buf, 6, 0) ==
+              TASK_HANDLE_INVALID &&
+          scheduler_register_event_queue(&sched, "bad", queue_consumer, NULL, TASK_PRIORITY_LOW, small_buf, 1, 0) ==
+              TASK_HANDLE_INVALID,
+          "queue depth must be a power of two >= 2");
+    task_handle_t per = scheduler_register_periodic(&sched, "per", busy_task, (void *)0, TASK_PRIORITY_LOW, 1000, 0);
+    task_handle_t h = scheduler_register_event_queue(&sched, "q4", queue_consumer, NULL, TASK_PRIORITY_LOW,
+                                                     small_buf, 4, 0);
+
+    scheduler_suspend_task(&sched, h);
+    int accepted = 0;
+    for (int i = 0; i < 6; i++) {
+        frames[i].seq = (uint32_t)i;
+        accepted += scheduler_post_from_isr(&sched, h, 1, (uint16_t)sizeof(fake_frame_t), &frames[i]);
+    }
+    scheduler_run(&sched);
+    const task_stats_t *st = scheduler_get_stats(&sched, h);
+    CHECK(accepted == 4 && st->event_drop_count == 2 && queue_frames == 0,
+          "full queue drops newest events: accepted %d, drops %u", accepted, st->event_drop_count);
+
+    scheduler_resume_task(&sched, h);
+    scheduler_run(&sched);
+    CHECK(queue_frames == 4 && queue_in_order && st->exec_count == 1,
+          "one dispatch drains the 4 queued events in order");
+
+    CHECK(!scheduler_post_from_isr(&sched, per, 0, 0, NULL) &&
+          !scheduler_post_from_isr(&sched, TASK_HANDLE_INVALID, 0, 0, NULL) &&
+          !scheduler_post_from_isr(&sched, 17, 0, 0, NULL),
+          "post rejects non-queue tasks and invalid handles");
+    CHECK(scheduler_find_task(&sched, "q4") == h && scheduler_find_task(&sched, "nope") == TASK_HANDLE_INVALID,
+          "name lookup (CLI) resolves to the registration handle");
+}
+
+static uint32_t wfi_calls;
+
+// 模拟 WFI：睡到下一个节拍中断
+static void sim_wfi(void *user, uint32_t idle_cycles)
+{
+    (void)user;
+    (void)idle_cycles;
+    wfi_calls++;
+    sim_advance_us((uint32_t)(next_tick_us - sil_time_now_us()));
+}
+
+static int late_event_polls;
+static bool late_event(void *user)
+{
+    (void)user;
+    return ++late_event_polls >= 2;   // 第一次轮询之后“中断”才置位
+}
+
+static bool near(float v, float ref, float tol) { return v >= ref - tol && v <= ref + tol; }
+
+static void test_cpu_load_breakdown(void)
+{
+    // 实时通道 1kHz x 100us 陀螺 + 协作 50Hz x 2ms 气压计（被陀螺抢占），其余时间睡眠
+    setup();
+    wfi_calls = 0;
+    task_handle_t gyro = scheduler_register_periodic(&sched, "gyro", busy_task, (void *)100,
+                                                     TASK_PRIORITY_HIGH, 1000, 0);
+    task_handle_t baro = scheduler_register_periodic(&sched, "baro", busy_task, (void *)2000,
+                                                     TASK_PRIORITY_LOW, 20000, 0);
+    scheduler_enable_rt_lane(&sched, TASK_PRIORITY_HIGH);
+    scheduler_set_idle_hook(&sched, sim_wfi, NULL, 0);
+
+    const uint64_t end_us = sil_time_now_us() + 1500000U;
+    while (sil_time_now_us() < end_us) {
+        scheduler_run(&sched);     // 主循环不再额外推进时间：空闲全部发生在空闲回调中
+    }
+
+    const scheduler_load_t *ld = scheduler_get_load(&sched);
+    const task_stats_t *g = scheduler_get_stats(&sched, gyro);
+    const task_stats_t *b = scheduler_get_stats(&sched, baro);
+    CHECK(near(g->cpu_load, 10.0f, 0.2f) && near(b->cpu_load, 10.0f, 0.3f),   // 窗口内 49~50 次 x 2ms
+          "per-task load: gyro %.2f%%, baro %.2f%% (preemption not charged to baro)", g->cpu_load, b->cpu_load);
+    CHECK(near(ld->task, 20.0f, 0.4f) && near(ld->idle, 80.0f, 0.4f) && near(ld->cpu_load, 20.0f, 0.4f) &&
+          ld->overhead < 0.1f && ld->other < 0.3f,
+          "breakdown: load %.2f%% = task %.2f + overhead %.2f + other %.2f, idle %.2f%%",
+          ld->cpu_load, ld->task, ld->overhead, ld->other, ld->idle);
+    CHECK(near(ld->sleep, ld->idle, 0.3f) && wfi_calls > 1000 && scheduler_get_cpu_load(&sched) == ld->cpu_load,
+          "idle hook: %u sleeps, %.2f%% of the window asleep", wfi_calls, ld->sleep);
+
+    // 轮询之后才到达的事件：关中断复查发现，不进入睡眠
+    setup();
+    wfi_calls = 0;
+    late_event_polls = 0;
+    scheduler_register_event_callback(&sched, "late", busy_task, late_event, (void *)0, TASK_PRIORITY_NORMAL, 0);
+    scheduler_set_idle_hook(&sched, sim_wfi, NULL, 0);
+    scheduler_run(&sched);
+    CHECK(wfi_calls == 0 && late_event_polls == 2, "event raised after the poll keeps the core awake");
+
+    // 距下一个到期不足 min_idle_us：不睡
+    setup();
+    wfi_calls = 0;
+    scheduler_register_periodic(&sched, "tick", busy_task, (void *)0, TASK_PRIORITY_NORMAL, 1000, 0);
+    scheduler_set_idle_hook(&sched, sim_wfi, NULL, 200);
+    sim_advance_us(900);
+    scheduler_run(&sched);
+    uint32_t near_deadline = wfi_calls;
+    sim_advance_us(150);            // 执行 tick，距下一次到期 950us
+    scheduler_run(&sched);
+    scheduler_run(&sched);
+    CHECK(near_deadline == 0 && wfi_calls == 1, "no sleep within min_idle_us of the next deadline");
+
+    // 默认空闲回调：余量不超过唤醒间隔（默认 1ms SysTick）时不执行 WFI
+    uint32_t wfi_before = sil_wfi_count;
+    scheduler_idle_wfi(NULL, clockMicrosToCycles(SCHEDULER_IDLE_WAKE_US));
+    uint32_t within_tick = sil_wfi_count - wfi_before;
+    scheduler_idle_wfi(NULL, clockMicrosToCycles(SCHEDULER_IDLE_WAKE_US + 1));
+    uint32_t beyond_tick = sil_wfi_count - wfi_before;
+    const uint32_t wake_us = 100;
+    scheduler_idle_wfi((void *)&wake_us, clockMicrosToCycles(500));
+    CHECK(within_tick == 0 && beyond_tick == 1 && sil_wfi_count - wfi_before == 2,
+          "idle_wfi sleeps only when the slack exceeds the wake interval");
+}
+
+// 与 run_flight_mix 相同的四个周期任务，外加一个标志位任务和一个事件队列任务
+static volatile bool manifest_flag;
+static task_event_t  manifest_events[8];
+static uint32_t      manifest_event_runs;
+static void manifest_event_task(void *user, const task_event_t *ev)
+{
+    (void)user;
+    manifest_event_runs += ev->arg;
+}
+
+#define TEST_TASKS(PERIODIC, EVENT_FLAG, EVENT_CB, EVENT_QUEUE)                                         \
+    PERIODIC(gyro, busy_task, (void *)20, TASK_PRIORITY_CRITICAL, 1000, 200)                            \
+    PERIODIC(pid, busy_task, (void *)30, TASK_PRIORITY_HIGH, 1000, 200)                                 \
+    PERIODIC(baro, busy_task, (void *)3000, TASK_PRIORITY_LOW, 20000, 4000)                             \
+    PERIODIC(led, busy_task, (void *)5, TASK_PRIORITY_IDLE, 100000, 50)                                 \
+    EVENT_FLAG(imu, imu_task, NULL, TASK_PRIORITY_HIGH, &manifest_flag, 1000, 20)                       \
+    EVENT_QUEUE(link, manifest_event_task, NULL, TASK_PRIORITY_NORMAL, manifest_events, 8, 0, 100)
+
+TASK_MANIFEST_IDS(test, TEST_TASKS);
+TASK_MANIFEST_DEFINE(test, TEST_TASKS);
+
+static void test_manifest_table(void)
+{
+    // 动态注册的参考结果
+    run_flight_mix(true);
+    task_stats_t ref[4];
+    const task_handle_t ref_h[4] = { gyro_h, pid_h, baro_h, led_h };
+    for (int i = 0; i < 4; i++) ref[i] = *scheduler_get_stats(&sched, ref_h[i]);
+
+    CHECK(TASK_COUNT_test == 6 && TASK_ID_gyro == 0 && TASK_ID_link == 5,
+          "manifest enum: %d tasks, handles are table indices", TASK_COUNT_test);
+    CHECK(TASK_MANIFEST_UTIL_PPM(TEST_TASKS) == 200000U + 200000U + 200000U + 500U + 20000U,
+          "worst-case utilisation computed at compile time: %lu ppm",
+          (unsigned long)TASK_MANIFEST_UTIL_PPM(TEST_TASKS));
+
+    setup();
+    bool ok = scheduler_init_static(&sched, &test_task_table, storage, SCHEDULER_MAX_TASKS, NULL);
+    CHECK(ok && sched.task_count == TASK_COUNT_test &&
+          sched.tasks[TASK_ID_baro].desc == &test_task_table.tasks[TASK_ID_baro] &&
+          sched.tasks[TASK_ID_baro].desc->period_cycles == 20000U * (SystemCoreClock / 1000000U) &&
+          scheduler_find_task(&sched, "link") == TASK_ID_link,
+          "static init: descriptors stay in the const table, periods precomputed in cycles");
+
+    scheduler_enable_rt_lane(&sched, TASK_PRIORITY_HIGH);
+    run_mix_1s();
+    bool same = true;
+    for (int i = 0; i < 4; i++) {
+        const task_stats_t *st = scheduler_get_stats(&sched, (task_handle_t)i);
+        same &= st->exec_count == ref[i].exec_count && st->missed_count == ref[i].missed_count &&
+                st->jitter_max_us == ref[i].jitter_max_us;
+    }
+    CHECK(same, "manifest schedule matches dynamic registration: gyro %u runs, baro %u runs, gyro jitter max %u us",
+          scheduler_get_stats(&sched, TASK_ID_gyro)->exec_count,
+          scheduler_get_stats(&sched, TASK_ID_baro)->exec_count,
+          scheduler_get_stats(&sched, TASK_ID_gyro)->jitter_max_us);
+
+    manifest_event_runs = 0;
+    imu_runs = 0;
+    manifest_flag = true;
+    scheduler_post_from_isr(&sched, TASK_ID_link, 1, 7, NULL);
+    run_for_us(2000U);
+    CHECK(imu_runs == 1 && !manifest_flag && manifest_event_runs == 7,
+          "event flag and event queue tasks from the table dispatch");
+
+    task_handle_t extra = scheduler_register_periodic(&sched, "extra", busy_task, (void *)1,
+                                                      TASK_PRIORITY_IDLE, 50000, 0);
+    CHECK(extra == TASK_COUNT_test, "dynamic registration continues after the static table (handle %d)", extra);
+
+    // 表的主频与运行主频不一致 / 容量不足
+    setup();
+    const scheduler_config_t slow = { .enable_stats = true, .enable_overrun_check = true,
+                                      .cpu_freq_hz = SCHEDULER_CPU_HZ / 2, .max_tasks = SCHEDULER_MAX_TASKS };
+    CHECK(!scheduler_init_static(&sched, &test_task_table, storage, SCHEDULER_MAX_TASKS, &slow),
+          "table built for another core clock rejected");
+    CHECK(!scheduler_init_static(&sched, &test_task_table, storage, TASK_COUNT_test - 1, NULL),
+          "state array smaller than the table rejected");
+}
+
+int main(void)
+{
+    test_cooperative_baseline();
+    test_rt_lane_bounds_jitter();
+    test_event_task_in_rt_lane();
+    test_heap_dispatch_many_tasks();
+    test_same_deadline_priority_order();
+    test_self_suspend();
+    test_anchored_no_drift();
+    test_overrun_policies();
+    test_phase_pipeline();
+    test_hist_layout();
+    test_percentiles_tail();
+    test_hist_dump_decode();
+    test_event_queue_vs_flag();
+    test_event_queue_overflow();
+    test_cpu_load_breakdown();
+    test_manifest_table();
+
+    return sil_test_report();
+}
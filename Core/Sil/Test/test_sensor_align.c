@@ -0,0 +1,203 @@
+/**
+ * @file    test_sensor_align.c
+ * @brief   SIL 测试：板载/传感器安装方向（sensor_align）及其在陀螺仪、加速度计、磁力计处理中的应用
+ * @note    检查：8 种 90° 步进均预编译为置换快路径且与查表一致；微调角与步进同旋向
+ *          （yaw 90 = CW90，roll/pitch 180 = 倒装）；板载与传感器方向相乘可抵消为单位阵；
+ *          非 90° 微调走矩阵路径且为正交阵；无效配置被拒绝；
+ *          sensor_alignment_configure 下发后三个 *_process_sample 输出为机体系，
+ *          零偏在传感器系中减去，方向在 *_processing_init 之后保留。
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "sil_board.h"
+#include "sensor_align.h"
+#include "imu_frontend.h"
+#include "task_gyro.h"
+#include "task_acc.h"
+#include "task_mag.h"
+#include "icm42688p_lib.h"
+#include "sil_test.h"
+
+// 各步进下 (1, 2, 3) 的期望输出
+static const float step_expect[SENSOR_ALIGN_COUNT][3] = {
+    [SENSOR_ALIGN_CW0]        = {  1,  2,  3 },
+    [SENSOR_ALIGN_CW90]       = {  2, -1,  3 },
+    [SENSOR_ALIGN_CW180]      = { -1, -2,  3 },
+    [SENSOR_ALIGN_CW270]      = { -2,  1,  3 },
+    [SENSOR_ALIGN_CW0_FLIP]   = { -1,  2, -3 },
+    [SENSOR_ALIGN_CW90_FLIP]  = {  2,  1, -3 },
+    [SENSOR_ALIGN_CW180_FLIP] = {  1, -2, -3 },
+    [SENSOR_ALIGN_CW270_FLIP] = { -2, -1, -3 },
+};
+
+static bool same_rotation(const sensor_rotation_t *a, const sensor_rotation_t *b)
+{
+    if (a->kind != b->kind) return false;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            if (fabsf(a->m[i][j] - b->m[i][j]) > 1e-6f) return false;
+        }
+    }
+    return true;
+}
+
+static void test_steps(void)
+{
+    int wrong = 0, slow = 0;
+    for (int s = 0; s < SENSOR_ALIGN_COUNT; s++) {
+        const sensor_align_t cfg = { .step = (sensor_align_step_e)s };
+        sensor_rotation_t rot;
+        if (!sensor_rotation_build(&rot, NULL, &cfg)) {
+            wrong++;
+            continue;
+        }
+        const sensor_rotation_kind_e want = (s == SENSOR_ALIGN_CW0) ? SENSOR_ROTATION_IDENTITY
+                                                                    : SENSOR_ROTATION_PERMUTE;
+        if (rot.kind != want) slow++;
+        float v[3] = { 1, 2, 3 };
+        sensor_rotation_apply(&rot, v);
+        for (int a = 0; a < 3; a++) {
+            if (v[a] != step_expect[s][a]) wrong++;
+        }
+    }
+    CHECK(wrong == 0 && slow == 0, "all 8 90-degree steps precompile to the permutation path (%d wrong, %d matrix)",
+          wrong, slow);
+}
+
+static void test_trim_matches_steps(void)
+{
+    sensor_rotation_t a, b;
+    const sensor_align_t yaw90 = { .step = SENSOR_ALIGN_CW0, .yaw_deg = 90.0f };
+    const sensor_align_t cw90 = { .step = SENSOR_ALIGN_CW90 };
+    sensor_rotation_build(&a, NULL, &yaw90);
+    sensor_rotation_build(&b, NULL, &cw90);
+    CHECK(same_rotation(&a, &b), "yaw trim 90 == CW90 (snapped to the permutation path)");
+
+    const sensor_align_t roll180 = { .step = SENSOR_ALIGN_CW0, .roll_deg = 180.0f };
+    const sensor_align_t cw180f = { .step = SENSOR_ALIGN_CW180_FLIP };
+    sensor_rotation_build(&a, NULL, &roll180);
+    sensor_rotation_build(&b, NULL, &cw180f);
+    CHECK(same_rotation(&a, &b), "roll trim 180 == CW180_FLIP");
+
+    const sensor_align_t pitch180 = { .step = SENSOR_ALIGN_CW0, .pitch_deg = 180.0f };
+    const sensor_align_t cw0f = { .step = SENSOR_ALIGN_CW0_FLIP };
+    sensor_rotation_build(&a, NULL, &pitch180);
+    sensor_rotation_build(&b, NULL, &cw0f);
+    CHECK(same_rotation(&a, &b), "pitch trim 180 == CW0_FLIP");
+
+    // 板载 CW90 + 传感器 CW270 抵消
+    const sensor_align_t board = { .step = SENSOR_ALIGN_CW90 };
+    const sensor_align_t sensor = { .step = SENSOR_ALIGN_CW270 };
+    sensor_rotation_build(&a, &board, &sensor);
+    CHECK(a.kind == SENSOR_ROTATION_IDENTITY, "board CW90 * sensor CW270 = identity");
+}
+
+static void test_fine_trim(void)
+{
+    // 传感器 CW90 + 3° yaw 微调：绕 Z 轴共 93°，走矩阵路径
+    const sensor_align_t cfg = { .step = SENSOR_ALIGN_CW90, .yaw_deg = 3.0f };
+    sensor_rotation_t rot;
+    CHECK(sensor_rotation_build(&rot, NULL, &cfg) && rot.kind == SENSOR_ROTATION_MATRIX,
+          "fine trim selects the matrix path");
+
+    double ortho = 0.0;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            double d = 0.0;
+            for (int k = 0; k < 3; k++) d += (double)rot.m[i][k] * rot.m[j][k];
+            ortho = fmax(ortho, fabs(d - (i == j ? 1.0 : 0.0)));
+        }
+    }
+    const double a = -93.0 * 3.14159265358979323846 / 180.0;
+    float v[3] = { 1.0f, 0.0f, 0.0f };
+    sensor_rotation_apply(&rot, v);
+    const double err = fabs(v[0] - cos(a)) + fabs(v[1] - sin(a)) + fabs(v[2]);
+    CHECK(ortho < 1e-6 && err < 1e-6, "trim matrix orthonormal (%.1e) and rotates x by -93 deg about z (err %.1e)",
+          ortho, err);
+
+    // 整数前端：Q14 量化后与浮点相差不超过 2 个计数
+    imu_frontend_t fe;
+    imu_frontend_init(&fe);
+    imu_frontend_set_alignment(&fe, &rot);
+    double worst = 0.0;
+    static const int16_t zero[3] = { 0, 0, 0 };
+    for (int i = -16000; i <= 16000; i += 137) {
+        const int16_t raw[3] = { (int16_t)i, (int16_t)(-i / 2), (int16_t)(i / 3) };
+        int16_t got[3];
+        imu_frontend_apply(&fe, raw, zero, got);
+        float ref[3] = { raw[0], raw[1], raw[2] };
+        sensor_rotation_apply(&rot, ref);
+        for (int k = 0; k < 3; k++) worst = fmax(worst, fabs(got[k] - ref[k]));
+    }
+    CHECK(fe.mode == SENSOR_ROTATION_MATRIX && worst <= 2.0,
+          "integer front end matches the float matrix within %.2f counts", worst);
+}
+
+static void test_invalid(void)
+{
+    sensor_rotation_t rot = { .kind = SENSOR_ROTATION_PERMUTE };
+    const sensor_align_t bad_step = { .step = SENSOR_ALIGN_COUNT };
+    const sensor_align_t bad_trim = { .step = SENSOR_ALIGN_CW0, .roll_deg = NAN };
+    CHECK(!sensor_rotation_build(&rot, NULL, &bad_step) && rot.kind == SENSOR_ROTATION_PERMUTE,
+          "out-of-range step rejected, rotation unchanged");
+    CHECK(!sensor_rotation_build(&rot, &bad_trim, NULL), "non-finite trim rejected");
+    CHECK(!sensor_alignment_configure(NULL, &bad_step, NULL), "configure rejects an invalid IMU alignment");
+}
+
+static void test_processing(void)
+{
+    sil_board_init();
+    gyro_processing_init(1);
+    accel_processing_init();
+    mag_processing_init();
+    mag_set_calibration(0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f);
+
+    // IMU 倒装 CW90（x' = y, y' = x, z' = -z），磁力计 CW180
+    const sensor_align_t imu = { .step = SENSOR_ALIGN_CW90_FLIP };
+    const sensor_align_t mag = { .step = SENSOR_ALIGN_CW180 };
+    CHECK(sensor_alignment_configure(NULL, &imu, &mag), "alignment configured");
+
+    // 重新初始化后方向保留
+    gyro_processing_init(1);
+    accel_processing_init();
+    mag_processing_init();
+
+    icm.gyro_offset[0] = 10; icm.gyro_offset[1] = -20; icm.gyro_offset[2] = 30;
+    gyro_process_sample(1010, 1980, -32768);
+    CHECK(gyro_compensated.x == 2000 && gyro_compensated.y == 1000 && gyro_compensated.z == 32767,
+          "gyro: offset removed in sensor frame, then rotated (%d, %d, %d)",
+          gyro_compensated.x, gyro_compensated.y, gyro_compensated.z);
+    CHECK(gyro_decimated.ready && fabsf(gyro_decimated.dps_x - 2000.0f / icm.gyro_scale) < 1e-4f &&
+          fabsf(gyro_decimated.dps_y - 1000.0f / icm.gyro_scale) < 1e-4f,
+          "gyro: decimated output is in the body frame");
+    icm.gyro_offset[0] = icm.gyro_offset[1] = icm.gyro_offset[2] = 0;
+
+    // 水平静止、芯片倒装：传感器 z 读 -1g，机体 z 应为 +1g
+    accel_process_sample(0, 0, (int16_t)-icm.accel_scale);
+    CHECK(fabsf(accel_scaled.g_z - 1.0f) < 1e-6f && accel_scaled.g_x == 0.0f && accel_scaled.g_y == 0.0f,
+          "accel: upside-down chip reads +1g on body z (%.3f)", (double)accel_scaled.g_z);
+
+    mag_process_sample(300, -200, 100);
+    const float k = 1.0f / hmc_dev.gain_scale;
+    CHECK(fabsf(mag_calibrated.gauss_x + 300.0f * k) < 1e-6f && fabsf(mag_calibrated.gauss_y - 200.0f * k) < 1e-6f &&
+          fabsf(mag_calibrated.gauss_z - 100.0f * k) < 1e-6f && mag_raw.x == 300,
+          "mag: calibrated in sensor frame, rotated CW180, raw kept");
+
+    // 恢复默认方向，避免影响同进程中的其他用例
+    CHECK(sensor_alignment_configure(NULL, NULL, NULL), "alignment reset to identity");
+    gyro_process_sample(1, 2, 3);
+    CHECK(gyro_compensated.x == 1 && gyro_compensated.y == 2 && gyro_compensated.z == 3, "identity restored");
+}
+
+int main(void)
+{
+    test_steps();
+    test_trim_matches_steps();
+    test_fine_trim();
+    test_invalid();
+    test_processing();
+
+    return sil_test_report();
+}
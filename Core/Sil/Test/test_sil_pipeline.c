@@ -0,0 +1,187 @@
+/**
+ * @file    test_sil_pipeline.c
+ * @brief   SIL 回归测试：task_gyro -> task_filter -> Attitude_Update -> task_pid 全链路
+ * @note    用合成的 8kHz IMU 数据驱动固件原始代码，检查静止水平、定速旋转积分
+ *          以及 ELRS 帧 -> RC 指令 -> 混控输出，并报告主机吞吐量。
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <time.h>
+#include "sil_board.h"
+#include "attitude.h"
+#include "task_gyro.h"
+#include "task_acc.h"
+#include "task_fliter.h"
+#include "task_rc.h"
+#include "task_pid.h"
+#include "elrs_crsf_uart.h"
+#include "elrs_crsf_port.h"
+#include "sil_test.h"
+
+#define GYRO_ODR_HZ     8000U
+#define DECIM           8U
+#define CONTROL_HZ      (GYRO_ODR_HZ / DECIM)
+
+static int16_t to_raw(float v, float scale)
+{
+    float r = v * scale;
+    if (r > 32767.0f) r = 32767.0f;
+    if (r < -32768.0f) r = -32768.0f;
+    return (int16_t)lrintf(r);
+}
+
+static void pipeline_init(void)
+{
+    sil_board_init();
+    gyro_processing_init(DECIM);
+    accel_processing_init();
+    gyro_filter_init((float)CONTROL_HZ, 100.0f, 300.0f);
+    Attitude_InitFromAccelerometer(0.0f, 0.0f, 1.0f);
+    task_pid_init((float)CONTROL_HZ);
+}
+
+/**
+ * @brief 以 8kHz 送入一个 IMU 样本，降采样输出就绪时跑一次滤波 + 姿态 + PID
+ * @return 本次是否跑了控制环
+ */
+static bool pipeline_step(float gx_dps, float gy_dps, float gz_dps,
+                          float ax_g, float ay_g, float az_g)
+{
+    sil_time_advance_us(1000000U / GYRO_ODR_HZ);
+
+    gyro_process_sample(to_raw(gx_dps, icm.gyro_scale),
+                        to_raw(gy_dps, icm.gyro_scale),
+                        to_raw(gz_dps, icm.gyro_scale));
+    if (!gyro_decimated.ready) {
+        return false;
+    }
+
+    accel_process_sample(to_raw(ax_g, icm.accel_scale),
+                         to_raw(ay_g, icm.accel_scale),
+                         to_raw(az_g, icm.accel_scale));
+    gyro_filter_feed_sample(gyro_decimated.dps_x, gyro_decimated.dps_y, gyro_decimated.dps_z);
+
+    Attitude_Update_IMU_Only(accel_scaled.g_x, accel_scaled.g_y, accel_scaled.g_z,
+                             gyro_filtered.dps_x, gyro_filtered.dps_y, gyro_filtered.dps_z);
+    task_pid_step(1.0f / (float)CONTROL_HZ, 400.0f);
+    return true;
+}
+
+static void test_static_level(void)
+{
+    pipeline_init();
+    for (uint32_t i = 0; i < 10U * GYRO_ODR_HZ; i++) {
+        pipeline_step(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+    }
+    Euler_angles a = Attitude_Get_Angles();
+    CHECK(fabsf(a.roll) < 0.5f && fabsf(a.pitch) < 0.5f && fabsf(a.yaw) < 0.5f,
+          "static level 10s: roll=%.3f pitch=%.3f yaw=%.3f deg", a.roll, a.pitch, a.yaw);
+}
+
+static void test_constant_yaw_rate(void)
+{
+    pipeline_init();
+    // 先静止 0.5s 让滤波器稳定，再以 45dps 绕 Z 旋转 1s
+    for (uint32_t i = 0; i < GYRO_ODR_HZ / 2U; i++) {
+        pipeline_step(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+    }
+    for (uint32_t i = 0; i < GYRO_ODR_HZ; i++) {
+        pipeline_step(0.0f, 0.0f, 45.0f, 0.0f, 0.0f, 1.0f);
+    }
+    for (uint32_t i = 0; i < GYRO_ODR_HZ / 2U; i++) {
+        pipeline_step(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+    }
+    Euler_angles a = Attitude_Get_Angles();
+    CHECK(fabsf(a.yaw - 45.0f) < 1.0f,
+          "45dps x 1s yaw integration: yaw=%.3f deg (expect 45)", a.yaw);
+}
+
+// 构造一帧 CRSF RC_CHANNELS_PACKED（16 通道 x 11bit）
+static uint8_t build_rc_frame(uint8_t *out, const uint16_t ch[16])
+{
+    uint8_t payload[22];
+    memset(payload, 0, sizeof(payload));
+    for (uint16_t i = 0; i < 16; i++) {
+        uint16_t bit = (uint16_t)(i * 11U);
+        for (uint8_t b = 0; b < 11; b++, bit++) {
+            if (ch[i] & (1U << b)) {
+                payload[bit >> 3] |= (uint8_t)(1U << (bit & 7U));
+            }
+        }
+    }
+    out[0] = ELRS_CRSF_ADDRESS_FLIGHT_CONTROLLER;
+    out[1] = (uint8_t)(sizeof(payload) + 2U);
+    out[2] = ELRS_CRSF_FRAMETYPE_RC_CHANNELS_PACKED;
+    memcpy(&out[3], payload, sizeof(payload));
+
+    uint8_t crc = 0;
+    for (uint8_t i = 2; i < 3U + sizeof(payload); i++) {
+        crc ^= out[i];
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0xD5) : (uint8_t)(crc << 1);
+        }
+    }
+    out[3 + sizeof(payload)] = crc;
+    return (uint8_t)(4U + sizeof(payload));
+}
+
+static void test_rc_to_motors(void)
+{
+    pipeline_init();
+    ELRS_CRSF_InitOnUART1();
+
+    uint16_t ch[16];
+    for (uint8_t i = 0; i < 16; i++) ch[i] = 1024;
+    ch[RC_CH_INDEX_THROTTLE] = 1024;  // ~50% 油门
+
+    uint8_t frame[ELRS_CRSF_FRAME_MAX];
+    uint8_t len = build_rc_frame(frame, ch);
+    sil_uart_inject(1, frame, len);
+
+    rc_update(30.0f, 30.0f, 180.0f, 100);
+    const rc_command_t *rc = rc_get_command();
+    CHECK(rc->link_active && fabsf(rc->throttle - 0.5f) < 0.01f,
+          "CRSF frame -> rc_update: link=%d throttle=%.3f", rc->link_active, rc->throttle);
+
+    const pid_output_t *out = NULL;
+    for (uint32_t i = 0; i < GYRO_ODR_HZ / 10U; i++) {
+        if (pipeline_step(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f)) {
+            out = task_pid_step(1.0f / (float)CONTROL_HZ, 400.0f);
+        }
+    }
+    bool balanced = out && out->link_active;
+    for (uint8_t m = 0; balanced && m < 4; m++) {
+        balanced = fabsf(out->motor[m] - rc->throttle) < 0.02f;
+    }
+    CHECK(balanced, "level hover mix: motors=%.3f %.3f %.3f %.3f",
+          out ? out->motor[0] : -1.0f, out ? out->motor[1] : -1.0f,
+          out ? out->motor[2] : -1.0f, out ? out->motor[3] : -1.0f);
+}
+
+static void report_throughput(void)
+{
+    pipeline_init();
+    const uint32_t n = 60U * GYRO_ODR_HZ;  // 60s 飞行数据
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (uint32_t i = 0; i < n; i++) {
+        float s = (float)(i & 1023U) * (1.0f / 1024.0f);
+        pipeline_step(100.0f * s, -50.0f * s, 20.0f, 0.02f, -0.01f, 0.99f);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double sec = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    printf("[INFO] throughput: %u gyro samples in %.3fs => %.2f Msamples/s (%.0fx real time)\n",
+           n, sec, (double)n / sec * 1e-6, 60.0 / sec);
+}
+
+int main(void)
+{
+    test_static_level();
+    test_constant_yaw_rate();
+    test_rc_to_motors();
+    report_throughput();
+
+    return sil_test_report();
+}
@@ -0,0 +1,141 @@
+/**
+ * @file    sil_board.c
+ * @brief   SIL 虚拟板级支持实现
+ */
+
+#include "sil_board.h"
+#include "bsp_System.h"
+#include "bsp_uart.h"
+#include "bsp_flash.h"
+#include "hmc5883l.h"
+#include <string.h>
+
+// 设备实例（固件中由驱动层定义）
+icm42688p_dev_t icm;
+hmc5883l_dev_t hmc_dev;
+
+static uint8_t  uart_tx_buf[SIL_UART_TX_CAPTURE];
+static uint16_t uart_tx_len = 0;
+
+void sil_board_init(void)
+{
+    sil_time_reset();
+    cycleCounterInit();
+
+    memset(&icm, 0, sizeof(icm));
+    icm.config.gyro_fsr  = ICM42688P_GYRO_FSR_2000DPS;
+    icm.config.accel_fsr = ICM42688P_ACCEL_FSR_2G;
+    icm.config.gyro_odr  = ICM42688P_ODR_8KHZ;
+    icm.config.accel_odr = ICM42688P_ODR_1KHZ;
+    icm.gyro_scale  = icm42688p_get_gyro_scale(icm.config.gyro_fsr);
+    icm.accel_scale = icm42688p_get_accel_scale(icm.config.accel_fsr);
+
+    memset(&hmc_dev, 0, sizeof(hmc_dev));
+    hmc_dev.config.gain = HMC5883L_GAIN_1_3GA;
+    hmc_dev.gain_scale  = hmc5883l_get_gain_scale(hmc_dev.config.gain);
+
+    uart_tx_len = 0;
+}
+
+// ============================================================================
+// UART 替身（bsp_uart.h）
+// ============================================================================
+
+void BSP_UART_Init(void)
+{
+}
+
+void BSP_UART_Open(uint8_t uart_id, uint32_t baudrate)
+{
+    (void)uart_id;
+    (void)baudrate;
+}
+
+int BSP_UART_Write(uint8_t uart_id, const uint8_t *data, uint16_t len)
+{
+    (void)uart_id;
+    if (!data) return -1;
+    for (uint16_t i = 0; i < len && uart_tx_len < SIL_UART_TX_CAPTURE; i++) {
+        uart_tx_buf[uart_tx_len++] = data[i];
+    }
+    return len;
+}
+
+// 控制台钩子缺省为空（与 bsp_uart.c 的弱定义一致），测试可重载
+__attribute__((weak)) void BSP_UART_ConsoleByteCallback(uint8_t uart_id, uint8_t byte)
+{
+    (void)uart_id;
+    (void)byte;
+}
+
+void sil_uart_inject(uint8_t uart_id, const uint8_t *data, uint16_t len)
+{
+    if (!data) return;
+    for (uint16_t i = 0; i < len; i++) {
+        BSP_UART_RxByteCallback(uart_id, data[i]);
+    }
+}
+
+uint16_t sil_uart_tx_captured(const uint8_t **data)
+{
+    if (data) *data = uart_tx_buf;
+    return uart_tx_len;
+}
+
+// ============================================================================
+// Flash 配置扇区替身（bsp_flash.h）：NOR 语义，擦除置 0xFF，写入只能把 1 变成 0
+// ============================================================================
+
+static uint8_t  flash_config[BSP_FLASH_CONFIG_SIZE] __attribute__((aligned(4)));
+static bool     flash_config_valid = false;   // 首次访问时视为出厂擦除状态
+static uint32_t flash_config_erases = 0;
+
+void sil_flash_config_reset(void)
+{
+    memset(flash_config, 0xFF, sizeof(flash_config));
+    flash_config_valid = true;
+    flash_config_erases = 0;
+}
+
+uint32_t sil_flash_config_erase_count(void)
+{
+    return flash_config_erases;
+}
+
+const uint8_t *BSP_Flash_ConfigBase(void)
+{
+    if (!flash_config_valid) sil_flash_config_reset();
+    return flash_config;
+}
+
+bool BSP_Flash_ConfigErase(void)
+{
+    memset(flash_config, 0xFF, sizeof(flash_config));
+    flash_config_valid = true;
+    flash_config_erases++;
+    return true;
+}
+
+bool BSP_Flash_ConfigWrite(uint32_t offset, const void *data, uint32_t len)
+{
+    if (!data || (offset & 3U) || (len & 3U) || offset > BSP_FLASH_CONFIG_SIZE ||
+        len > BSP_FLASH_CONFIG_SIZE - offset) {
+        return false;
+    }
+    if (!flash_config_valid) sil_flash_config_reset();
+    const uint8_t *src = (const uint8_t *)data;
+    for (uint32_t i = 0; i < len; i++) {
+        flash_config[offset + i] &= src[i];
+    }
+    return memcmp(flash_config + offset, data, len) == 0;
+}
+
+// ============================================================================
+// HMC5883L 应用层替身（hmc5883l.h）
+// ============================================================================
+
+bool hmc5883l_calibrate_compass(uint16_t samples)
+{
+    (void)samples;
+    return false;  // 主机上没有可旋转的设备，交互式校准不可用
+}
@@ -0,0 +1,55 @@
+/**
+ * @file    sil_board.h
+ * @brief   SIL 虚拟板级支持：传感器设备实例 + 串口替身
+ * @note    替代 icm42688p.c / hmc5883l.c / bsp_uart.c / bsp_flash.c 中依赖真实外设的部分，
+ *          让 task_* 流水线、姿态解算、PID 与 ELRS 解析在主机上原样运行。
+ */
+
+#ifndef SIL_BOARD_H
+#define SIL_BOARD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sil_hal.h"
+#include "icm42688p_lib.h"
+#include "hmc5883l_lib.h"
+
+// 与固件共用的设备实例（固件中分别定义在 icm42688p.c / hmc5883l.c）
+extern icm42688p_dev_t icm;
+extern hmc5883l_dev_t hmc_dev;
+
+// UART 发送捕获缓冲区大小
+#ifndef SIL_UART_TX_CAPTURE
+#define SIL_UART_TX_CAPTURE 256
+#endif
+
+/**
+ * @brief 初始化虚拟板：复位虚拟时钟、启动 DWT，并按固件默认量程配置 IMU/磁力计比例因子
+ * @note 量程与 icm42688p_init_driver / hmc5883l_init_driver 保持一致：
+ *       gyro ±2000dps，accel ±2g，mag ±1.3Ga
+ */
+void sil_board_init(void);
+
+/**
+ * @brief 向 UART 接收回调注入字节（模拟 RXNE 中断）
+ */
+void sil_uart_inject(uint8_t uart_id, const uint8_t *data, uint16_t len);
+
+/**
+ * @brief 获取固件通过 BSP_UART_Write 发出的字节
+ * @return 已捕获字节数（最多 SIL_UART_TX_CAPTURE）
+ */
+uint16_t sil_uart_tx_captured(const uint8_t **data);
+
+/**
+ * @brief 把模拟的 Flash 配置扇区恢复为出厂（全 0xFF）并清零擦除计数
+ * @note sil_board_init 不动配置扇区，两次 init 之间的内容即"断电重启"后保留的数据
+ */
+void sil_flash_config_reset(void);
+
+/**
+ * @brief 配置扇区被擦除的次数（sil_flash_config_reset 后清零）
+ */
+uint32_t sil_flash_config_erase_count(void);
+
+#endif // SIL_BOARD_H
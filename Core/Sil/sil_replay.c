@@ -0,0 +1,446 @@
+/**
+ * @file    sil_replay.c
+ * @brief   SIL 飞行日志回放引擎实现
+ */
+
+#include "sil_replay.h"
+#include "sil_board.h"
+#include "task_gyro.h"
+#include "task_acc.h"
+#include "task_mag.h"
+#include "task_fliter.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+static const char *const stage_names[SIL_STAGE_COUNT] = {
+    "gyro", "accel", "mag", "filter", "attitude", "pid",
+};
+
+static uint64_t host_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void stage_account(sil_stage_stats_t *s, uint64_t ns)
+{
+    s->calls++;
+    s->total_ns += ns;
+    if (ns > s->max_ns) s->max_ns = ns;
+}
+
+static int16_t phys_to_raw(float v, float scale)
+{
+    float r = v * scale;
+    if (r > 32767.0f) r = 32767.0f;
+    if (r < -32768.0f) r = -32768.0f;
+    return (int16_t)lrintf(r);
+}
+
+// ============================================================================
+// 日志容器
+// ============================================================================
+
+void sil_replay_default_config(sil_replay_config_t *cfg)
+{
+    if (!cfg) return;
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->decim        = 8;
+    cfg->pt1_cut_hz   = 100.0f;
+    cfg->aa_cut_hz    = 300.0f;
+    cfg->max_rate_dps = 400.0f;
+    cfg->use_mag      = true;
+    cfg->estimator    = ATTITUDE_ESTIMATOR_DEFAULT;
+}
+
+void sil_replay_log_init(sil_replay_log_t *log)
+{
+    if (!log) return;
+    memset(log, 0, sizeof(*log));
+}
+
+void sil_replay_log_free(sil_replay_log_t *log)
+{
+    if (!log) return;
+    free(log->samples);
+    memset(log, 0, sizeof(*log));
+}
+
+bool sil_replay_log_append(sil_replay_log_t *log, const sil_replay_sample_t *sample)
+{
+    if (!log || !sample) return false;
+    if (log->count == log->capacity) {
+        uint32_t cap = log->capacity ? log->capacity * 2U : 4096U;
+        sil_replay_sample_t *p = realloc(log->samples, (size_t)cap * sizeof(*p));
+        if (!p) return false;
+        log->samples  = p;
+        log->capacity = cap;
+    }
+    log->samples[log->count++] = *sample;
+    return true;
+}
+
+// ============================================================================
+// 文本日志
+// ============================================================================
+
+bool sil_replay_parse_line(const char *line, sil_replay_sample_t *out,
+                           float gyro_scale, float accel_scale)
+{
+    if (!line || !out) return false;
+    memset(out, 0, sizeof(*out));
+
+    // 串口抓取的行前面可能带有残留字符，按关键字定位
+    const char *p;
+    if ((p = strstr(line, "IMU_CSV,")) != NULL) {
+        unsigned t;
+        int g[3], a[3], m[3];
+        int n = sscanf(p, "IMU_CSV,%u,%d,%d,%d,%d,%d,%d,%d,%d,%d",
+                       &t, &g[0], &g[1], &g[2], &a[0], &a[1], &a[2], &m[0], &m[1], &m[2]);
+        if (n < 7) return false;
+        out->t_us  = (uint32_t)t;
+        out->flags = SIL_REPLAY_HAS_GYRO | SIL_REPLAY_HAS_ACCEL;
+        for (int i = 0; i < 3; i++) {
+            out->gyro[i]  = (int16_t)g[i];
+            out->accel[i] = (int16_t)a[i];
+        }
+        if (n == 10) {
+            out->flags |= SIL_REPLAY_HAS_MAG;
+            for (int i = 0; i < 3; i++) out->mag[i] = (int16_t)m[i];
+        }
+        return true;
+    }
+
+    if ((p = strstr(line, "ATTITUDE_FULL,")) != NULL) {
+        unsigned t_ms;
+        float ang[3], a[3], g[3];
+        int m[3];
+        int n = sscanf(p, "ATTITUDE_FULL,%u,%f,%f,%f,%f,%f,%f,%f,%f,%f,%d,%d,%d",
+                       &t_ms, &ang[0], &ang[1], &ang[2], &a[0], &a[1], &a[2],
+                       &g[0], &g[1], &g[2], &m[0], &m[1], &m[2]);
+        if (n < 10) return false;
+        out->t_us  = (uint32_t)t_ms * 1000U;
+        out->flags = SIL_REPLAY_HAS_GYRO | SIL_REPLAY_HAS_ACCEL;
+        for (int i = 0; i < 3; i++) {
+            out->gyro[i]  = phys_to_raw(g[i], gyro_scale);
+            out->accel[i] = phys_to_raw(a[i], accel_scale);
+        }
+        // 磁力计未启用时固件输出全 0
+        if (n == 13 && (m[0] | m[1] | m[2]) != 0) {
+            out->flags |= SIL_REPLAY_HAS_MAG;
+            for (int i = 0; i < 3; i++) out->mag[i] = (int16_t)m[i];
+        }
+        return true;
+    }
+
+    if ((p = strstr(line, "BAR:")) != NULL) {
+        long temp_deci, pa, alt_deci;
+        if (sscanf(p, "BAR: %ld %ld %ld", &temp_deci, &pa, &alt_deci) != 3) return false;
+        out->flags          = SIL_REPLAY_HAS_BARO;
+        out->baro_pa        = (int32_t)pa;
+        out->baro_temp_deci = (int16_t)temp_deci;
+        return true;
+    }
+
+    return false;
+}
+
+static bool load_text(FILE *f, sil_replay_log_t *log)
+{
+    char line[512];
+    sil_replay_sample_t s;
+    sil_replay_sample_t baro = {0};
+    bool baro_pending = false;
+
+    while (fgets(line, sizeof(line), f)) {
+        if (!sil_replay_parse_line(line, &s, icm.gyro_scale, icm.accel_scale)) {
+            continue;
+        }
+        if (s.flags == SIL_REPLAY_HAS_BARO) {
+            baro = s;
+            baro_pending = true;
+            continue;
+        }
+        if (baro_pending) {
+            s.flags |= SIL_REPLAY_HAS_BARO;
+            s.baro_pa = baro.baro_pa;
+            s.baro_temp_deci = baro.baro_temp_deci;
+            baro_pending = false;
+        }
+        if (!sil_replay_log_append(log, &s)) return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// 二进制日志（小端，逐字节序列化，与主机字节序无关）
+// ============================================================================
+
+static void put_u16(uint8_t *p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void put_u32(uint8_t *p, uint32_t v) { put_u16(p, (uint16_t)v); put_u16(p + 2, (uint16_t)(v >> 16)); }
+static uint16_t get_u16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t get_u32(const uint8_t *p) { return (uint32_t)get_u16(p) | ((uint32_t)get_u16(p + 2) << 16); }
+
+static void encode_record(uint8_t *r, const sil_replay_sample_t *s)
+{
+    memset(r, 0, SIL_REPLAY_BIN_RECORD);
+    put_u32(&r[0], s->t_us);
+    put_u16(&r[4], s->flags);
+    for (int i = 0; i < 3; i++) {
+        put_u16(&r[6 + 2 * i],  (uint16_t)s->gyro[i]);
+        put_u16(&r[12 + 2 * i], (uint16_t)s->accel[i]);
+        put_u16(&r[18 + 2 * i], (uint16_t)s->mag[i]);
+    }
+    put_u32(&r[24], (uint32_t)s->baro_pa);
+    put_u16(&r[28], (uint16_t)s->baro_temp_deci);
+}
+
+static void decode_record(const uint8_t *r, sil_replay_sample_t *s)
+{
+    s->t_us  = get_u32(&r[0]);
+    s->flags = get_u16(&r[4]);
+    for (int i = 0; i < 3; i++) {
+        s->gyro[i]  = (int16_t)get_u16(&r[6 + 2 * i]);
+        s->accel[i] = (int16_t)get_u16(&r[12 + 2 * i]);
+        s->mag[i]   = (int16_t)get_u16(&r[18 + 2 * i]);
+    }
+    s->baro_pa        = (int32_t)get_u32(&r[24]);
+    s->baro_temp_deci = (int16_t)get_u16(&r[28]);
+}
+
+static bool load_bin(FILE *f, sil_replay_log_t *log)
+{
+    uint8_t hdr[SIL_REPLAY_BIN_HEADER];
+    if (fread(hdr, 1, sizeof(hdr), f) != sizeof(hdr)) return false;
+    if (get_u16(&hdr[4]) != SIL_REPLAY_BIN_VERSION || get_u16(&hdr[6]) != SIL_REPLAY_BIN_RECORD) {
+        printf("[sil_replay] Unsupported binary log version %u / record %u\r\n",
+               get_u16(&hdr[4]), get_u16(&hdr[6]));
+        return false;
+    }
+
+    const uint32_t count = get_u32(&hdr[8]);
+    uint8_t rec[SIL_REPLAY_BIN_RECORD];
+    sil_replay_sample_t s;
+    for (uint32_t i = 0; i < count; i++) {
+        if (fread(rec, 1, sizeof(rec), f) != sizeof(rec)) {
+            printf("[sil_replay] Truncated binary log at record %u/%u\r\n", i, count);
+            return false;
+        }
+        decode_record(rec, &s);
+        if (!sil_replay_log_append(log, &s)) return false;
+    }
+    return true;
+}
+
+bool sil_replay_load(const char *path, sil_replay_log_t *log)
+{
+    if (!path || !log) return false;
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        printf("[sil_replay] Cannot open %s\r\n", path);
+        return false;
+    }
+
+    uint8_t magic[4];
+    bool is_bin = (fread(magic, 1, sizeof(magic), f) == sizeof(magic)) &&
+                  get_u32(magic) == SIL_REPLAY_BIN_MAGIC;
+    rewind(f);
+
+    bool ok = is_bin ? load_bin(f, log) : load_text(f, log);
+    fclose(f);
+    return ok;
+}
+
+bool sil_replay_save_bin(const char *path, const sil_replay_log_t *log)
+{
+    if (!path || !log) return false;
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        printf("[sil_replay] Cannot create %s\r\n", path);
+        return false;
+    }
+
+    uint8_t hdr[SIL_REPLAY_BIN_HEADER] = {0};
+    put_u32(&hdr[0], SIL_REPLAY_BIN_MAGIC);
+    put_u16(&hdr[4], SIL_REPLAY_BIN_VERSION);
+    put_u16(&hdr[6], SIL_REPLAY_BIN_RECORD);
+    put_u32(&hdr[8], log->count);
+    bool ok = fwrite(hdr, 1, sizeof(hdr), f) == sizeof(hdr);
+
+    uint8_t rec[SIL_REPLAY_BIN_RECORD];
+    for (uint32_t i = 0; ok && i < log->count; i++) {
+        encode_record(rec, &log->samples[i]);
+        ok = fwrite(rec, 1, sizeof(rec), f) == sizeof(rec);
+    }
+    return (fclose(f) == 0) && ok;
+}
+
+// ============================================================================
+// 回放
+// ============================================================================
+
+// 根据陀螺仪样本时间戳估算 ODR
+static float estimate_gyro_odr(const sil_replay_log_t *log)
+{
+    uint32_t n = 0, first = 0, last = 0;
+    for (uint32_t i = 0; i < log->count; i++) {
+        if (!(log->samples[i].flags & SIL_REPLAY_HAS_GYRO)) continue;
+        if (n == 0) first = log->samples[i].t_us;
+        last = log->samples[i].t_us;
+        n++;
+    }
+    const uint32_t span = last - first;
+    return (n > 1 && span > 0) ? (float)(n - 1U) * 1e6f / (float)span : 1000.0f;
+}
+
+// 推进虚拟时钟（分段，避免 sil_time_advance_us 内部乘法溢出）
+static void advance_to(uint32_t delta_us)
+{
+    while (delta_us > 1000000U) {
+        sil_time_advance_us(1000000U);
+        delta_us -= 1000000U;
+    }
+    sil_time_advance_us(delta_us);
+}
+
+bool sil_replay_run(const sil_replay_log_t *log, const sil_replay_config_t *cfg,
+                    sil_replay_report_t *report)
+{
+    if (!log || !cfg || !report || log->count == 0 || cfg->decim == 0) return false;
+
+    memset(report, 0, sizeof(*report));
+    report->gyro_odr_hz = estimate_gyro_odr(log);
+    const float control_hz = report->gyro_odr_hz / (float)cfg->decim;
+
+    sil_board_init();
+    gyro_processing_init(cfg->decim);
+    accel_processing_init();
+    mag_processing_init();
+    gyro_filter_init(control_hz, cfg->pt1_cut_hz, cfg->aa_cut_hz);
+    task_pid_init(control_hz);
+
+    // 与 test_attitude_full 一致：用第一帧加速度初始化姿态
+    Attitude_SetEstimator((AttitudeEstimator)cfg->estimator);
+    Attitude_Init();
+    for (uint32_t i = 0; i < log->count; i++) {
+        const sil_replay_sample_t *s = &log->samples[i];
+        if (s->flags & SIL_REPLAY_HAS_ACCEL) {
+            const float ax = (float)s->accel[0], ay = (float)s->accel[1], az = (float)s->accel[2];
+            const float norm = sqrtf(ax * ax + ay * ay + az * az);
+            if (norm > 0.0f) Attitude_InitFromAccelerometer(ax / norm, ay / norm, az / norm);
+            break;
+        }
+    }
+
+    uint32_t prev_t = log->samples[0].t_us;
+    uint32_t last_control_t = prev_t;
+    bool have_control = false;
+    const uint64_t wall_start = host_ns();
+
+    for (uint32_t i = 0; i < log->count; i++) {
+        const sil_replay_sample_t *s = &log->samples[i];
+
+        // 原始时间戳驱动虚拟时钟（uint32 差值兼容回绕）
+        const uint32_t delta = s->t_us - prev_t;
+        prev_t = s->t_us;
+        advance_to(delta);
+        report->sim_us += delta;
+        report->samples++;
+
+        uint64_t t0 = host_ns(), t1;
+        const uint64_t cycle_start = t0;
+
+        if (s->flags & SIL_REPLAY_HAS_GYRO) {
+            gyro_process_sample(s->gyro[0], s->gyro[1], s->gyro[2]);
+            t1 = host_ns();
+            stage_account(&report->stage[SIL_STAGE_GYRO], t1 - t0);
+            t0 = t1;
+        }
+        if (s->flags & SIL_REPLAY_HAS_ACCEL) {
+            accel_process_sample(s->accel[0], s->accel[1], s->accel[2]);
+            t1 = host_ns();
+            stage_account(&report->stage[SIL_STAGE_ACCEL], t1 - t0);
+            t0 = t1;
+        }
+        if (s->flags & SIL_REPLAY_HAS_MAG) {
+            mag_process_sample(s->mag[0], s->mag[1], s->mag[2]);
+            t1 = host_ns();
+            stage_account(&report->stage[SIL_STAGE_MAG], t1 - t0);
+            t0 = t1;
+        }
+
+        if (!(s->flags & SIL_REPLAY_HAS_GYRO) || !gyro_decimated.ready || !accel_scaled.ready) {
+            continue;
+        }
+
+        gyro_filter_feed_sample(gyro_decimated.dps_x, gyro_decimated.dps_y, gyro_decimated.dps_z);
+        t1 = host_ns();
+        stage_account(&report->stage[SIL_STAGE_FILTER], t1 - t0);
+        t0 = t1;
+
+        Euler_angles ang;
+        float mx = 0.0f, my = 0.0f, mz = 0.0f, strength = 0.0f;
+        if (cfg->use_mag && mag_calibrated.ready && mag_get_normalized(&mx, &my, &mz, &strength)) {
+            ang = Attitude_Update(accel_scaled.g_x, accel_scaled.g_y, accel_scaled.g_z,
+                                  gyro_filtered.dps_x, gyro_filtered.dps_y, gyro_filtered.dps_z,
+                                  mx, my, mz);
+        } else {
+            ang = Attitude_Update_IMU_Only(accel_scaled.g_x, accel_scaled.g_y, accel_scaled.g_z,
+                                           gyro_filtered.dps_x, gyro_filtered.dps_y, gyro_filtered.dps_z);
+        }
+        t1 = host_ns();
+        stage_account(&report->stage[SIL_STAGE_ATTITUDE], t1 - t0);
+        t0 = t1;
+
+        const float dt = have_control ? (float)(s->t_us - last_control_t) * 1e-6f : 1.0f / control_hz;
+        last_control_t = s->t_us;
+        have_control = true;
+
+        const pid_output_t *out = task_pid_step(dt, cfg->max_rate_dps);
+        t1 = host_ns();
+        stage_account(&report->stage[SIL_STAGE_PID], t1 - t0);
+        stage_account(&report->control, t1 - cycle_start);
+        report->control_steps++;
+
+        if (cfg->on_step) {
+            sil_replay_step_t step = {
+                .t_us     = s->t_us,
+                .dt       = dt,
+                .angles   = ang,
+                .gyro_dps = { gyro_filtered.dps_x, gyro_filtered.dps_y, gyro_filtered.dps_z },
+                .pid      = out,
+            };
+            cfg->on_step(&step, cfg->user);
+        }
+    }
+
+    report->host_sec = (double)(host_ns() - wall_start) * 1e-9;
+    return true;
+}
+
+void sil_replay_print_report(const sil_replay_report_t *report)
+{
+    if (!report) return;
+    const double sim_sec = (double)report->sim_us * 1e-6;
+
+    printf("[sil_replay] %u samples, %u control steps, gyro ODR %.1f Hz\r\n",
+           report->samples, report->control_steps, report->gyro_odr_hz);
+    printf("[sil_replay] %.3f s flight replayed in %.3f s host (%.0fx real time)\r\n",
+           sim_sec, report->host_sec, report->host_sec > 0.0 ? sim_sec / report->host_sec : 0.0);
+    printf("  %-10s %10s %10s %10s\r\n", "stage", "calls", "avg(ns)", "max(ns)");
+    for (int i = 0; i < SIL_STAGE_COUNT; i++) {
+        const sil_stage_stats_t *s = &report->stage[i];
+        printf("  %-10s %10llu %10.1f %10llu\r\n", stage_names[i],
+               (unsigned long long)s->calls,
+               s->calls ? (double)s->total_ns / (double)s->calls : 0.0,
+               (unsigned long long)s->max_ns);
+    }
+    printf("  %-10s %10llu %10.1f %10llu\r\n", "control",
+           (unsigned long long)report->control.calls,
+           report->control.calls ? (double)report->control.total_ns / (double)report->control.calls : 0.0,
+           (unsigned long long)report->control.max_ns);
+}
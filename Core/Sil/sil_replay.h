@@ -0,0 +1,163 @@
+/**
+ * @file    sil_replay.h
+ * @brief   SIL 飞行日志回放引擎：按原始时间戳把录制的传感器数据送入固件处理链
+ * @note    支持的日志格式：
+ *          1) 文本日志（串口抓取，无关行自动忽略）：
+ *             IMU_CSV,t_us,gx,gy,gz,ax,ay,az[,mx,my,mz]     —— 原始 LSB，微秒时间戳
+ *             ATTITUDE_FULL,t_ms,roll,pitch,yaw,ax,ay,az,gx,gy,gz,mx,my,mz
+ *                                                         —— test_attitude_full 的输出（g / dps / 磁力计原始值）
+ *             BAR: temp_deci pa alt_deci                  —— 气压计（附加到下一条 IMU 样本）
+ *          2) 紧凑二进制日志：16 字节文件头 + 每样本 32 字节定长记录（小端）
+ *
+ *          回放流程与 test_attitude_full 主循环一致：
+ *          gyro_process_sample -> accel_process_sample -> mag_process_sample
+ *          -> (降采样就绪) gyro_filter_feed_sample -> Attitude_Update -> task_pid_step
+ *          虚拟时钟按样本时间戳推进，因此 HAL_GetTick/DWT 得到的 dt 与飞行时一致；
+ *          每个阶段的主机耗时单独统计，用于离线评估 CPU 开销。
+ */
+
+#ifndef SIL_REPLAY_H
+#define SIL_REPLAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "attitude.h"
+#include "task_pid.h"
+
+// 样本内容标志
+#define SIL_REPLAY_HAS_GYRO     (1U << 0)
+#define SIL_REPLAY_HAS_ACCEL    (1U << 1)
+#define SIL_REPLAY_HAS_MAG      (1U << 2)
+#define SIL_REPLAY_HAS_BARO     (1U << 3)
+
+// 二进制日志
+#define SIL_REPLAY_BIN_MAGIC    0x4C524346U   // "FCRL"
+#define SIL_REPLAY_BIN_VERSION  1U
+#define SIL_REPLAY_BIN_HEADER   16U
+#define SIL_REPLAY_BIN_RECORD   32U
+
+/**
+ * @brief 一个录制样本（原始传感器值 + 时间戳）
+ */
+typedef struct sil_replay_sample_s {
+    uint32_t t_us;              // 采样时间戳（us，允许 32 位回绕）
+    uint16_t flags;             // SIL_REPLAY_HAS_*
+    int16_t  gyro[3];           // 陀螺仪原始值（LSB）
+    int16_t  accel[3];          // 加速度计原始值（LSB）
+    int16_t  mag[3];            // 磁力计原始值（LSB）
+    int32_t  baro_pa;           // 气压（Pa）
+    int16_t  baro_temp_deci;    // 气压计温度（0.1°C）
+} sil_replay_sample_t;
+
+/**
+ * @brief 内存中的日志
+ */
+typedef struct sil_replay_log_s {
+    sil_replay_sample_t *samples;
+    uint32_t count;
+    uint32_t capacity;
+} sil_replay_log_t;
+
+/**
+ * @brief 处理阶段
+ */
+typedef enum {
+    SIL_STAGE_GYRO = 0,     // gyro_process_sample
+    SIL_STAGE_ACCEL,        // accel_process_sample
+    SIL_STAGE_MAG,          // mag_process_sample
+    SIL_STAGE_FILTER,       // gyro_filter_feed_sample
+    SIL_STAGE_ATTITUDE,     // Attitude_Update / Attitude_Update_IMU_Only
+    SIL_STAGE_PID,          // task_pid_step
+    SIL_STAGE_COUNT
+} sil_stage_t;
+
+/**
+ * @brief 单阶段主机耗时统计
+ */
+typedef struct sil_stage_stats_s {
+    uint64_t calls;
+    uint64_t total_ns;
+    uint64_t max_ns;
+} sil_stage_stats_t;
+
+/**
+ * @brief 每个控制周期的回放输出（降采样就绪时回调一次）
+ */
+typedef struct sil_replay_step_s {
+    uint32_t            t_us;       // 触发本次控制的样本时间戳
+    float               dt;         // 与上次控制周期的时间差（s）
+    Euler_angles        angles;     // 姿态角（deg）
+    float               gyro_dps[3];// 送入姿态解算的角速度（滤波后）
+    const pid_output_t *pid;        // PID / 混控输出
+} sil_replay_step_t;
+
+typedef void (*sil_replay_step_cb)(const sil_replay_step_t *step, void *user);
+
+/**
+ * @brief 回放配置
+ */
+typedef struct sil_replay_config_s {
+    uint8_t  decim;             // 陀螺仪降采样因子（与 gyro_processing_init 一致）
+    float    pt1_cut_hz;        // gyro_filter_init 参数
+    float    aa_cut_hz;
+    float    max_rate_dps;      // task_pid_step 参数
+    bool     use_mag;           // 磁力计就绪时使用 9DoF 融合
+    uint8_t  estimator;         // AttitudeEstimator：Mahony / EKF
+    sil_replay_step_cb on_step; // 可选：每个控制周期回调
+    void    *user;
+} sil_replay_config_t;
+
+/**
+ * @brief 回放结果
+ */
+typedef struct sil_replay_report_s {
+    uint32_t samples;               // 回放样本数
+    uint32_t control_steps;         // 控制周期数
+    float    gyro_odr_hz;           // 根据时间戳估算的陀螺仪采样率
+    uint64_t sim_us;                // 日志覆盖的飞行时间
+    double   host_sec;              // 主机墙钟耗时
+    sil_stage_stats_t stage[SIL_STAGE_COUNT];
+    sil_stage_stats_t control;      // 控制周期端到端耗时（gyro 样本到 PID 输出）
+} sil_replay_report_t;
+
+// 填充默认配置（8:1 降采样，100Hz PT1，300Hz 抗混叠，400dps，启用磁力计，默认估计器）
+void sil_replay_default_config(sil_replay_config_t *cfg);
+
+// 日志容器
+void sil_replay_log_init(sil_replay_log_t *log);
+void sil_replay_log_free(sil_replay_log_t *log);
+bool sil_replay_log_append(sil_replay_log_t *log, const sil_replay_sample_t *sample);
+
+/**
+ * @brief 解析一行文本日志
+ * @param line        一行文本（可带 \r\n）
+ * @param out         输出样本（仅在返回 true 时有效）
+ * @param gyro_scale  ATTITUDE_FULL 的 dps -> LSB 比例（icm.gyro_scale）
+ * @param accel_scale ATTITUDE_FULL 的 g -> LSB 比例（icm.accel_scale）
+ * @return true=识别到 IMU_CSV / ATTITUDE_FULL / BAR 行
+ * @note BAR 行只带 SIL_REPLAY_HAS_BARO 标志，由 sil_replay_load 合并到下一条 IMU 样本
+ */
+bool sil_replay_parse_line(const char *line, sil_replay_sample_t *out,
+                           float gyro_scale, float accel_scale);
+
+/**
+ * @brief 加载日志文件（按文件头自动识别二进制/文本）
+ * @note 文本中 ATTITUDE_FULL 的物理量按当前 icm 比例因子转换回原始值，
+ *       因此应在 sil_board_init() 之后调用
+ */
+bool sil_replay_load(const char *path, sil_replay_log_t *log);
+
+// 保存为二进制日志
+bool sil_replay_save_bin(const char *path, const sil_replay_log_t *log);
+
+/**
+ * @brief 回放整段日志
+ * @note 会重新初始化虚拟板与各处理模块，相同输入保证得到逐位相同的输出
+ */
+bool sil_replay_run(const sil_replay_log_t *log, const sil_replay_config_t *cfg,
+                    sil_replay_report_t *report);
+
+// 打印回放报告（各阶段平均/最大耗时、相对实时倍数）
+void sil_replay_print_report(const sil_replay_report_t *report);
+
+#endif // SIL_REPLAY_H
@@ -0,0 +1,126 @@
+/**
+ * @file    sil_sched.h
+ * @brief   任务集可调度性分析与过载仿真（主机端）
+ * @note    在虚拟时钟上运行固件同一份 scheduler.c：任务回调按给定的执行时间分布推进时间，
+ *          节拍中断（IMU EXTI）按 tick_us 到来，向事件任务投递事件，启用实时通道时派发实时任务。
+ *          每个任务统计响应时间（完成时刻 - 释放时刻）、错过的截止期（隐式截止期 = 周期）与释放抖动，
+ *          同一任务集可在不同调度策略下对比。另给出非抢占固定优先级的响应时间上界（解析）。
+ *
+ *          任务集文本格式（# 后为注释）：
+ *            tick <us>                                      节拍中断周期（默认取最小事件周期）
+ *            <名称> <优先级> <触发> <周期us> <max_exec_us> <执行时间>
+ *              优先级：CRITICAL / HIGH / NORMAL / LOW / IDLE
+ *              触发：  periodic（周期任务）/ event（节拍中断投递的事件队列任务，周期须为 tick 的整数倍）
+ *              max_exec_us：0 = 不检查超时
+ *              执行时间：<us> 固定 | <a>-<b> 均匀分布 | hist（取自 scheduler_dump_histograms 导出中同名任务）
+ *
+ *          例：8kHz 陀螺下加入 500Hz OSD
+ *            tick 125
+ *            gyro  CRITICAL event     125   40  20
+ *            pid   HIGH     periodic  250   60  30-40
+ *            osd   LOW      periodic  2000  600 300-450
+ */
+
+#ifndef SIL_SCHED_H
+#define SIL_SCHED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "scheduler.h"
+
+#define SIL_SCHED_NAME_MAX      15
+#define SIL_SCHED_EVENT_DEPTH   4       // 事件任务的队列深度（队列满时丢弃，计为错过）
+
+typedef enum {
+    SIL_SCHED_EXEC_FIXED,
+    SIL_SCHED_EXEC_UNIFORM,
+    SIL_SCHED_EXEC_HIST,
+} sil_sched_exec_kind_t;
+
+typedef struct {
+    char                  name[SIL_SCHED_NAME_MAX + 1];
+    task_priority_t       priority;
+    task_trigger_mode_t   trigger;        // PERIODIC 或 EVENT（事件队列）
+    uint32_t              period_us;
+    uint32_t              max_exec_us;
+
+    sil_sched_exec_kind_t exec_kind;
+    uint32_t              exec_min_us;    // FIXED: min == max
+    uint32_t              exec_max_us;
+    task_hist_t           exec_hist;      // HIST：实测执行时间直方图（CPU 周期数）
+    uint32_t              hist_cpu_hz;    // 直方图所用主频
+    bool                  has_hist;
+} sil_sched_task_t;
+
+typedef struct {
+    sil_sched_task_t tasks[SCHEDULER_MAX_TASKS];
+    uint8_t          count;
+    uint32_t         tick_us;
+} sil_sched_set_t;
+
+typedef enum {
+    SIL_SCHED_COOP = 0,         // 只用 scheduler_run（当前策略）
+    SIL_SCHED_RT_CRITICAL,      // 实时通道：CRITICAL 在节拍中断中派发
+    SIL_SCHED_RT_HIGH,          // 实时通道：CRITICAL + HIGH 在节拍中断中派发
+    SIL_SCHED_POLICY_COUNT,
+} sil_sched_policy_t;
+
+typedef struct {
+    uint32_t releases;          // 释放次数（周期数 / 投递的事件数）
+    uint32_t runs;              // 完成次数
+    uint32_t missed;            // 错过截止期：响应时间 > 周期 + 跳过的周期 + 队列满丢弃的事件
+    uint32_t overruns;          // 执行时间 > max_exec_us
+    uint32_t resp_max_us;
+    uint32_t resp_p99_us;
+    float    resp_mean_us;
+    uint32_t jitter_max_us;     // 释放抖动（调度器统计）
+    uint32_t jitter_p99_us;
+    uint32_t exec_max_us;
+    uint32_t bound_us;          // 解析响应时间上界，UINT32_MAX = 不收敛（必然错过）
+    task_lane_t lane;
+} sil_sched_task_result_t;
+
+typedef struct {
+    sil_sched_policy_t      policy;
+    uint64_t                sim_us;
+    uint32_t                ticks;
+    float                   load;       // 任务占用 CPU 的比例（%）
+    uint32_t                missed;     // 所有任务错过截止期之和
+    sil_sched_task_result_t tasks[SCHEDULER_MAX_TASKS];
+} sil_sched_result_t;
+
+/**
+ * @brief 解析任务集文本（见文件头格式）
+ * @return false=语法错误、未知优先级/触发方式、事件周期不是 tick 的整数倍或任务过多（打印行号）
+ */
+bool sil_sched_parse(const char *text, sil_sched_set_t *set);
+
+/**
+ * @brief 从 scheduler_dump_histograms 导出（可夹杂文本）中为同名任务填入执行时间直方图
+ * @return 填入的任务数；-1 = 未找到有效导出（帧头/CRC）
+ */
+int sil_sched_load_hist(sil_sched_set_t *set, const uint8_t *data, size_t len);
+
+/**
+ * @brief 检查任务集可仿真：执行时间为 hist 的任务必须已载入直方图
+ */
+bool sil_sched_validate(const sil_sched_set_t *set);
+
+// 最坏情况利用率（%）：sum(C / T)，C 取 max_exec_us，未设置时取执行时间分布上限
+float sil_sched_utilization(const sil_sched_set_t *set);
+
+/**
+ * @brief 在虚拟时钟上用 scheduler.c 仿真 ticks 个节拍
+ * @param seed 执行时间抽样的随机种子（相同种子结果可复现）
+ */
+void sil_sched_simulate(const sil_sched_set_t *set, sil_sched_policy_t policy, uint32_t ticks,
+                        uint32_t seed, sil_sched_result_t *out);
+
+const char *sil_sched_policy_name(sil_sched_policy_t policy);
+bool sil_sched_policy_parse(const char *name, sil_sched_policy_t *policy);
+
+// 打印一个策略的逐任务结果表
+void sil_sched_print(const sil_sched_set_t *set, const sil_sched_result_t *result);
+
+#endif // SIL_SCHED_H
@@ -0,0 +1,139 @@
+/**
+ * @file    sil_sched_main.c
+ * @brief   fc_sched 命令行工具：任务集可调度性分析与过载仿真
+ *
+ * 用法：
+ *   fc_sched <taskset> [--hist dump] [--policy coop|rt-critical|rt-high|all] [--ticks N] [--seed S]
+ *     <taskset>      任务集文本（格式见 sil_sched.h）
+ *     --hist dump    scheduler_dump_histograms 的串口抓包，执行时间为 hist 的任务按名字取实测直方图
+ *     --policy       仿真的调度策略（默认 all：三种策略逐一仿真并对比）
+ *     --ticks N      仿真的节拍中断数（默认 1000000，8kHz 下为 125 s）
+ *     --seed S       执行时间抽样种子（默认 1）
+ *
+ * 返回值：0 = 所选策略下没有错过截止期，3 = 有任务错过截止期，1/2 = 输入错误
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sil_sched.h"
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr, "usage: %s <taskset> [--hist dump] [--policy coop|rt-critical|rt-high|all] "
+                    "[--ticks N] [--seed S]\n", argv0);
+}
+
+static uint8_t *read_file(const char *path, size_t *len)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *buf = (size >= 0) ? malloc((size_t)size + 1U) : NULL;
+    if (buf && fread(buf, 1, (size_t)size, f) != (size_t)size) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    if (buf) buf[size] = '\0';
+    *len = buf ? (size_t)size : 0;
+    return buf;
+}
+
+int main(int argc, char **argv)
+{
+    const char *set_path = NULL;
+    const char *hist_path = NULL;
+    bool all = true;
+    sil_sched_policy_t policy = SIL_SCHED_COOP;
+    uint32_t ticks = 1000000U;
+    uint32_t seed = 1U;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--hist") == 0 && i + 1 < argc) {
+            hist_path = argv[++i];
+        } else if (strcmp(argv[i], "--policy") == 0 && i + 1 < argc) {
+            i++;
+            all = strcmp(argv[i], "all") == 0;
+            if (!all && !sil_sched_policy_parse(argv[i], &policy)) {
+                usage(argv[0]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            ticks = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!set_path && argv[i][0] != '-') {
+            set_path = argv[i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!set_path || ticks == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    size_t len = 0;
+    uint8_t *text = read_file(set_path, &len);
+    if (!text) {
+        fprintf(stderr, "cannot read %s\n", set_path);
+        return 1;
+    }
+    static sil_sched_set_t set;
+    const bool parsed = sil_sched_parse((const char *)text, &set);
+    free(text);
+    if (!parsed) return 1;
+
+    if (hist_path) {
+        uint8_t *dump = read_file(hist_path, &len);
+        if (!dump) {
+            fprintf(stderr, "cannot read %s\n", hist_path);
+            return 1;
+        }
+        const int matched = sil_sched_load_hist(&set, dump, len);
+        free(dump);
+        if (matched < 0) {
+            fprintf(stderr, "no valid histogram dump in %s\n", hist_path);
+            return 1;
+        }
+        printf("histograms loaded for %d task(s)\n", matched);
+    }
+    if (!sil_sched_validate(&set)) return 1;
+
+    printf("task set: %u tasks, tick %u us, worst-case utilisation %.1f %%\n\n",
+           set.count, set.tick_us, sil_sched_utilization(&set));
+
+    static sil_sched_result_t results[SIL_SCHED_POLICY_COUNT];
+    const int first = all ? 0 : (int)policy;
+    const int last = all ? SIL_SCHED_POLICY_COUNT - 1 : (int)policy;
+    for (int p = first; p <= last; p++) {
+        sil_sched_simulate(&set, (sil_sched_policy_t)p, ticks, seed, &results[p]);
+        sil_sched_print(&set, &results[p]);
+        printf("\n");
+    }
+
+    // 策略对比：每个任务错过截止期的次数
+    if (all) {
+        printf("missed deadlines per policy\n  %-15s", "task");
+        for (int p = 0; p < SIL_SCHED_POLICY_COUNT; p++) {
+            printf(" %12s", sil_sched_policy_name((sil_sched_policy_t)p));
+        }
+        printf("\n");
+        for (uint8_t i = 0; i < set.count; i++) {
+            printf("  %-15s", set.tasks[i].name);
+            for (int p = 0; p < SIL_SCHED_POLICY_COUNT; p++) {
+                printf(" %12u", results[p].tasks[i].missed);
+            }
+            printf("\n");
+        }
+    }
+
+    for (int p = first; p <= last; p++) {
+        if (results[p].missed) return 3;
+    }
+    return 0;
+}
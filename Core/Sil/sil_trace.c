@@ -0,0 +1,143 @@
+/**
+ * @file    sil_trace.c
+ * @brief   latency_trace 导出的主机端解码与统计
+ */
+
+#include "sil_trace.h"
+#include "dump_writer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRACE_HEADER_LEN    14U     // magic(2) + ver + N + cpu_hz(4) + stale(4) + count(2)
+
+static uint16_t rd16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t rd32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// 尝试在 p 处解码一帧；成功返回 true
+static bool decode_at(const uint8_t *p, size_t avail, sil_trace_dump_t *out)
+{
+    if (avail < TRACE_HEADER_LEN + 2U || p[0] != 'L' || p[1] != 'T' || p[2] != 1) return false;
+
+    const uint8_t points = p[3];
+    if (points < 1 || points > LATENCY_TRACE_POINTS) return false;
+
+    const uint16_t count = rd16(&p[12]);
+    const size_t rec_len = 9U + 4U * (size_t)(points - 1U);
+    const size_t total = TRACE_HEADER_LEN + (size_t)count * rec_len + 2U;
+    if (avail < total) return false;
+    if (crc16_ccitt(p, total - 2U) != rd16(&p[total - 2U])) return false;
+
+    sil_trace_record_t *records = calloc(count ? count : 1U, sizeof(*records));
+    if (!records) return false;
+
+    const uint8_t *r = &p[TRACE_HEADER_LEN];
+    for (uint16_t i = 0; i < count; i++, r += rec_len) {
+        records[i].id = rd32(&r[0]);
+        records[i].t_exti = rd32(&r[4]);
+        records[i].mask = r[8];
+        for (uint8_t k = 1; k < points; k++) {
+            records[i].delta[k] = rd32(&r[9 + 4 * (k - 1)]);
+        }
+    }
+
+    out->cpu_hz = rd32(&p[4]);
+    out->stale = rd32(&p[8]);
+    out->points = points;
+    out->count = count;
+    out->records = records;
+    return true;
+}
+
+bool sil_trace_decode(const uint8_t *data, size_t len, sil_trace_dump_t *out)
+{
+    if (!data || !out) return false;
+    memset(out, 0, sizeof(*out));
+
+    for (size_t i = 0; i + 1 < len; i++) {
+        if (data[i] == 'L' && data[i + 1] == 'T' && decode_at(&data[i], len - i, out)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void sil_trace_free(sil_trace_dump_t *dump)
+{
+    if (!dump) return;
+    free(dump->records);
+    dump->records = NULL;
+    dump->count = 0;
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    const uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+void sil_trace_span(const sil_trace_dump_t *dump, uint8_t from, uint8_t to, sil_trace_span_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    if (!dump || !dump->count || from >= dump->points || to >= dump->points) return;
+
+    uint32_t *v = malloc(dump->count * sizeof(uint32_t));
+    if (!v) return;
+
+    const uint8_t need = (uint8_t)((1U << from) | (1U << to));
+    uint64_t sum = 0;
+    for (uint16_t i = 0; i < dump->count; i++) {
+        const sil_trace_record_t *r = &dump->records[i];
+        if ((r->mask & need) != need) continue;
+        v[out->n] = r->delta[to] - r->delta[from];
+        sum += v[out->n];
+        out->n++;
+    }
+
+    if (out->n) {
+        qsort(v, out->n, sizeof(uint32_t), cmp_u32);
+        const float us = 1e6f / (float)dump->cpu_hz;
+        out->min_us  = (float)v[0] * us;
+        out->max_us  = (float)v[out->n - 1] * us;
+        out->mean_us = (float)((double)sum / out->n) * us;
+        out->p50_us  = (float)v[(out->n - 1) * 50U / 100U] * us;
+        out->p99_us  = (float)v[(out->n - 1) * 99U / 100U] * us;
+    }
+    free(v);
+}
+
+static void print_span(const sil_trace_dump_t *dump, uint8_t from, uint8_t to)
+{
+    sil_trace_span_t s;
+    sil_trace_span(dump, from, to, &s);
+    if (!s.n) return;
+
+    char label[32];
+    snprintf(label, sizeof(label), "%s -> %s",
+             latency_trace_point_name((latency_trace_point_t)from),
+             latency_trace_point_name((latency_trace_point_t)to));
+    printf("  %-20s %6u %9.2f %9.2f %9.2f %9.2f %9.2f\n",
+           label, s.n, s.min_us, s.mean_us, s.p50_us, s.p99_us, s.max_us);
+}
+
+void sil_trace_print(const sil_trace_dump_t *dump)
+{
+    if (!dump) return;
+
+    printf("latency trace: %u records, cpu %u Hz, %u stale marks\n",
+           dump->count, dump->cpu_hz, dump->stale);
+    printf("  %-20s %6s %9s %9s %9s %9s %9s\n", "span (us)", "n", "min", "mean", "p50", "p99", "max");
+
+    // 相邻节点：跳过没有打点的节点（例如未降采样输出的样本只有 exti/spi/gyro）
+    for (uint8_t from = 0; from + 1 < dump->points; from++) {
+        print_span(dump, from, (uint8_t)(from + 1));
+    }
+    print_span(dump, LATENCY_TRACE_EXTI, (uint8_t)(dump->points - 1));
+}
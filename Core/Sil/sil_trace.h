@@ -0,0 +1,62 @@
+/**
+ * @file    sil_trace.h
+ * @brief   latency_trace 二进制导出的主机端解码与统计
+ * @note    输入可以是串口原始抓包：在字节流中查找 'L' 'T' 帧头并校验 CRC，
+ *          帧前后的文本行（printf 日志）自动忽略。格式见 latency_trace.h。
+ */
+
+#ifndef SIL_TRACE_H
+#define SIL_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "latency_trace.h"
+
+/**
+ * @brief 解码后的一条记录
+ */
+typedef struct sil_trace_record_s {
+    uint32_t id;
+    uint32_t t_exti;                        // EXTI 时刻（DWT 周期）
+    uint8_t  mask;                          // bit n = 第 n 个节点已打点
+    uint32_t delta[LATENCY_TRACE_POINTS];   // 相对 EXTI 的周期数（delta[0] = 0）
+} sil_trace_record_t;
+
+/**
+ * @brief 一次导出
+ */
+typedef struct sil_trace_dump_s {
+    uint32_t cpu_hz;
+    uint32_t stale;                         // 固件侧打点时记录已被覆盖的次数
+    uint8_t  points;                        // 导出中的节点数
+    uint16_t count;
+    sil_trace_record_t *records;            // 按 id 从旧到新
+} sil_trace_dump_t;
+
+/**
+ * @brief 两个节点之间的延迟分布（只统计两端都已打点的记录）
+ */
+typedef struct sil_trace_span_s {
+    uint32_t n;
+    float    min_us;
+    float    mean_us;
+    float    p50_us;
+    float    p99_us;
+    float    max_us;
+} sil_trace_span_t;
+
+/**
+ * @brief 在字节流中查找并解码第一帧有效导出
+ * @return false=未找到帧头、长度不足、CRC 错误或内存不足
+ */
+bool sil_trace_decode(const uint8_t *data, size_t len, sil_trace_dump_t *out);
+void sil_trace_free(sil_trace_dump_t *dump);
+
+// from -> to 两节点之间的延迟统计
+void sil_trace_span(const sil_trace_dump_t *dump, uint8_t from, uint8_t to, sil_trace_span_t *out);
+
+// 打印相邻节点与 EXTI -> 电机的延迟表
+void sil_trace_print(const sil_trace_dump_t *dump);
+
+#endif // SIL_TRACE_H
@@ -0,0 +1,109 @@
+/**
+ * @file    sil_trace_main.c
+ * @brief   fc_trace 命令行工具：解码 latency_trace_dump 的串口抓包并输出延迟统计
+ *
+ * 用法：
+ *   fc_trace <capture> [-o out.csv]
+ *     <capture>   串口原始抓包（可夹杂文本日志，自动查找 'LT' 帧）
+ *     -o out.csv  每条记录一行：id,t_exti,<各节点相对 EXTI 的 us，未打点为空>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sil_trace.h"
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr, "usage: %s <capture> [-o out.csv]\n", argv0);
+}
+
+static uint8_t *read_file(const char *path, size_t *len)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *buf = (size > 0) ? malloc((size_t)size) : NULL;
+    if (buf && fread(buf, 1, (size_t)size, f) != (size_t)size) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    *len = buf ? (size_t)size : 0;
+    return buf;
+}
+
+static bool write_csv(const char *path, const sil_trace_dump_t *d)
+{
+    FILE *f = fopen(path, "w");
+    if (!f) return false;
+
+    fprintf(f, "id,t_exti");
+    for (uint8_t k = 1; k < d->points; k++) {
+        fprintf(f, ",%s_us", latency_trace_point_name((latency_trace_point_t)k));
+    }
+    fprintf(f, "\n");
+
+    const double us = 1e6 / (double)d->cpu_hz;
+    for (uint16_t i = 0; i < d->count; i++) {
+        const sil_trace_record_t *r = &d->records[i];
+        fprintf(f, "%u,%u", r->id, r->t_exti);
+        for (uint8_t k = 1; k < d->points; k++) {
+            if (r->mask & (1U << k)) {
+                fprintf(f, ",%.3f", r->delta[k] * us);
+            } else {
+                fprintf(f, ",");
+            }
+        }
+        fprintf(f, "\n");
+    }
+    fclose(f);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    const char *in_path = NULL;
+    const char *csv_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else if (!in_path && argv[i][0] != '-') {
+            in_path = argv[i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!in_path) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    size_t len = 0;
+    uint8_t *data = read_file(in_path, &len);
+    if (!data) {
+        fprintf(stderr, "cannot read %s\n", in_path);
+        return 1;
+    }
+
+    sil_trace_dump_t dump;
+    const bool ok = sil_trace_decode(data, len, &dump);
+    free(data);
+    if (!ok) {
+        fprintf(stderr, "no valid latency trace frame in %s\n", in_path);
+        return 1;
+    }
+
+    sil_trace_print(&dump);
+    if (csv_path && !write_csv(csv_path, &dump)) {
+        fprintf(stderr, "cannot write %s\n", csv_path);
+        sil_trace_free(&dump);
+        return 1;
+    }
+    sil_trace_free(&dump);
+    return 0;
+}
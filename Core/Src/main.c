@@ -10,8 +10,10 @@
 #include "test_gyro.h"
 #include "test_attitude_full.h"
 #include "test_mag.h"
+#include "bench_hotpath.h"
+#include "test_flight_loop.h"
 
-#define RUN_MODE 1  // 0: gyro+acc attitude test, 1: gyro+acc+mag attitude test, 2: magnetometer stream test
+#define RUN_MODE 1  // 0: gyro+acc attitude test, 1: gyro+acc+mag attitude test, 2: magnetometer stream test, 3: hot-path benchmark, 4: gyro+acc attitude test on the DMA burst stream, 5: scheduler flight loop (RT lane)
 
 int main(void)
 {
@@ -31,6 +33,14 @@ int main(void)
         test_attitude_full_run();
     } else if (RUN_MODE == 2) {
         test_mag_run();
+    } else if (RUN_MODE == 3) {
+        bench_hotpath_run();
+#ifdef ICM_USE_DMA
+    } else if (RUN_MODE == 4) {
+        test_gyro_dma_run();
+#endif
+    } else if (RUN_MODE == 5) {
+        test_flight_loop_run();
     } else {
         test_gyro_run();
     }
@@ -0,0 +1,35 @@
+/**
+ * @file    bench_budget.h
+ * @brief   Stored per-call budgets for the hot-path micro-benchmarks (bench_hotpath.c).
+ * @note    Target budgets are DWT cycles/call on STM32F405 @168MHz (FPU on); they start
+ *          as conservative estimates and should be tightened from RUN_MODE 3 output.
+ *          Host budgets are ns/call for the SIL build on an x86-64 host. They are
+ *          wall-clock and move with machine load, so the SIL run only reports them;
+ *          the cycle budgets are the gate.
+ *          When a change legitimately moves a number, update the budget in the same
+ *          commit and note the before/after in the message.
+ */
+
+#ifndef BENCH_BUDGET_H
+#define BENCH_BUDGET_H
+
+//                                   target (cycles)   host (ns)
+#define BENCH_BUDGET_ATTITUDE_IMU    1800U,            250U
+#define BENCH_BUDGET_ATTITUDE_MAG    2600U,            400U
+#define BENCH_BUDGET_ATTITUDE_EKF    6000U,            1500U
+#define BENCH_BUDGET_BIQUAD          60U,              30U
+#define BENCH_BUDGET_PT1             25U,              25U
+#define BENCH_BUDGET_FILTER_BANK     200U,             100U
+#define BENCH_BUDGET_FIR_DECIM       120U,             50U
+#define BENCH_BUDGET_IMU_FRONTEND    60U,              80U
+#define BENCH_BUDGET_IMU_FRONTEND_PERM 40U,            60U
+#define BENCH_BUDGET_ACCEL_CAL       90U,              60U
+#define BENCH_BUDGET_PID_FF          400U,             40U
+#define BENCH_BUDGET_SIN_APPROX      60U,              35U
+#define BENCH_BUDGET_ATAN2_APPROX    90U,              20U
+#define BENCH_BUDGET_FAST_INV_SQRT   30U,              15U
+#define BENCH_BUDGET_CRSF_BYTE       90U,              80U
+#define BENCH_BUDGET_BMP280_CALC     2500U,            120U
+#define BENCH_BUDGET_SCHED_IDLE      250U,             60U
+
+#endif // BENCH_BUDGET_H
@@ -0,0 +1,529 @@
+/**
+ * @file    bench_hotpath.c
+ * @brief   热路径函数微基准：随机输入批量调用，报告每次调用开销并与预算比较
+ * @note    板上用 DWT->CYCCNT 计时（单位 cycles），SIL 主机构建用 CLOCK_MONOTONIC（单位 ns）。
+ *          只有板上 cycles 预算是门限；主机 ns 受负载影响，超出只打印不计失败（BENCH_ENFORCE）。
+ *          每个函数重复 BENCH_REPS 轮、每轮 BENCH_CALLS 次调用，取最快一轮，
+ *          以排除中断/调度带来的偶发抖动。
+ */
+
+#include "bench_hotpath.h"
+#include "bench_budget.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "stm32f4xx_hal.h"
+#include "attitude.h"
+#include "attitude_ekf.h"
+#include "filter.h"
+#include "filter_bank.h"
+#include "fir_decimator.h"
+#include "imu_frontend.h"
+#include "task_acc.h"
+#include "maths.h"
+#include "pid.h"
+#include "elrs_crsf_uart.h"
+#include "bmp280_lib.h"
+#include "scheduler.h"
+
+#ifdef FC_SIL
+#include <time.h>
+#define BENCH_UNIT      "ns"
+#define BENCH_CALLS     4096U
+#define BENCH_REPS      32U
+#else
+#define BENCH_UNIT      "cycles"
+#define BENCH_CALLS     1024U
+#define BENCH_REPS      8U
+#endif
+
+// 是否把超预算计为失败：板上 cycles 是确定的，作为门限；
+// 主机 ns 是墙钟时间，随机器负载波动，只打印供参考（可用 -DBENCH_ENFORCE=1 强制）
+#ifndef BENCH_ENFORCE
+#ifdef FC_SIL
+#define BENCH_ENFORCE   0
+#else
+#define BENCH_ENFORCE   1
+#endif
+#endif
+
+#define BENCH_INPUTS    1024U   // 随机输入表长度（2 的幂，循环使用）
+#define BENCH_CRSF_FRAMES 8U
+
+typedef void (*bench_fn_t)(uint32_t calls);
+
+typedef struct {
+    const char *name;
+    bench_fn_t  fn;
+    uint32_t    budget_cycles;  // 板上预算（cycles/call）
+    uint32_t    budget_ns;      // 主机预算（ns/call）
+} bench_case_t;
+
+static float bench_in[BENCH_INPUTS];
+static volatile float bench_sink;   // 防止结果被优化掉
+
+// ============================================================================
+// 计时
+// ============================================================================
+
+static uint64_t bench_now(void)
+{
+#ifdef FC_SIL
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#else
+    return DWT->CYCCNT;
+#endif
+}
+
+static uint64_t bench_elapsed(uint64_t start)
+{
+#ifdef FC_SIL
+    return bench_now() - start;
+#else
+    return (uint32_t)((uint32_t)DWT->CYCCNT - (uint32_t)start);  // 32 位回绕
+#endif
+}
+
+// xorshift32：固定种子，主机与板上输入一致
+static uint32_t bench_rng = 0x12345678U;
+
+static uint32_t bench_rand(void)
+{
+    uint32_t x = bench_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    bench_rng = x;
+    return x;
+}
+
+// [-1, 1)
+static float bench_randf(void)
+{
+    return (float)(int32_t)bench_rand() * (1.0f / 2147483648.0f);
+}
+
+#define IN(i)   bench_in[(i) & (BENCH_INPUTS - 1U)]
+
+// ============================================================================
+// 被测函数
+// ============================================================================
+
+static void bench_attitude_imu(uint32_t calls)
+{
+    Euler_angles acc = {0};
+    for (uint32_t i = 0; i < calls; i++) {
+        Euler_angles e = Attitude_Update_IMU_Only(0.05f * IN(i), 0.05f * IN(i + 1), 1.0f + 0.05f * IN(i + 2),
+                                                  500.0f * IN(i + 3), 500.0f * IN(i + 4), 500.0f * IN(i + 5));
+        acc.roll += e.roll;
+    }
+    bench_sink = acc.roll;
+}
+
+#if USE_MAGNETOMETER
+static void bench_attitude_mag(uint32_t calls)
+{
+    Euler_angles acc = {0};
+    for (uint32_t i = 0; i < calls; i++) {
+        Euler_angles e = Attitude_Update(0.05f * IN(i), 0.05f * IN(i + 1), 1.0f + 0.05f * IN(i + 2),
+                                         500.0f * IN(i + 3), 500.0f * IN(i + 4), 500.0f * IN(i + 5),
+                                         0.3f + 0.05f * IN(i + 6), 0.05f * IN(i + 7), -0.4f + 0.05f * IN(i + 8));
+        acc.yaw += e.yaw;
+    }
+    bench_sink = acc.yaw;
+}
+
+// 同一输入走 EKF（预测 + 加速度计 3 维更新 + 磁力计航向更新）
+static void bench_attitude_ekf(uint32_t calls)
+{
+    Attitude_SetEstimator(ATTITUDE_ESTIMATOR_EKF);
+    bench_attitude_mag(calls);
+    Attitude_SetEstimator(ATTITUDE_ESTIMATOR_MAHONY);
+}
+#endif
+
+static biquadFilter_t bench_biquad;
+
+static void bench_biquad_apply(uint32_t calls)
+{
+    float acc = 0.0f;
+    for (uint32_t i = 0; i < calls; i++) {
+        acc += biquadFilterApply(&bench_biquad, 500.0f * IN(i));
+    }
+    bench_sink = acc;
+}
+
+// 默认陀螺链（PT1 + LPF）三轴，每次调用 = 一个三轴样本，按 8 样本块送入 CMSIS 级联
+static filterBank_t bench_bank;
+
+static void bench_filter_bank_block(uint32_t calls)
+{
+    float x[8], y[8];
+    float acc = 0.0f;
+    for (uint32_t i = 0; i < calls; i += 8U) {
+        const uint32_t n = (calls - i < 8U) ? (calls - i) : 8U;
+        for (uint8_t axis = 0; axis < FILTER_BANK_AXES; axis++) {
+            for (uint32_t k = 0; k < n; k++) {
+                x[k] = 500.0f * IN(i + k + axis);
+            }
+            filterBankProcess(&bench_bank, axis, x, y, n);
+            acc += y[n - 1U];
+        }
+    }
+    bench_sink = acc;
+}
+
+// 8kHz -> 1kHz 多相 FIR（陀螺仪路径的整数 Q15 版本），每次调用 = 一个 8kHz 三轴输入样本
+static firDecimatorQ15_t bench_fir;
+
+static void bench_fir_decimate(uint32_t calls)
+{
+    int32_t out[3] = { 0, 0, 0 };
+    int32_t acc = 0;
+    for (uint32_t i = 0; i < calls; i++) {
+        const int16_t in[3] = { (int16_t)(30000.0f * IN(i)), (int16_t)(30000.0f * IN(i + 1U)),
+                                (int16_t)(30000.0f * IN(i + 2U)) };
+        if (firDecimatorQ15Apply(&bench_fir, in, out)) {
+            acc += out[0];
+        }
+    }
+    bench_sink = (float)acc;
+}
+
+// 定点前端：零偏饱和 + 非单位旋转（最坏路径）/ 90° 步进（置换快路径），每次调用 = 一个三轴样本
+static imu_frontend_t bench_fe;
+static imu_frontend_t bench_fe_perm;
+
+static void bench_imu_frontend_run(const imu_frontend_t *fe, uint32_t calls)
+{
+    static const int16_t offset[3] = { -23, 8, 310 };
+    int16_t out[3];
+    int32_t acc = 0;
+    for (uint32_t i = 0; i < calls; i++) {
+        const int16_t raw[3] = { (int16_t)(30000.0f * IN(i)), (int16_t)(30000.0f * IN(i + 1U)),
+                                 (int16_t)(30000.0f * IN(i + 2U)) };
+        imu_frontend_apply(fe, raw, offset, out);
+        acc += out[0] + out[2];
+    }
+    bench_sink = (float)acc;
+}
+
+static void bench_imu_frontend(uint32_t calls)
+{
+    bench_imu_frontend_run(&bench_fe, calls);
+}
+
+static void bench_imu_frontend_perm(uint32_t calls)
+{
+    bench_imu_frontend_run(&bench_fe_perm, calls);
+}
+
+// 加速度计六面校准路径：校准矩阵与安装方向合成后的一次 3x3 乘加
+static void bench_accel_calibrated(uint32_t calls)
+{
+    float acc = 0.0f;
+    for (uint32_t i = 0; i < calls; i++) {
+        accel_process_sample((int16_t)(16000.0f * IN(i)), (int16_t)(16000.0f * IN(i + 1U)),
+                             (int16_t)(16000.0f * IN(i + 2U)));
+        acc += accel_scaled.g_z;
+    }
+    bench_sink = acc;
+}
+
+static pt1Filter_t bench_pt1;
+
+static void bench_pt1_apply(uint32_t calls)
+{
+    float acc = 0.0f;
+    for (uint32_t i = 0; i < calls; i++) {
+        acc += pt1FilterApply(&bench_pt1, 500.0f * IN(i));
+    }
+    bench_sink = acc;
+}
+
+static pid_controller_t bench_pid;
+
+static void bench_pid_ff(uint32_t calls)
+{
+    float acc = 0.0f;
+    for (uint32_t i = 0; i < calls; i++) {
+        acc += pid_update_with_feedforward(&bench_pid, 400.0f * IN(i), 400.0f * IN(i + 1), 100.0f * IN(i + 2));
+    }
+    bench_sink = acc;
+}
+
+static void bench_sin_approx(uint32_t calls)
+{
+    float acc = 0.0f;
+    for (uint32_t i = 0; i < calls; i++) {
+        acc += sin_approx(3.14159265f * IN(i));
+    }
+    bench_sink = acc;
+}
+
+static void bench_atan2_approx(uint32_t calls)
+{
+    float acc = 0.0f;
+    for (uint32_t i = 0; i < calls; i++) {
+        acc += atan2_approx(IN(i), IN(i + 1));
+    }
+    bench_sink = acc;
+}
+
+static void bench_fast_inv_sqrt(uint32_t calls)
+{
+    float acc = 0.0f;
+    for (uint32_t i = 0; i < calls; i++) {
+        acc += fast_inv_sqrt(1.5f + IN(i));
+    }
+    bench_sink = acc;
+}
+
+// CRSF：预先生成若干帧随机通道值的 RC 帧字节流，逐字节喂给解析器
+static uint8_t  bench_crsf_stream[BENCH_CRSF_FRAMES * ELRS_CRSF_FRAME_MAX];
+static uint16_t bench_crsf_len;
+static elrs_crsf_t bench_crsf;
+static uint32_t bench_crsf_frames;
+
+static uint32_t bench_crsf_now_us(void *user)
+{
+    (void)user;
+    return 0;   // 固定时间戳：不触发帧间超时
+}
+
+static void bench_crsf_capture(void *user, const uint8_t *data, uint16_t len)
+{
+    (void)user;
+    for (uint16_t i = 0; i < len && bench_crsf_len < sizeof(bench_crsf_stream); i++) {
+        bench_crsf_stream[bench_crsf_len++] = data[i];
+    }
+}
+
+static void bench_crsf_on_rc(elrs_crsf_t *ctx, const uint16_t *ch, uint8_t count, uint32_t timestamp_us)
+{
+    (void)ctx; (void)ch; (void)count; (void)timestamp_us;
+    bench_crsf_frames++;
+}
+
+static void bench_crsf_byte(uint32_t calls)
+{
+    uint16_t pos = 0;
+    for (uint32_t i = 0; i < calls; i++) {
+        elrs_crsf_input_byte(&bench_crsf, bench_crsf_stream[pos]);
+        if (++pos == bench_crsf_len) pos = 0;
+    }
+}
+
+static bmp280_dev_t bench_bmp;
+
+static void bench_bmp280_calc(uint32_t calls)
+{
+    bmp280_data_t d;
+    int32_t acc = 0;
+    for (uint32_t i = 0; i < calls; i++) {
+        bench_bmp.adc_T = 519888 + (int32_t)(2000.0f * IN(i));
+        bench_bmp.adc_P = 415148 + (int32_t)(20000.0f * IN(i + 1));
+        bmp280_calculate(&bench_bmp, &d);
+        acc += d.pressure;
+    }
+    bench_sink = (float)acc;
+}
+
+// 调度器空转：24 个周期任务 + 4 个事件任务均未到期时一次 scheduler_run 的开销
+#define BENCH_SCHED_PERIODIC    24U
+#define BENCH_SCHED_EVENTS      4U
+#define BENCH_SCHED_TASKS       (BENCH_SCHED_PERIODIC + BENCH_SCHED_EVENTS)
+static task_scheduler_fc_t bench_sched;
+static task_entry_t bench_sched_tasks[BENCH_SCHED_TASKS];
+static task_desc_t bench_sched_desc[BENCH_SCHED_TASKS];    // 自带描述符，固件构建不需要动态注册池
+static volatile bool bench_sched_flags[BENCH_SCHED_EVENTS];
+
+static void bench_sched_task(void *user)
+{
+    (void)user;
+}
+
+static void bench_scheduler_idle(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++) {
+        scheduler_run(&bench_sched);
+    }
+}
+
+static const bench_case_t bench_cases[] = {
+    { "Attitude_Update_IMU_Only",    bench_attitude_imu,  BENCH_BUDGET_ATTITUDE_IMU },
+#if USE_MAGNETOMETER
+    { "Attitude_Update (mag)",       bench_attitude_mag,  BENCH_BUDGET_ATTITUDE_MAG },
+    { "Attitude_Update (EKF, mag)",  bench_attitude_ekf,  BENCH_BUDGET_ATTITUDE_EKF },
+#endif
+    { "biquadFilterApply",           bench_biquad_apply,  BENCH_BUDGET_BIQUAD },
+    { "pt1FilterApply",              bench_pt1_apply,     BENCH_BUDGET_PT1 },
+    { "filterBankProcess (3ax, x8)", bench_filter_bank_block, BENCH_BUDGET_FILTER_BANK },
+    { "firDecimatorQ15Apply (3ax, 8:1)", bench_fir_decimate, BENCH_BUDGET_FIR_DECIM },
+    { "imu_frontend_apply (rotated)", bench_imu_frontend, BENCH_BUDGET_IMU_FRONTEND },
+    { "imu_frontend_apply (CW90_FLIP)", bench_imu_frontend_perm, BENCH_BUDGET_IMU_FRONTEND_PERM },
+    { "accel_process_sample (6-pos cal)", bench_accel_calibrated, BENCH_BUDGET_ACCEL_CAL },
+    { "pid_update_with_feedforward", bench_pid_ff,        BENCH_BUDGET_PID_FF },
+    { "sin_approx",                  bench_sin_approx,    BENCH_BUDGET_SIN_APPROX },
+    { "atan2_approx",                bench_atan2_approx,  BENCH_BUDGET_ATAN2_APPROX },
+    { "fast_inv_sqrt",               bench_fast_inv_sqrt, BENCH_BUDGET_FAST_INV_SQRT },
+    { "elrs_crsf_input_byte",        bench_crsf_byte,     BENCH_BUDGET_CRSF_BYTE },
+    { "bmp280_calculate",            bench_bmp280_calc,   BENCH_BUDGET_BMP280_CALC },
+    { "scheduler_run (28, idle)",    bench_scheduler_idle, BENCH_BUDGET_SCHED_IDLE },
+};
+
+// ============================================================================
+// 准备输入与被测对象
+// ============================================================================
+
+static void bench_setup(void)
+{
+    bench_rng = 0x12345678U;
+    for (uint32_t i = 0; i < BENCH_INPUTS; i++) {
+        bench_in[i] = bench_randf();
+    }
+
+    Attitude_InitFromAccelerometer(0.0f, 0.0f, 1.0f);
+
+    biquadFilterInitLPF(&bench_biquad, 100.0f, 1000U);
+    pt1FilterInit(&bench_pt1, pt1FilterGain(100.0f, 0.001f));
+    const filterBankStage_t bank_stages[] = {
+        { FILTER_BANK_PT1, 100.0f, 0.0f },
+        { FILTER_BANK_LPF, 300.0f, 0.0f },
+    };
+    filterBankInit(&bench_bank, bank_stages, 2, 1000.0f);
+    firDecimatorQ15Init(&bench_fir, 8);
+    static const float bench_rot[3][3] = {
+        { 0.866f, -0.5f, 0.0f }, { 0.5f, 0.866f, 0.0f }, { 0.0f, 0.0f, 1.0f },
+    };
+    imu_frontend_init(&bench_fe);
+    imu_frontend_set_rotation(&bench_fe, bench_rot);
+    const sensor_align_t bench_align = { .step = SENSOR_ALIGN_CW90_FLIP };
+    sensor_rotation_t bench_perm;
+    sensor_rotation_build(&bench_perm, NULL, &bench_align);
+    imu_frontend_init(&bench_fe_perm);
+    imu_frontend_set_alignment(&bench_fe_perm, &bench_perm);
+    static const float bench_accel_c[3][3] = {
+        { 6.1e-5f, 7.0e-7f, -4.0e-7f }, { -3.0e-7f, 6.2e-5f, 9.0e-7f }, { 6.0e-7f, 2.0e-7f, 5.9e-5f },
+    };
+    static const float bench_accel_b[3] = { 310.0f, -245.0f, 520.0f };
+    accel_processing_init();
+    accel_processing_set_alignment(&bench_perm);
+    accel_processing_set_calibration(bench_accel_c, bench_accel_b);
+
+    pid_config_t cfg;
+    pid_get_default_config(&cfg);
+    cfg.enable_feedforward = true;
+    pid_init(&bench_pid, &cfg, 1000.0f);
+
+    // 通过库自身的发送函数生成合法帧（CRC 正确）
+    elrs_crsf_config_t crsf_cfg;
+    memset(&crsf_cfg, 0, sizeof(crsf_cfg));
+    crsf_cfg.now_us = bench_crsf_now_us;
+    crsf_cfg.tx_write = bench_crsf_capture;
+    crsf_cfg.on_rc_channels = bench_crsf_on_rc;
+    elrs_crsf_init(&bench_crsf, &crsf_cfg);
+    bench_crsf_len = 0;
+    for (uint32_t f = 0; f < BENCH_CRSF_FRAMES; f++) {
+        uint8_t payload[22];
+        for (uint32_t i = 0; i < sizeof(payload); i++) {
+            payload[i] = (uint8_t)bench_rand();
+        }
+        elrs_crsf_send_frame(&bench_crsf, ELRS_CRSF_ADDRESS_FLIGHT_CONTROLLER,
+                             ELRS_CRSF_FRAMETYPE_RC_CHANNELS_PACKED, payload, sizeof(payload));
+    }
+    bench_crsf_frames = 0;
+
+    // BMP280 数据手册示例校准参数
+    memset(&bench_bmp, 0, sizeof(bench_bmp));
+    bench_bmp.calib.dig_T1 = 27504; bench_bmp.calib.dig_T2 = 26435; bench_bmp.calib.dig_T3 = -1000;
+    bench_bmp.calib.dig_P1 = 36477; bench_bmp.calib.dig_P2 = -10685; bench_bmp.calib.dig_P3 = 3024;
+    bench_bmp.calib.dig_P4 = 2855;  bench_bmp.calib.dig_P5 = 140;    bench_bmp.calib.dig_P6 = -7;
+    bench_bmp.calib.dig_P7 = 15500; bench_bmp.calib.dig_P8 = -14600; bench_bmp.calib.dig_P9 = 6000;
+
+    // 周期 1~4 秒：整个基准期间都不会到期
+    memset(bench_sched_desc, 0, sizeof(bench_sched_desc));
+    for (uint32_t i = 0; i < BENCH_SCHED_PERIODIC; i++) {
+        task_desc_t *d = &bench_sched_desc[i];
+        d->name = "bench";
+        d->callback = bench_sched_task;
+        d->priority = (task_priority_t)(i % TASK_PRIORITY_COUNT);
+        d->trigger_mode = TASK_TRIGGER_PERIODIC;
+        d->period_cycles = clockMicrosToCycles(1000000U * (1U + i % 4U));
+    }
+    for (uint32_t i = 0; i < BENCH_SCHED_EVENTS; i++) {
+        task_desc_t *d = &bench_sched_desc[BENCH_SCHED_PERIODIC + i];
+        bench_sched_flags[i] = false;
+        d->name = "bench_evt";
+        d->callback = bench_sched_task;
+        d->priority = (task_priority_t)i;
+        d->trigger_mode = TASK_TRIGGER_EVENT;
+        d->event_flag = &bench_sched_flags[i];
+    }
+    const task_table_t bench_sched_table = {
+        .tasks = bench_sched_desc,
+        .count = BENCH_SCHED_TASKS,
+        .cpu_freq_hz = SystemCoreClock,
+    };
+    scheduler_init_static(&bench_sched, &bench_sched_table, bench_sched_tasks, BENCH_SCHED_TASKS, NULL);
+    bench_bmp.sea_level_pressure = 101325.0f;
+}
+
+// ============================================================================
+// 入口
+// ============================================================================
+
+int bench_hotpath_run(void)
+{
+    int over = 0;
+    int slow = 0;
+
+    printf("\r\n========================================\r\n");
+    printf("[bench] 热路径微基准 (%u calls x %u reps, best rep, unit=%s/call)\r\n",
+           (unsigned)BENCH_CALLS, (unsigned)BENCH_REPS, BENCH_UNIT);
+    printf("========================================\r\n");
+    printf("  %-28s %10s %10s  %s\r\n", "function", BENCH_UNIT, "budget", "result");
+
+    bench_setup();
+
+    for (uint32_t c = 0; c < sizeof(bench_cases) / sizeof(bench_cases[0]); c++) {
+        const bench_case_t *bc = &bench_cases[c];
+#ifdef FC_SIL
+        const uint32_t budget = bc->budget_ns;
+#else
+        const uint32_t budget = bc->budget_cycles;
+#endif
+        bc->fn(BENCH_CALLS);    // 预热（cache / 分支预测 / 滤波器状态）
+
+        uint64_t best = UINT64_MAX;
+        for (uint32_t r = 0; r < BENCH_REPS; r++) {
+            const uint64_t t0 = bench_now();
+            bc->fn(BENCH_CALLS);
+            const uint64_t dt = bench_elapsed(t0);
+            if (dt < best) best = dt;
+        }
+
+        const float per_call = (float)best / (float)BENCH_CALLS;
+        const bool ok = per_call <= (float)budget;
+        if (!ok) slow++;
+        printf("  %-28s %10.1f %10u  %s\r\n", bc->name, per_call, (unsigned)budget,
+               ok ? "ok" : (BENCH_ENFORCE ? "OVER BUDGET" : "over (info)"));
+    }
+    if (BENCH_ENFORCE) {
+        over += slow;
+    } else if (slow) {
+        printf("[bench] %d over the host budget (informational, not a failure)\r\n", slow);
+    }
+
+    if (bench_crsf_frames == 0) {
+        printf("[bench] 警告: CRSF 解析器未解出任何帧，基准输入无效\r\n");
+        over++;
+    }
+
+    printf("[bench] %s (%d over budget)\r\n", over ? "FAILED" : "OK", over);
+    return over;
+}
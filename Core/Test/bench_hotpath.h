@@ -0,0 +1,18 @@
+/**
+ * @file    bench_hotpath.h
+ * @brief   Micro-benchmarks for the control hot path with stored per-call budgets.
+ * @note    Same source runs on the board (DWT cycles/call) and in the SIL host build
+ *          (ns/call). Budgets live in bench_budget.h.
+ */
+
+#ifndef BENCH_HOTPATH_H
+#define BENCH_HOTPATH_H
+
+/**
+ * @brief Run every benchmark, print a table and compare against the stored budgets
+ * @return number of functions over budget (0 = all within budget); in the SIL build
+ *         host ns budgets are informational and only invalid benchmark input counts
+ */
+int bench_hotpath_run(void);
+
+#endif // BENCH_HOTPATH_H
@@ -2,6 +2,8 @@
  * @file    test_attitude_full.c
  * @brief   完整姿态解算测试（陀螺仪 + 加速度计 + 磁力计）
  * @note    配合优化后的attitude.c使用，陀螺仪零偏已在底层处理
+ *          主循环从硬件 FIFO 读取 8kHz 全速率陀螺仪数据，经 task_gyro 多相 FIR 8:1 降采样后以 1kHz 更新姿态
+ *          陀螺仪零偏由 gyro_cal 在线估计（主循环轮询 gyro_cal_task），启动时不再阻塞校准
  */
 
 #include "test_attitude_full.h"
@@ -17,6 +19,7 @@
 #include "task_gyro.h"
 #include "task_acc.h"
 #include "task_mag.h"
+#include "gyro_cal.h"
 
 extern icm42688p_dev_t icm;
 extern hmc5883l_dev_t hmc_dev;
@@ -24,6 +27,11 @@ extern hmc5883l_dev_t hmc_dev;
 // 磁力计融合开关：如果磁力计未校准，建议设为false避免yaw漂移
 #define USE_MAG_FUSION  true  // true=使用磁力计融合, false=仅IMU
 
+#define IMU_FIFO_WATERMARK  8U      // 8kHz ODR：每个水位中断对应一个 1kHz 输出
+#define IMU_FIFO_BATCH      64U     // 磁力计/气压计 I2C 阻塞期间积压的样本
+
+static icm42688p_fifo_sample_t imu_fifo_batch[IMU_FIFO_BATCH];
+
 /**
  * @brief 从传感器数据初始化姿态
  * @param use_mag 是否使用磁力计初始化yaw角
@@ -85,8 +93,8 @@ void test_attitude_full_run(void)
     // ============ 步骤3: 传感器校准 ============
     printf("[3/5] 校准传感器...\r\n");
     
-    // 3.1 陀螺仪零偏校准（静止状态）
-    printf("  >> 陀螺仪零偏校准（请保持设备静止，采样500个样本，约2.5秒）...\r\n");
+    // 3.1 陀螺仪零偏在线估计（静止窗口）
+    printf("  >> 陀螺仪零偏在线估计（gyro_cal：保持静止约0.5秒后生效，不阻塞启动）...\r\n");
     
     // 显示校准前的原始数据（用于调试）
     int16_t dbg_gx, dbg_gy, dbg_gz, dbg_ax, dbg_ay, dbg_az;
@@ -96,16 +104,16 @@ void test_attitude_full_run(void)
                dbg_gx, dbg_gy, dbg_gz, dbg_ax, dbg_ay, dbg_az);
     }
     
-    if (icm42688p_calibrate(500)) {
-        printf("      ✓ 陀螺仪零偏: [%d, %d, %d] (已自动应用)\r\n", 
-               icm.gyro_offset[0], icm.gyro_offset[1], icm.gyro_offset[2]);
-    } else {
-        printf("      ✗ 陀螺仪校准失败！\r\n");
+    icm.gyro_offset[0] = icm.gyro_offset[1] = icm.gyro_offset[2] = 0;
+    if (!gyro_cal_init(NULL)) {
+        printf("      ✗ gyro_cal 初始化失败！\r\n");
     }
+    gyro_cal_load();   // Flash 中有温度模型时，第一块（62.5ms）就按模型给出零偏
     
     // 3.2 加速度计（不校准，保留重力信号用于姿态解算）
     printf("  >> 加速度计无需校准（保留重力信号用于姿态解算）\r\n");
-    icm42688p_calibrate_accel(&icm, 0);  // 零偏设为0（不校准）
+    // 不做平均值校准（会吃掉重力）；零偏/刻度/交叉轴用六面校准（accel_cal），此处清零
+    icm.accel_offset[0] = icm.accel_offset[1] = icm.accel_offset[2] = 0;
     printf("      加速度计零偏: [%d, %d, %d] (应全为0)\r\n", 
            icm.accel_offset[0], icm.accel_offset[1], icm.accel_offset[2]);
     
@@ -128,7 +136,7 @@ void test_attitude_full_run(void)
 
     // ============ 步骤4: 初始化数据处理模块 ============
     printf("[4/5] 初始化数据处理模块...\r\n");
-    gyro_processing_init(1);  // 不降采样
+    gyro_processing_init(8);  // 8kHz -> 1kHz，多相 FIR 抗混叠降采样
     accel_processing_init();
     if (mag_available) {
         mag_processing_init();
@@ -164,7 +172,7 @@ void test_attitude_full_run(void)
             printf("  样本%d:\r\n", i+1);
             printf("    原始RAW: G(%d,%d,%d) A(%d,%d,%d) T=%.1f°C\r\n",
                    gx_raw, gy_raw, gz_raw, ax_raw, ay_raw, az_raw, temp);
-            printf("    零偏补偿后: G(%d,%d,%d) [应接近0]\r\n",
+            printf("    零偏补偿后: G(%d,%d,%d) [gyro_cal 就绪后应接近0]\r\n",
                    gx_comp, gy_comp, gz_comp);
             printf("    task输出: gyro(%.1f,%.1f,%.1f)dps acc(%.3f,%.3f,%.3f)g\r\n",
                    gyro_scaled.dps_x, gyro_scaled.dps_y, gyro_scaled.dps_z,
@@ -183,7 +191,7 @@ void test_attitude_full_run(void)
     printf("\r\n[诊断] ICM42688P 配置:\r\n");
     printf("  gyro_scale  = %.2f (LSB/dps)\r\n", icm.gyro_scale);
     printf("  accel_scale = %.2f (LSB/g)\r\n", icm.accel_scale);
-    printf("  gyro_offset = [%d, %d, %d] [陀螺仪零偏，通常<±500]\r\n", 
+    printf("  gyro_offset = [%d, %d, %d] [陀螺仪零偏，gyro_cal 静止窗口后写入]\r\n", 
            icm.gyro_offset[0], icm.gyro_offset[1], icm.gyro_offset[2]);
     printf("  accel_offset= [%d, %d, %d] [加速度计零偏，应全为0]\r\n", 
            icm.accel_offset[0], icm.accel_offset[1], icm.accel_offset[2]);
@@ -212,22 +220,48 @@ void test_attitude_full_run(void)
     const uint32_t sat_guard_enable_ms = HAL_GetTick() + 800; // 上电后延迟一段时间再开始饱和检测
     const float cycles_to_us = 1000000.0f / (float)SystemCoreClock;
     float last_mag_strength = 0.0f;
+    bool gyro_cal_reported = false;
+
+    // 陀螺仪全速率数据走硬件 FIFO，不再轮询丢弃 8kHz 样本
+    if (!icm42688p_fifo_start(IMU_FIFO_WATERMARK, false)) {
+        printf("[测试] FIFO 启动失败\r\n");
+        return;
+    }
 
     while (1) {
-        int16_t gx_raw, gy_raw, gz_raw, ax_raw, ay_raw, az_raw;
         int16_t mx_raw = 0, my_raw = 0, mz_raw = 0;
-        float temp_c;
 
-        // ---- 读取IMU原始数据 ----
-        if (!icm42688p_get_all_data(&gx_raw, &gy_raw, &gz_raw, 
-                                    &ax_raw, &ay_raw, &az_raw, &temp_c)) {
-            HAL_Delay(100);
+        // ---- 读取IMU FIFO ----
+        if (!icm42688p_fifo_ready) {
             continue;
         }
+        const uint16_t n = icm42688p_fifo_drain(imu_fifo_batch, IMU_FIFO_BATCH);
 
-        // 处理陀螺仪和加速度计数据
-        gyro_process_sample(gx_raw, gy_raw, gz_raw);
-        accel_process_sample(ax_raw, ay_raw, az_raw);
+        // 加速度计取批内最新样本，陀螺仪逐个样本进入降采样
+        for (uint16_t i = n; i > 0; i--) {
+            const icm42688p_fifo_sample_t *s = &imu_fifo_batch[i - 1];
+            if (s->accel_valid) {
+                accel_process_sample(s->accel[0], s->accel[1], s->accel[2]);
+                break;
+            }
+        }
+        const uint16_t outputs = gyro_process_batch(imu_fifo_batch, n, NULL, NULL);
+
+        // ---- 陀螺仪零偏在线估计（轮询版事件任务） ----
+        if (gyro_cal_should_run(NULL)) {
+            gyro_cal_task(NULL);
+            if (!gyro_cal_reported && gyro_cal_is_ready()) {
+                gyro_cal_reported = true;
+                printf("[gyro_cal] 陀螺仪零偏: [%d, %d, %d]\r\n",
+                       icm.gyro_offset[0], icm.gyro_offset[1], icm.gyro_offset[2]);
+            }
+        }
+        if (gyro_cal_save_should_run(NULL)) {
+            gyro_cal_save_task(NULL);   // 拟合变化时写入 Flash（扇区写满擦除时阻塞约 1~2 秒）
+        }
+        if (outputs == 0) {
+            continue;
+        }
 
         // ---- 读取磁力计（降低频率，每2次读一次，响应更快） ----
         if (mag_available && (loop_count % 2 == 0)) {
@@ -285,14 +319,14 @@ void test_attitude_full_run(void)
             // 使用磁力计融合（9DoF）
             ang = Attitude_Update(
                 accel_scaled.g_x, accel_scaled.g_y, accel_scaled.g_z,
-                gyro_scaled.dps_x, gyro_scaled.dps_y, gyro_scaled.dps_z,
+                gyro_decimated.dps_x, gyro_decimated.dps_y, gyro_decimated.dps_z,
                 mx_unit, my_unit, mz_unit
             );
         } else {
             // 仅使用IMU（6DoF）
             ang = Attitude_Update_IMU_Only(
                 accel_scaled.g_x, accel_scaled.g_y, accel_scaled.g_z,
-                gyro_scaled.dps_x, gyro_scaled.dps_y, gyro_scaled.dps_z
+                gyro_decimated.dps_x, gyro_decimated.dps_y, gyro_decimated.dps_z
             );
         }
         
@@ -305,7 +339,7 @@ void test_attitude_full_run(void)
                    (unsigned long)now,
                    ang.roll, ang.pitch, ang.yaw,
                    accel_scaled.g_x, accel_scaled.g_y, accel_scaled.g_z,
-                   gyro_scaled.dps_x, gyro_scaled.dps_y, gyro_scaled.dps_z,
+                   gyro_decimated.dps_x, gyro_decimated.dps_y, gyro_decimated.dps_z,
                    mag_raw.x, mag_raw.y, mag_raw.z);
         }
 
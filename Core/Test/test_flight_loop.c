@@ -0,0 +1,299 @@
+/**
+ * @file    test_flight_loop.c
+ * @brief   调度器驱动的姿态测试（陀螺仪 + 加速度计），IMU 路径走实时通道
+ * @note    ICM42688P FIFO 水位中断（8kHz ODR，每 8 个样本 = 1kHz）-> EXTI 置位 imu 任务标志并挂起
+ *          PendSV -> scheduler_rt_isr 在 PendSV（优先级 2，低于 SPI DMA）中运行 imu 任务：
+ *          读出 FIFO，逐个样本跑默认飞控流水线（task_pipeline：降采样 -> 滤波 -> 姿态 -> PID/混控）。
+ *          打印与统计是协作通道的 IDLE 任务，串口阻塞输出不会推迟 IMU 路径。
+ *          协作通道空闲时 scheduler_idle_wfi 睡眠，由 EXTI/SysTick 唤醒。
+ *          陀螺仪零偏由 gyro_cal 在线估计：样本路径只累加，静止判定与零偏更新是协作通道的 LOW 任务；
+ *          零偏-温度模型启动时从 Flash 导入，拟合变化时由 IDLE 任务 gyro_cal_save 写回。
+ *          串口（UART1）收到 'A' 启动加速度计六面校准（accel_cal），按提示依次静置 6 个面，
+ *          完成后校准结果立即下发到 task_acc。
+ *          延迟追踪：水位中断开记录，FIFO 读完打 SPI_DONE，流水线各阶段打点，混控输出后打 MOTOR；
+ *          串口收到 'T' 由 IDLE 任务导出环形缓冲区（二进制 'LT' 帧，上位机用 fc_trace 解码）。
+ */
+
+#include "test_flight_loop.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include "stm32f4xx_hal.h"
+#include "bsp_IO.h"
+#include "bsp_uart.h"
+#include "attitude.h"
+#include "icm42688p.h"
+#include "scheduler.h"
+#include "task_manifest.h"
+#include "task_gyro.h"
+#include "task_acc.h"
+#include "task_fliter.h"
+#include "task_pid.h"
+#include "task_pipeline.h"
+#include "gyro_cal.h"
+#include "accel_cal.h"
+#include "latency_trace.h"
+
+extern icm42688p_dev_t icm;
+
+#define FLIGHT_FIFO_WATERMARK   8U      // 8kHz ODR：每个水位中断对应一个 1kHz 输出
+#define FLIGHT_FIFO_BATCH       32U
+#define FLIGHT_GYRO_ODR_HZ      8000U
+#define FLIGHT_CONTROL_HZ       1000U
+
+static task_scheduler_fc_t flight_sched;
+static volatile bool flight_active = false;     // 调度器就绪后才响应 EXTI / PendSV
+static volatile bool flight_imu_ready = false;  // FIFO 水位中断 -> imu 任务
+static volatile uint32_t flight_imu_t_exti = 0; // 最近一次水位中断时刻（DWT 周期）
+static volatile bool flight_accel_cal_req = false;  // 串口命令 'A' -> accel_cal_cmd 任务
+static volatile bool flight_trace_dump_req = false; // 串口命令 'T' -> trace_dump 任务
+
+static icm42688p_fifo_sample_t flight_fifo_batch[FLIGHT_FIFO_BATCH];
+static pipeline_t flight_pipe;
+static Euler_angles flight_att;
+static pid_output_t flight_mixer;   // 混控输出（电机驱动接入前只保存，stats 任务打印）
+
+// ============================================================================
+// 中断钩子
+// ============================================================================
+
+// IMU 数据就绪 EXTI（优先级 1）：只置位标志并挂起实时通道中断
+void icm42688p_on_data_ready_isr(uint32_t timestamp)
+{
+    if (flight_active) {
+        flight_imu_t_exti = timestamp;
+        flight_imu_ready = true;
+        BSP_RT_Lane_Pend();
+    }
+}
+
+// 控制台串口字节（UART1 接收中断，优先级 5；CRSF 未绑定 UART1 时才会转交过来）：单字节命令，只置位任务标志
+void BSP_UART_ConsoleByteCallback(uint8_t uart_id, uint8_t byte)
+{
+    if (!flight_active || uart_id != 1) {
+        return;
+    }
+    if (byte == 'A' || byte == 'a') {
+        flight_accel_cal_req = true;
+    } else if (byte == 'T' || byte == 't') {
+        flight_trace_dump_req = true;
+    }
+}
+
+// PendSV（优先级 2）：派发实时通道任务
+void BSP_RT_Lane_IRQ(void)
+{
+    if (flight_active) {
+        scheduler_rt_isr(&flight_sched);
+    }
+}
+
+// ============================================================================
+// 任务
+// ============================================================================
+
+// 实时通道：读出 FIFO，每个陀螺仪样本跑一遍飞控流水线；加速度计取批内最新一个，随第一帧送入
+static void flight_imu_task(void *user)
+{
+    (void)user;
+
+    const uint32_t t_exti = flight_imu_t_exti;
+    const uint16_t n = icm42688p_fifo_drain(flight_fifo_batch, FLIGHT_FIFO_BATCH);
+    const uint32_t trace_id = latency_trace_find(t_exti);   // EXTI 中开的记录
+    latency_trace_mark(trace_id, LATENCY_TRACE_SPI_DONE);
+    const icm42688p_fifo_sample_t *accel = NULL;
+    for (uint16_t i = n; i > 0 && !accel; i--) {
+        if (flight_fifo_batch[i - 1].accel_valid) accel = &flight_fifo_batch[i - 1];
+    }
+
+    // 批内最后一个样本对应水位中断，之前的样本按 ODR 周期往前推采样时刻（PID dt 与延迟统计用）
+    const uint32_t cycles_per_sample = SystemCoreClock / FLIGHT_GYRO_ODR_HZ;
+    const icm42688p_fifo_sample_t *last = NULL;
+    for (uint16_t i = 0; i < n; i++) {
+        const icm42688p_fifo_sample_t *s = &flight_fifo_batch[i];
+        if (!s->gyro_valid) continue;
+
+        pipeline_frame_t f = {
+            .valid = PIPE_SIG(PIPE_SIG_GYRO_RAW),
+            .t_sample = t_exti - (uint32_t)(n - 1U - i) * cycles_per_sample,
+            .trace_id = trace_id,
+            .gyro_raw = { s->gyro[0], s->gyro[1], s->gyro[2] },
+        };
+        if (accel) {
+            f.valid |= PIPE_SIG(PIPE_SIG_ACCEL_RAW);
+            f.accel_raw[0] = accel->accel[0];
+            f.accel_raw[1] = accel->accel[1];
+            f.accel_raw[2] = accel->accel[2];
+            accel = NULL;
+        }
+
+        const uint32_t out = pipeline_run(&flight_pipe, &f);
+        if (out & PIPE_SIG(PIPE_SIG_ATTITUDE)) flight_att = f.attitude;
+        if (out & PIPE_SIG(PIPE_SIG_MOTOR)) {
+            flight_mixer = *f.motor;
+            latency_trace_mark(trace_id, LATENCY_TRACE_MOTOR);
+        }
+        last = s;
+    }
+
+    // 芯片温度每批更新一次，供零偏温度模型使用（同 gyro_process_batch）
+    if (last) {
+        gyro_cal_set_temperature(last->temp_c);
+    }
+}
+
+// 协作通道：上位机格式输出（10Hz）
+static void flight_report_task(void *user)
+{
+    (void)user;
+
+    // imu 任务在实时通道（PendSV）中写这三份数据：关中断一起拷贝，打印同一帧的姿态/加速度/角速度
+    __disable_irq();
+    const Euler_angles ang = flight_att;
+    const accel_scaled_t acc = accel_scaled;
+    const gyro_decimated_t gyro = gyro_decimated;
+    __enable_irq();
+
+    printf("ATTITUDE_FULL,%lu,%.2f,%.2f,%.2f,%.3f,%.3f,%.3f,%.2f,%.2f,%.2f,0,0,0\r\n",
+           (unsigned long)HAL_GetTick(),
+           ang.roll, ang.pitch, ang.yaw,
+           acc.g_x, acc.g_y, acc.g_z,
+           gyro.dps_x, gyro.dps_y, gyro.dps_z);
+}
+
+// 协作通道：串口命令启动（或重新开始）六面校准
+static void flight_accel_cal_cmd_task(void *user)
+{
+    (void)user;
+    if (accel_cal_start(NULL)) {
+        printf("[flight_loop] 六面校准：顺序任意，每个面静置约 1 秒，完成后自动下发\r\n");
+    }
+}
+
+// 协作通道：串口命令导出延迟追踪（轮询发送，导出期间暂停记录）
+static void flight_trace_dump_task(void *user)
+{
+    (void)user;
+    const uint32_t bytes = latency_trace_dump_uart(1);
+    printf("\r\n[flight_loop] latency trace: %lu 条记录, %lu 字节, stale=%lu\r\n",
+           (unsigned long)latency_trace_count(), (unsigned long)bytes,
+           (unsigned long)latency_trace_stale());
+}
+
+// 协作通道：调度器统计与直方图（每 5 秒；SCHED_HIST 行由上位机 Scheduler Timing 面板显示）
+static void flight_stats_task(void *user)
+{
+    (void)user;
+    scheduler_print_stats(&flight_sched);
+    scheduler_print_histograms(&flight_sched);
+
+    gyro_cal_status_t cal;
+    gyro_cal_get_status(&cal);
+    printf("[gyro_cal] state=%d windows=%lu bias=%.3f,%.3f,%.3f dps temp=%.1fC\r\n",
+           (int)cal.state, (unsigned long)cal.windows,
+           cal.bias_dps[0], cal.bias_dps[1], cal.bias_dps[2], cal.temp_c);
+
+    __disable_irq();
+    const pid_output_t mix = flight_mixer;
+    __enable_irq();
+    pipeline_print_stats(&flight_pipe);
+    printf("[mixer] link=%d motor=%.3f,%.3f,%.3f,%.3f\r\n",
+           (int)mix.link_active, mix.motor[0], mix.motor[1], mix.motor[2], mix.motor[3]);
+
+    accel_cal_status_t acc;
+    accel_cal_get_status(&acc);
+    if (acc.state != ACCEL_CAL_STATE_OFF) {
+        printf("[accel_cal] state=%d captured=0x%02x next=%d overruns=%lu\r\n",
+               (int)acc.state, acc.captured, (int)acc.next, (unsigned long)acc.overruns);
+    }
+}
+
+// ============================================================================
+// 任务清单（编译期任务表，见 task_manifest.h）
+// ============================================================================
+
+// imu：FIFO 水位中断 1kHz，每次 8 帧流水线（1 帧完整跑到混控）；gyro_cal：每块 500 样本（8kHz 下 62.5ms）；
+// gyro_cal_save：只在拟合变化时运行，扇区写满时擦除阻塞约 1~2 秒，不设执行时间上限；
+// accel_cal：每块 100 个 1kHz 样本，采集/完成时串口打印（阻塞），预算按 10ms；report 10Hz；stats 0.2Hz；
+// trace_dump：一次导出约 8KB 轮询发送，不设执行时间上限
+// gyro_cal_task 在协作通道关中断一次写入三轴 icm.gyro_offset，imu 任务不会读到新旧混合的零偏
+#define FLIGHT_TASKS(PERIODIC, EVENT_FLAG, EVENT_CB, EVENT_QUEUE)                                                   \
+    EVENT_FLAG(imu, flight_imu_task, NULL, TASK_PRIORITY_CRITICAL, &flight_imu_ready, 1000, 300)                    \
+    EVENT_CB(gyro_cal, gyro_cal_task, gyro_cal_should_run, NULL, TASK_PRIORITY_LOW, 62500, 100)                     \
+    EVENT_CB(gyro_cal_save, gyro_cal_save_task, gyro_cal_save_should_run, NULL, TASK_PRIORITY_IDLE, 0, 0)           \
+    EVENT_CB(accel_cal, accel_cal_task, accel_cal_should_run, NULL, TASK_PRIORITY_LOW, 100000, 10000)               \
+    EVENT_FLAG(accel_cal_cmd, flight_accel_cal_cmd_task, NULL, TASK_PRIORITY_IDLE, &flight_accel_cal_req, 0, 10000) \
+    EVENT_FLAG(trace_dump, flight_trace_dump_task, NULL, TASK_PRIORITY_IDLE, &flight_trace_dump_req, 0, 0)          \
+    PERIODIC(report, flight_report_task, NULL, TASK_PRIORITY_IDLE, 100000, 2000)                                    \
+    PERIODIC(stats, flight_stats_task, NULL, TASK_PRIORITY_IDLE, 5000000, 20000)
+
+TASK_MANIFEST_IDS(flight, FLIGHT_TASKS);
+TASK_MANIFEST_DEFINE(flight, FLIGHT_TASKS);
+
+static task_entry_t flight_task_state[TASK_COUNT_flight];
+
+// ============================================================================
+// 入口
+// ============================================================================
+
+void test_flight_loop_run(void)
+{
+    printf("\r\n========================================\r\n");
+    printf("[flight_loop] 调度器 + 实时通道姿态测试（陀螺仪+加速度计）\r\n");
+    printf("========================================\r\n\r\n");
+
+    printf("[1/4] 初始化 ICM42688P...\r\n");
+    icm42688p_init_driver();
+    HAL_Delay(100);
+
+    printf("[2/4] 启动陀螺仪在线零偏估计（gyro_cal，静止约0.5秒后生效）...\r\n");
+    icm.gyro_offset[0] = icm.gyro_offset[1] = icm.gyro_offset[2] = 0;
+    gyro_cal_init(NULL);
+    gyro_cal_load();   // Flash 中有温度模型时不必等静止窗口
+    icm.accel_offset[0] = icm.accel_offset[1] = icm.accel_offset[2] = 0;   // 六面校准见 accel_cal
+
+    printf("[3/4] 初始化飞控流水线（降采样/滤波/姿态/PID）...\r\n");
+    gyro_processing_init(FLIGHT_GYRO_ODR_HZ / FLIGHT_CONTROL_HZ);   // 8kHz -> 1kHz
+    accel_processing_init();
+    gyro_filter_init((float)FLIGHT_CONTROL_HZ, 100.0f, 300.0f);
+    Attitude_Init();
+    task_pid_init((float)FLIGHT_CONTROL_HZ);
+    const pipeline_flight_config_t pipe_cfg = {
+        .control_hz = (float)FLIGHT_CONTROL_HZ,
+        .max_rate_dps = 400.0f,
+        .use_mag = false,
+    };
+    if (!pipeline_flight_init(&flight_pipe, &pipe_cfg)) {
+        printf("[flight_loop] 流水线建立失败\r\n");
+        return;
+    }
+
+    printf("[4/4] 加载任务表并启用实时通道...\r\n");
+    const scheduler_config_t cfg = {
+        .enable_stats = true,
+        .enable_overrun_check = true,
+        .cpu_freq_hz = SystemCoreClock,
+        .max_tasks = TASK_COUNT_flight,
+    };
+    if (!scheduler_init_static(&flight_sched, &flight_task_table, flight_task_state, TASK_COUNT_flight, &cfg)) {
+        printf("[flight_loop] 任务表加载失败\r\n");
+        return;
+    }
+    scheduler_set_idle_hook(&flight_sched, scheduler_idle_wfi, NULL, 0);   // 余量超过 1ms SysTick 才 WFI
+
+    scheduler_enable_rt_lane(&flight_sched, TASK_PRIORITY_HIGH);   // CRITICAL + HIGH -> PendSV
+    BSP_RT_Lane_Init();
+
+    if (!icm42688p_fifo_start(FLIGHT_FIFO_WATERMARK, false)) {
+        printf("[flight_loop] FIFO 启动失败\r\n");
+        return;
+    }
+    latency_trace_init();
+    flight_active = true;
+
+    printf("格式: ATTITUDE_FULL,时间,Roll,Pitch,Yaw,ax,ay,az,gx,gy,gz,0,0,0\r\n");
+    printf("命令: 发送 'A' 开始加速度计六面校准，'T' 导出延迟追踪\r\n\r\n");
+    while (1) {
+        scheduler_run(&flight_sched);   // 只运行 NORMAL/LOW/IDLE
+    }
+}
@@ -0,0 +1,12 @@
+/**
+ * @file    test_flight_loop.h
+ * @brief   Scheduler-driven attitude test: IMU path on the real-time lane (PendSV),
+ *          reporting on the cooperative lane.
+ */
+
+#ifndef TEST_FLIGHT_LOOP_H
+#define TEST_FLIGHT_LOOP_H
+
+void test_flight_loop_run(void);
+
+#endif // TEST_FLIGHT_LOOP_H
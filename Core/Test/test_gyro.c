@@ -2,6 +2,11 @@
  * @file    test_gyro.c
  * @brief   Attitude solving on MCU using only gyro + accel (Mahony IMU-only).
  * @note    Uses task_gyro and task_acc modules for data processing.
+ *          Gyro runs from the hardware FIFO at the full 8kHz ODR and is decimated
+ *          8:1 by the polyphase FIR in task_gyro; attitude updates at 1kHz.
+ *          test_gyro_dma_run() is the same test fed by the data-ready EXTI + SPI DMA
+ *          burst stream (one frame per 8kHz sample, decoded in place).
+ *          Gyro bias comes from the non-blocking gyro_cal estimator, polled from the loop.
  */
 
 #include "test_gyro.h"
@@ -13,9 +18,15 @@
 #include "icm42688p.h"
 #include "task_gyro.h"
 #include "task_acc.h"
+#include "gyro_cal.h"
 
 extern icm42688p_dev_t icm;
 
+#define TEST_GYRO_FIFO_WATERMARK  8U     // 8kHz ODR: one watermark interrupt per 1kHz output
+#define TEST_GYRO_FIFO_BATCH      32U
+
+static icm42688p_fifo_sample_t fifo_batch[TEST_GYRO_FIFO_BATCH];
+
 static void init_attitude_from_static_accel(void)
 {
     if (accel_scaled.ready) {
@@ -27,7 +38,8 @@ static void init_attitude_from_static_accel(void)
     }
 }
 
-void test_gyro_run(void)
+// 初始化 IMU、零偏与数据处理模块，并用静止加速度计初始化姿态（两种数据源共用）
+static void test_gyro_setup(void)
 {
     printf("\r\n========================================\r\n");
     printf("[test_gyro] IMU姿态测量(仅陀螺仪+加速度计)\r\n");
@@ -38,8 +50,8 @@ void test_gyro_run(void)
     icm42688p_init_driver();
     HAL_Delay(100);
 
-    // 2. 校准陀螺仪（加速度计不需要校准，因为重力是真实信号）
-    printf("[2/4] 校准陀螺仪零偏（请保持设备静止，采集500个样本，约0.5秒）...\r\n");
+    // 2. 陀螺仪零偏在线估计（加速度计不需要校准，因为重力是真实信号）
+    printf("[2/4] 启动陀螺仪在线零偏估计（gyro_cal：静止约0.5秒后生效，不阻塞启动）...\r\n");
     
     // 读取几个样本查看原始数据（用于调试）
     int16_t dbg_gx, dbg_gy, dbg_gz, dbg_ax, dbg_ay, dbg_az;
@@ -49,18 +61,20 @@ void test_gyro_run(void)
                dbg_gx, dbg_gy, dbg_gz, dbg_ax, dbg_ay, dbg_az);
     }
     
-    icm42688p_calibrate(500);  // 500个样本足以获得良好精度
-    printf("      陀螺仪零偏: %d %d %d\r\n", icm.gyro_offset[0], icm.gyro_offset[1], icm.gyro_offset[2]);
+    icm.gyro_offset[0] = icm.gyro_offset[1] = icm.gyro_offset[2] = 0;
+    gyro_cal_init(NULL);       // 零偏由主循环中的 gyro_cal_task 写入 icm.gyro_offset
+    gyro_cal_load();           // Flash 中有温度模型时，第一块（62.5ms）就按模型给出零偏
     
     printf("      加速度计无需校准（保留重力信号用于姿态解算）\r\n");
-    icm42688p_calibrate_accel(&icm, 0);  // 不校准，零偏设为0
+    // 不做平均值校准（会吃掉重力）；零偏/刻度/交叉轴用六面校准（accel_cal），此处清零
+    icm.accel_offset[0] = icm.accel_offset[1] = icm.accel_offset[2] = 0;
     printf("      加速度计零偏: %d %d %d (应全为0)\r\n", icm.accel_offset[0], icm.accel_offset[1], icm.accel_offset[2]);
     
     // 零偏由 task_gyro/task_acc 处理，姿态模块直接使用补偿后的数据
 
     // 3. 初始化数据处理模块
     printf("[3/4] 初始化数据处理模块..\r\n");
-    gyro_processing_init(1);  // 不降采样:1
+    gyro_processing_init(8);  // 8kHz -> 1kHz，多相 FIR 抗混叠降采样
     accel_processing_init();
 
     // 4. 初始化姿态解算
@@ -81,71 +95,147 @@ void test_gyro_run(void)
     printf("\r\n[test_gyro] 开始实时输出姿态角...\r\n");
     printf("格式: ATTITUDE_FULL,时间,Roll,Pitch,Yaw,ax,ay,az,gx,gy,gz,0,0,0\r\n");
     printf("注意: 姿态解算不再单独处理零偏，完全依赖 task_gyro/task_acc 校准结果\r\n\r\n");
+}
+
+// 轮询版的 gyro_cal 事件任务：有待处理的块时处理，首次得到零偏时打印；拟合变化时写入 Flash
+static void test_gyro_cal_poll(void)
+{
+    static bool reported = false;
+
+    if (gyro_cal_should_run(NULL)) {
+        gyro_cal_task(NULL);
+    }
+    if (gyro_cal_save_should_run(NULL)) {
+        gyro_cal_save_task(NULL);
+    }
+    if (!reported && gyro_cal_is_ready()) {
+        reported = true;
+        printf("[gyro_cal] 陀螺仪零偏: %d %d %d\r\n", icm.gyro_offset[0], icm.gyro_offset[1], icm.gyro_offset[2]);
+    }
+}
 
-    uint32_t last_print = HAL_GetTick();
-    uint32_t last_perf = last_print;
+// 用最新的降采样陀螺仪与加速度计更新姿态，并定时打印
+static void test_gyro_attitude_step(void)
+{
+    static uint32_t last_print = 0;
+    static uint32_t last_perf = 0;
     const float cycles_to_us = 1000000.0f / (float)SystemCoreClock;
 
+    // 使用处理后的数据更新姿态
+    if (!accel_scaled.ready) {
+        return;
+    }
+
+#if USE_MAGNETOMETER
+    Euler_angles ang = Attitude_Update_IMU_Only(
+        accel_scaled.g_x, accel_scaled.g_y, accel_scaled.g_z,
+        gyro_decimated.dps_x, gyro_decimated.dps_y, gyro_decimated.dps_z
+    );
+#else
+    Euler_angles ang = Attitude_Update(
+        accel_scaled.g_x, accel_scaled.g_y, accel_scaled.g_z,
+        gyro_decimated.dps_x, gyro_decimated.dps_y, gyro_decimated.dps_z
+    );
+#endif
+    const AttitudeDiagnostics *diag = Attitude_GetDiagnostics();
+
+    // 定时打印（上位机格式）
+    uint32_t now = HAL_GetTick();
+    if (now - last_print >= 100) {
+        last_print = now;
+        
+        // ATTITUDE_FULL 格式（单片机计算的姿态）
+        printf("ATTITUDE_FULL,%lu,%.2f,%.2f,%.2f,%.3f,%.3f,%.3f,%.2f,%.2f,%.2f,0,0,0\r\n",
+               (unsigned long)now,
+               ang.roll, ang.pitch, ang.yaw,
+               accel_scaled.g_x, accel_scaled.g_y, accel_scaled.g_z,
+               gyro_decimated.dps_x, gyro_decimated.dps_y, gyro_decimated.dps_z);
+    }
+
+    if (now - last_perf >= 1000) {
+        last_perf = now;
+        float last_us = diag->cycles * cycles_to_us;
+        float max_us  = diag->cycles_max * cycles_to_us;
+        printf("[perf] dt=%.3fs spin=%.1f dps acc=%d mag=%d strength_ok=%d cycles=%lu (max %lu) => %.2fus / %.2fus\r\n",
+               diag->dt,
+               diag->spin_rate_dps,
+               diag->acc_valid,
+               diag->mag_used,
+               diag->mag_strength_ok,
+               (unsigned long)diag->cycles,
+               (unsigned long)diag->cycles_max,
+               last_us,
+               max_us);
+#ifdef ICM_USE_DMA
+        if (icm42688p_dma_is_streaming()) {
+            printf("[dma] frames=%lu overruns=%lu dropped=%lu errors=%lu\r\n",
+                   (unsigned long)icm_dma.stats.completed, (unsigned long)icm_dma.stats.overruns,
+                   (unsigned long)icm_dma.stats.dropped, (unsigned long)icm_dma.stats.errors);
+        }
+#endif
+    }
+}
+
+void test_gyro_run(void)
+{
+    test_gyro_setup();
+
+    // 陀螺仪全速率数据走硬件 FIFO，不再轮询丢弃 8kHz 样本
+    if (!icm42688p_fifo_start(TEST_GYRO_FIFO_WATERMARK, false)) {
+        printf("[test_gyro] FIFO 启动失败\r\n");
+        return;
+    }
+
     while (1) {
-        int16_t gx_raw, gy_raw, gz_raw, ax_raw, ay_raw, az_raw;
-        float temp_c;
+        if (!icm42688p_fifo_ready) {
+            continue;
+        }
 
-        // 读取IMU原始数据
-        if (!icm42688p_get_all_data(&gx_raw, &gy_raw, &gz_raw, 
-                                    &ax_raw, &ay_raw, &az_raw, &temp_c)) {
-            HAL_Delay(1);
+        // 读出 FIFO 中的全部样本：陀螺仪逐个进入降采样，加速度计取批内最新一个
+        const uint16_t n = icm42688p_fifo_drain(fifo_batch, TEST_GYRO_FIFO_BATCH);
+        for (uint16_t i = n; i > 0; i--) {
+            const icm42688p_fifo_sample_t *s = &fifo_batch[i - 1];
+            if (s->accel_valid) {
+                accel_process_sample(s->accel[0], s->accel[1], s->accel[2]);
+                break;
+            }
+        }
+        const uint16_t outputs = gyro_process_batch(fifo_batch, n, NULL, NULL);
+        test_gyro_cal_poll();
+        if (outputs == 0) {
             continue;
         }
+        test_gyro_attitude_step();
+    }
+}
+
+#ifdef ICM_USE_DMA
+void test_gyro_dma_run(void)
+{
+    test_gyro_setup();
 
-        // 使用 task_gyro 和 task_acc 处理数据
-        gyro_process_sample(gx_raw, gy_raw, gz_raw);
-        accel_process_sample(ax_raw, ay_raw, az_raw);
+    // 数据就绪 EXTI 每个样本发起一次 15 字节 DMA 突发读，主循环原地解码最新帧
+    icm42688p_dma_start_stream();
 
-        // 使用处理后的数据更新姿态
-        if (!accel_scaled.ready) {
+    while (1) {
+        icm42688p_dma_frame_t f;
+        if (!icm42688p_dma_acquire(&icm_dma, &f)) {
             continue;
         }
-
-#if USE_MAGNETOMETER
-        Euler_angles ang = Attitude_Update_IMU_Only(
-            accel_scaled.g_x, accel_scaled.g_y, accel_scaled.g_z,
-            gyro_scaled.dps_x, gyro_scaled.dps_y, gyro_scaled.dps_z
-        );
-#else
-        Euler_angles ang = Attitude_Update(
-            accel_scaled.g_x, accel_scaled.g_y, accel_scaled.g_z,
-            gyro_scaled.dps_x, gyro_scaled.dps_y, gyro_scaled.dps_z
-        );
-#endif
-        const AttitudeDiagnostics *diag = Attitude_GetDiagnostics();
-
-        // 定时打印（上位机格式）
-        uint32_t now = HAL_GetTick();
-        if (now - last_print >= 100) {
-            last_print = now;
-            
-            // ATTITUDE_FULL 格式（单片机计算的姿态）
-            printf("ATTITUDE_FULL,%lu,%.2f,%.2f,%.2f,%.3f,%.3f,%.3f,%.2f,%.2f,%.2f,0,0,0\r\n",
-                   (unsigned long)now,
-                   ang.roll, ang.pitch, ang.yaw,
-                   accel_scaled.g_x, accel_scaled.g_y, accel_scaled.g_z,
-                   gyro_scaled.dps_x, gyro_scaled.dps_y, gyro_scaled.dps_z);
+        gyro_process_frame(&f);
+        if (gyro_decimated.ready) {
+            // 加速度计 ODR 1kHz：每个降采样输出取一次
+            int16_t ax, ay, az;
+            icm42688p_dma_frame_accel(&f, &ax, &ay, &az);
+            accel_process_sample(ax, ay, az);
+            gyro_cal_set_temperature(icm42688p_dma_frame_temp(&f));
         }
+        icm42688p_dma_release(&icm_dma);
 
-        if (now - last_perf >= 1000) {
-            last_perf = now;
-            float last_us = diag->cycles * cycles_to_us;
-            float max_us  = diag->cycles_max * cycles_to_us;
-            printf("[perf] dt=%.3fs spin=%.1f dps acc=%d mag=%d strength_ok=%d cycles=%lu (max %lu) => %.2fus / %.2fus\r\n",
-                   diag->dt,
-                   diag->spin_rate_dps,
-                   diag->acc_valid,
-                   diag->mag_used,
-                   diag->mag_strength_ok,
-                   (unsigned long)diag->cycles,
-                   (unsigned long)diag->cycles_max,
-                   last_us,
-                   max_us);
+        if (gyro_decimated.ready) {
+            test_gyro_cal_poll();
+            test_gyro_attitude_step();
         }
     }
 }
+#endif
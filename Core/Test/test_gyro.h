@@ -8,4 +8,9 @@
 
 void test_gyro_run(void);
 
+#ifdef ICM_USE_DMA
+// Same test fed by the data-ready EXTI + SPI DMA burst stream instead of the FIFO
+void test_gyro_dma_run(void);
+#endif
+
 #endif // TEST_GYRO_H
@@ -21,6 +21,8 @@ class SerialManager {
                 rssi: null, lq: null,
                 lastTs: 0
             },
+            // 调度器任务直方图（从 SCHED_HIST 消息获取，见 scheduler_dump_histograms）
+            schedHist: null,
             lastUpdateType: 'init'
         };
         this.onDataUpdate = null;
@@ -70,6 +72,19 @@ class SerialManager {
             this.onLine(line);
         }
         
+        // 调度器直方图：SCHED_HIST,<base64 二进制>
+        if (line.startsWith('SCHED_HIST,')) {
+            const hist = this.parseSchedHist(line.slice(11));
+            if (hist) {
+                this.sensorData.schedHist = hist;
+                this.sensorData.lastUpdateType = 'sched_hist';
+                if (this.onDataUpdate) {
+                    this.onDataUpdate(this.sensorData);
+                }
+            }
+            return;
+        }
+
         // ToF 距离（毫米）：TOF,timestamp,distMm
         if (line.startsWith('TOF,')) {
             const parts = line.split(',');
@@ -208,6 +223,92 @@ class SerialManager {
         }
     }
 
+    // 解码 scheduler_dump_histograms 的二进制格式，返回 { cpuHz, tasks: [...] }，失败返回 null
+    // 每个任务的 exec/jitter 为 { buckets: [{lo, width, count}], p50, p99, p999 }（单位 us）
+    parseSchedHist(b64) {
+        let bytes;
+        try {
+            bytes = Uint8Array.from(atob(b64.trim()), c => c.charCodeAt(0));
+        } catch (e) {
+            return null;
+        }
+        if (bytes.length < 13 || bytes[0] !== 0x53 || bytes[1] !== 0x48 || bytes[2] !== 1) return null;
+
+        // CRC-16/CCITT-FALSE
+        let crc = 0xFFFF;
+        for (let i = 0; i < bytes.length - 2; i++) {
+            crc ^= bytes[i] << 8;
+            for (let b = 0; b < 8; b++) {
+                crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) & 0xFFFF : (crc << 1) & 0xFFFF;
+            }
+        }
+        if (crc !== (bytes[bytes.length - 2] | (bytes[bytes.length - 1] << 8))) return null;
+
+        const view = new DataView(bytes.buffer);
+        const taskCount = bytes[3];
+        const cpuHz = view.getUint32(4, true);
+        const linear = bytes[8];
+        const subBits = bytes[9];
+        const usPerCycle = 1e6 / cpuHz;
+
+        // 与 scheduler_hist.c 相同的分桶公式
+        const bucketLow = (b) => {
+            if (b < linear) return b;
+            const sub = 1 << subBits;
+            const msb = Math.floor((b - linear) / sub) + subBits + 1;
+            return (sub + (b - linear) % sub) * Math.pow(2, msb - subBits);
+        };
+        const bucketWidth = (b) => {
+            if (b < linear) return 1;
+            const msb = Math.floor((b - linear) / (1 << subBits)) + subBits + 1;
+            return Math.pow(2, msb - subBits);
+        };
+
+        let pos = 11;
+        const readHist = () => {
+            const k = bytes[pos++];
+            const buckets = [];
+            let total = 0;
+            for (let i = 0; i < k; i++) {
+                const b = bytes[pos];
+                const count = view.getUint16(pos + 1, true);
+                pos += 3;
+                total += count;
+                buckets.push({ lo: bucketLow(b) * usPerCycle, width: bucketWidth(b) * usPerCycle, count });
+            }
+            const percentile = (p) => {
+                if (total === 0) return 0;
+                const rank = Math.max(1, Math.ceil(total * p));
+                let cum = 0;
+                for (const bk of buckets) {
+                    if (cum + bk.count >= rank) {
+                        return bk.lo + bk.width * (rank - cum) / bk.count;
+                    }
+                    cum += bk.count;
+                }
+                return 0;
+            };
+            return { buckets, total, p50: percentile(0.5), p99: percentile(0.99), p999: percentile(0.999) };
+        };
+
+        const tasks = [];
+        for (let t = 0; t < taskCount; t++) {
+            const nameLen = bytes[pos++];
+            const name = String.fromCharCode(...bytes.slice(pos, pos + nameLen));
+            pos += nameLen;
+            const priority = bytes[pos];
+            const lane = bytes[pos + 1] === 1 ? 'RT' : 'COOP';
+            const trigger = bytes[pos + 2] === 0 ? 'PERIODIC' : 'EVENT';
+            const execCount = view.getUint32(pos + 3, true);
+            pos += 7;
+            const exec = readHist();
+            const jitter = readHist();
+            tasks.push({ name, priority, lane, trigger, execCount, exec, jitter });
+        }
+
+        return { cpuHz, tasks, ts: Date.now() };
+    }
+
     getSensorData() {
         return this.sensorData;
     }
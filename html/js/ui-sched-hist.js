@@ -0,0 +1,92 @@
+// 调度器直方图面板：显示 SCHED_HIST 解码结果（每任务 p50/p99/p99.9，点击行查看分桶）
+class SchedHistPanel {
+    constructor() {
+        this.root = document.getElementById('sched-hist');
+        if (!this.root) return;
+        this.badge = this.root.querySelector('.status-badge');
+        this.body = document.getElementById('sched-hist-body');
+        this.canvas = document.getElementById('sched-hist-canvas');
+        this.caption = document.getElementById('sched-hist-caption');
+        this.selected = null;   // 选中的任务名
+        this.last = null;
+
+        if (this.body) {
+            this.body.addEventListener('click', (e) => {
+                const row = e.target.closest('tr[data-task]');
+                if (!row) return;
+                this.selected = row.dataset.task;
+                this.render(this.last);
+            });
+        }
+    }
+
+    update(hist) {
+        if (!this.root || !hist || hist === this.last) return;
+        this.last = hist;
+        this.render(hist);
+    }
+
+    render(hist) {
+        if (!hist || !this.body) return;
+        const fmt = (us) => us >= 1000 ? `${(us / 1000).toFixed(2)}ms` : `${us.toFixed(us < 10 ? 2 : 1)}us`;
+
+        if (!this.selected || !hist.tasks.some(t => t.name === this.selected)) {
+            this.selected = hist.tasks.length ? hist.tasks[0].name : null;
+        }
+
+        this.body.innerHTML = hist.tasks.map(t => `
+            <tr data-task="${t.name}" class="${t.name === this.selected ? 'active' : ''}">
+                <td class="task-name">${t.name}<span class="lane lane-${t.lane.toLowerCase()}">${t.lane}</span></td>
+                <td>${fmt(t.exec.p50)}</td>
+                <td>${fmt(t.exec.p99)}</td>
+                <td>${fmt(t.exec.p999)}</td>
+                <td>${fmt(t.jitter.p99)}</td>
+                <td>${fmt(t.jitter.p999)}</td>
+            </tr>`).join('');
+
+        if (this.badge) {
+            this.badge.innerText = `${hist.tasks.length} TASKS @ ${(hist.cpuHz / 1e6).toFixed(0)}MHz`;
+        }
+
+        const task = hist.tasks.find(t => t.name === this.selected);
+        this.drawBuckets(task);
+    }
+
+    // 执行时间分桶：横轴为对数时间，纵轴为对数计数（尾部的 1~2 次也能看见）
+    drawBuckets(task) {
+        if (!this.canvas) return;
+        const ctx = this.canvas.getContext('2d');
+        const w = this.canvas.width;
+        const h = this.canvas.height;
+        ctx.clearRect(0, 0, w, h);
+        if (!task || task.exec.buckets.length === 0) {
+            if (this.caption) this.caption.innerText = task ? `${task.name}: 无样本` : '';
+            return;
+        }
+
+        const buckets = task.exec.buckets;
+        const loUs = Math.max(buckets[0].lo, 0.01);
+        const last = buckets[buckets.length - 1];
+        const hiUs = Math.max(last.lo + last.width, loUs * 2);
+        const span = Math.log10(hiUs / loUs);
+        const xOf = (us) => Math.log10(Math.max(us, loUs) / loUs) / span * w;
+        const maxLog = Math.log10(Math.max(...buckets.map(b => b.count)) + 1);
+
+        ctx.fillStyle = '#3b82f6';
+        for (const b of buckets) {
+            const x0 = xOf(b.lo);
+            const x1 = Math.max(xOf(b.lo + b.width), x0 + 1);
+            const bh = Math.log10(b.count + 1) / maxLog * (h - 2);
+            ctx.fillRect(x0, h - bh, x1 - x0, bh);
+        }
+
+        // 百分位标记
+        ctx.fillStyle = '#ef4444';
+        [task.exec.p99, task.exec.p999].forEach(p => ctx.fillRect(xOf(p), 0, 1, h));
+
+        if (this.caption) {
+            const fmt = (us) => us >= 1000 ? `${(us / 1000).toFixed(2)}ms` : `${us.toFixed(1)}us`;
+            this.caption.innerText = `${task.name} exec: ${fmt(loUs)} ~ ${fmt(hiUs)}，共 ${task.exec.total} 次（红线 p99 / p99.9）`;
+        }
+    }
+}
@@ -6,6 +6,7 @@ class UIManager {
         this.imuCard = typeof ImuCard !== 'undefined' ? new ImuCard() : null;
         this.attWidget = typeof AttitudeWidget !== 'undefined' ? new AttitudeWidget() : null;
         this.motorMini = typeof MotorOutputMini !== 'undefined' ? new MotorOutputMini() : null;
+        this.schedHist = typeof SchedHistPanel !== 'undefined' ? new SchedHistPanel() : null;
         this.connectionState = null;
 
         this.elements = {
@@ -47,6 +48,11 @@ class UIManager {
             }
         }
 
+        // 调度器直方图（SCHED_HIST）
+        if (updateType === 'sched_hist' && this.schedHist) {
+            this.schedHist.update(sensorData.schedHist);
+        }
+
         // 更新 RC 显示
         if (sensorData.rc) {
             this.updateRC(sensorData.rc);